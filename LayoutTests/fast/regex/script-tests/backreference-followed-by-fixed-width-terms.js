@@ -0,0 +1,25 @@
+description(
+"Tests that a back-reference followed by fixed-width terms does not match past the end of the input. The inputs are substrings, which can share the characters of a longer string."
+);
+
+var longString = "aab";
+var shortString = longString.substring(0, 2);
+shouldBeNull("/(a)\\1[b]/.exec(shortString)");
+shouldBeNull("/(a)\\1b/.exec(shortString)");
+shouldBeNull("/(a)\\1./.exec(shortString)");
+shouldBe("/(a)\\1[b]/.exec(longString)", "['aab', 'a']");
+shouldBe("/(a)\\1/.exec(shortString)", "['aa', 'a']");
+
+longString = "xyaaxy";
+shortString = longString.substring(0, 5);
+shouldBeNull("/(a)\\1.{2}/.exec(shortString)");
+shouldBe("/(a)\\1.{2}/.exec(longString)", "['aaxy', 'a']");
+shouldBe("/(a)\\1.?/.exec(shortString)", "['aax', 'a']");
+
+longString = "ababcd";
+shortString = longString.substring(0, 5);
+shouldBeNull("/(ab)\\1cd/.exec(shortString)");
+shouldBe("/(ab)\\1cd/.exec(longString)", "['ababcd', 'ab']");
+shouldBe("/(ab)\\1c/.exec(shortString)", "['ababc', 'ab']");
+
+var successfullyParsed = true;
@@ -66,6 +66,7 @@ SOURCES += \
     assembler/MacroAssemblerSH4.cpp \
     assembler/SH4Assembler.h \
     bytecode/CodeBlock.cpp \
+    bytecode/BytecodeCache.cpp \
     bytecode/JumpTable.cpp \
     bytecode/Opcode.cpp \
     bytecode/SamplingTool.cpp \
@@ -73,9 +74,12 @@ SOURCES += \
     bytecompiler/BytecodeGenerator.cpp \
     bytecompiler/NodesCodegen.cpp \
     heap/ConservativeRoots.cpp \
+    heap/CopiedSpace.cpp \
     heap/HandleHeap.cpp \
     heap/HandleStack.cpp \
     heap/Heap.cpp \
+    heap/LargeObjectSpace.cpp \
+    heap/HeapSizingPolicy.cpp \
     heap/MachineStackMarker.cpp \
     heap/MarkStack.cpp \
     heap/MarkStackPosix.cpp \
@@ -109,6 +113,7 @@ SOURCES += \
     jit/JITPropertyAccess32_64.cpp \
     jit/JITStubs.cpp \
     jit/ThunkGenerators.cpp \
+    parser/BackgroundPreparser.cpp \
     parser/JSParser.cpp \
     parser/Lexer.cpp \
     parser/Nodes.cpp \
@@ -170,6 +175,7 @@ SOURCES += \
     runtime/LiteralParser.cpp \
     runtime/Lookup.cpp \
     runtime/MathObject.cpp \
+    runtime/MemoryStatistics.cpp \
     runtime/NativeErrorConstructor.cpp \
     runtime/NativeErrorPrototype.cpp \
     runtime/NumberConstructor.cpp \
@@ -177,6 +183,7 @@ SOURCES += \
     runtime/NumberPrototype.cpp \
     runtime/ObjectConstructor.cpp \
     runtime/ObjectPrototype.cpp \
+    runtime/Options.cpp \
     runtime/Operations.cpp \
     runtime/PropertyDescriptor.cpp \
     runtime/PropertyNameArray.cpp \
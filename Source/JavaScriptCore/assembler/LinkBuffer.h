@@ -154,6 +154,13 @@ public:
 
     // This method obtains the return address of the call, given as an offset from
     // the start of the code.
+    // The offset of a label from the start of the code, for code that is
+    // entered part way through, at a label other than its entry point.
+    unsigned offsetOf(Label label)
+    {
+        return static_cast<char*>(locationOf(label).dataLocation()) - static_cast<char*>(code());
+    }
+
     unsigned returnAddressOffset(Call call)
     {
         call.m_jmp = applyOffset(call.m_jmp);
@@ -0,0 +1,1548 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "BytecodeCache.h"
+
+#include "BytecodeGenerator.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSGlobalObject.h"
+#include "JSString.h"
+#include "Nodes.h"
+#include "RegExpCache.h"
+#include "ScopeChain.h"
+#include "SourceProvider.h"
+#include <string.h>
+
+namespace JSC {
+
+// Serialized caches start with the magic number, the format version and a
+// description of the build, so that a cache is only read back by the
+// JavaScriptCore that wrote it, and end with a checksum of everything before
+// it. Bump the version whenever the format, or the meaning of the bytecode
+// that it holds, changes. Values are stored in host byte order.
+static const uint32_t cacheMagic = 0x4342534a; // "JSBC"
+static const uint32_t cacheVersion = 2;
+
+static const uint32_t nullStringLength = 0xffffffff;
+
+enum ConstantTag { UndefinedTag, NullTag, TrueTag, FalseTag, Int32Tag, DoubleTag, StringTag, GlobalObjectTag };
+enum FunctionTag { CallFunctionTag, ApplyFunctionTag };
+
+static uint32_t buildConfiguration()
+{
+    uint32_t configuration = numOpcodeIDs << 8;
+#if ENABLE(JIT)
+    configuration |= 1;
+#endif
+#if ENABLE(INTERPRETER)
+    configuration |= 2;
+#endif
+    return configuration;
+}
+
+// Code is generated differently when any of these are set, so it is only
+// loaded for a global object with the same settings.
+static uint32_t generationFlags(JSGlobalObject* globalObject)
+{
+    return (globalObject->debugger() ? 1 : 0) | (globalObject->supportsProfiling() ? 2 : 0) | (globalObject->supportsRichSourceInfo() ? 4 : 0);
+}
+
+static uint64_t hashSource(const UChar* characters, unsigned length)
+{
+    // 64-bit FNV-1a.
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned i = 0; i < length; ++i) {
+        hash ^= characters[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t hashData(const char* data, size_t size)
+{
+    // 64-bit FNV-1a.
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+class BytecodeWriter {
+public:
+    BytecodeWriter(Vector<char>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    void writeUInt8(uint8_t value) { m_buffer.append(static_cast<char>(value)); }
+
+    // Most values are small, so integers are written seven bits at a time.
+    void writeUInt32(uint32_t value)
+    {
+        while (value >= 0x80) {
+            writeUInt8(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        writeUInt8(value);
+    }
+
+    // Negative operands are common too (registers of arguments and globals),
+    // so the sign is moved to the low bit.
+    void writeInt32(int32_t value) { writeUInt32((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31)); }
+
+    void writeDouble(double value) { m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    void writeString(const UChar* characters, unsigned length)
+    {
+        writeUInt32(length);
+        m_buffer.append(reinterpret_cast<const char*>(characters), length * sizeof(UChar));
+    }
+
+    void writeString(StringImpl* string)
+    {
+        if (!string) {
+            writeUInt32(nullStringLength);
+            return;
+        }
+        writeString(string->characters(), string->length());
+    }
+
+    void writeString(const UString& string) { writeString(string.impl()); }
+    void writeIdentifier(const Identifier& identifier) { writeString(identifier.impl()); }
+
+private:
+    Vector<char>& m_buffer;
+};
+
+// Reading past the end of the data makes the reader fail, after which every
+// read returns zero.
+class BytecodeReader {
+public:
+    BytecodeReader(const char* data, size_t size)
+        : m_position(data)
+        , m_end(data + size)
+        , m_failed(false)
+    {
+    }
+
+    bool failed() const { return m_failed; }
+    bool atEnd() const { return !m_failed && m_position == m_end; }
+
+    uint8_t readUInt8() { return read<uint8_t>(); }
+
+    uint32_t readUInt32()
+    {
+        uint32_t value = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = readUInt8();
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    int32_t readInt32()
+    {
+        uint32_t value = readUInt32();
+        return static_cast<int32_t>((value >> 1) ^ (0 - (value & 1)));
+    }
+
+    double readDouble() { return read<double>(); }
+
+    // Reads the number of items that follow, each of which takes at least a
+    // byte.
+    unsigned readCount()
+    {
+        uint32_t count = readUInt32();
+        if (!canRead(count))
+            return 0;
+        return count;
+    }
+
+    const char* readBytes(size_t size)
+    {
+        if (!canRead(size))
+            return 0;
+        const char* bytes = m_position;
+        m_position += size;
+        return bytes;
+    }
+
+    UString readString()
+    {
+        uint32_t length = readUInt32();
+        if (length == nullStringLength || !canRead(static_cast<uint64_t>(length) * sizeof(UChar)))
+            return UString();
+        UString string = length ? UString(reinterpret_cast<const UChar*>(m_position), length) : UString("");
+        m_position += length * sizeof(UChar);
+        return string;
+    }
+
+    Identifier readIdentifier(JSGlobalData* globalData)
+    {
+        uint32_t length = readUInt32();
+        if (length == nullStringLength || !canRead(static_cast<uint64_t>(length) * sizeof(UChar)))
+            return Identifier();
+        Vector<UChar, 64> characters(length);
+        memcpy(characters.data(), m_position, length * sizeof(UChar));
+        m_position += length * sizeof(UChar);
+        return Identifier(globalData, characters.data(), length);
+    }
+
+private:
+    bool canRead(uint64_t size)
+    {
+        if (m_failed || static_cast<uint64_t>(m_end - m_position) < size)
+            m_failed = true;
+        return !m_failed;
+    }
+
+    template<typename T> T read()
+    {
+        T value = 0;
+        if (canRead(sizeof(T))) {
+            memcpy(&value, m_position, sizeof(T));
+            m_position += sizeof(T);
+        }
+        return value;
+    }
+
+    const char* m_position;
+    const char* m_end;
+    bool m_failed;
+};
+
+static void writeFunction(BytecodeWriter& writer, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, bool isStrictMode, int firstLine, int lastLine)
+{
+    writer.writeIdentifier(name);
+    writer.writeInt32(source.startOffset());
+    writer.writeInt32(source.endOffset());
+    writer.writeInt32(source.firstLine());
+    writer.writeUInt8(forceUsesArguments);
+    writer.writeUInt8(isStrictMode);
+    writer.writeInt32(firstLine);
+    writer.writeInt32(lastLine);
+    writer.writeUInt32(parameters->size());
+    for (size_t i = 0; i < parameters->size(); ++i)
+        writer.writeIdentifier(parameters->at(i));
+}
+
+// A function that is declared or created by cached code. The code of the
+// function itself has its own cache entry.
+struct CachedFunction {
+    Identifier name;
+    int startOffset;
+    int endOffset;
+    int sourceFirstLine;
+    bool forceUsesArguments;
+    bool isStrictMode;
+    int firstLine;
+    int lastLine;
+    RefPtr<FunctionParameters> parameters;
+
+    bool read(BytecodeReader& reader, JSGlobalData* globalData, SourceProvider* provider)
+    {
+        name = reader.readIdentifier(globalData);
+        startOffset = reader.readInt32();
+        endOffset = reader.readInt32();
+        sourceFirstLine = reader.readInt32();
+        forceUsesArguments = reader.readUInt8();
+        isStrictMode = reader.readUInt8();
+        firstLine = reader.readInt32();
+        lastLine = reader.readInt32();
+        parameters = FunctionParameters::create();
+        for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+            Identifier parameter = reader.readIdentifier(globalData);
+            if (parameter.isNull())
+                return false;
+            parameters->append(parameter);
+        }
+        return !reader.failed() && startOffset >= 0 && startOffset <= endOffset && endOffset <= provider->length();
+    }
+
+    FunctionExecutable* create(JSGlobalData* globalData, SourceProvider* provider) const
+    {
+        return FunctionExecutable::create(globalData, name, SourceCode(provider, startOffset, endOffset, sourceFirstLine), forceUsesArguments, parameters.get(), isStrictMode, firstLine, lastLine);
+    }
+};
+
+class CachedDeclarations : public GlobalDeclarations {
+public:
+    CachedDeclarations(SourceProvider* provider)
+        : m_provider(provider)
+    {
+    }
+
+    bool read(BytecodeReader& reader, JSGlobalData* globalData)
+    {
+        m_functions.resize(reader.readCount());
+        for (size_t i = 0; i < m_functions.size(); ++i) {
+            if (!m_functions[i].read(reader, globalData, m_provider) || m_functions[i].name.isNull())
+                return false;
+        }
+        for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+            Identifier name = reader.readIdentifier(globalData);
+            if (name.isNull())
+                return false;
+            m_variables.append(std::make_pair(name, static_cast<bool>(reader.readUInt8())));
+        }
+        return !reader.failed();
+    }
+
+    virtual size_t numberOfFunctions() const { return m_functions.size(); }
+    virtual const Identifier& functionName(size_t i) const { return m_functions[i].name; }
+    virtual FunctionExecutable* makeFunction(ExecState* exec, size_t i) const { return m_functions[i].create(&exec->globalData(), m_provider); }
+
+    virtual size_t numberOfVariables() const { return m_variables.size(); }
+    virtual const Identifier& variableName(size_t i) const { return m_variables[i].first; }
+    virtual bool variableIsConstant(size_t i) const { return m_variables[i].second; }
+
+private:
+    SourceProvider* m_provider;
+    Vector<CachedFunction> m_functions;
+    Vector<std::pair<Identifier, bool> > m_variables;
+};
+
+BytecodeCache::BytecodeCache()
+    : m_sourceHash(0)
+    , m_sourceLength(0)
+    , m_hasSource(false)
+    , m_hasNewCodeBlocks(false)
+    , m_numberOfLoadedCodeBlocks(0)
+{
+}
+
+BytecodeCache::~BytecodeCache()
+{
+}
+
+PassRefPtr<BytecodeCache> BytecodeCache::create(const char* data, size_t size)
+{
+    RefPtr<BytecodeCache> cache = create();
+
+    uint64_t checksum;
+    if (size < sizeof(checksum))
+        return cache.release();
+    size -= sizeof(checksum);
+    memcpy(&checksum, data + size, sizeof(checksum));
+    if (checksum != hashData(data, size))
+        return cache.release();
+
+    BytecodeReader reader(data, size);
+    if (reader.readUInt32() != cacheMagic || reader.readUInt32() != cacheVersion || reader.readUInt32() != buildConfiguration())
+        return cache.release();
+    uint32_t sourceLength = reader.readUInt32();
+    uint64_t sourceHash = reader.readUInt32();
+    sourceHash |= static_cast<uint64_t>(reader.readUInt32()) << 32;
+
+    EntryMap entries;
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        unsigned key = reader.readUInt32();
+        Entry entry;
+        entry.offset = reader.readUInt32();
+        entry.length = reader.readUInt32();
+        if (!key || key == static_cast<unsigned>(-1))
+            return cache.release();
+        entries.set(key, entry);
+    }
+    unsigned dataSize = reader.readUInt32();
+    const char* entryData = reader.readBytes(dataSize);
+    if (!reader.atEnd())
+        return cache.release();
+    for (EntryMap::iterator it = entries.begin(); it != entries.end(); ++it) {
+        if (it->second.offset > dataSize || it->second.length > dataSize - it->second.offset)
+            return cache.release();
+    }
+
+    cache->m_sourceHash = sourceHash;
+    cache->m_sourceLength = sourceLength;
+    cache->m_hasSource = true;
+    cache->m_entries.swap(entries);
+    cache->m_data.append(entryData, dataSize);
+    return cache.release();
+}
+
+void BytecodeCache::setSource(const UChar* characters, unsigned length)
+{
+    uint64_t sourceHash = hashSource(characters, length);
+    if (m_hasSource && (sourceHash != m_sourceHash || length != m_sourceLength)) {
+        m_entries.clear();
+        m_data.clear();
+    }
+    m_sourceHash = sourceHash;
+    m_sourceLength = length;
+    m_hasSource = true;
+}
+
+void BytecodeCache::serialize(Vector<char>& data) const
+{
+    size_t start = data.size();
+    BytecodeWriter writer(data);
+    writer.writeUInt32(cacheMagic);
+    writer.writeUInt32(cacheVersion);
+    writer.writeUInt32(buildConfiguration());
+    writer.writeUInt32(m_sourceLength);
+    writer.writeUInt32(static_cast<uint32_t>(m_sourceHash));
+    writer.writeUInt32(static_cast<uint32_t>(m_sourceHash >> 32));
+
+    writer.writeUInt32(m_entries.size());
+    EntryMap::const_iterator end = m_entries.end();
+    for (EntryMap::const_iterator it = m_entries.begin(); it != end; ++it) {
+        writer.writeUInt32(it->first);
+        writer.writeUInt32(it->second.offset);
+        writer.writeUInt32(it->second.length);
+    }
+    writer.writeUInt32(m_data.size());
+    data.append(m_data.data(), m_data.size());
+
+    uint64_t checksum = hashData(data.data() + start, data.size() - start);
+    data.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+}
+
+void BytecodeCache::addEntry(unsigned key, const Vector<char>& data)
+{
+    Entry entry;
+    entry.offset = m_data.size();
+    entry.length = data.size();
+    m_data.append(data.data(), data.size());
+    m_entries.set(key, entry);
+    m_hasNewCodeBlocks = true;
+}
+
+static void writeParseInfo(BytecodeWriter& writer, JSGlobalObject* globalObject, CodeFeatures features, bool hasCapturedVariables, int firstLine, int lastLine)
+{
+    writer.writeUInt32(generationFlags(globalObject));
+    writer.writeUInt32(features);
+    writer.writeUInt8(hasCapturedVariables);
+    writer.writeInt32(firstLine);
+    writer.writeInt32(lastLine);
+}
+
+void BytecodeCache::addProgram(ProgramExecutable* executable, ProgramNode* programNode)
+{
+    unsigned key = entryKey(executable->source().startOffset(), ProgramEntry);
+    if (m_entries.contains(key))
+        return;
+
+    ProgramCodeBlock* codeBlock = executable->m_programCodeBlock.get();
+    Vector<char> data;
+    BytecodeWriter writer(data);
+    writeParseInfo(writer, codeBlock->globalObject(), executable->m_features, executable->m_hasCapturedVariables, executable->m_firstLine, executable->m_lastLine);
+
+    const DeclarationStacks::FunctionStack& functionStack = programNode->functionStack();
+    writer.writeUInt32(functionStack.size());
+    for (size_t i = 0; i < functionStack.size(); ++i) {
+        FunctionBodyNode* body = functionStack[i];
+        writeFunction(writer, body->ident(), body->source(), body->usesArguments(), body->parameters(), body->isStrictMode(), body->lineNo(), body->lastLine());
+    }
+    const DeclarationStacks::VarStack& varStack = programNode->varStack();
+    writer.writeUInt32(varStack.size());
+    for (size_t i = 0; i < varStack.size(); ++i) {
+        writer.writeIdentifier(*varStack[i].first);
+        writer.writeUInt8(varStack[i].second & DeclarationStacks::IsConstant);
+    }
+
+    if (writeCodeBlock(writer, codeBlock))
+        addEntry(key, data);
+}
+
+void BytecodeCache::addFunction(FunctionExecutable* executable, bool isConstructor)
+{
+    unsigned key = entryKey(executable->source().startOffset(), isConstructor ? ConstructEntry : CallEntry);
+    if (m_entries.contains(key))
+        return;
+
+    FunctionCodeBlock* codeBlock = isConstructor ? executable->m_codeBlockForConstruct.get() : executable->m_codeBlockForCall.get();
+    Vector<char> data;
+    BytecodeWriter writer(data);
+    writeParseInfo(writer, codeBlock->globalObject(), executable->m_features, executable->m_hasCapturedVariables, executable->m_firstLine, executable->m_lastLine);
+    if (!writeCodeBlock(writer, codeBlock))
+        return;
+
+    SymbolTable* symbolTable = codeBlock->symbolTable();
+    writer.writeUInt32(symbolTable->size());
+    SymbolTable::iterator end = symbolTable->end();
+    for (SymbolTable::iterator it = symbolTable->begin(); it != end; ++it) {
+        writer.writeString(it->first.get());
+        writer.writeInt32(it->second.getIndex());
+        writer.writeUInt32(it->second.getAttributes());
+    }
+
+    addEntry(key, data);
+}
+
+bool BytecodeCache::loadProgram(ExecState* exec, ScopeChainNode* scopeChainNode, ProgramExecutable* executable)
+{
+    EntryMap::iterator it = m_entries.find(entryKey(executable->source().startOffset(), ProgramEntry));
+    if (it == m_entries.end())
+        return false;
+
+    JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
+    JSGlobalData* globalData = &exec->globalData();
+    SourceProvider* provider = executable->source().provider();
+    BytecodeReader reader(m_data.data() + it->second.offset, it->second.length);
+    if (!readParseInfo(reader, globalObject, executable))
+        return false;
+
+    // Declaring the globals before the program is compiled matches what the
+    // BytecodeGenerator does, so a failure from here on leaves the global
+    // object as compiling the program would.
+    CachedDeclarations declarations(provider);
+    if (!declarations.read(reader, globalData))
+        return false;
+    BytecodeGenerator::declareGlobals(scopeChainNode, declarations);
+
+    executable->m_programCodeBlock = adoptPtr(new ProgramCodeBlock(executable, GlobalCode, globalObject, provider));
+    if (!readCodeBlock(reader, executable->m_programCodeBlock.get(), scopeChainNode) || !reader.atEnd()) {
+        executable->m_programCodeBlock.clear();
+        return false;
+    }
+    ++m_numberOfLoadedCodeBlocks;
+    return true;
+}
+
+bool BytecodeCache::loadFunction(ExecState* exec, ScopeChainNode* scopeChainNode, FunctionExecutable* executable, bool isConstructor)
+{
+    EntryMap::iterator it = m_entries.find(entryKey(executable->source().startOffset(), isConstructor ? ConstructEntry : CallEntry));
+    if (it == m_entries.end())
+        return false;
+
+    JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
+    JSGlobalData* globalData = &exec->globalData();
+    BytecodeReader reader(m_data.data() + it->second.offset, it->second.length);
+    if (!readParseInfo(reader, globalObject, executable))
+        return false;
+
+    OwnPtr<FunctionCodeBlock>& codeBlock = isConstructor ? executable->m_codeBlockForConstruct : executable->m_codeBlockForCall;
+    ASSERT(!codeBlock);
+    codeBlock = adoptPtr(new FunctionCodeBlock(executable, FunctionCode, globalObject, executable->source().provider(), executable->source().startOffset(), isConstructor));
+    bool succeeded = readCodeBlock(reader, codeBlock.get(), scopeChainNode);
+
+    SymbolTable* symbolTable = codeBlock->symbolTable();
+    for (unsigned count = reader.readCount(), i = 0; succeeded && i < count; ++i) {
+        Identifier name = reader.readIdentifier(globalData);
+        int index = reader.readInt32();
+        unsigned attributes = reader.readUInt32();
+        // Variables are locals, and parameters are below the call frame header.
+        bool isParameter = index < -RegisterFile::CallFrameHeaderSize && index >= -RegisterFile::CallFrameHeaderSize - codeBlock->m_numParameters;
+        if (reader.failed() || name.isNull() || (!isParameter && (index < 0 || index >= codeBlock->m_numVars))) {
+            succeeded = false;
+            break;
+        }
+        symbolTable->add(name.impl(), SymbolTableEntry(index, attributes));
+    }
+    if (!succeeded || !reader.atEnd()) {
+        codeBlock.clear();
+        return false;
+    }
+
+    if (isConstructor)
+        executable->m_numParametersForConstruct = codeBlock->m_numParameters;
+    else
+        executable->m_numParametersForCall = codeBlock->m_numParameters;
+    executable->m_numCapturedVariables = codeBlock->m_numCapturedVars;
+    executable->m_symbolTable = codeBlock->sharedSymbolTable();
+    ++m_numberOfLoadedCodeBlocks;
+    return true;
+}
+
+bool BytecodeCache::readParseInfo(BytecodeReader& reader, JSGlobalObject* globalObject, ScriptExecutable* executable)
+{
+    if (reader.readUInt32() != generationFlags(globalObject))
+        return false;
+    CodeFeatures features = reader.readUInt32();
+    bool hasCapturedVariables = reader.readUInt8();
+    int firstLine = reader.readInt32();
+    int lastLine = reader.readInt32();
+    if (reader.failed())
+        return false;
+    executable->recordParse(features, hasCapturedVariables, firstLine, lastLine);
+    return true;
+}
+
+// Code addresses global variables by their index in the global object. The
+// cache stores their names instead, and finds their indexes again when it
+// loads the code, which may be for a different global object.
+StringImpl* BytecodeCache::globalName(JSGlobalObject* globalObject, int index)
+{
+    if (index >= 0)
+        return 0;
+    SymbolTable& symbolTable = globalObject->symbolTable();
+    size_t slot = -index - 1;
+    if (slot < m_globalNames.size() && m_globalNames[slot]) {
+        SymbolTableEntry entry = symbolTable.get(m_globalNames[slot].get());
+        if (!entry.isNull() && entry.getIndex() == index)
+            return m_globalNames[slot].get();
+    }
+
+    m_globalNames.clear();
+    SymbolTable::iterator end = symbolTable.end();
+    for (SymbolTable::iterator it = symbolTable.begin(); it != end; ++it) {
+        int entryIndex = it->second.getIndex();
+        if (entryIndex >= 0)
+            continue;
+        size_t entrySlot = -entryIndex - 1;
+        if (entrySlot >= m_globalNames.size())
+            m_globalNames.grow(entrySlot + 1);
+        m_globalNames[entrySlot] = it->first;
+    }
+    return slot < m_globalNames.size() ? m_globalNames[slot].get() : 0;
+}
+
+bool BytecodeCache::writeGlobalVariable(BytecodeWriter& writer, JSGlobalObject* globalObject, int index)
+{
+    StringImpl* name = globalName(globalObject, index);
+    if (!name)
+        return false;
+    writer.writeUInt8(globalObject->symbolTable().get(name).isReadOnly());
+    writer.writeString(name);
+    return true;
+}
+
+static bool readGlobalVariable(BytecodeReader& reader, JSGlobalObject* globalObject, int& index)
+{
+    bool isReadOnly = reader.readUInt8();
+    Identifier name = reader.readIdentifier(&globalObject->globalData());
+    if (reader.failed() || name.isNull())
+        return false;
+    SymbolTableEntry entry = globalObject->symbolTable().get(name.impl());
+    if (entry.isNull() || entry.isReadOnly() != isReadOnly)
+        return false;
+    index = entry.getIndex();
+    return true;
+}
+
+static bool writeConstant(BytecodeWriter& writer, JSGlobalObject* globalObject, JSValue value)
+{
+    if (value.isUndefined())
+        writer.writeUInt8(UndefinedTag);
+    else if (value.isNull())
+        writer.writeUInt8(NullTag);
+    else if (value.isTrue())
+        writer.writeUInt8(TrueTag);
+    else if (value.isFalse())
+        writer.writeUInt8(FalseTag);
+    else if (value.isInt32()) {
+        writer.writeUInt8(Int32Tag);
+        writer.writeInt32(value.asInt32());
+    } else if (value.isDouble()) {
+        writer.writeUInt8(DoubleTag);
+        writer.writeDouble(value.asDouble());
+    } else if (value.isString()) {
+        writer.writeUInt8(StringTag);
+        writer.writeString(asString(value)->tryGetValue());
+    } else if (value == JSValue(globalObject))
+        writer.writeUInt8(GlobalObjectTag);
+    else
+        return false;
+    return true;
+}
+
+static bool readConstant(BytecodeReader& reader, JSGlobalObject* globalObject, JSValue& value)
+{
+    switch (reader.readUInt8()) {
+    case UndefinedTag:
+        value = jsUndefined();
+        break;
+    case NullTag:
+        value = jsNull();
+        break;
+    case TrueTag:
+        value = jsBoolean(true);
+        break;
+    case FalseTag:
+        value = jsBoolean(false);
+        break;
+    case Int32Tag:
+        value = jsNumber(reader.readInt32());
+        break;
+    case DoubleTag:
+        value = jsNumber(reader.readDouble());
+        break;
+    case StringTag: {
+        UString string = reader.readString();
+        if (string.isNull())
+            return false;
+        value = jsOwnedString(&globalObject->globalData(), string);
+        break;
+    }
+    case GlobalObjectTag:
+        value = globalObject;
+        break;
+    default:
+        return false;
+    }
+    return !reader.failed();
+}
+
+// The operands of each instruction that the BytecodeGenerator emits, one
+// character for each:
+//   r  a register or a constant
+//   d  a register
+//   a  the arguments register
+//   v  the activation register
+//   i  an identifier
+//   f  a function declaration
+//   e  a function expression
+//   x  a regular expression
+//   s  an immediate switch jump table
+//   c  a character switch jump table
+//   t  a string switch jump table
+//   j  a jump, relative to the start of the instruction
+//   k  a number of scopes to skip
+//   g  a global variable, which is cached by name
+//   p  Function.prototype.call or apply, which is cached as a FunctionTag
+//   z  a cache, which is empty until the code runs
+//   n  anything else
+// Instructions that code is only rewritten to as it runs are never cached,
+// so they have no operands here.
+static const char* operandKinds(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_enter:
+    case op_method_check:
+    case op_pop_scope:
+        return "";
+    case op_create_activation:
+        return "v";
+    case op_sret:
+    case op_init_lazy_reg:
+    case op_get_callee:
+    case op_convert_this:
+    case op_convert_this_strict:
+    case op_new_object:
+    case op_pre_inc:
+    case op_pre_dec:
+    case op_call_put_result:
+    case op_catch:
+        return "d";
+    case op_create_arguments:
+    case op_tear_off_arguments:
+        return "a";
+    case op_check_has_instance:
+    case op_ret:
+    case op_push_scope:
+    case op_throw:
+    case op_throw_reference_error:
+    case op_profile_will_call:
+    case op_profile_did_call:
+    case op_end:
+        return "r";
+    case op_create_this:
+    case op_mov:
+    case op_not:
+    case op_eq_null:
+    case op_neq_null:
+    case op_to_jsnumber:
+    case op_negate:
+    case op_bitnot:
+    case op_typeof:
+    case op_is_undefined:
+    case op_is_boolean:
+    case op_is_number:
+    case op_is_string:
+    case op_is_object:
+    case op_is_function:
+    case op_to_primitive:
+        return "dr";
+    case op_post_inc:
+    case op_post_dec:
+        return "dd";
+    case op_eq:
+    case op_neq:
+    case op_stricteq:
+    case op_nstricteq:
+    case op_less:
+    case op_lesseq:
+    case op_mod:
+    case op_lshift:
+    case op_rshift:
+    case op_urshift:
+    case op_in:
+    case op_get_by_val:
+    case op_get_argument_by_val:
+    case op_del_by_val:
+        return "drr";
+    case op_add:
+    case op_mul:
+    case op_div:
+    case op_sub:
+    case op_bitand:
+    case op_bitxor:
+    case op_bitor:
+        return "drrn";
+    case op_instanceof:
+        return "drrr";
+    case op_new_array:
+        return "dnn";
+    case op_new_regexp:
+        return "dx";
+    case op_resolve:
+    case op_ensure_property_exists:
+        return "di";
+    case op_resolve_skip:
+        return "dik";
+    case op_resolve_base:
+        return "din";
+    case op_resolve_global:
+        return "dizz";
+    case op_resolve_global_dynamic:
+        return "dizzk";
+    case op_get_scoped_var:
+        return "dnk";
+    case op_put_scoped_var:
+        return "nkr";
+    case op_get_global_var:
+        return "dg";
+    case op_put_global_var:
+        return "gr";
+    case op_resolve_with_base:
+        return "ddi";
+    case op_get_by_id:
+        return "drizzzz";
+    case op_get_arguments_length:
+    case op_del_by_id:
+        return "dri";
+    case op_put_by_id:
+        return "rirzzzzn";
+    case op_get_by_pname:
+        return "drrrrr";
+    case op_put_by_val:
+        return "rrr";
+    case op_put_by_index:
+        return "rnr";
+    case op_put_getter:
+    case op_put_setter:
+        return "rir";
+    case op_jmp:
+    case op_loop:
+        return "j";
+    case op_jtrue:
+    case op_jfalse:
+    case op_jeq_null:
+    case op_jneq_null:
+    case op_loop_if_true:
+    case op_loop_if_false:
+        return "rj";
+    case op_jneq_ptr:
+        return "rpj";
+    case op_jnless:
+    case op_jnlesseq:
+    case op_jless:
+    case op_jlesseq:
+    case op_loop_if_less:
+    case op_loop_if_lesseq:
+        return "rrj";
+    case op_jmp_scopes:
+        return "nj";
+    case op_switch_imm:
+        return "sjr";
+    case op_switch_char:
+        return "cjr";
+    case op_switch_string:
+        return "tjr";
+    case op_new_func:
+        return "dfn";
+    case op_new_func_exp:
+        return "de";
+    case op_call:
+    case op_call_eval:
+    case op_construct:
+        return "rnn";
+    case op_call_varargs:
+        return "rrn";
+    case op_load_varargs:
+        return "drn";
+    case op_tear_off_activation:
+        return "va";
+    case op_ret_object_or_this:
+        return "rr";
+    case op_strcat:
+        return "dnn";
+    case op_get_pnames:
+        return "drddj";
+    case op_next_pname:
+        return "drdrrj";
+    case op_push_new_scope:
+        return "dir";
+    case op_jsr:
+        return "dj";
+    case op_debug:
+        return "nnn";
+    default:
+        return 0;
+    }
+}
+
+// Checks that the operands of code read from a cache refer to registers,
+// constants, functions and instructions of the code block that it is read
+// into, and to variables in the scope chain that it is read for, so that a
+// cache that does not match its source is rejected rather than run. The
+// tables that are read after the instructions are checked once they have been
+// read.
+class CachedCodeValidator {
+public:
+    CachedCodeValidator(CodeBlock* codeBlock, ScopeChainNode* scopeChainNode, unsigned instructionCount)
+        : m_codeBlock(codeBlock)
+        , m_argumentsRegister(codeBlock->usesArguments() ? codeBlock->argumentsRegister() : -1)
+        , m_activationRegister(hasActivation() ? codeBlock->activationRegister() : -1)
+        , m_scopeChain(scopeChainNode)
+        , m_scopeChainLength(0)
+        , m_isInstructionStart(instructionCount)
+        , m_isInPrologue(true)
+        , m_lastOpcode(op_end)
+        , m_numberOfRegExps(0)
+        , m_numberOfScopePushes(0)
+        , m_maxScopeDepthOfJumps(0)
+    {
+        for (ScopeChainNode* node = scopeChainNode; node; node = node->next.get())
+            ++m_scopeChainLength;
+        m_isInstructionStart.fill(false);
+    }
+
+    bool isLocal(int index) const { return index >= 0 && index < m_codeBlock->m_numCalleeRegisters; }
+
+    bool isRegister(int index) const
+    {
+        if (index >= 0)
+            return index < m_codeBlock->m_numCalleeRegisters;
+        // "this" and the other parameters.
+        return index < -RegisterFile::CallFrameHeaderSize && index >= -RegisterFile::CallFrameHeaderSize - m_codeBlock->m_numParameters;
+    }
+
+    bool isInstructionStart(unsigned bytecodeOffset) const { return bytecodeOffset < m_isInstructionStart.size() && m_isInstructionStart[bytecodeOffset]; }
+
+    bool checkOperand(char kind, int operand, unsigned bytecodeOffset)
+    {
+        switch (kind) {
+        case 'r':
+            if (operand >= FirstConstantRegisterIndex)
+                return static_cast<unsigned>(operand - FirstConstantRegisterIndex) < m_codeBlock->numberOfConstantRegisters();
+            return isRegister(operand);
+        case 'd':
+            return isRegister(operand);
+        case 'a':
+            return operand == m_argumentsRegister;
+        case 'v':
+            return operand == m_activationRegister;
+        case 'i':
+            return static_cast<unsigned>(operand) < m_codeBlock->numberOfIdentifiers();
+        case 'f':
+            return operand >= 0 && operand < m_codeBlock->numberOfFunctionDecls();
+        case 'e':
+            return operand >= 0 && operand < m_codeBlock->numberOfFunctionExprs();
+        case 'x':
+            if (operand < 0)
+                return false;
+            m_numberOfRegExps = std::max(m_numberOfRegExps, static_cast<unsigned>(operand) + 1);
+            return true;
+        case 's':
+        case 'c':
+        case 't': {
+            SwitchInfo info = { kind, static_cast<unsigned>(operand), bytecodeOffset };
+            m_switches.append(info);
+            return true;
+        }
+        case 'j':
+            m_jumps.append(bytecodeOffset + operand);
+            return true;
+        case 'k':
+            return operand >= 0 && operand < m_scopeChainLength + hasActivation();
+        case 'z':
+            return !operand;
+        case 'n':
+            return true;
+        }
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+
+    // Checks the operands that only make sense together.
+    bool checkInstruction(OpcodeID opcodeID, const Instruction* instruction)
+    {
+        switch (opcodeID) {
+        case op_get_scoped_var:
+            return isScopedVariable(instruction[2].u.operand, instruction[3].u.operand);
+        case op_put_scoped_var:
+            return isScopedVariable(instruction[1].u.operand, instruction[2].u.operand);
+        case op_init_lazy_reg:
+            if (m_isInPrologue)
+                m_lazyRegisters.append(instruction[1].u.operand);
+            return true;
+        case op_push_scope:
+        case op_push_new_scope:
+            ++m_numberOfScopePushes;
+            return true;
+        case op_jmp_scopes:
+            // Jumps out of scopes pushed by the code itself.
+            if (instruction[1].u.operand < 0)
+                return false;
+            m_maxScopeDepthOfJumps = std::max(m_maxScopeDepthOfJumps, instruction[1].u.operand);
+            return true;
+        case op_jsr:
+            m_returnAddressRegisters.append(instruction[1].u.operand);
+            return true;
+        case op_sret:
+            m_returnRegisters.append(instruction[1].u.operand);
+            return true;
+        case op_create_arguments:
+        case op_tear_off_arguments:
+            return m_codeBlock->usesArguments();
+        case op_new_array:
+        case op_strcat: {
+            // A range of registers, which is empty for an empty array.
+            int first = instruction[2].u.operand;
+            int count = instruction[3].u.operand;
+            return !count || (count > 0 && isLocal(first) && count <= m_codeBlock->m_numCalleeRegisters - first);
+        }
+        case op_call:
+        case op_call_eval:
+        case op_construct: {
+            // The arguments, starting with "this", are followed by the header
+            // of the new call frame.
+            int argumentCount = instruction[2].u.operand;
+            int registerOffset = instruction[3].u.operand;
+            return registerOffset > RegisterFile::CallFrameHeaderSize && registerOffset <= m_codeBlock->m_numCalleeRegisters
+                && argumentCount > 0 && argumentCount <= registerOffset - RegisterFile::CallFrameHeaderSize;
+        }
+        case op_call_varargs:
+        case op_load_varargs: {
+            // The register offset starts just after "this".
+            int registerOffset = instruction[3].u.operand;
+            return registerOffset >= RegisterFile::CallFrameHeaderSize && isLocal(registerOffset - RegisterFile::CallFrameHeaderSize);
+        }
+        default:
+            return true;
+        }
+    }
+
+    // The code starts by initializing its registers, which it does only once.
+    bool addInstruction(OpcodeID opcodeID, unsigned bytecodeOffset)
+    {
+        if ((opcodeID == op_enter) != !bytecodeOffset)
+            return false;
+        m_isInstructionStart[bytecodeOffset] = true;
+        if (bytecodeOffset && opcodeID != op_init_lazy_reg)
+            m_isInPrologue = false;
+        m_lastOpcode = opcodeID;
+        return true;
+    }
+
+    bool checkControlFlow() const
+    {
+        if (m_isInstructionStart.isEmpty())
+            return false;
+
+        // The activation and the arguments object are created on demand, so
+        // their registers are cleared before anything else runs.
+        if (m_activationRegister != -1 && m_lazyRegisters.find(m_activationRegister) == notFound)
+            return false;
+        if (m_argumentsRegister != -1 && (m_lazyRegisters.find(m_argumentsRegister) == notFound || m_lazyRegisters.find(unmodifiedArgumentsRegister(m_argumentsRegister)) == notFound))
+            return false;
+
+        // The code does not run past its end.
+        switch (m_lastOpcode) {
+        case op_ret:
+        case op_ret_object_or_this:
+        case op_end:
+        case op_throw:
+        case op_jmp:
+        case op_loop:
+        case op_sret:
+            break;
+        default:
+            return false;
+        }
+
+        for (size_t i = 0; i < m_jumps.size(); ++i) {
+            if (!isInstructionStart(m_jumps[i]))
+                return false;
+        }
+        if (m_maxScopeDepthOfJumps > m_numberOfScopePushes)
+            return false;
+        // A finally block returns to the address that its jsr stored.
+        for (size_t i = 0; i < m_returnRegisters.size(); ++i) {
+            if (m_returnAddressRegisters.find(m_returnRegisters[i]) == notFound)
+                return false;
+        }
+        return true;
+    }
+
+    bool checkTables() const
+    {
+        if (m_numberOfRegExps > m_codeBlock->numberOfRegExps())
+            return false;
+        for (size_t i = 0; i < m_switches.size(); ++i) {
+            const SwitchInfo& info = m_switches[i];
+            if (info.kind == 't') {
+                if (info.table >= m_codeBlock->numberOfStringSwitchJumpTables())
+                    return false;
+                StringJumpTable::StringOffsetTable& offsetTable = m_codeBlock->stringSwitchJumpTable(info.table).offsetTable;
+                StringJumpTable::StringOffsetTable::iterator end = offsetTable.end();
+                for (StringJumpTable::StringOffsetTable::iterator it = offsetTable.begin(); it != end; ++it) {
+                    if (!isInstructionStart(info.bytecodeOffset + it->second.branchOffset))
+                        return false;
+                }
+                continue;
+            }
+            bool isImmediate = info.kind == 's';
+            if (info.table >= (isImmediate ? m_codeBlock->numberOfImmediateSwitchJumpTables() : m_codeBlock->numberOfCharacterSwitchJumpTables()))
+                return false;
+            SimpleJumpTable& jumpTable = isImmediate ? m_codeBlock->immediateSwitchJumpTable(info.table) : m_codeBlock->characterSwitchJumpTable(info.table);
+            for (size_t j = 0; j < jumpTable.branchOffsets.size(); ++j) {
+                // Keys without a case of their own go to the default target.
+                int32_t offset = jumpTable.branchOffsets[j];
+                if (offset && !isInstructionStart(info.bytecodeOffset + offset))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct SwitchInfo {
+        char kind;
+        unsigned table;
+        unsigned bytecodeOffset;
+    };
+
+    // The activation of a function is pushed on its scope chain as it runs.
+    int hasActivation() const { return m_codeBlock->codeType() == FunctionCode && m_codeBlock->needsFullScopeChain(); }
+
+    // The scope chain that the code is read for has the same variable
+    // objects as the chain of every other closure of its function, so the
+    // variables that the BytecodeGenerator found in it can be checked there.
+    bool isScopedVariable(int index, int skip) const
+    {
+        if (skip < hasActivation())
+            return false;
+        ScopeChainNode* node = m_scopeChain;
+        for (skip -= hasActivation(); skip && node; --skip)
+            node = node->next.get();
+        if (!node || !node->object->isVariableObject())
+            return false;
+        SymbolTable& symbolTable = static_cast<JSVariableObject*>(node->object.get())->symbolTable();
+        SymbolTable::iterator end = symbolTable.end();
+        for (SymbolTable::iterator it = symbolTable.begin(); it != end; ++it) {
+            if (it->second.getIndex() == index)
+                return true;
+        }
+        return false;
+    }
+
+    CodeBlock* m_codeBlock;
+    int m_argumentsRegister;
+    int m_activationRegister;
+    ScopeChainNode* m_scopeChain;
+    int m_scopeChainLength;
+    Vector<bool> m_isInstructionStart;
+    bool m_isInPrologue;
+    Vector<int> m_lazyRegisters;
+    OpcodeID m_lastOpcode;
+    Vector<unsigned> m_jumps;
+    Vector<SwitchInfo> m_switches;
+    unsigned m_numberOfRegExps;
+    int m_numberOfScopePushes;
+    int m_maxScopeDepthOfJumps;
+    Vector<int> m_returnAddressRegisters;
+    Vector<int> m_returnRegisters;
+};
+
+// The tables that the JIT and the interpreter keep for the instructions that
+// cache what they find are made the same way as the BytecodeGenerator makes
+// them, rather than being stored.
+static void addInstructionInfo(CodeBlock* codeBlock, OpcodeID opcodeID, unsigned bytecodeOffset)
+{
+    UNUSED_PARAM(bytecodeOffset);
+    switch (opcodeID) {
+    case op_get_by_id:
+    case op_put_by_id:
+#if ENABLE(JIT)
+        codeBlock->addStructureStubInfo(StructureStubInfo(opcodeID == op_get_by_id ? access_get_by_id : access_put_by_id));
+#endif
+#if ENABLE(INTERPRETER)
+        codeBlock->addPropertyAccessInstruction(bytecodeOffset);
+#endif
+        break;
+    case op_resolve_global:
+    case op_resolve_global_dynamic:
+#if ENABLE(JIT)
+        codeBlock->addGlobalResolveInfo(bytecodeOffset);
+#endif
+#if ENABLE(INTERPRETER)
+        codeBlock->addGlobalResolveInstruction(bytecodeOffset);
+#endif
+        break;
+    case op_call:
+    case op_call_eval:
+    case op_construct:
+#if ENABLE(JIT)
+        codeBlock->addCallLinkInfo();
+#endif
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeSimpleJumpTable(BytecodeWriter& writer, const SimpleJumpTable& jumpTable)
+{
+    writer.writeInt32(jumpTable.min);
+    writer.writeUInt32(jumpTable.branchOffsets.size());
+    for (size_t i = 0; i < jumpTable.branchOffsets.size(); ++i)
+        writer.writeInt32(jumpTable.branchOffsets[i]);
+}
+
+static void readSimpleJumpTable(BytecodeReader& reader, SimpleJumpTable& jumpTable)
+{
+    jumpTable.min = reader.readInt32();
+    unsigned count = reader.readCount();
+    jumpTable.branchOffsets.reserveCapacity(count);
+    for (unsigned i = 0; i < count; ++i)
+        jumpTable.branchOffsets.append(reader.readInt32());
+}
+
+bool BytecodeCache::writeCodeBlock(BytecodeWriter& writer, CodeBlock* codeBlock)
+{
+    JSGlobalObject* globalObject = codeBlock->globalObject();
+    Interpreter* interpreter = codeBlock->m_globalData->interpreter;
+
+    writer.writeInt32(codeBlock->m_numCalleeRegisters);
+    writer.writeInt32(codeBlock->m_numVars);
+    writer.writeInt32(codeBlock->m_numCapturedVars);
+    writer.writeInt32(codeBlock->m_numParameters);
+    writer.writeInt32(codeBlock->m_thisRegister);
+    writer.writeInt32(codeBlock->m_argumentsRegister);
+    bool hasActivation = codeBlock->m_codeType == FunctionCode && codeBlock->m_needsFullScopeChain;
+    writer.writeInt32(hasActivation ? codeBlock->m_activationRegister : 0);
+    writer.writeUInt8(codeBlock->m_needsFullScopeChain);
+    writer.writeUInt8(codeBlock->m_usesEval);
+    writer.writeUInt8(codeBlock->m_isNumericCompareFunction);
+
+    writer.writeUInt32(codeBlock->m_identifiers.size());
+    for (size_t i = 0; i < codeBlock->m_identifiers.size(); ++i)
+        writer.writeIdentifier(codeBlock->m_identifiers[i]);
+
+    writer.writeUInt32(codeBlock->m_constantRegisters.size());
+    for (size_t i = 0; i < codeBlock->m_constantRegisters.size(); ++i) {
+        if (!writeConstant(writer, globalObject, codeBlock->m_constantRegisters[i].get()))
+            return false;
+    }
+
+    Vector<WriteBarrier<FunctionExecutable> >* functionLists[] = { &codeBlock->m_functionDecls, &codeBlock->m_functionExprs };
+    for (size_t list = 0; list < WTF_ARRAY_LENGTH(functionLists); ++list) {
+        Vector<WriteBarrier<FunctionExecutable> >& functions = *functionLists[list];
+        writer.writeUInt32(functions.size());
+        for (size_t i = 0; i < functions.size(); ++i) {
+            FunctionExecutable* function = functions[i].get();
+            writeFunction(writer, function->m_name, function->source(), function->m_forceUsesArguments, function->m_parameters.get(), function->isStrictMode(), function->lineNo(), function->lastLine());
+        }
+    }
+
+    Vector<Instruction>& instructions = codeBlock->m_instructions;
+    writer.writeUInt32(instructions.size());
+    for (size_t i = 0; i < instructions.size(); ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        const char* kinds = operandKinds(opcodeID);
+        if (!kinds)
+            return false;
+        writer.writeUInt8(opcodeID);
+        for (int j = 1; j < opcodeLengths[opcodeID]; ++j) {
+            switch (kinds[j - 1]) {
+            case 'g':
+                if (!writeGlobalVariable(writer, globalObject, instructions[i + j].u.operand))
+                    return false;
+                break;
+            case 'p': {
+                JSCell* function = instructions[i + j].u.jsCell.get();
+                if (function == globalObject->callFunction())
+                    writer.writeUInt8(CallFunctionTag);
+                else if (function == globalObject->applyFunction())
+                    writer.writeUInt8(ApplyFunctionTag);
+                else
+                    return false;
+                break;
+            }
+            default:
+                writer.writeInt32(instructions[i + j].u.operand);
+            }
+        }
+        i += opcodeLengths[opcodeID];
+    }
+
+    writer.writeUInt32(codeBlock->m_jumpTargets.size());
+    for (size_t i = 0; i < codeBlock->m_jumpTargets.size(); ++i)
+        writer.writeUInt32(codeBlock->m_jumpTargets[i]);
+
+    CodeBlock::RareData emptyRareData;
+    CodeBlock::RareData& rareData = codeBlock->m_rareData ? *codeBlock->m_rareData : emptyRareData;
+
+    writer.writeUInt32(rareData.m_exceptionHandlers.size());
+    for (size_t i = 0; i < rareData.m_exceptionHandlers.size(); ++i) {
+        const HandlerInfo& handler = rareData.m_exceptionHandlers[i];
+        writer.writeUInt32(handler.start);
+        writer.writeUInt32(handler.end);
+        writer.writeUInt32(handler.target);
+        writer.writeUInt32(handler.scopeDepth);
+    }
+
+    writer.writeUInt32(rareData.m_regexps.size());
+    for (size_t i = 0; i < rareData.m_regexps.size(); ++i) {
+        RegExp* regExp = rareData.m_regexps[i].get();
+        writer.writeString(regExp->pattern());
+        writer.writeUInt32((regExp->global() ? FlagGlobal : 0) | (regExp->ignoreCase() ? FlagIgnoreCase : 0) | (regExp->multiline() ? FlagMultiline : 0));
+    }
+
+    writer.writeUInt32(rareData.m_immediateSwitchJumpTables.size());
+    for (size_t i = 0; i < rareData.m_immediateSwitchJumpTables.size(); ++i)
+        writeSimpleJumpTable(writer, rareData.m_immediateSwitchJumpTables[i]);
+    writer.writeUInt32(rareData.m_characterSwitchJumpTables.size());
+    for (size_t i = 0; i < rareData.m_characterSwitchJumpTables.size(); ++i)
+        writeSimpleJumpTable(writer, rareData.m_characterSwitchJumpTables[i]);
+    writer.writeUInt32(rareData.m_stringSwitchJumpTables.size());
+    for (size_t i = 0; i < rareData.m_stringSwitchJumpTables.size(); ++i) {
+        StringJumpTable::StringOffsetTable& offsetTable = rareData.m_stringSwitchJumpTables[i].offsetTable;
+        writer.writeUInt32(offsetTable.size());
+        StringJumpTable::StringOffsetTable::iterator end = offsetTable.end();
+        for (StringJumpTable::StringOffsetTable::iterator it = offsetTable.begin(); it != end; ++it) {
+            writer.writeString(it->first.get());
+            writer.writeInt32(it->second.branchOffset);
+        }
+    }
+
+    writer.writeUInt32(rareData.m_expressionInfo.size());
+    for (size_t i = 0; i < rareData.m_expressionInfo.size(); ++i) {
+        const ExpressionRangeInfo& info = rareData.m_expressionInfo[i];
+        writer.writeUInt32(info.instructionOffset);
+        writer.writeUInt32(info.divotPoint);
+        writer.writeUInt32(info.startOffset);
+        writer.writeUInt32(info.endOffset);
+    }
+    writer.writeUInt32(rareData.m_lineInfo.size());
+    for (size_t i = 0; i < rareData.m_lineInfo.size(); ++i) {
+        writer.writeUInt32(rareData.m_lineInfo[i].instructionOffset);
+        writer.writeInt32(rareData.m_lineInfo[i].lineNumber);
+    }
+    return true;
+}
+
+// Fills in a CodeBlock that has already been handed to its executable, so
+// that the garbage collector marks the cells it refers to as they are read.
+bool BytecodeCache::readCodeBlock(BytecodeReader& reader, CodeBlock* codeBlock, ScopeChainNode* scopeChainNode)
+{
+    JSGlobalObject* globalObject = codeBlock->globalObject();
+    JSGlobalData* globalData = &globalObject->globalData();
+    Interpreter* interpreter = globalData->interpreter;
+    SourceProvider* provider = codeBlock->source();
+
+    codeBlock->setGlobalData(globalData);
+    codeBlock->m_numCalleeRegisters = reader.readInt32();
+    codeBlock->m_numVars = reader.readInt32();
+    codeBlock->m_numCapturedVars = reader.readInt32();
+    codeBlock->m_numParameters = reader.readInt32();
+    codeBlock->m_thisRegister = reader.readInt32();
+    codeBlock->m_argumentsRegister = reader.readInt32();
+    int activationRegister = reader.readInt32();
+    codeBlock->m_needsFullScopeChain = reader.readUInt8();
+    codeBlock->m_usesEval = reader.readUInt8();
+    codeBlock->m_isNumericCompareFunction = reader.readUInt8();
+    bool hasActivation = codeBlock->m_codeType == FunctionCode && codeBlock->m_needsFullScopeChain;
+    if (hasActivation)
+        codeBlock->m_activationRegister = activationRegister;
+
+    if (codeBlock->m_numCapturedVars < 0 || codeBlock->m_numCapturedVars > codeBlock->m_numVars || codeBlock->m_numVars > codeBlock->m_numCalleeRegisters || codeBlock->m_numCalleeRegisters >= FirstConstantRegisterIndex)
+        return false;
+    size_t numParameters = codeBlock->m_codeType == FunctionCode ? static_cast<FunctionExecutable*>(codeBlock->ownerExecutable())->parameterCount() + 1 : 1;
+    if (static_cast<size_t>(codeBlock->m_numParameters) != numParameters)
+        return false;
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        Identifier identifier = reader.readIdentifier(globalData);
+        if (identifier.isNull())
+            return false;
+        codeBlock->addIdentifier(identifier);
+    }
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        JSValue value;
+        if (!readConstant(reader, globalObject, value))
+            return false;
+        codeBlock->addConstant(value);
+    }
+
+    for (unsigned list = 0; list < 2; ++list) {
+        for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+            CachedFunction function;
+            if (!function.read(reader, globalData, provider))
+                return false;
+            FunctionExecutable* executable = function.create(globalData, provider);
+            if (!list)
+                codeBlock->addFunctionDecl(executable);
+            else
+                codeBlock->addFunctionExpr(executable);
+        }
+    }
+
+    Vector<Instruction>& instructions = codeBlock->m_instructions;
+    unsigned instructionCount = reader.readCount();
+    CachedCodeValidator validator(codeBlock, scopeChainNode, instructionCount);
+    // The arguments register is followed by the register that holds the
+    // unmodified arguments object.
+    if (!validator.isRegister(codeBlock->m_thisRegister)
+        || (codeBlock->usesArguments() && (!validator.isLocal(codeBlock->m_argumentsRegister) || !validator.isLocal(unmodifiedArgumentsRegister(codeBlock->m_argumentsRegister))))
+        || (hasActivation && !validator.isLocal(activationRegister)))
+        return false;
+
+    instructions.reserveCapacity(instructionCount);
+    while (instructions.size() < instructionCount) {
+        unsigned bytecodeOffset = instructions.size();
+        unsigned opcodeValue = reader.readUInt8();
+        if (reader.failed() || opcodeValue >= static_cast<unsigned>(numOpcodeIDs) || bytecodeOffset + opcodeLengths[opcodeValue] > instructionCount)
+            return false;
+        OpcodeID opcodeID = static_cast<OpcodeID>(opcodeValue);
+        const char* kinds = operandKinds(opcodeID);
+        if (!kinds)
+            return false;
+        ASSERT(strlen(kinds) == static_cast<size_t>(opcodeLengths[opcodeID] - 1));
+
+        if (!validator.addInstruction(opcodeID, bytecodeOffset))
+            return false;
+        instructions.append(interpreter->getOpcode(opcodeID));
+        for (const char* kind = kinds; *kind; ++kind) {
+            switch (*kind) {
+            case 'g': {
+                int index;
+                if (!readGlobalVariable(reader, globalObject, index))
+                    return false;
+                instructions.append(index);
+                break;
+            }
+            case 'p': {
+                uint8_t tag = reader.readUInt8();
+                if (tag != CallFunctionTag && tag != ApplyFunctionTag)
+                    return false;
+                JSCell* function = tag == CallFunctionTag ? globalObject->callFunction() : globalObject->applyFunction();
+                instructions.append(Instruction(*globalData, codeBlock->ownerExecutable(), function));
+                break;
+            }
+            default: {
+                int operand = reader.readInt32();
+                if (!validator.checkOperand(*kind, operand, bytecodeOffset))
+                    return false;
+                instructions.append(operand);
+            }
+            }
+        }
+        if (!validator.checkInstruction(opcodeID, &instructions[bytecodeOffset]))
+            return false;
+        addInstructionInfo(codeBlock, opcodeID, bytecodeOffset);
+    }
+    if (reader.failed() || !validator.checkControlFlow())
+        return false;
+#ifndef NDEBUG
+    codeBlock->setInstructionCount(instructions.size());
+#endif
+
+    unsigned previousJumpTarget = 0;
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        unsigned jumpTarget = reader.readUInt32();
+        if ((i && jumpTarget <= previousJumpTarget) || !validator.isInstructionStart(jumpTarget))
+            return false;
+        codeBlock->addJumpTarget(jumpTarget);
+        previousJumpTarget = jumpTarget;
+    }
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        HandlerInfo handler;
+        handler.start = reader.readUInt32();
+        handler.end = reader.readUInt32();
+        handler.target = reader.readUInt32();
+        handler.scopeDepth = reader.readUInt32();
+        if (handler.start > handler.end || handler.end > instructionCount || !validator.isInstructionStart(handler.target))
+            return false;
+        codeBlock->addExceptionHandler(handler);
+    }
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        UString pattern = reader.readString();
+        RegExpFlags flags = static_cast<RegExpFlags>(reader.readUInt32() & (FlagGlobal | FlagIgnoreCase | FlagMultiline));
+        if (reader.failed() || pattern.isNull())
+            return false;
+        codeBlock->addRegExp(globalData->regExpCache()->lookupOrCreate(pattern, flags));
+    }
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i)
+        readSimpleJumpTable(reader, codeBlock->addImmediateSwitchJumpTable());
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i)
+        readSimpleJumpTable(reader, codeBlock->addCharacterSwitchJumpTable());
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        StringJumpTable& jumpTable = codeBlock->addStringSwitchJumpTable();
+        for (unsigned entryCount = reader.readCount(), j = 0; j < entryCount; ++j) {
+            Identifier value = reader.readIdentifier(globalData);
+            OffsetLocation location;
+            location.branchOffset = reader.readInt32();
+            if (reader.failed() || value.isNull())
+                return false;
+            jumpTable.offsetTable.add(value.impl(), location);
+        }
+    }
+    if (reader.failed() || !validator.checkTables())
+        return false;
+
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        ExpressionRangeInfo info;
+        info.instructionOffset = reader.readUInt32();
+        info.divotPoint = reader.readUInt32();
+        info.startOffset = reader.readUInt32();
+        info.endOffset = reader.readUInt32();
+        if (info.instructionOffset > instructionCount)
+            return false;
+        codeBlock->addExpressionInfo(info);
+    }
+    for (unsigned count = reader.readCount(), i = 0; i < count; ++i) {
+        codeBlock->createRareDataIfNecessary();
+        LineInfo info;
+        info.instructionOffset = reader.readUInt32();
+        info.lineNumber = reader.readInt32();
+        if (info.instructionOffset > instructionCount)
+            return false;
+        codeBlock->m_rareData->m_lineInfo.append(info);
+    }
+
+    if (reader.failed())
+        return false;
+    codeBlock->shrinkToFit();
+    return true;
+}
+
+} // namespace JSC
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BytecodeCache_h
+#define BytecodeCache_h
+
+#include <wtf/HashMap.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefCounted.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringImpl.h>
+
+namespace JSC {
+
+    class BytecodeReader;
+    class BytecodeWriter;
+    class CodeBlock;
+    class ExecState;
+    class FunctionExecutable;
+    class JSGlobalObject;
+    class ProgramExecutable;
+    class ProgramNode;
+    class ScopeChainNode;
+    class ScriptExecutable;
+
+    // Keeps the bytecode generated for the program and function code of a
+    // source, so that when the source is loaded again its code can be read
+    // back instead of being parsed and generated. A cache is attached to the
+    // SourceProvider of the source, and can be serialized so that an embedder
+    // can store it with the source, for example as the CachedMetadata of a
+    // CachedScript.
+    //
+    // Program code is loaded when the program runs, and the code of each
+    // function only when the function is first called. Eval code is never
+    // cached. Global code generated for a source with a cache accesses global
+    // variables more slowly, so an embedder should only attach a cache when
+    // code is likely to be stored in it or loaded from it.
+    class BytecodeCache : public RefCounted<BytecodeCache> {
+    public:
+        static PassRefPtr<BytecodeCache> create() { return adoptRef(new BytecodeCache); }
+
+        // Creates a cache from data that serialize() returned. The cache is
+        // empty if the data was serialized by a different version of
+        // JavaScriptCore, or has been changed since. Code whose operands do
+        // not fit the code block they are read into is not loaded either.
+        static PassRefPtr<BytecodeCache> create(const char* data, size_t size);
+
+        ~BytecodeCache();
+
+        // Drops the cached code unless it was generated from the given source.
+        void setSource(const UChar* characters, unsigned length);
+
+        void serialize(Vector<char>&) const;
+
+        size_t numberOfCodeBlocks() const { return m_entries.size(); }
+        size_t numberOfLoadedCodeBlocks() const { return m_numberOfLoadedCodeBlocks; }
+
+        // Returns true if code was added since the cache was created.
+        bool hasNewCodeBlocks() const { return m_hasNewCodeBlocks; }
+
+        // Load the code of an executable instead of compiling it. These return
+        // false if the cache has no usable code for the executable.
+        bool loadProgram(ExecState*, ScopeChainNode*, ProgramExecutable*);
+        bool loadFunction(ExecState*, ScopeChainNode*, FunctionExecutable*, bool isConstructor);
+
+        // Add the code of an executable that has just been generated.
+        void addProgram(ProgramExecutable*, ProgramNode*);
+        void addFunction(FunctionExecutable*, bool isConstructor);
+
+    private:
+        BytecodeCache();
+
+        enum EntryKind { ProgramEntry, CallEntry, ConstructEntry };
+        static unsigned entryKey(int sourceOffset, EntryKind kind) { return (static_cast<unsigned>(sourceOffset + 1) << 2) | kind; }
+
+        struct Entry {
+            unsigned offset;
+            unsigned length;
+        };
+
+        void addEntry(unsigned key, const Vector<char>& data);
+
+        bool writeCodeBlock(BytecodeWriter&, CodeBlock*);
+        bool writeGlobalVariable(BytecodeWriter&, JSGlobalObject*, int index);
+        StringImpl* globalName(JSGlobalObject*, int index);
+
+        static bool readParseInfo(BytecodeReader&, JSGlobalObject*, ScriptExecutable*);
+        static bool readCodeBlock(BytecodeReader&, CodeBlock*, ScopeChainNode*);
+
+        typedef HashMap<unsigned, Entry> EntryMap;
+        EntryMap m_entries;
+        Vector<char> m_data;
+
+        uint64_t m_sourceHash;
+        unsigned m_sourceLength;
+        bool m_hasSource;
+        bool m_hasNewCodeBlocks;
+        size_t m_numberOfLoadedCodeBlocks;
+
+        // The names of the variables of the global object that code was last
+        // added for, by symbol table index.
+        Vector<RefPtr<StringImpl> > m_globalNames;
+    };
+
+} // namespace JSC
+
+#endif // BytecodeCache_h
@@ -32,12 +32,14 @@
 
 #include "BytecodeGenerator.h"
 #include "Debugger.h"
+#include "Executable.h"
 #include "Interpreter.h"
 #include "JIT.h"
 #include "JSActivation.h"
 #include "JSFunction.h"
 #include "JSStaticScopeObject.h"
 #include "JSValue.h"
+#include "SamplingTool.h"
 #include "UStringConcatenate.h"
 #include <stdio.h>
 #include <wtf/StringExtras.h>
@@ -252,6 +254,9 @@ static void printStructureStubInfo(const StructureStubInfo& stubInfo, unsigned i
     case access_put_by_id_replace:
         printf("  [%4d] %s: %s\n", instructionOffset, "put_by_id_replace", pointerToSourceString(stubInfo.u.putByIdReplace.baseObjectStructure).utf8().data());
         return;
+    case access_put_by_id_replace_list:
+        printf("  [%4d] %s: %s (%d)\n", instructionOffset, "op_put_by_id_replace_list", pointerToSourceString(stubInfo.u.putByIdReplaceList.structureList).utf8().data(), stubInfo.u.putByIdReplaceList.listSize);
+        return;
     case access_get_by_id:
         printf("  [%4d] %s\n", instructionOffset, "get_by_id");
         return;
@@ -1379,10 +1384,27 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
     , m_codeType(codeType)
     , m_source(sourceProvider)
     , m_sourceOffset(sourceOffset)
+#if ENABLE(TIERED_COMPILATION)
+    , m_jitExecuteCounter(0)
+#endif
+#if ENABLE(DFG_JIT)
+    , m_jitCodeEntryAfterReturnPCOffset(0)
+    , m_executeCounter(0)
+    , m_speculativeFailCounter(0)
+    , m_reoptimizationCount(0)
+    , m_canBeOptimized(false)
+#endif
     , m_symbolTable(symTab)
 {
     ASSERT(m_source);
 
+#if ENABLE(TIERED_COMPILATION)
+    jitAfterWarmUp();
+#endif
+#if ENABLE(DFG_JIT)
+    optimizeAfterWarmUp();
+#endif
+
 #if DUMP_CODE_BLOCK_STATISTICS
     liveCodeBlockSet.add(this);
 #endif
@@ -1390,10 +1412,16 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
 
 CodeBlock::~CodeBlock()
 {
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    PropertyAccessSampling::removeCodeBlock(this);
+#endif
 #if ENABLE(JIT)
     for (size_t size = m_structureStubInfos.size(), i = 0; i < size; ++i)
         m_structureStubInfos[i].deref();
 #endif // ENABLE(JIT)
+#if ENABLE(DFG_JIT)
+    deleteAllValues(m_jettisonedCodeBlocks);
+#endif
 
 #if DUMP_CODE_BLOCK_STATISTICS
     liveCodeBlockSet.remove(this);
@@ -1494,6 +1522,12 @@ void CodeBlock::markAggregate(MarkStack& markStack)
         }
     }
 #endif
+#if ENABLE(DFG_JIT)
+    if (m_alternative)
+        m_alternative->markAggregate(markStack);
+    for (size_t size = m_jettisonedCodeBlocks.size(), i = 0; i < size; ++i)
+        m_jettisonedCodeBlocks[i]->markAggregate(markStack);
+#endif
 }
 
 HandlerInfo* CodeBlock::handlerForBytecodeOffset(unsigned bytecodeOffset)
@@ -1617,6 +1651,82 @@ bool CodeBlock::hasGlobalResolveInfoAtBytecodeOffset(unsigned bytecodeOffset)
     return true;
 }
 #endif
+#if ENABLE(VALUE_PROFILER)
+ValueProfile* CodeBlock::valueProfileForBytecodeOffset(int bytecodeOffset)
+{
+    // Skip the argument profiles, which all have an offset of -1.
+    int low = 0;
+    while (static_cast<unsigned>(low) < m_valueProfiles.size() && m_valueProfiles[low].m_bytecodeOffset == -1)
+        low++;
+
+    int high = m_valueProfiles.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (m_valueProfiles[mid].m_bytecodeOffset <= bytecodeOffset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (!low || m_valueProfiles[low - 1].m_bytecodeOffset != bytecodeOffset)
+        return 0;
+    return &m_valueProfiles[low - 1];
+}
+#endif
+#if ENABLE(JIT)
+void* CodeBlock::machineCodeForBytecodeIndex(unsigned bytecodeIndex)
+{
+    int low = 0;
+    int high = m_jitCodeMap.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (m_jitCodeMap[mid].m_bytecodeIndex <= bytecodeIndex)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (!low || m_jitCodeMap[low - 1].m_bytecodeIndex != bytecodeIndex)
+        return 0;
+    return static_cast<char*>(getJITCode().start()) + m_jitCodeMap[low - 1].m_machineCodeOffset;
+}
+#endif
+#if ENABLE(TIERED_COMPILATION)
+void CodeBlock::jitCompile(JSGlobalData& globalData)
+{
+    switch (m_codeType) {
+    case GlobalCode:
+        static_cast<ProgramExecutable*>(ownerExecutable())->jitCompile(globalData);
+        break;
+    case EvalCode:
+        static_cast<EvalExecutable*>(ownerExecutable())->jitCompile(globalData);
+        break;
+    case FunctionCode:
+        if (m_isConstructor)
+            static_cast<FunctionExecutable*>(ownerExecutable())->jitCompileForConstruct(globalData);
+        else
+            static_cast<FunctionExecutable*>(ownerExecutable())->jitCompileForCall(globalData);
+        break;
+    }
+    ASSERT(!!m_jitCode);
+}
+
+void CodeBlock::unspecializePropertyAccessInstructions()
+{
+    Interpreter* interpreter = m_globalData->interpreter;
+    for (size_t size = m_propertyAccessInstructions.size(), i = 0; i < size; ++i) {
+        Instruction* vPC = &m_instructions[m_propertyAccessInstructions[i]];
+        OpcodeID opcodeID = interpreter->getOpcodeID(vPC[0].u.opcode);
+        if (opcodeID == op_get_by_id || opcodeID == op_put_by_id)
+            continue;
+        if (opcodeID == op_put_by_id_transition || opcodeID == op_put_by_id_replace || opcodeID == op_put_by_id_generic)
+            vPC[0] = interpreter->getOpcode(op_put_by_id);
+        else
+            vPC[0] = interpreter->getOpcode(op_get_by_id);
+        vPC[4] = 0;
+    }
+}
+#endif
 
 void CodeBlock::shrinkToFit()
 {
@@ -1631,6 +1741,9 @@ void CodeBlock::shrinkToFit()
     m_globalResolveInfos.shrinkToFit();
     m_callLinkInfos.shrinkToFit();
 #endif
+#if ENABLE(DFG_JIT)
+    m_jitCodeMap.shrinkToFit();
+#endif
 
     m_identifiers.shrinkToFit();
     m_functionDecls.shrinkToFit();
@@ -36,11 +36,14 @@
 #include "JSGlobalObject.h"
 #include "JumpTable.h"
 #include "Nodes.h"
+#include "Options.h"
 #include "RegExp.h"
 #include "UString.h"
+#include "ValueProfile.h"
 #include <wtf/FastAllocBase.h>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/RefPtr.h>
+#include <wtf/SegmentedVector.h>
 #include <wtf/Vector.h>
 
 #if ENABLE(JIT)
@@ -201,6 +204,7 @@ namespace JSC {
 
     class CodeBlock {
         WTF_MAKE_FAST_ALLOCATED;
+        friend class BytecodeCache;
         friend class JIT;
     protected:
         CodeBlock(ScriptExecutable* ownerExecutable, CodeType, JSGlobalObject*, PassRefPtr<SourceProvider>, unsigned sourceOffset, SymbolTable* symbolTable, bool isConstructor);
@@ -281,7 +285,14 @@ namespace JSC {
         bool isNumericCompareFunction() { return m_isNumericCompareFunction; }
 
         Vector<Instruction>& instructions() { return m_instructions; }
-        void discardBytecode() { m_instructions.clear(); }
+        void discardBytecode()
+        {
+            m_instructions.clear();
+#if ENABLE(INTERPRETER)
+            m_propertyAccessInstructions.clear();
+            m_globalResolveInstructions.clear();
+#endif
+        }
 
 #ifndef NDEBUG
         unsigned instructionCount() { return m_instructionCount; }
@@ -289,8 +300,101 @@ namespace JSC {
 #endif
 
 #if ENABLE(JIT)
-        JITCode& getJITCode() { return m_isConstructor ? ownerExecutable()->generatedJITCodeForConstruct() : ownerExecutable()->generatedJITCodeForCall(); }
+        // Each code block owns its machine code, so that a function can switch
+        // between its baseline and optimized code blocks without losing track of
+        // which code a frame, a stub or a repatch belongs to.
+        void setJITCode(const JITCode& code, MacroAssemblerCodePtr codeWithArityCheck)
+        {
+            m_jitCode = code;
+            m_jitCodeWithArityCheck = codeWithArityCheck;
+        }
+        JITCode& getJITCode() { return m_jitCode; }
+        MacroAssemblerCodePtr getJITCodeWithArityCheck() { return m_jitCodeWithArityCheck; }
         ExecutablePool* executablePool() { return getJITCode().getExecutablePool(); }
+
+        // Maps the bytecode indices at which control may transfer between
+        // tiers to the matching machine code.
+        void addJITCodeMapEntry(unsigned bytecodeIndex, unsigned machineCodeOffset)
+        {
+            ASSERT(m_jitCodeMap.isEmpty() || m_jitCodeMap.last().m_bytecodeIndex < bytecodeIndex);
+            m_jitCodeMap.append(BytecodeAndMachineOffset(bytecodeIndex, machineCodeOffset));
+        }
+        void* machineCodeForBytecodeIndex(unsigned bytecodeIndex);
+#endif
+
+#if ENABLE(TIERED_COMPILATION)
+        // The interpreter counts entries and loop iterations, and has the code
+        // block compiled with the baseline JIT when the count reaches zero.
+        void jitAfterWarmUp() { m_jitExecuteCounter = -Options::thresholdForJITAfterWarmUp; }
+        bool checkIfJITThresholdReached() { return ++m_jitExecuteCounter >= 0; }
+        void jitCompile(JSGlobalData&);
+
+        // The interpreter rewrites property accesses for the structures it has
+        // seen; this puts them back the way the JIT expects to find them.
+        void unspecializePropertyAccessInstructions();
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+        // Argument profiles come first, followed by one profile per profiled
+        // instruction in bytecode order.
+        ValueProfile* addValueProfile(int bytecodeOffset)
+        {
+            ASSERT(bytecodeOffset != -1 || m_valueProfiles.size() < static_cast<unsigned>(m_numParameters));
+            m_valueProfiles.append(ValueProfile(bytecodeOffset));
+            return &m_valueProfiles.last();
+        }
+        unsigned numberOfValueProfiles() { return m_valueProfiles.size(); }
+        ValueProfile* valueProfile(int index) { return &m_valueProfiles[index]; }
+        ValueProfile* valueProfileForArgument(int argumentIndex)
+        {
+            if (static_cast<unsigned>(argumentIndex) >= m_valueProfiles.size())
+                return 0;
+            ValueProfile* result = &m_valueProfiles[argumentIndex];
+            if (result->m_bytecodeOffset != -1)
+                return 0;
+            return result;
+        }
+        ValueProfile* valueProfileForBytecodeOffset(int bytecodeOffset);
+#endif
+
+#if ENABLE(DFG_JIT)
+        // An optimized code block keeps the baseline code block it was compiled
+        // from, so that it can exit to it and fall back to it if it is jettisoned.
+        CodeBlock* alternative() { return m_alternative.get(); }
+        void setAlternative(PassOwnPtr<CodeBlock> alternative) { m_alternative = alternative; }
+        PassOwnPtr<CodeBlock> releaseAlternative() { return m_alternative.release(); }
+
+        // Optimized code can still be running when it is jettisoned, so it is
+        // kept alive until its baseline code block goes away.
+        void addJettisonedCodeBlock(PassOwnPtr<CodeBlock> codeBlock) { m_jettisonedCodeBlocks.append(codeBlock.leakPtr()); }
+
+        bool canBeOptimized() const { return m_canBeOptimized; }
+        void setCanBeOptimized(bool canBeOptimized) { m_canBeOptimized = canBeOptimized; }
+
+        // The baseline JIT increments the execute counter on function entry and
+        // at loop headers, and asks for optimized code when it reaches zero.
+        int32_t* addressOfExecuteCounter() { return &m_executeCounter; }
+        void optimizeNextInvocation() { m_executeCounter = -1; }
+        void optimizeAfterWarmUp() { m_executeCounter = -(Options::thresholdForOptimizeAfterWarmUp << m_reoptimizationCount); }
+        void optimizeSoon() { m_executeCounter = -Options::thresholdForOptimizeSoon; }
+        void dontOptimizeAnytimeSoon() { m_executeCounter = std::numeric_limits<int32_t>::min(); }
+
+        // Optimized code counts the speculation failures that sent it back to
+        // baseline code; too many of them get it jettisoned.
+        uint32_t* addressOfSpeculativeFailCounter() { return &m_speculativeFailCounter; }
+        bool shouldReoptimizeNow() const { return m_speculativeFailCounter >= speculativeFailCounterThreshold; }
+
+        unsigned reoptimizationCount() const { return m_reoptimizationCount; }
+        void countReoptimization() { m_reoptimizationCount++; }
+        bool hasExhaustedReoptimizations() const { return m_reoptimizationCount >= maximumReoptimizationCount; }
+
+        // The machine code entry point just past the prologue's return address
+        // store, for jumping into an already set up call frame.
+        void setJITCodeEntryAfterReturnPCOffset(unsigned offset) { m_jitCodeEntryAfterReturnPCOffset = offset; }
+        void* jitCodeEntryAfterReturnPC() { return static_cast<char*>(getJITCode().start()) + m_jitCodeEntryAfterReturnPCOffset; }
+
+        static const uint32_t speculativeFailCounterThreshold = 10;
+        static const unsigned maximumReoptimizationCount = 5;
 #endif
 
         ScriptExecutable* ownerExecutable() const { return m_ownerExecutable.get(); }
@@ -434,9 +538,11 @@ namespace JSC {
             return size;
         }
         FunctionExecutable* functionExpr(int index) { return m_functionExprs[index].get(); }
+        int numberOfFunctionExprs() { return m_functionExprs.size(); }
 
         unsigned addRegExp(PassRefPtr<RegExp> r) { createRareDataIfNecessary(); unsigned size = m_rareData->m_regexps.size(); m_rareData->m_regexps.append(r); return size; }
         RegExp* regexp(int index) const { ASSERT(m_rareData); return m_rareData->m_regexps[index].get(); }
+        size_t numberOfRegExps() const { return m_rareData ? m_rareData->m_regexps.size() : 0; }
 
         JSGlobalObject* globalObject() { return m_globalObject.get(); }
 
@@ -520,6 +626,35 @@ namespace JSC {
         Vector<GlobalResolveInfo> m_globalResolveInfos;
         Vector<CallLinkInfo> m_callLinkInfos;
         Vector<MethodCallLinkInfo> m_methodCallLinkInfos;
+        JITCode m_jitCode;
+        MacroAssemblerCodePtr m_jitCodeWithArityCheck;
+
+        struct BytecodeAndMachineOffset {
+            BytecodeAndMachineOffset(unsigned bytecodeIndex, unsigned machineCodeOffset)
+                : m_bytecodeIndex(bytecodeIndex)
+                , m_machineCodeOffset(machineCodeOffset)
+            {
+            }
+
+            unsigned m_bytecodeIndex;
+            unsigned m_machineCodeOffset;
+        };
+        Vector<BytecodeAndMachineOffset> m_jitCodeMap;
+#endif
+#if ENABLE(TIERED_COMPILATION)
+        int32_t m_jitExecuteCounter;
+#endif
+#if ENABLE(VALUE_PROFILER)
+        SegmentedVector<ValueProfile, 8> m_valueProfiles;
+#endif
+#if ENABLE(DFG_JIT)
+        OwnPtr<CodeBlock> m_alternative;
+        Vector<CodeBlock*> m_jettisonedCodeBlocks;
+        unsigned m_jitCodeEntryAfterReturnPCOffset;
+        int32_t m_executeCounter;
+        uint32_t m_speculativeFailCounter;
+        unsigned m_reoptimizationCount;
+        bool m_canBeOptimized;
 #endif
 
         Vector<unsigned> m_jumpTargets;
@@ -36,7 +36,11 @@
 #include "StructureChain.h"
 #include <wtf/VectorTraits.h>
 
+// The most cases a polymorphic get_by_id or put_by_id site caches before it
+// falls back to the generic slow path. Builds may override it.
+#ifndef POLYMORPHIC_LIST_CACHE_SIZE
 #define POLYMORPHIC_LIST_CACHE_SIZE 8
+#endif
 
 namespace JSC {
 
@@ -55,6 +59,7 @@ namespace JSC {
     class StructureChain;
 
     // Structure used by op_get_by_id_self_list and op_get_by_id_proto_list instruction to hold data off the main opcode stream.
+    // The JIT also uses it for polymorphic put_by_id replace sites.
     struct PolymorphicAccessStructureList {
         WTF_MAKE_FAST_ALLOCATED;
     public:
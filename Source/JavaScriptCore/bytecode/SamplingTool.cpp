@@ -32,6 +32,8 @@
 #include "CodeBlock.h"
 #include "Interpreter.h"
 #include "Opcode.h"
+#include <wtf/HashSet.h>
+#include <wtf/text/CString.h>
 
 #if !OS(WINDOWS)
 #include <unistd.h>
@@ -386,6 +388,165 @@ void SamplingTool::dump(ExecState*)
 
 #endif
 
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+
+struct PropertyAccessSiteRecord {
+    CString sourceURL;
+    int lineNumber;
+    char cacheState[32];
+    uint32_t executionCount;
+    uint32_t slowCaseCount;
+};
+
+static HashSet<CodeBlock*>& liveCodeBlocks()
+{
+    DEFINE_STATIC_LOCAL(HashSet<CodeBlock*>, codeBlocks, ());
+    return codeBlocks;
+}
+
+static Vector<PropertyAccessSiteRecord>& deadCodeBlockSiteRecords()
+{
+    DEFINE_STATIC_LOCAL(Vector<PropertyAccessSiteRecord>, records, ());
+    return records;
+}
+
+static void describeCacheState(const StructureStubInfo& stubInfo, char* buffer, size_t bufferSize)
+{
+    switch (stubInfo.accessType) {
+    case access_get_by_id_self:
+        snprintf(buffer, bufferSize, "get self");
+        return;
+    case access_get_by_id_proto:
+        snprintf(buffer, bufferSize, "get proto");
+        return;
+    case access_get_by_id_chain:
+        snprintf(buffer, bufferSize, "get chain");
+        return;
+    case access_get_by_id_self_list:
+        snprintf(buffer, bufferSize, "get self list (%d)", stubInfo.u.getByIdSelfList.listSize);
+        return;
+    case access_get_by_id_proto_list:
+        snprintf(buffer, bufferSize, "get proto list (%d)", stubInfo.u.getByIdProtoList.listSize);
+        return;
+    case access_put_by_id_transition:
+        snprintf(buffer, bufferSize, "put transition");
+        return;
+    case access_put_by_id_replace:
+        snprintf(buffer, bufferSize, "put replace");
+        return;
+    case access_put_by_id_replace_list:
+        snprintf(buffer, bufferSize, "put replace list (%d)", stubInfo.u.putByIdReplaceList.listSize);
+        return;
+    case access_get_array_length:
+        snprintf(buffer, bufferSize, "array length");
+        return;
+    case access_get_string_length:
+        snprintf(buffer, bufferSize, "string length");
+        return;
+    default:
+        // Uncached sites don't always record going generic.
+        snprintf(buffer, bufferSize, "uncached");
+        return;
+    }
+}
+
+static void appendSiteRecords(CodeBlock* codeBlock, Vector<PropertyAccessSiteRecord>& records)
+{
+    CString sourceURL = codeBlock->ownerExecutable()->sourceURL().utf8();
+    for (size_t i = 0; i < codeBlock->numberOfStructureStubInfos(); ++i) {
+        StructureStubInfo& stubInfo = codeBlock->structureStubInfo(i);
+        if (!stubInfo.executionCount)
+            continue;
+
+        PropertyAccessSiteRecord record;
+        record.sourceURL = sourceURL;
+        record.lineNumber = codeBlock->lineNumberForBytecodeOffset(stubInfo.bytecodeOffset);
+        describeCacheState(stubInfo, record.cacheState, sizeof(record.cacheState));
+        record.executionCount = stubInfo.executionCount;
+        record.slowCaseCount = stubInfo.slowCaseCount;
+        records.append(record);
+    }
+}
+
+void PropertyAccessSampling::addCodeBlock(CodeBlock* codeBlock)
+{
+    liveCodeBlocks().add(codeBlock);
+}
+
+void PropertyAccessSampling::removeCodeBlock(CodeBlock* codeBlock)
+{
+    HashSet<CodeBlock*>::iterator it = liveCodeBlocks().find(codeBlock);
+    if (it == liveCodeBlocks().end())
+        return;
+
+    appendSiteRecords(codeBlock, deadCodeBlockSiteRecords());
+    liveCodeBlocks().remove(it);
+}
+
+void PropertyAccessSampling::countSlowCase(CodeBlock* codeBlock, void* returnAddress)
+{
+    // The same search as CodeBlock::getStubInfo(), except that it tolerates
+    // return addresses that aren't in the table.
+    size_t low = 0;
+    size_t high = codeBlock->numberOfStructureStubInfos();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        StructureStubInfo& stubInfo = codeBlock->structureStubInfo(mid);
+        void* callReturnLocation = stubInfo.callReturnLocation.executableAddress();
+        if (callReturnLocation == returnAddress) {
+            ++stubInfo.slowCaseCount;
+            return;
+        }
+        if (callReturnLocation < returnAddress)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+}
+
+static int compareSiteRecordsBySlowCases(const void* left, const void* right)
+{
+    const PropertyAccessSiteRecord* leftValue = static_cast<const PropertyAccessSiteRecord*>(left);
+    const PropertyAccessSiteRecord* rightValue = static_cast<const PropertyAccessSiteRecord*>(right);
+
+    return (leftValue->slowCaseCount < rightValue->slowCaseCount) ? 1 : (leftValue->slowCaseCount > rightValue->slowCaseCount) ? -1 : 0;
+}
+
+void PropertyAccessSampling::dump()
+{
+    Vector<PropertyAccessSiteRecord> records(deadCodeBlockSiteRecords());
+    HashSet<CodeBlock*>::iterator end = liveCodeBlocks().end();
+    for (HashSet<CodeBlock*>::iterator it = liveCodeBlocks().begin(); it != end; ++it)
+        appendSiteRecords(*it, records);
+
+    if (records.isEmpty())
+        return;
+
+    qsort(records.data(), records.size(), sizeof(PropertyAccessSiteRecord), compareSiteRecordsBySlowCases);
+
+    unsigned long long executionCount = 0;
+    unsigned long long slowCaseCount = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        executionCount += records[i].executionCount;
+        slowCaseCount += records[i].slowCaseCount;
+    }
+
+    printf("\nProperty access sites: %u sites, %llu accesses, %llu slow cases (%.3f%%)\n", static_cast<unsigned>(records.size()), executionCount, slowCaseCount, slowCaseCount * 100.0 / executionCount);
+    printf("  accesses  slow cases   hit %%    cache                    site\n");
+    printf("--------------------------------------------------------------------------\n");
+
+    // The rest are mostly sites that never left their inline caches.
+    static const size_t maxSitesToPrint = 50;
+    for (size_t i = 0; i < records.size() && i < maxSitesToPrint; ++i) {
+        const PropertyAccessSiteRecord& record = records[i];
+        uint32_t hits = record.executionCount > record.slowCaseCount ? record.executionCount - record.slowCaseCount : 0;
+        printf("%10u  %10u  %6.2f%%   %-22s   %s:%d\n", record.executionCount, record.slowCaseCount, hits * 100.0 / record.executionCount, record.cacheState, record.sourceURL.data(), record.lineNumber);
+    }
+    printf("\n");
+}
+
+#endif // ENABLE(PROPERTY_ACCESS_SAMPLING)
+
 void AbstractSamplingCounter::dump()
 {
 #if ENABLE(SAMPLING_COUNTERS)
@@ -275,6 +275,28 @@ namespace JSC {
 #endif
     };
 
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    // PropertyAccessSampling:
+    //
+    // Counts, for every get_by_id and put_by_id site the JIT compiles, how many
+    // times the site ran and how many of those runs missed in its inline cache
+    // and stubs and went to a C++ slow path. The JIT registers CodeBlocks as it
+    // compiles them; a CodeBlock that is destroyed leaves its sites' totals
+    // behind, so dump() reports on every site, live or not.
+    class PropertyAccessSampling {
+    public:
+        static void addCodeBlock(CodeBlock*);
+        static void removeCodeBlock(CodeBlock*);
+
+        // Safe to call with a return address that is not a property access
+        // site's slow case call; nothing is counted.
+        static void countSlowCase(CodeBlock*, void* returnAddress);
+
+        // Prints the sites with the most slow cases.
+        static void dump();
+    };
+#endif
+
     // AbstractSamplingCounter:
     //
     // Implements a named set of counters, printed on exit if ENABLE(SAMPLING_COUNTERS).
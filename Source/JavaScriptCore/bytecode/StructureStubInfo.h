@@ -43,6 +43,7 @@ namespace JSC {
         access_get_by_id_proto_list,
         access_put_by_id_transition,
         access_put_by_id_replace,
+        access_put_by_id_replace_list,
         access_get_by_id,
         access_put_by_id,
         access_get_by_id_generic,
@@ -55,6 +56,11 @@ namespace JSC {
         StructureStubInfo(AccessType accessType)
             : accessType(accessType)
             , seen(false)
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+            , executionCount(0)
+            , slowCaseCount(0)
+            , bytecodeOffset(0)
+#endif
         {
         }
 
@@ -115,6 +121,14 @@ namespace JSC {
             u.putByIdReplace.baseObjectStructure.set(globalData, owner, baseObjectStructure);
         }
 
+        void initPutByIdReplaceList(PolymorphicAccessStructureList* structureList, int listSize)
+        {
+            accessType = access_put_by_id_replace_list;
+
+            u.putByIdReplaceList.structureList = structureList;
+            u.putByIdReplaceList.listSize = listSize;
+        }
+
         void deref();
         void markAggregate(MarkStack&);
 
@@ -159,11 +173,23 @@ namespace JSC {
             struct {
                 WriteBarrierBase<Structure> baseObjectStructure;
             } putByIdReplace;
+            struct {
+                PolymorphicAccessStructureList* structureList;
+                int listSize;
+            } putByIdReplaceList;
         } u;
 
         CodeLocationLabel stubRoutine;
         CodeLocationCall callReturnLocation;
         CodeLocationLabel hotPathBegin;
+
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+        // See PropertyAccessSampling. The JIT increments executionCount from
+        // the hot path, and the C++ slow paths increment slowCaseCount.
+        uint32_t executionCount;
+        uint32_t slowCaseCount;
+        unsigned bytecodeOffset;
+#endif
     };
 
 } // namespace JSC
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef ValueProfile_h
+#define ValueProfile_h
+
+#if ENABLE(VALUE_PROFILER)
+
+namespace JSC {
+
+// A set of the kinds of value that have been seen at one place in the code.
+// The baseline JIT ors one bit in for every value it profiles, so the DFG JIT
+// can speculate that later values will be of one of the kinds already seen.
+typedef uint32_t PredictedType;
+static const PredictedType PredictNone        = 0x00; // Nothing has been seen yet.
+static const PredictedType PredictInt32       = 0x01;
+static const PredictedType PredictDouble      = 0x02; // A number that is not stored as an int32.
+static const PredictedType PredictNumber      = 0x03;
+static const PredictedType PredictArray       = 0x04;
+static const PredictedType PredictString      = 0x08;
+static const PredictedType PredictObjectOther = 0x10; // Any cell that is neither an array nor a string.
+static const PredictedType PredictCell        = 0x1c;
+static const PredictedType PredictBoolean     = 0x20;
+static const PredictedType PredictOther       = 0x40; // null or undefined.
+static const PredictedType PredictTop         = 0x7f;
+
+inline bool isInt32Prediction(PredictedType value)
+{
+    return value == PredictInt32;
+}
+
+inline bool isNumberPrediction(PredictedType value)
+{
+    return value && !(value & ~PredictNumber);
+}
+
+inline bool isArrayPrediction(PredictedType value)
+{
+    return value == PredictArray;
+}
+
+inline bool isCellPrediction(PredictedType value)
+{
+    return value && !(value & ~PredictCell);
+}
+
+inline bool isBooleanPrediction(PredictedType value)
+{
+    return value == PredictBoolean;
+}
+
+struct ValueProfile {
+    ValueProfile(int bytecodeOffset)
+        : m_bytecodeOffset(bytecodeOffset)
+        , m_observedTypes(PredictNone)
+    {
+    }
+
+    int m_bytecodeOffset; // -1 for the profiles of a function's arguments.
+    PredictedType m_observedTypes;
+};
+
+inline int getValueProfileBytecodeOffset(ValueProfile* valueProfile)
+{
+    return valueProfile->m_bytecodeOffset;
+}
+
+} // namespace JSC
+
+#endif // ENABLE(VALUE_PROFILER)
+
+#endif // ValueProfile_h
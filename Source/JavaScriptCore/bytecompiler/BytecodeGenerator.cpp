@@ -175,22 +175,30 @@ bool BytecodeGenerator::addVar(const Identifier& ident, bool isConstant, Registe
     return true;
 }
 
-bool BytecodeGenerator::addGlobalVar(const Identifier& ident, bool isConstant, RegisterID*& r0)
-{
-    int index = m_nextGlobalIndex;
-    SymbolTableEntry newEntry(index, isConstant ? ReadOnly : 0);
-    pair<SymbolTable::iterator, bool> result = symbolTable().add(ident.impl(), newEntry);
+class ProgramNodeDeclarations : public GlobalDeclarations {
+public:
+    ProgramNodeDeclarations(ProgramNode* programNode)
+        : m_functionStack(programNode->functionStack())
+        , m_varStack(programNode->varStack())
+    {
+    }
 
-    if (!result.second)
-        index = result.first->second.getIndex();
-    else {
-        --m_nextGlobalIndex;
-        m_globals.append(index + m_globalVarStorageOffset);
+    virtual size_t numberOfFunctions() const { return m_functionStack.size(); }
+    virtual const Identifier& functionName(size_t i) const { return m_functionStack[i]->ident(); }
+    virtual FunctionExecutable* makeFunction(ExecState* exec, size_t i) const
+    {
+        FunctionBodyNode* body = m_functionStack[i];
+        return FunctionExecutable::create(exec, body->ident(), body->source(), body->usesArguments(), body->parameters(), body->isStrictMode(), body->lineNo(), body->lastLine());
     }
 
-    r0 = &registerFor(index);
-    return result.second;
-}
+    virtual size_t numberOfVariables() const { return m_varStack.size(); }
+    virtual const Identifier& variableName(size_t i) const { return *m_varStack[i].first; }
+    virtual bool variableIsConstant(size_t i) const { return m_varStack[i].second & DeclarationStacks::IsConstant; }
+
+private:
+    const DeclarationStacks::FunctionStack& m_functionStack;
+    const DeclarationStacks::VarStack& m_varStack;
+};
 
 void BytecodeGenerator::preserveLastVar()
 {
@@ -211,7 +219,7 @@ BytecodeGenerator::BytecodeGenerator(ProgramNode* programNode, ScopeChainNode* s
     , m_dynamicScopeDepth(0)
     , m_baseScopeDepth(0)
     , m_codeType(GlobalCode)
-    , m_nextGlobalIndex(-1)
+    , m_isCacheable(codeBlock->source()->bytecodeCache())
     , m_nextConstantOffset(0)
     , m_globalConstantIndex(0)
     , m_hasCreatedActivation(true)
@@ -237,87 +245,98 @@ BytecodeGenerator::BytecodeGenerator(ProgramNode* programNode, ScopeChainNode* s
     m_codeBlock->m_numParameters = 1; // Allocate space for "this"
 
     JSGlobalObject* globalObject = scopeChain->globalObject.get();
-    ExecState* exec = globalObject->globalExec();
-    RegisterFile* registerFile = &exec->globalData().interpreter->registerFile();
+    RegisterFile* registerFile = &globalObject->globalExec()->globalData().interpreter->registerFile();
     
     // Shift register indexes in generated code to elide registers allocated by intermediate stack frames.
     m_globalVarStorageOffset = -RegisterFile::CallFrameHeaderSize - m_codeBlock->m_numParameters - registerFile->size();
 
-    // Add previously defined symbols to bookkeeping.
+    declareGlobals(scopeChain, ProgramNodeDeclarations(programNode));
+
+    // Add the symbols of the global object to bookkeeping.
     m_globals.grow(symbolTable->size());
     SymbolTable::iterator end = symbolTable->end();
     for (SymbolTable::iterator it = symbolTable->begin(); it != end; ++it)
         registerFor(it->second.getIndex()).setIndex(it->second.getIndex() + m_globalVarStorageOffset);
 
-    BatchedTransitionOptimizer optimizer(*m_globalData, globalObject);
+    preserveLastVar();
+    codeBlock->m_numCapturedVars = codeBlock->m_numVars;
+}
+
+void BytecodeGenerator::declareGlobals(ScopeChainNode* scopeChain, const GlobalDeclarations& declarations)
+{
+    JSGlobalObject* globalObject = scopeChain->globalObject.get();
+    ExecState* exec = globalObject->globalExec();
+    JSGlobalData& globalData = exec->globalData();
+    RegisterFile* registerFile = &globalData.interpreter->registerFile();
+    SymbolTable* symbolTable = &globalObject->symbolTable();
+
+    BatchedTransitionOptimizer optimizer(globalData, globalObject);
 
-    const VarStack& varStack = programNode->varStack();
-    const FunctionStack& functionStack = programNode->functionStack();
-    bool canOptimizeNewGlobals = symbolTable->size() + functionStack.size() + varStack.size() < registerFile->maxGlobals();
+    size_t numberOfFunctions = declarations.numberOfFunctions();
+    size_t numberOfVariables = declarations.numberOfVariables();
+    bool canOptimizeNewGlobals = symbolTable->size() + numberOfFunctions + numberOfVariables < registerFile->maxGlobals();
     if (canOptimizeNewGlobals) {
         // Shift new symbols so they get stored prior to existing symbols.
-        m_nextGlobalIndex -= symbolTable->size();
+        int nextGlobalIndex = -1 - static_cast<int>(symbolTable->size());
 
         HashSet<StringImpl*, IdentifierRepHash> newGlobals;
-        Vector<std::pair<int, bool>, 16> functionInfo(functionStack.size());
-        for (size_t i = 0; i < functionStack.size(); ++i) {
-            FunctionBodyNode* function = functionStack[i];
-            globalObject->removeDirect(*m_globalData, function->ident()); // Make sure our new function is not shadowed by an old property.
-            SymbolTableEntry entry = symbolTable->inlineGet(function->ident().impl());
+        Vector<std::pair<int, bool>, 16> functionInfo(numberOfFunctions);
+        for (size_t i = 0; i < numberOfFunctions; ++i) {
+            const Identifier& ident = declarations.functionName(i);
+            globalObject->removeDirect(globalData, ident); // Make sure our new function is not shadowed by an old property.
+            SymbolTableEntry entry = symbolTable->inlineGet(ident.impl());
             
             if (entry.isNull())
-                newGlobals.add(function->ident().impl());
+                newGlobals.add(ident.impl());
             functionInfo[i] = make_pair(entry.getIndex(), entry.isReadOnly());
         }
         
-        Vector<bool, 16> shouldCreateVar(varStack.size());
-        for (size_t i = 0; i < varStack.size(); ++i) {
-            if (newGlobals.contains(varStack[i].first->impl()) || globalObject->hasProperty(exec, *varStack[i].first)) {
+        Vector<bool, 16> shouldCreateVar(numberOfVariables);
+        for (size_t i = 0; i < numberOfVariables; ++i) {
+            const Identifier& ident = declarations.variableName(i);
+            if (newGlobals.contains(ident.impl()) || globalObject->hasProperty(exec, ident)) {
                 shouldCreateVar[i] = false;
                 continue;
             }
             shouldCreateVar[i] = true;
-            newGlobals.add(varStack[i].first->impl());
+            newGlobals.add(ident.impl());
         }
 
         int expectedSize = symbolTable->size() + newGlobals.size();
         globalObject->resizeRegisters(symbolTable->size(), expectedSize);
     
-        for (size_t i = 0; i < functionStack.size(); ++i) {
-            FunctionBodyNode* function = functionStack[i];
+        for (size_t i = 0; i < numberOfFunctions; ++i) {
             if (functionInfo[i].second)
                 continue;
-            RegisterID* dst = addGlobalVar(function->ident(), false);
-            JSValue value = new (exec) JSFunction(exec, makeFunction(exec, function), scopeChain);
-            globalObject->registerAt(dst->index() - m_globalVarStorageOffset).set(*m_globalData, globalObject, value);
+            pair<SymbolTable::iterator, bool> result = symbolTable->add(declarations.functionName(i).impl(), SymbolTableEntry(nextGlobalIndex));
+            if (result.second)
+                --nextGlobalIndex;
+            int index = result.first->second.getIndex();
+            JSValue value = new (exec) JSFunction(exec, declarations.makeFunction(exec, i), scopeChain);
+            globalObject->registerAt(index).set(globalData, globalObject, value);
         }
 
-        for (size_t i = 0; i < varStack.size(); ++i) {
+        for (size_t i = 0; i < numberOfVariables; ++i) {
             if (!shouldCreateVar[i])
                 continue;
-            addGlobalVar(*varStack[i].first, varStack[i].second & DeclarationStacks::IsConstant);
+            if (symbolTable->add(declarations.variableName(i).impl(), SymbolTableEntry(nextGlobalIndex, declarations.variableIsConstant(i) ? ReadOnly : 0)).second)
+                --nextGlobalIndex;
         }
         if (symbolTable->size() != expectedSize)
             CRASH();
-
-        preserveLastVar();
     } else {
-        for (size_t i = 0; i < functionStack.size(); ++i) {
-            FunctionBodyNode* function = functionStack[i];
-            globalObject->putWithAttributes(exec, function->ident(), new (exec) JSFunction(exec, makeFunction(exec, function), scopeChain), DontDelete);
-        }
-        for (size_t i = 0; i < varStack.size(); ++i) {
-            if (globalObject->symbolTableHasProperty(*varStack[i].first) || globalObject->hasProperty(exec, *varStack[i].first))
+        for (size_t i = 0; i < numberOfFunctions; ++i)
+            globalObject->putWithAttributes(exec, declarations.functionName(i), new (exec) JSFunction(exec, declarations.makeFunction(exec, i), scopeChain), DontDelete);
+        for (size_t i = 0; i < numberOfVariables; ++i) {
+            const Identifier& ident = declarations.variableName(i);
+            if (globalObject->symbolTableHasProperty(ident) || globalObject->hasProperty(exec, ident))
                 continue;
             int attributes = DontDelete;
-            if (varStack[i].second & DeclarationStacks::IsConstant)
+            if (declarations.variableIsConstant(i))
                 attributes |= ReadOnly;
-            globalObject->putWithAttributes(exec, *varStack[i].first, jsUndefined(), attributes);
+            globalObject->putWithAttributes(exec, ident, jsUndefined(), attributes);
         }
-
-        preserveLastVar();
     }
-    codeBlock->m_numCapturedVars = codeBlock->m_numVars;
 }
 
 BytecodeGenerator::BytecodeGenerator(FunctionBodyNode* functionBody, ScopeChainNode* scopeChain, SymbolTable* symbolTable, CodeBlock* codeBlock)
@@ -333,6 +352,7 @@ BytecodeGenerator::BytecodeGenerator(FunctionBodyNode* functionBody, ScopeChainN
     , m_dynamicScopeDepth(0)
     , m_baseScopeDepth(0)
     , m_codeType(FunctionCode)
+    , m_isCacheable(false)
     , m_nextConstantOffset(0)
     , m_globalConstantIndex(0)
     , m_hasCreatedActivation(false)
@@ -497,6 +517,7 @@ BytecodeGenerator::BytecodeGenerator(EvalNode* evalNode, ScopeChainNode* scopeCh
     , m_dynamicScopeDepth(0)
     , m_baseScopeDepth(codeBlock->baseScopeDepth())
     , m_codeType(EvalCode)
+    , m_isCacheable(false)
     , m_nextConstantOffset(0)
     , m_globalConstantIndex(0)
     , m_hasCreatedActivation(true)
@@ -610,7 +631,7 @@ RegisterID* BytecodeGenerator::createLazyRegisterIfNecessary(RegisterID* reg)
 
 RegisterID* BytecodeGenerator::constRegisterFor(const Identifier& ident)
 {
-    if (m_codeType == EvalCode)
+    if (m_codeType == EvalCode || m_isCacheable)
         return 0;
 
     SymbolTableEntry entry = symbolTable().get(ident.impl());
@@ -1132,12 +1153,29 @@ RegisterID* BytecodeGenerator::emitLoad(RegisterID* dst, JSValue v)
 
 bool BytecodeGenerator::findScopedProperty(const Identifier& property, int& index, size_t& stackDepth, bool forWriting, bool& requiresDynamicChecks, JSObject*& globalObject)
 {
+    // Global code that may be cached addresses global variables by their index
+    // in the global object instead, which a BytecodeCache can relink.
+    if (m_isCacheable && !m_dynamicScopeDepth && property != propertyNames().arguments) {
+        JSVariableObject* currentVariableObject = static_cast<JSVariableObject*>(m_scopeChain->begin()->get());
+        ASSERT(++m_scopeChain->begin() == m_scopeChain->end());
+        SymbolTableEntry entry = currentVariableObject->symbolTable().get(property.impl());
+        stackDepth = 0;
+        requiresDynamicChecks = false;
+        globalObject = currentVariableObject;
+        if (entry.isNull() || (entry.isReadOnly() && forWriting)) {
+            index = missingSymbolMarker();
+            return !forWriting || entry.isNull();
+        }
+        index = entry.getIndex();
+        return true;
+    }
+
     // Cases where we cannot statically optimize the lookup.
     if (property == propertyNames().arguments || !canOptimizeNonLocals()) {
         stackDepth = 0;
         index = missingSymbolMarker();
 
-        if (shouldOptimizeLocals() && m_codeType == GlobalCode) {
+        if (m_codeType == GlobalCode && !m_dynamicScopeDepth) {
             ScopeChainIterator iter = m_scopeChain->begin();
             globalObject = iter->get();
             ASSERT((++iter) == m_scopeChain->end());
@@ -1225,7 +1263,8 @@ RegisterID* BytecodeGenerator::emitResolve(RegisterID* dst, const Identifier& pr
 
 #if ENABLE(JIT)
         m_codeBlock->addGlobalResolveInfo(instructions().size());
-#else
+#endif
+#if ENABLE(INTERPRETER)
         m_codeBlock->addGlobalResolveInstruction(instructions().size());
 #endif
         emitOpcode(requiresDynamicChecks ? op_resolve_global_dynamic : op_resolve_global);
@@ -1365,7 +1404,8 @@ RegisterID* BytecodeGenerator::emitResolveWithBase(RegisterID* baseDst, Register
 
 #if ENABLE(JIT)
     m_codeBlock->addGlobalResolveInfo(instructions().size());
-#else
+#endif
+#if ENABLE(INTERPRETER)
     m_codeBlock->addGlobalResolveInstruction(instructions().size());
 #endif
     emitOpcode(requiresDynamicChecks ? op_resolve_global_dynamic : op_resolve_global);
@@ -1387,7 +1427,8 @@ RegisterID* BytecodeGenerator::emitGetById(RegisterID* dst, RegisterID* base, co
 {
 #if ENABLE(JIT)
     m_codeBlock->addStructureStubInfo(StructureStubInfo(access_get_by_id));
-#else
+#endif
+#if ENABLE(INTERPRETER)
     m_codeBlock->addPropertyAccessInstruction(instructions().size());
 #endif
 
@@ -1416,7 +1457,8 @@ RegisterID* BytecodeGenerator::emitPutById(RegisterID* base, const Identifier& p
 {
 #if ENABLE(JIT)
     m_codeBlock->addStructureStubInfo(StructureStubInfo(access_put_by_id));
-#else
+#endif
+#if ENABLE(INTERPRETER)
     m_codeBlock->addPropertyAccessInstruction(instructions().size());
 #endif
 
@@ -1436,7 +1478,8 @@ RegisterID* BytecodeGenerator::emitDirectPutById(RegisterID* base, const Identif
 {
 #if ENABLE(JIT)
     m_codeBlock->addStructureStubInfo(StructureStubInfo(access_put_by_id));
-#else
+#endif
+#if ENABLE(INTERPRETER)
     m_codeBlock->addPropertyAccessInstruction(instructions().size());
 #endif
     
@@ -83,6 +83,23 @@ namespace JSC {
         RefPtr<RegisterID> propertyRegister;
     };
 
+    // The functions and variables that program code declares in the global
+    // object before it runs. Code that is generated takes them from its
+    // ProgramNode; code that is loaded from a BytecodeCache takes them from
+    // the cache.
+    class GlobalDeclarations {
+    public:
+        virtual ~GlobalDeclarations() { }
+
+        virtual size_t numberOfFunctions() const = 0;
+        virtual const Identifier& functionName(size_t) const = 0;
+        virtual FunctionExecutable* makeFunction(ExecState*, size_t) const = 0;
+
+        virtual size_t numberOfVariables() const = 0;
+        virtual const Identifier& variableName(size_t) const = 0;
+        virtual bool variableIsConstant(size_t) const = 0;
+    };
+
     class BytecodeGenerator {
         WTF_MAKE_FAST_ALLOCATED;
     public:
@@ -92,6 +109,8 @@ namespace JSC {
         static void setDumpsGeneratedCode(bool dumpsGeneratedCode);
         static bool dumpsGeneratedCode();
 
+        static void declareGlobals(ScopeChainNode*, const GlobalDeclarations&);
+
         BytecodeGenerator(ProgramNode*, ScopeChainNode*, SymbolTable*, ProgramCodeBlock*);
         BytecodeGenerator(FunctionBodyNode*, ScopeChainNode*, SymbolTable*, CodeBlock*);
         BytecodeGenerator(EvalNode*, ScopeChainNode*, SymbolTable*, EvalCodeBlock*);
@@ -446,16 +465,6 @@ namespace JSC {
             return newRegister();
         }
 
-        // Returns the RegisterID corresponding to ident.
-        RegisterID* addGlobalVar(const Identifier& ident, bool isConstant)
-        {
-            RegisterID* local;
-            addGlobalVar(ident, isConstant, local);
-            return local;
-        }
-        // Returns true if a new RegisterID was added, false if a pre-existing RegisterID was re-used.
-        bool addGlobalVar(const Identifier&, bool isConstant, RegisterID*&);
-
         void addParameter(const Identifier&, int parameterIndex);
         
         void preserveLastVar();
@@ -500,7 +509,10 @@ namespace JSC {
         Vector<Instruction>& instructions() { return m_codeBlock->instructions(); }
         SymbolTable& symbolTable() { return *m_symbolTable; }
 
-        bool shouldOptimizeLocals() { return (m_codeType != EvalCode) && !m_dynamicScopeDepth; }
+        // Global code that may be stored in a BytecodeCache cannot address
+        // global variables as registers, because their offsets depend on the
+        // RegisterFile in which it first ran.
+        bool shouldOptimizeLocals() { return (m_codeType != EvalCode) && !m_dynamicScopeDepth && !m_isCacheable; }
         bool canOptimizeNonLocals() { return (m_codeType == FunctionCode) && !m_dynamicScopeDepth && !m_codeBlock->usesEval(); }
 
         RegisterID* emitThrowExpressionTooDeepException();
@@ -536,12 +548,12 @@ namespace JSC {
         int m_dynamicScopeDepth;
         int m_baseScopeDepth;
         CodeType m_codeType;
+        bool m_isCacheable;
 
         Vector<ControlFlowContext> m_scopeContextStack;
         Vector<SwitchInfo> m_switchContextStack;
         Vector<ForInContext> m_forInContextStack;
 
-        int m_nextGlobalIndex;
         int m_firstConstantIndex;
         int m_nextConstantOffset;
         unsigned m_globalConstantIndex;
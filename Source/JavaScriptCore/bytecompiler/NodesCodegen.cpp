@@ -1302,6 +1302,14 @@ RegisterID* ConstDeclNode::emitCodeSingle(BytecodeGenerator& generator)
     }
 
     if (generator.codeType() != EvalCode) {
+        int index = 0;
+        size_t depth = 0;
+        JSObject* globalObject = 0;
+        bool requiresDynamicChecks = false;
+        if (m_init && generator.codeType() == GlobalCode && generator.findScopedProperty(m_ident, index, depth, false, requiresDynamicChecks, globalObject) && index != missingSymbolMarker() && globalObject) {
+            RegisterID* value = generator.emitNode(m_init);
+            return generator.emitPutScopedVar(depth, index, value, globalObject);
+        }
         if (m_init)
             return generator.emitNode(m_init);
         else
@@ -31,24 +31,19 @@
 #include "DFGAliasTracker.h"
 #include "DFGScoreBoard.h"
 #include "CodeBlock.h"
+#include "JSArray.h"
 
 namespace JSC { namespace DFG {
 
-#if ENABLE(DFG_JIT_RESTRICTIONS)
-// FIXME: Temporarily disable arithmetic, until we fix associated performance regressions.
-#define ARITHMETIC_OP() m_parseFailed = true
-#else
-#define ARITHMETIC_OP() ((void)0)
-#endif
-
 // === ByteCodeParser ===
 //
 // This class is used to compile the dataflow graph from a CodeBlock.
 class ByteCodeParser {
 public:
-    ByteCodeParser(JSGlobalData* globalData, CodeBlock* codeBlock, Graph& graph)
+    ByteCodeParser(JSGlobalData* globalData, CodeBlock* codeBlock, CodeBlock* profiledBlock, Graph& graph)
         : m_globalData(globalData)
         , m_codeBlock(codeBlock)
+        , m_profiledBlock(profiledBlock)
         , m_graph(graph)
         , m_currentIndex(0)
         , m_parseFailed(false)
@@ -57,11 +52,8 @@ public:
         , m_constant1(UINT_MAX)
         , m_constants(codeBlock->numberOfConstantRegisters())
         , m_arguments(codeBlock->m_numParameters)
-        , m_variables(codeBlock->m_numVars)
-        , m_temporaries(codeBlock->m_numCalleeRegisters - codeBlock->m_numVars)
+        , m_variables(codeBlock->m_numCalleeRegisters)
     {
-        for (unsigned i = 0; i < m_temporaries.size(); ++i)
-            m_temporaries[i] = NoNode;
     }
 
     // Parse a full CodeBlock of bytecode.
@@ -70,6 +62,9 @@ public:
 private:
     // Parse a single basic block of bytecode instructions.
     bool parseBlock(unsigned limit);
+    // Annotate every node with the types it is expected to produce.
+    void predictTypes();
+    PredictedType predictionFromProfile(unsigned bytecodeOffset);
 
     // Get/Set the operands/result of a bytecode instruction.
     NodeIndex get(int operand)
@@ -85,15 +80,8 @@ private:
         if (operand < 0)
             return getArgument(operand);
 
-        // Is this a variable?
-        unsigned numVariables = m_variables.size();
-        if ((unsigned)operand < numVariables)
-            return getVariable((unsigned)operand);
-        
-        // Must be a temporary.
-        unsigned temporary = (unsigned)operand - numVariables;
-        ASSERT(temporary < m_temporaries.size());
-        return getTemporary(temporary);
+        // Must be a local variable or a temporary.
+        return getVariable((unsigned)operand);
     }
     void set(int operand, NodeIndex value)
     {
@@ -103,22 +91,18 @@ private:
             return;
         }
 
-        // Is this a variable?
-        unsigned numVariables = m_variables.size();
-        if ((unsigned)operand < numVariables) {
-            setVariable((unsigned)operand, value);
-            return;
-        }
-        
-        // Must be a temporary.
-        unsigned temporary = (unsigned)operand - numVariables;
-        ASSERT(temporary < m_temporaries.size());
-        setTemporary(temporary, value);
+        // Must be a local variable or a temporary.
+        setVariable((unsigned)operand, value);
     }
 
-    // Used in implementing get/set, above, where the operand is a local variable.
+    // Used in implementing get/set, above, where the operand is a local variable
+    // or a temporary. Temporaries are stored back to the RegisterFile like any
+    // other local, so that the baseline JIT can pick them up should the
+    // speculative code exit in the middle of an expression.
     NodeIndex getVariable(unsigned operand)
     {
+        ASSERT(operand < m_variables.size());
+
         NodeIndex setNode = m_variables[operand].set;
         if (setNode != NoNode)
             return m_graph[setNode].child1;
@@ -133,26 +117,10 @@ private:
     }
     void setVariable(unsigned operand, NodeIndex value)
     {
-        NodeIndex priorSet = m_variables[operand].set;
+        ASSERT(operand < m_variables.size());
+        // Every store is kept, even when a later store in the same block
+        // overwrites it: the baseline JIT may need to see the value on exit.
         m_variables[operand].set = addToGraph(SetLocal, OpInfo(operand), value);
-        if (priorSet != NoNode)
-            m_graph.deref(priorSet);
-    }
-
-    // Used in implementing get/set, above, where the operand is a temporary.
-    NodeIndex getTemporary(unsigned operand)
-    {
-        NodeIndex index = m_temporaries[operand];
-        if (index != NoNode)
-            return index;
-        
-        // Detect a read of an temporary that is not a yet defined within this block (e.g. use of ?:).
-        m_parseFailed = true;
-        return constantUndefined();
-    }
-    void setTemporary(unsigned operand, NodeIndex value)
-    {
-        m_temporaries[operand] = value;
     }
 
     // Used in implementing get/set, above, where the operand is an argument.
@@ -178,10 +146,7 @@ private:
         unsigned argument = operand + m_codeBlock->m_numParameters + RegisterFile::CallFrameHeaderSize;
         ASSERT(argument < m_arguments.size());
 
-        NodeIndex priorSet = m_arguments[argument].set;
         m_arguments[argument].set = addToGraph(SetLocal, OpInfo(operand), value);
-        if (priorSet != NoNode)
-            m_graph.deref(priorSet);
     }
 
     // Get an operand, and perform a ToInt32/ToNumber conversion on it.
@@ -459,6 +424,8 @@ private:
 
     JSGlobalData* m_globalData;
     CodeBlock* m_codeBlock;
+    // The baseline code block whose value profiles drive type prediction.
+    CodeBlock* m_profiledBlock;
     Graph& m_graph;
 
     // The bytecode index of the current instruction being generated.
@@ -493,7 +460,7 @@ private:
 
     // For every local variable we track any existing get or set of the value.
     // We track the get so that these may be shared, and we track the set to
-    // retrieve the current value, and to reference the final definition.
+    // retrieve the current value.
     struct VariableRecord {
         VariableRecord()
             : get(NoNode)
@@ -506,11 +473,10 @@ private:
     };
 
     // Track the index of the node whose result is the current value for every
-    // register value in the bytecode - argument, local, and temporary.
+    // register value in the bytecode - argument, and local (including temporaries).
     Vector <ConstantRecord, 32> m_constants;
     Vector <VariableRecord, 32> m_arguments;
     Vector <VariableRecord, 32> m_variables;
-    Vector <NodeIndex, 32> m_temporaries;
 
     // These maps are used to unique ToNumber and ToInt32 operations.
     typedef HashMap<NodeIndex, NodeIndex> UnaryOpMap;
@@ -536,8 +502,9 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             m_variables[i] = VariableRecord();
         for (unsigned i = 0; i < m_arguments.size(); ++i)
             m_arguments[i] = VariableRecord();
-        for (unsigned i = 0; i < m_temporaries.size(); ++i)
-            m_temporaries[i] = NoNode;
+        // Values only flow between blocks through the RegisterFile.
+        m_int32ToNumberNodes.clear();
+        m_numberToInt32Nodes.clear();
     }
 
     AliasTracker aliases(m_graph);
@@ -658,8 +625,11 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             unsigned result = currentInstruction[1].u.operand;
             unsigned srcDst = currentInstruction[2].u.operand;
             NodeIndex op = getToNumber(srcDst);
+            // Compute the new value before storing either result, so that
+            // both stores follow any speculation checks.
+            NodeIndex newValue = addToGraph(ArithAdd, op, one());
             set(result, op);
-            set(srcDst, addToGraph(ArithAdd, op, one()));
+            set(srcDst, newValue);
             NEXT_OPCODE(op_post_inc);
         }
 
@@ -674,15 +644,17 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             unsigned result = currentInstruction[1].u.operand;
             unsigned srcDst = currentInstruction[2].u.operand;
             NodeIndex op = getToNumber(srcDst);
+            // Compute the new value before storing either result, so that
+            // both stores follow any speculation checks.
+            NodeIndex newValue = addToGraph(ArithSub, op, one());
             set(result, op);
-            set(srcDst, addToGraph(ArithSub, op, one()));
+            set(srcDst, newValue);
             NEXT_OPCODE(op_post_dec);
         }
 
         // === Arithmetic operations ===
 
         case op_add: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             // If both operands can statically be determined to the numbers, then this is an arithmetic add.
@@ -695,7 +667,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_sub: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithSub, op1, op2));
@@ -703,7 +674,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_mul: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithMul, op1, op2));
@@ -711,7 +681,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_mod: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithMod, op1, op2));
@@ -719,7 +688,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_div: {
-            ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(ArithDiv, op1, op2));
@@ -735,14 +703,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_not: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, value));
             NEXT_OPCODE(op_not);
         }
 
         case op_less: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareLess, op1, op2));
@@ -750,7 +716,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_lesseq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareLessEq, op1, op2));
@@ -758,7 +723,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_eq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareEq, op1, op2));
@@ -766,14 +730,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_eq_null: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareEq, value, constantNull()));
             NEXT_OPCODE(op_eq_null);
         }
 
         case op_stricteq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(CompareStrictEq, op1, op2));
@@ -781,7 +743,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_neq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareEq, op1, op2)));
@@ -789,14 +750,12 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         }
 
         case op_neq_null: {
-            ARITHMETIC_OP();
             NodeIndex value = get(currentInstruction[2].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareEq, value, constantNull())));
             NEXT_OPCODE(op_neq_null);
         }
 
         case op_nstricteq: {
-            ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             set(currentInstruction[1].u.operand, addToGraph(LogicalNot, addToGraph(CompareStrictEq, op1, op2)));
@@ -982,15 +941,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
         case op_ret: {
             addToGraph(Return, get(currentInstruction[1].u.operand));
-
-            // FIXME: throw away terminal definitions of variables;
-            // should not be necessary once we have proper DCE!
-            for (unsigned i = 0; i < m_variables.size(); ++i) {
-                NodeIndex priorSet = m_variables[i].set;
-                if (priorSet != NoNode)
-                    m_graph.deref(priorSet);
-            }
-
             LAST_OPCODE(op_ret);
         }
 
@@ -1029,6 +979,8 @@ bool ByteCodeParser::parse()
     // Should have reached the end of the instructions.
     ASSERT(m_currentIndex == m_codeBlock->instructions().size());
 
+    m_graph.computeLiveRanges();
+
     // Assign VirtualRegisters.
     ScoreBoard scoreBoard(m_graph, m_variables.size());
     Node* nodes = m_graph.begin();
@@ -1058,6 +1010,8 @@ bool ByteCodeParser::parse()
     if ((unsigned)m_codeBlock->m_numCalleeRegisters < calleeRegisters)
         m_codeBlock->m_numCalleeRegisters = calleeRegisters;
 
+    predictTypes();
+
 #if DFG_DEBUG_VERBOSE
     m_graph.dump(m_codeBlock);
 #endif
@@ -1065,15 +1019,239 @@ bool ByteCodeParser::parse()
     return true;
 }
 
-bool parse(Graph& graph, JSGlobalData* globalData, CodeBlock* codeBlock)
+PredictedType ByteCodeParser::predictionFromProfile(unsigned bytecodeOffset)
+{
+    ValueProfile* valueProfile = m_profiledBlock->valueProfileForBytecodeOffset(bytecodeOffset);
+    return valueProfile ? valueProfile->m_observedTypes : PredictNone;
+}
+
+static PredictedType predictionForConstant(JSGlobalData* globalData, JSValue value)
+{
+    if (value.isInt32())
+        return PredictInt32;
+    if (value.isNumber()) {
+        double number = value.uncheckedGetNumber();
+        return (number == static_cast<int32_t>(number) && (number || !signbit(number))) ? PredictInt32 : PredictDouble;
+    }
+    if (value.isCell())
+        return isJSArray(globalData, value) ? PredictArray : value.isString() ? PredictString : PredictObjectOther;
+    if (value.isBoolean())
+        return PredictBoolean;
+    return PredictOther;
+}
+
+// Arithmetic is expected to stay in the int32 range only if all of its
+// operands do, and the baseline JIT has never seen it produce anything else.
+static PredictedType predictionForArithmetic(PredictedType child1, PredictedType child2, PredictedType profile)
+{
+    bool operandsAreInt32 = (!child1 || isInt32Prediction(child1)) && (!child2 || isInt32Prediction(child2));
+    if (operandsAreInt32 && (!profile || isInt32Prediction(profile)))
+        return PredictInt32;
+    return PredictDouble;
+}
+
+void ByteCodeParser::predictTypes()
+{
+    // Predictions for locals are flow-insensitive: a GetLocal is expected to
+    // produce any of the values stored to that local anywhere in the function,
+    // or passed in as that argument. The undefined values stored by op_enter
+    // (always the instruction at offset 0) are ignored, since they are almost
+    // always overwritten before being read.
+    unsigned numArguments = m_arguments.size();
+    Vector<PredictedType, 32> localPredictions;
+    localPredictions.fill(PredictNone, numArguments + m_variables.size());
+    for (unsigned argument = 0; argument < numArguments; ++argument) {
+        if (ValueProfile* valueProfile = m_profiledBlock->valueProfileForArgument(argument))
+            localPredictions[argument] = valueProfile->m_observedTypes;
+    }
+
+    Node* nodes = m_graph.begin();
+    size_t size = m_graph.size();
+    bool changed;
+    do {
+        changed = false;
+        for (size_t i = 0; i < size; ++i) {
+            Node& node = nodes[i];
+            PredictedType child1 = node.child1 != NoNode ? nodes[node.child1].prediction : PredictNone;
+            PredictedType child2 = node.child2 != NoNode ? nodes[node.child2].prediction : PredictNone;
+            PredictedType prediction = PredictNone;
+
+            switch (node.op) {
+            case Int32Constant:
+                prediction = PredictInt32;
+                break;
+            case DoubleConstant:
+                prediction = predictionForConstant(m_globalData, jsNumber(node.numericConstant()));
+                break;
+            case JSConstant:
+                prediction = predictionForConstant(m_globalData, m_codeBlock->getConstant(FirstConstantRegisterIndex + node.constantNumber()));
+                break;
+
+            case GetLocal: {
+                int local = node.local();
+                prediction = localPredictions[local < 0 ? local + numArguments + RegisterFile::CallFrameHeaderSize : numArguments + local];
+                break;
+            }
+            case SetLocal: {
+                if (!node.exceptionInfo)
+                    break;
+                int local = node.local();
+                PredictedType& localPrediction = localPredictions[local < 0 ? local + numArguments + RegisterFile::CallFrameHeaderSize : numArguments + local];
+                if ((localPrediction | child1) != localPrediction) {
+                    localPrediction |= child1;
+                    changed = true;
+                }
+                break;
+            }
+
+            case BitAnd:
+            case BitOr:
+            case BitXor:
+            case BitLShift:
+            case BitRShift:
+            case BitURShift:
+            case NumberToInt32:
+            case ValueToInt32:
+            case Int32ToNumber:
+                prediction = PredictInt32;
+                break;
+
+            case UInt32ToNumber:
+                prediction = predictionFromProfile(node.exceptionInfo);
+                prediction = isInt32Prediction(prediction) || !prediction ? PredictInt32 : PredictDouble;
+                break;
+
+            case ValueToNumber:
+                prediction = !child1 || isInt32Prediction(child1) ? PredictInt32 : PredictDouble;
+                break;
+
+            case ArithAdd:
+            case ArithSub:
+            case ArithMul:
+            case ArithMod:
+                prediction = predictionForArithmetic(child1, child2, predictionFromProfile(node.exceptionInfo));
+                break;
+
+            case ArithDiv:
+                prediction = PredictDouble;
+                break;
+
+            case ValueAdd: {
+                PredictedType profile = predictionFromProfile(node.exceptionInfo);
+                if ((!child1 || isNumberPrediction(child1)) && (!child2 || isNumberPrediction(child2)))
+                    prediction = predictionForArithmetic(child1, child2, profile);
+                else
+                    prediction = profile ? profile : PredictTop;
+                break;
+            }
+
+            case CompareLess:
+            case CompareLessEq:
+            case CompareEq:
+            case CompareStrictEq:
+            case LogicalNot:
+                prediction = PredictBoolean;
+                break;
+
+            case GetByVal:
+            case GetById:
+            case GetGlobalVar:
+                prediction = predictionFromProfile(node.exceptionInfo);
+                break;
+
+            case ConvertThis:
+                prediction = PredictObjectOther;
+                break;
+
+            default:
+                break;
+            }
+
+            // Predictions only ever widen, so this reaches a fixpoint.
+            prediction |= node.prediction;
+            if (prediction != node.prediction) {
+                node.prediction = prediction;
+                changed = true;
+            }
+        }
+    } while (changed);
+}
+
+bool canCompile(JSGlobalData* globalData, CodeBlock* codeBlock)
+{
+    Interpreter* interpreter = globalData->interpreter;
+    Instruction* instructionsBegin = codeBlock->instructions().begin();
+    unsigned instructionCount = codeBlock->instructions().size();
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructionsBegin[bytecodeOffset].u.opcode);
+        switch (opcodeID) {
+        case op_enter:
+        case op_convert_this:
+        case op_bitand:
+        case op_bitor:
+        case op_bitxor:
+        case op_rshift:
+        case op_lshift:
+        case op_urshift:
+        case op_pre_inc:
+        case op_post_inc:
+        case op_pre_dec:
+        case op_post_dec:
+        case op_add:
+        case op_sub:
+        case op_mul:
+        case op_mod:
+        case op_div:
+        case op_mov:
+        case op_not:
+        case op_less:
+        case op_lesseq:
+        case op_eq:
+        case op_eq_null:
+        case op_stricteq:
+        case op_neq:
+        case op_neq_null:
+        case op_nstricteq:
+        case op_get_by_val:
+        case op_put_by_val:
+        case op_get_by_id:
+        case op_put_by_id:
+        case op_get_global_var:
+        case op_put_global_var:
+        case op_jmp:
+        case op_loop:
+        case op_jtrue:
+        case op_jfalse:
+        case op_loop_if_true:
+        case op_loop_if_false:
+        case op_jeq_null:
+        case op_jneq_null:
+        case op_jnless:
+        case op_jnlesseq:
+        case op_jless:
+        case op_jlesseq:
+        case op_loop_if_less:
+        case op_loop_if_lesseq:
+        case op_ret:
+            break;
+        default:
+            return false;
+        }
+        bytecodeOffset += opcodeLengths[opcodeID];
+    }
+    return true;
+}
+
+bool parse(Graph& graph, JSGlobalData* globalData, CodeBlock* codeBlock, CodeBlock* profiledBlock)
 {
 #if DFG_DEBUG_LOCAL_DISBALE
     UNUSED_PARAM(graph);
     UNUSED_PARAM(globalData);
     UNUSED_PARAM(codeBlock);
+    UNUSED_PARAM(profiledBlock);
     return false;
 #else
-    return ByteCodeParser(globalData, codeBlock, graph).parse();
+    return ByteCodeParser(globalData, codeBlock, profiledBlock, graph).parse();
 #endif
 }
 
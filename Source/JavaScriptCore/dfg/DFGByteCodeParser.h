@@ -37,9 +37,13 @@ class JSGlobalData;
 
 namespace DFG {
 
-// Populate the Graph with a basic block of code from the CodeBlock,
-// starting at the provided bytecode index.
-bool parse(Graph&, JSGlobalData*, CodeBlock*);
+// Check whether the DFG JIT supports every instruction in the CodeBlock; the
+// baseline JIT only profiles, and counts towards optimizing, code that it does.
+bool canCompile(JSGlobalData*, CodeBlock*);
+
+// Populate the Graph with the code from the CodeBlock, predicting types from
+// the value profiles gathered by the baseline code in profiledBlock.
+bool parse(Graph&, JSGlobalData*, CodeBlock*, CodeBlock* profiledBlock);
 
 } } // namespace JSC::DFG
 
@@ -66,6 +66,7 @@ public:
         , m_registerFormat(DataFormatNone)
         , m_spillFormat(DataFormatNone)
         , m_canFill(false)
+        , m_local(InvalidVirtualRegister)
     {
     }
 
@@ -76,6 +77,18 @@ public:
         m_registerFormat = DataFormatNone;
         m_spillFormat = DataFormatNone;
         m_canFill = true;
+        m_local = InvalidVirtualRegister;
+    }
+    // Values read from a local, that will not be stored to again while the value is
+    // live, start out as if they had already been spilled, to the local's slot.
+    void initLocal(NodeIndex nodeIndex, uint32_t useCount, VirtualRegister local)
+    {
+        m_nodeIndex = nodeIndex;
+        m_useCount = useCount;
+        m_registerFormat = DataFormatNone;
+        m_spillFormat = DataFormatJS;
+        m_canFill = true;
+        m_local = local;
     }
     void initInteger(NodeIndex nodeIndex, uint32_t useCount, GPRReg gpr)
     {
@@ -84,6 +97,7 @@ public:
         m_registerFormat = DataFormatInteger;
         m_spillFormat = DataFormatNone;
         m_canFill = false;
+        m_local = InvalidVirtualRegister;
         u.gpr = gpr;
     }
     void initJSValue(NodeIndex nodeIndex, uint32_t useCount, GPRReg gpr, DataFormat format = DataFormatJS)
@@ -95,6 +109,7 @@ public:
         m_registerFormat = format;
         m_spillFormat = DataFormatNone;
         m_canFill = false;
+        m_local = InvalidVirtualRegister;
         u.gpr = gpr;
     }
     void initCell(NodeIndex nodeIndex, uint32_t useCount, GPRReg gpr)
@@ -104,6 +119,7 @@ public:
         m_registerFormat = DataFormatCell;
         m_spillFormat = DataFormatNone;
         m_canFill = false;
+        m_local = InvalidVirtualRegister;
         u.gpr = gpr;
     }
     void initDouble(NodeIndex nodeIndex, uint32_t useCount, FPRReg fpr)
@@ -113,6 +129,7 @@ public:
         m_registerFormat = DataFormatDouble;
         m_spillFormat = DataFormatNone;
         m_canFill = false;
+        m_local = InvalidVirtualRegister;
         u.fpr = fpr;
     }
     void initNone(NodeIndex nodeIndex, uint32_t useCount)
@@ -122,6 +139,7 @@ public:
         m_registerFormat = DataFormatNone;
         m_spillFormat = DataFormatNone;
         m_canFill = false;
+        m_local = InvalidVirtualRegister;
     }
 
     // Get the index of the node that produced this value.
@@ -180,6 +198,22 @@ public:
         m_canFill = true;
     }
 
+    // Called when a value held in machine registers has been stored to a local, that will
+    // not be stored to again while the value is live; the value need never be spilled,
+    // since it can be filled from the local's slot.
+    void setLocal(VirtualRegister local)
+    {
+        ASSERT(!m_canFill && m_spillFormat == DataFormatNone);
+        ASSERT(m_registerFormat != DataFormatNone && m_registerFormat != DataFormatDouble);
+        // Values are stored to locals boxed as JSValues.
+        m_spillFormat = (DataFormat)(m_registerFormat | DataFormatJS);
+        m_canFill = true;
+        m_local = local;
+    }
+    // Get the slot in the RegisterFile that a spilled value is filled from: a local,
+    // or InvalidVirtualRegister if this is the value's own VirtualRegister.
+    VirtualRegister local() { return m_local; }
+
     // Called on values that don't need spilling (constants and values that have
     // already been spilled), to mark them as no longer being in machine registers.
     void setSpilled()
@@ -217,15 +251,16 @@ public:
 
 private:
     // The index of the node whose result is stored in this virtual register.
-    // FIXME: Can we remove this? - this is currently only used when collecting
-    // snapshots of the RegisterBank for SpeculationCheck/EntryLocation. Could
-    // investigate storing NodeIndex as the name in RegsiterBank, instead of
-    // VirtualRegister.
+    // FIXME: Can we remove this? - this is currently only used when silently
+    // spilling and filling registers around calls out to helper functions.
+    // Could investigate storing NodeIndex as the name in RegsiterBank, instead
+    // of VirtualRegister.
     NodeIndex m_nodeIndex;
     uint32_t m_useCount;
     DataFormat m_registerFormat;
     DataFormat m_spillFormat;
     bool m_canFill;
+    VirtualRegister m_local;
     union {
         GPRReg gpr;
         FPRReg fpr;
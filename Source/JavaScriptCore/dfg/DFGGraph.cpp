@@ -55,8 +55,8 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
 
     // Example/explanation of dataflow dump output
     //
-    //   14:   <!2:7>  GetByVal(@3, @13)
-    //   ^1     ^2 ^3     ^4       ^5
+    //   14:   <!2:7>  GetByVal(@3, @13)   predicting 0x01
+    //   ^1     ^2 ^3     ^4       ^5                  ^6
     //
     // (1) The nodeIndex of this operation.
     // (2) The reference count. The number printed is the 'real' count,
@@ -70,6 +70,7 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
     //         $#   - the index in the CodeBlock of a constant { for numeric constants the value is displayed | for integers, in both decimal and hex }.
     //         id#  - the index in the CodeBlock of an identifier { if codeBlock is passed to dump(), the string representation is displayed }.
     //         var# - the index of a var on the global object, used by GetGlobalVar/PutGlobalVar operations.
+    // (6) The PredictedType bits for the value produced by the node, if any are known.
     printf("% 4d:\t<%c%u:%u>\t%s(", (int)nodeIndex, mustGenerate ? '!' : ' ', refCount, node.virtualRegister, dfgOpNames[op & NodeIdMask]);
     if (node.child1 != NoNode)
         printf("@%u", node.child1);
@@ -119,7 +120,10 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
         hasPrinted = true;
     }
 
-    printf(")\n");
+    printf(")");
+    if (node.prediction)
+        printf("\tpredicting 0x%02x", node.prediction);
+    printf("\n");
 }
 
 void Graph::dump(CodeBlock* codeBlock)
@@ -155,6 +159,58 @@ void Graph::refChildren(NodeIndex op)
         return;
     ref(node.child3);
 }
+void Graph::computeLiveRanges()
+{
+    // Count the uses of each node, leaving m_useBegin[n + 1] holding the count for node n.
+    m_useBegin.fill(0, size() + 1);
+    for (size_t i = 0; i < size(); ++i) {
+        Node& node = at(i);
+        if (!node.refCount)
+            continue;
+        if (node.child1 != NoNode)
+            ++m_useBegin[node.child1 + 1];
+        if (node.child2 != NoNode)
+            ++m_useBegin[node.child2 + 1];
+        if (node.child3 != NoNode)
+            ++m_useBegin[node.child3 + 1];
+    }
+    for (size_t i = 1; i <= size(); ++i)
+        m_useBegin[i] += m_useBegin[i - 1];
+
+    // Visit the nodes in order, so that the uses of each node are sorted.
+    Vector<unsigned> next;
+    next.append(m_useBegin.begin(), size());
+    m_uses.resize(m_useBegin[size()]);
+    for (size_t i = 0; i < size(); ++i) {
+        Node& node = at(i);
+        if (!node.refCount)
+            continue;
+        if (node.child1 != NoNode)
+            m_uses[next[node.child1]++] = i;
+        if (node.child2 != NoNode)
+            m_uses[next[node.child2]++] = i;
+        if (node.child3 != NoNode)
+            m_uses[next[node.child3]++] = i;
+    }
+}
+
+bool Graph::canReloadFromLocal(NodeIndex nodeIndex, int local, NodeIndex from)
+{
+    // Arguments may also be written through an arguments object.
+    if (local < 0)
+        return false;
+
+    // A SetLocal that is itself the last use reads its operand before storing it.
+    NodeIndex last = lastUse(nodeIndex);
+    ASSERT(last != NoNode);
+    for (NodeIndex i = from + 1; i < last; ++i) {
+        Node& node = at(i);
+        if (node.op == SetLocal && node.refCount && node.local() == local)
+            return false;
+    }
+    return true;
+}
+
 void Graph::derefChildren(NodeIndex op)
 {
     Node& node = at(op);
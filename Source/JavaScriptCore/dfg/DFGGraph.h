@@ -31,6 +31,7 @@
 #include <dfg/DFGNode.h>
 #include <wtf/Vector.h>
 #include <wtf/StdLibExtras.h>
+#include <algorithm>
 
 namespace JSC {
 
@@ -83,6 +84,33 @@ public:
             derefChildren(nodeIndex);
     }
 
+    // Compute the live range of every node: the ordered list of the nodes that
+    // use its value. Since values only flow between basic blocks through the
+    // RegisterFile, every live range ends in the block in which it begins.
+    void computeLiveRanges();
+
+    // Returns the index of the first node at or after 'from' that uses the value
+    // of 'nodeIndex', or NoNode if it is not used again.
+    NodeIndex nextUse(NodeIndex nodeIndex, NodeIndex from)
+    {
+        ASSERT(m_useBegin.size() == size() + 1);
+        NodeIndex* end = m_uses.begin() + m_useBegin[nodeIndex + 1];
+        NodeIndex* use = std::lower_bound(m_uses.begin() + m_useBegin[nodeIndex], end, from);
+        return use < end ? *use : NoNode;
+    }
+    // Returns the index of the last node to use the value of 'nodeIndex', or NoNode.
+    NodeIndex lastUse(NodeIndex nodeIndex)
+    {
+        ASSERT(m_useBegin.size() == size() + 1);
+        unsigned end = m_useBegin[nodeIndex + 1];
+        return end > m_useBegin[nodeIndex] ? m_uses[end - 1] : NoNode;
+    }
+
+    // Check whether the value of 'nodeIndex', which is held in 'local' in the RegisterFile
+    // once node 'from' has been generated, may be reloaded from there up to its last use;
+    // that is, no SetLocal stores to 'local' in the meantime.
+    bool canReloadFromLocal(NodeIndex nodeIndex, int local, NodeIndex from);
+
 #ifndef NDEBUG
     // CodeBlock is optional, but may allow additional information to be dumped (e.g. Identifier names).
     void dump(CodeBlock* = 0);
@@ -103,6 +131,11 @@ private:
     // When a node's refCount goes from 0 to 1, it must (logically) recursively ref all of its children, and vice versa.
     void refChildren(NodeIndex);
     void derefChildren(NodeIndex);
+
+    // The uses of every node, in order, indexed by m_useBegin (the uses of node
+    // n are m_uses[m_useBegin[n]] up to, but not including, m_uses[m_useBegin[n + 1]]).
+    Vector<unsigned> m_useBegin;
+    Vector<NodeIndex> m_uses;
 };
 
 } } // namespace JSC::DFG
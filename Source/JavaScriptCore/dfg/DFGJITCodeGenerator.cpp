@@ -28,12 +28,13 @@
 
 #if ENABLE(DFG_JIT)
 
-#include "DFGNonSpeculativeJIT.h"
 #include "DFGSpeculativeJIT.h"
 #include "LinkBuffer.h"
 
 namespace JSC { namespace DFG {
 
+const double twoToThe32 = (double)0x100000000ull;
+
 GPRReg JITCodeGenerator::fillInteger(NodeIndex nodeIndex, DataFormat& returnFormat)
 {
     Node& node = m_jit.graph()[nodeIndex];
@@ -46,6 +47,7 @@ GPRReg JITCodeGenerator::fillInteger(NodeIndex nodeIndex, DataFormat& returnForm
 
         if (node.isConstant()) {
             m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+            ++m_rematerializationCount;
             if (isInt32Constant(nodeIndex)) {
                 m_jit.move(MacroAssembler::Imm32(valueOfInt32Constant(nodeIndex)), reg);
                 info.fillInteger(gpr);
@@ -63,7 +65,8 @@ GPRReg JITCodeGenerator::fillInteger(NodeIndex nodeIndex, DataFormat& returnForm
         } else {
             ASSERT(info.spillFormat() == DataFormatJS || info.spillFormat() == DataFormatJSInteger);
             m_gprs.retain(gpr, virtualRegister, SpillOrderSpilled);
-            m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+            ++m_fillCount;
+            m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
         }
 
         // Since we statically know that we're filling an integer, and values
@@ -120,6 +123,7 @@ FPRReg JITCodeGenerator::fillDouble(NodeIndex nodeIndex)
                 // FIXME: should not be reachable?
                 m_jit.move(MacroAssembler::Imm32(valueOfInt32Constant(nodeIndex)), reg);
                 m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+                ++m_rematerializationCount;
                 info.fillInteger(gpr);
                 unlock(gpr);
             } else if (isDoubleConstant(nodeIndex)) {
@@ -128,7 +132,8 @@ FPRReg JITCodeGenerator::fillDouble(NodeIndex nodeIndex)
                 m_jit.movePtrToDouble(reg, JITCompiler::fprToRegisterID(fpr));
                 unlock(gpr);
 
-                m_fprs.retain(fpr, virtualRegister, SpillOrderDouble);
+                m_fprs.retain(fpr, virtualRegister, SpillOrderConstant);
+                ++m_rematerializationCount;
                 info.fillDouble(fpr);
                 return fpr;
             } else {
@@ -137,6 +142,7 @@ FPRReg JITCodeGenerator::fillDouble(NodeIndex nodeIndex)
                 JSValue jsValue = valueOfJSConstant(nodeIndex);
                 m_jit.move(MacroAssembler::ImmPtr(JSValue::encode(jsValue)), reg);
                 m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+                ++m_rematerializationCount;
                 info.fillJSValue(gpr, DataFormatJS);
                 unlock(gpr);
             }
@@ -144,7 +150,8 @@ FPRReg JITCodeGenerator::fillDouble(NodeIndex nodeIndex)
             DataFormat spillFormat = info.spillFormat();
             ASSERT(spillFormat & DataFormatJS);
             m_gprs.retain(gpr, virtualRegister, SpillOrderSpilled);
-            m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+            ++m_fillCount;
+            m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
             info.fillJSValue(gpr, m_isSpeculative ? spillFormat : DataFormatJS);
             unlock(gpr);
         }
@@ -259,11 +266,13 @@ GPRReg JITCodeGenerator::fillJSValue(NodeIndex nodeIndex)
             }
 
             m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+            ++m_rematerializationCount;
         } else {
             DataFormat spillFormat = info.spillFormat();
             ASSERT(spillFormat & DataFormatJS);
             m_gprs.retain(gpr, virtualRegister, SpillOrderSpilled);
-            m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+            ++m_fillCount;
+            m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
             info.fillJSValue(gpr, m_isSpeculative ? spillFormat : DataFormatJS);
         }
         return gpr;
@@ -312,6 +321,346 @@ GPRReg JITCodeGenerator::fillJSValue(NodeIndex nodeIndex)
     return InvalidGPRReg;
 }
 
+void JITCodeGenerator::valueToNumber(JSValueOperand& operand, FPRReg fpr)
+{
+    GPRReg jsValueGpr = operand.gpr();
+    GPRReg tempGpr = allocate(); // FIXME: can we skip this allocation on the last use of the virtual register?
+
+    JITCompiler::RegisterID jsValueReg = JITCompiler::gprToRegisterID(jsValueGpr);
+    JITCompiler::FPRegisterID fpReg = JITCompiler::fprToRegisterID(fpr);
+    JITCompiler::RegisterID tempReg = JITCompiler::gprToRegisterID(tempGpr);
+
+    JITCompiler::Jump isInteger = m_jit.branchPtr(MacroAssembler::AboveOrEqual, jsValueReg, JITCompiler::tagTypeNumberRegister);
+    JITCompiler::Jump nonNumeric = m_jit.branchTestPtr(MacroAssembler::Zero, jsValueReg, JITCompiler::tagTypeNumberRegister);
+
+    // First, if we get here we have a double encoded as a JSValue
+    m_jit.move(jsValueReg, tempReg);
+    m_jit.addPtr(JITCompiler::tagTypeNumberRegister, tempReg);
+    m_jit.movePtrToDouble(tempReg, fpReg);
+    JITCompiler::Jump hasUnboxedDouble = m_jit.jump();
+
+    // Next handle cells (& other JS immediates)
+    nonNumeric.link(&m_jit);
+    silentSpillAllRegisters(fpr, jsValueGpr);
+    m_jit.move(jsValueReg, JITCompiler::argumentRegister1);
+    m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+    appendCallWithExceptionCheck(dfgConvertJSValueToNumber);
+    m_jit.moveDouble(JITCompiler::fpReturnValueRegister, fpReg);
+    silentFillAllRegisters(fpr);
+    JITCompiler::Jump hasCalledToNumber = m_jit.jump();
+    
+    // Finally, handle integers.
+    isInteger.link(&m_jit);
+    m_jit.convertInt32ToDouble(jsValueReg, fpReg);
+    hasUnboxedDouble.link(&m_jit);
+    hasCalledToNumber.link(&m_jit);
+
+    m_gprs.unlock(tempGpr);
+}
+
+void JITCodeGenerator::valueToInt32(JSValueOperand& operand, GPRReg result)
+{
+    GPRReg jsValueGpr = operand.gpr();
+
+    JITCompiler::RegisterID jsValueReg = JITCompiler::gprToRegisterID(jsValueGpr);
+    JITCompiler::RegisterID resultReg = JITCompiler::gprToRegisterID(result);
+
+    JITCompiler::Jump isInteger = m_jit.branchPtr(MacroAssembler::AboveOrEqual, jsValueReg, JITCompiler::tagTypeNumberRegister);
+
+    // First handle non-integers
+    silentSpillAllRegisters(result, jsValueGpr);
+    m_jit.move(jsValueReg, JITCompiler::argumentRegister1);
+    m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+    appendCallWithExceptionCheck(dfgConvertJSValueToInt32);
+    m_jit.zeroExtend32ToPtr(JITCompiler::returnValueRegister, resultReg);
+    silentFillAllRegisters(result);
+    JITCompiler::Jump hasCalledToInt32 = m_jit.jump();
+    
+    // Then handle integers.
+    isInteger.link(&m_jit);
+    m_jit.zeroExtend32ToPtr(jsValueReg, resultReg);
+    hasCalledToInt32.link(&m_jit);
+}
+
+void JITCodeGenerator::numberToInt32(FPRReg fpr, GPRReg gpr)
+{
+    JITCompiler::FPRegisterID fpReg = JITCompiler::fprToRegisterID(fpr);
+    JITCompiler::RegisterID reg = JITCompiler::gprToRegisterID(gpr);
+
+    JITCompiler::Jump truncatedToInteger = m_jit.branchTruncateDoubleToInt32(fpReg, reg, JITCompiler::BranchIfTruncateSuccessful);
+
+    silentSpillAllRegisters(gpr);
+
+    m_jit.moveDouble(fpReg, JITCompiler::fpArgumentRegister0);
+    appendCallWithExceptionCheck(toInt32);
+    m_jit.zeroExtend32ToPtr(JITCompiler::returnValueRegister, reg);
+
+    silentFillAllRegisters(gpr);
+
+    truncatedToInteger.link(&m_jit);
+}
+
+bool JITCodeGenerator::isKnownInteger(NodeIndex nodeIndex)
+{
+    GenerationInfo& info = m_generationInfo[m_jit.graph()[nodeIndex].virtualRegister];
+
+    DataFormat registerFormat = info.registerFormat();
+    if (registerFormat != DataFormatNone)
+        return (registerFormat | DataFormatJS) == DataFormatJSInteger;
+
+    DataFormat spillFormat = info.spillFormat();
+    if (spillFormat != DataFormatNone)
+        return (spillFormat | DataFormatJS) == DataFormatJSInteger;
+
+    ASSERT(isConstant(nodeIndex));
+    return isInt32Constant(nodeIndex);
+}
+
+bool JITCodeGenerator::isKnownNumeric(NodeIndex nodeIndex)
+{
+    GenerationInfo& info = m_generationInfo[m_jit.graph()[nodeIndex].virtualRegister];
+
+    DataFormat registerFormat = info.registerFormat();
+    if (registerFormat != DataFormatNone)
+        return (registerFormat | DataFormatJS) == DataFormatJSInteger
+            || (registerFormat | DataFormatJS) == DataFormatJSDouble;
+
+    DataFormat spillFormat = info.spillFormat();
+    if (spillFormat != DataFormatNone)
+        return (spillFormat | DataFormatJS) == DataFormatJSInteger
+            || (spillFormat | DataFormatJS) == DataFormatJSDouble;
+
+    ASSERT(isConstant(nodeIndex));
+    return isInt32Constant(nodeIndex) || isDoubleConstant(nodeIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeValueToNumber(Node& node)
+{
+    ASSERT(!isInt32Constant(node.child1));
+    ASSERT(!isDoubleConstant(node.child1));
+
+    if (isKnownInteger(node.child1)) {
+        IntegerOperand op1(this, node.child1);
+        FPRTemporary result(this);
+        m_jit.convertInt32ToDouble(op1.registerID(), result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        return;
+    }
+
+    if (isKnownNumeric(node.child1)) {
+        DoubleOperand op1(this, node.child1);
+        FPRTemporary result(this, op1);
+        m_jit.moveDouble(op1.registerID(), result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        return;
+    }
+
+    JSValueOperand op1(this, node.child1);
+    FPRTemporary result(this);
+    valueToNumber(op1, result.fpr());
+    doubleResult(result.fpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeValueToInt32(Node& node)
+{
+    ASSERT(!isInt32Constant(node.child1));
+
+    if (isKnownInteger(node.child1)) {
+        IntegerOperand op1(this, node.child1);
+        GPRTemporary result(this, op1);
+        m_jit.move(op1.registerID(), result.registerID());
+        integerResult(result.gpr(), m_compileIndex);
+        return;
+    }
+
+    if (isKnownNumeric(node.child1)) {
+        DoubleOperand op1(this, node.child1);
+        GPRTemporary result(this);
+        numberToInt32(op1.fpr(), result.gpr());
+        integerResult(result.gpr(), m_compileIndex);
+        return;
+    }
+
+    // We should have handled this via isKnownInteger, or isKnownNumeric!
+    ASSERT(node.op != NumberToInt32);
+
+    JSValueOperand op1(this, node.child1);
+    GPRTemporary result(this, op1);
+    valueToInt32(op1, result.gpr());
+    integerResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeUInt32ToNumber(Node& node)
+{
+    IntegerOperand op1(this, node.child1);
+    FPRTemporary result(this);
+    m_jit.convertInt32ToDouble(op1.registerID(), result.registerID());
+
+    MacroAssembler::Jump positive = m_jit.branch32(MacroAssembler::GreaterThanOrEqual, op1.registerID(), TrustedImm32(0));
+    m_jit.addDouble(JITCompiler::AbsoluteAddress(&twoToThe32), result.registerID());
+    positive.link(&m_jit);
+
+    doubleResult(result.fpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeArithmetic(Node& node)
+{
+    DoubleOperand op1(this, node.child1);
+    DoubleOperand op2(this, node.child2);
+    MacroAssembler::FPRegisterID reg1 = op1.registerID();
+    MacroAssembler::FPRegisterID reg2 = op2.registerID();
+
+    switch (node.op) {
+    case ArithAdd: {
+        FPRTemporary result(this, op1, op2);
+        m_jit.addDouble(reg1, reg2, result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        break;
+    }
+
+    case ArithSub: {
+        FPRTemporary result(this, op1);
+        m_jit.subDouble(reg1, reg2, result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        break;
+    }
+
+    case ArithMul: {
+        FPRTemporary result(this, op1, op2);
+        m_jit.mulDouble(reg1, reg2, result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        break;
+    }
+
+    case ArithDiv: {
+        FPRTemporary result(this, op1);
+        m_jit.divDouble(reg1, reg2, result.registerID());
+        doubleResult(result.fpr(), m_compileIndex);
+        break;
+    }
+
+    default:
+        ASSERT_NOT_REACHED();
+    }
+}
+
+void JITCodeGenerator::nonSpeculativeArithMod(Node& node)
+{
+    DoubleOperand arg1(this, node.child1);
+    DoubleOperand arg2(this, node.child2);
+    FPRReg arg1FPR = arg1.fpr();
+    FPRReg arg2FPR = arg2.fpr();
+    flushRegisters();
+
+    FPRResult result(this);
+    callOperation(fmod, result.fpr(), arg1FPR, arg2FPR);
+
+    doubleResult(result.fpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeValueAdd(Node& node)
+{
+    JSValueOperand arg1(this, node.child1);
+    JSValueOperand arg2(this, node.child2);
+    GPRReg arg1GPR = arg1.gpr();
+    GPRReg arg2GPR = arg2.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(operationValueAdd, result.gpr(), arg1GPR, arg2GPR);
+
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeLogicalNot(Node& node)
+{
+    JSValueOperand arg1(this, node.child1);
+    GPRReg arg1GPR = arg1.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(dfgConvertJSValueToBoolean, result.gpr(), arg1GPR);
+
+    // If we add a DataFormatBool, we should use it here.
+    m_jit.xor32(TrustedImm32(ValueTrue), result.registerID());
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeCompare(Node& node, Z_DFGOperation_EJJ helperFunction)
+{
+    JSValueOperand arg1(this, node.child1);
+    JSValueOperand arg2(this, node.child2);
+    GPRReg arg1GPR = arg1.gpr();
+    GPRReg arg2GPR = arg2.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(helperFunction, result.gpr(), arg1GPR, arg2GPR);
+    m_jit.or32(TrustedImm32(ValueFalse), result.registerID());
+
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeGetByVal(Node& node)
+{
+    JSValueOperand arg1(this, node.child1);
+    JSValueOperand arg2(this, node.child2);
+    GPRReg arg1GPR = arg1.gpr();
+    GPRReg arg2GPR = arg2.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(operationGetByVal, result.gpr(), arg1GPR, arg2GPR);
+
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativePutByVal(Node& node)
+{
+    JSValueOperand arg1(this, node.child1);
+    JSValueOperand arg2(this, node.child2);
+    JSValueOperand arg3(this, node.child3);
+    GPRReg arg1GPR = arg1.gpr();
+    GPRReg arg2GPR = arg2.gpr();
+    GPRReg arg3GPR = arg3.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(m_jit.codeBlock()->isStrictMode() ? operationPutByValStrict : operationPutByValNonStrict, arg1GPR, arg2GPR, arg3GPR);
+
+    noResult(m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeConvertThis(Node& node)
+{
+    JSValueOperand thisValue(this, node.child1);
+    GPRReg thisGPR = thisValue.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(operationConvertThis, result.gpr(), thisGPR);
+    cellResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::nonSpeculativeBranch(Node& node)
+{
+    JSValueOperand value(this, node.child1);
+    GPRReg valueGPR = value.gpr();
+    flushRegisters();
+
+    GPRResult result(this);
+    callOperation(dfgConvertJSValueToBoolean, result.gpr(), valueGPR);
+
+    BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(node.takenBytecodeOffset());
+    BlockIndex notTaken = m_jit.graph().blockIndexForBytecodeOffset(node.notTakenBytecodeOffset());
+
+    addBranch(m_jit.branchTest8(MacroAssembler::NonZero, result.registerID()), taken);
+    if (notTaken != (m_block + 1))
+        addBranch(m_jit.jump(), notTaken);
+
+    noResult(m_compileIndex);
+}
+
 void JITCodeGenerator::useChildren(Node& node)
 {
     NodeIndex child1 = node.child1;
@@ -382,6 +731,17 @@ void JITCodeGenerator::dump(const char* label)
 #endif
 
 
+#if DFG_SPILL_STATS
+void JITCodeGenerator::dumpSpillStats(const char* label)
+{
+    CodeBlock* codeBlock = m_jit.codeBlock();
+    ScriptExecutable* executable = codeBlock->ownerExecutable();
+    fprintf(stderr, "%s: %s:%d: %u spills, %u fills, %u rematerialized constants (%u nodes)\n",
+        label, executable->sourceURL().utf8().data(), executable->lineNo(), m_spillCount, m_fillCount, m_rematerializationCount,
+        static_cast<unsigned>(m_jit.graph().size()));
+}
+#endif
+
 #if DFG_CONSISTENCY_CHECK
 void JITCodeGenerator::checkConsistency()
 {
@@ -37,6 +37,7 @@
 
 namespace JSC { namespace DFG {
 
+class JSValueOperand;
 class SpeculateIntegerOperand;
 class SpeculateStrictInt32Operand;
 class SpeculateCellOperand;
@@ -113,7 +114,7 @@ public:
     GPRReg allocate()
     {
         VirtualRegister spillMe;
-        GPRReg gpr = m_gprs.allocate(spillMe);
+        GPRReg gpr = m_gprs.allocate(spillMe, *this);
         if (spillMe != InvalidVirtualRegister)
             spill(spillMe);
         return gpr;
@@ -121,12 +122,29 @@ public:
     FPRReg fprAllocate()
     {
         VirtualRegister spillMe;
-        FPRReg fpr = m_fprs.allocate(spillMe);
+        FPRReg fpr = m_fprs.allocate(spillMe, *this);
         if (spillMe != InvalidVirtualRegister)
             spill(spillMe);
         return fpr;
     }
 
+    // Called by the RegisterBanks to choose a register to spill when none are free.
+    // Spilling the value whose next use is furthest away frees up a register for
+    // longest; this is weighted by the cost of spilling and refilling the value,
+    // so that constants (which are rematerialized) and values that are already in
+    // the RegisterFile (which need no store) are spilled in preference to others.
+    uint32_t spillCost(VirtualRegister name, SpillOrder spillOrder)
+    {
+        GenerationInfo& info = m_generationInfo[name];
+        // Values may have been stored to a local since they were filled.
+        if (!info.needsSpill() && spillOrder > SpillOrderSpilled)
+            spillOrder = SpillOrderSpilled;
+
+        NodeIndex nextUse = m_jit.graph().nextUse(info.nodeIndex(), m_compileIndex);
+        ASSERT(nextUse != NoNode);
+        return (static_cast<uint32_t>(spillOrder) << 16) / (nextUse - m_compileIndex + 1);
+    }
+
     // Check whether a VirtualRegsiter is currently in a machine register.
     // We use this when filling operands to fill those that are already in
     // machine registers first (by locking VirtualRegsiters that are already
@@ -145,6 +163,14 @@ public:
         return info.registerFormat() == DataFormatDouble;
     }
 
+    // The labels at the head of each basic block, used by the JITCompiler to
+    // record the entry points for OSR from the baseline JIT.
+    const Vector<MacroAssembler::Label>& blockHeads() const { return m_blockHeads; }
+
+#if DFG_SPILL_STATS
+    void dumpSpillStats(const char* label);
+#endif
+
 protected:
     JITCodeGenerator(JITCompiler& jit, bool isSpeculative)
         : m_jit(jit)
@@ -152,6 +178,10 @@ protected:
         , m_compileIndex(0)
         , m_generationInfo(m_jit.codeBlock()->m_numCalleeRegisters)
         , m_blockHeads(jit.graph().m_blocks.size())
+        , m_spillCount(0)
+        , m_fillCount(0)
+        , m_rematerializationCount(0)
+        , m_lastNodeThatCalledOut(NoNode)
     {
     }
 
@@ -212,6 +242,7 @@ protected:
             return;
         }
 
+        ++m_spillCount;
         DataFormat spillFormat = info.registerFormat();
         if (spillFormat == DataFormatDouble) {
             // All values are spilled as JSValues, so box the double via a temporary gpr.
@@ -445,6 +476,237 @@ protected:
         Node& node = m_jit.graph()[nodeIndex];
         m_generationInfo[node.virtualRegister].initConstant(nodeIndex, node.refCount);
     }
+    void initLocalInfo(NodeIndex nodeIndex)
+    {
+        Node& node = m_jit.graph()[nodeIndex];
+        ASSERT(node.op == GetLocal);
+        m_generationInfo[node.virtualRegister].initLocal(nodeIndex, node.refCount, static_cast<VirtualRegister>(node.local()));
+    }
+
+    // Called once a SetLocal has stored its operand; if the local will not be stored
+    // to again while the value is live, the value can be filled from the local rather
+    // than being spilled.
+    void storedToLocal(Node& node)
+    {
+        ASSERT(node.op == SetLocal);
+        GenerationInfo& info = m_generationInfo[m_jit.graph()[node.child1].virtualRegister];
+        if (info.needsSpill() && m_jit.graph().canReloadFromLocal(node.child1, node.local(), m_compileIndex))
+            info.setLocal(static_cast<VirtualRegister>(node.local()));
+    }
+
+    // The address in the RegisterFile that a spilled value is filled from.
+    MacroAssembler::Address spillSlotFor(VirtualRegister virtualRegister)
+    {
+        VirtualRegister local = m_generationInfo[virtualRegister].local();
+        return JITCompiler::addressFor(local == InvalidVirtualRegister ? virtualRegister : local);
+    }
+
+    // These methods are used when generating 'unexpected'
+    // calls out from JIT code to C++ helper routines -
+    // they spill all live values to the appropriate
+    // slots in the RegisterFile without changing any state
+    // in the GenerationInfo.
+    void silentSpillGPR(VirtualRegister spillMe, GPRReg exclude = InvalidGPRReg)
+    {
+        GenerationInfo& info = m_generationInfo[spillMe];
+        ASSERT(info.registerFormat() != DataFormatNone && info.registerFormat() != DataFormatDouble);
+
+        if (!info.needsSpill() || (info.gpr() == exclude))
+            return;
+
+        DataFormat registerFormat = info.registerFormat();
+        JITCompiler::RegisterID reg = JITCompiler::gprToRegisterID(info.gpr());
+
+        ++m_spillCount;
+        if (registerFormat == DataFormatInteger) {
+            m_jit.orPtr(JITCompiler::tagTypeNumberRegister, reg);
+            m_jit.storePtr(reg, JITCompiler::addressFor(spillMe));
+        } else {
+            ASSERT(registerFormat & DataFormatJS || registerFormat == DataFormatCell);
+            m_jit.storePtr(reg, JITCompiler::addressFor(spillMe));
+        }
+    }
+    void silentSpillFPR(VirtualRegister spillMe, GPRReg canTrample, FPRReg exclude = InvalidFPRReg)
+    {
+        GenerationInfo& info = m_generationInfo[spillMe];
+        ASSERT(info.registerFormat() == DataFormatDouble);
+
+        if (!info.needsSpill() || (info.fpr() == exclude))
+            return;
+
+        ++m_spillCount;
+        boxDouble(info.fpr(), canTrample);
+        m_jit.storePtr(JITCompiler::gprToRegisterID(canTrample), JITCompiler::addressFor(spillMe));
+    }
+
+    void silentFillGPR(VirtualRegister spillMe, GPRReg exclude = InvalidGPRReg)
+    {
+        GenerationInfo& info = m_generationInfo[spillMe];
+        if (info.gpr() == exclude)
+            return;
+
+        NodeIndex nodeIndex = info.nodeIndex();
+        Node& node = m_jit.graph()[nodeIndex];
+        ASSERT(info.registerFormat() != DataFormatNone && info.registerFormat() != DataFormatDouble);
+        DataFormat registerFormat = info.registerFormat();
+        JITCompiler::RegisterID reg = JITCompiler::gprToRegisterID(info.gpr());
+
+        if (registerFormat == DataFormatInteger) {
+            if (node.isConstant()) {
+                // The SpeculativeJIT may also fill integral double constants as integers.
+                ASSERT(isInt32Constant(nodeIndex) || isDoubleConstant(nodeIndex));
+                m_jit.move(Imm32(isInt32Constant(nodeIndex) ? valueOfInt32Constant(nodeIndex) : static_cast<int32_t>(valueOfDoubleConstant(nodeIndex))), reg);
+                ++m_rematerializationCount;
+            } else {
+                m_jit.load32(spillSlotFor(spillMe), reg);
+                ++m_fillCount;
+            }
+            return;
+        }
+
+        if (node.isConstant()) {
+            m_jit.move(constantAsJSValueAsImmPtr(nodeIndex), reg);
+            ++m_rematerializationCount;
+        } else {
+            ASSERT(registerFormat & DataFormatJS || registerFormat == DataFormatCell);
+            m_jit.loadPtr(spillSlotFor(spillMe), reg);
+            ++m_fillCount;
+        }
+    }
+    void silentFillFPR(VirtualRegister spillMe, GPRReg canTrample, FPRReg exclude = InvalidFPRReg)
+    {
+        GenerationInfo& info = m_generationInfo[spillMe];
+        if (info.fpr() == exclude)
+            return;
+
+        NodeIndex nodeIndex = info.nodeIndex();
+        Node& node = m_jit.graph()[nodeIndex];
+        ASSERT(info.registerFormat() == DataFormatDouble);
+
+        JITCompiler::RegisterID reg = JITCompiler::gprToRegisterID(canTrample);
+        JITCompiler::FPRegisterID fpReg = JITCompiler::fprToRegisterID(info.fpr());
+        if (node.isConstant()) {
+            JSValue jsValue = constantAsJSValue(nodeIndex);
+            ASSERT(jsValue.isNumber());
+            double value = jsValue.uncheckedGetNumber();
+            m_jit.move(MacroAssembler::ImmPtr(reinterpret_cast<void*>(reinterpretDoubleToIntptr(value))), reg);
+            m_jit.movePtrToDouble(reg, fpReg);
+            ++m_rematerializationCount;
+            return;
+        }
+
+        ++m_fillCount;
+        m_jit.loadPtr(spillSlotFor(spillMe), reg);
+        // Silently spilled doubles were boxed by silentSpillFPR, but values that need
+        // no spill are reloaded in the form in which they were first spilled, which
+        // may be an integer that has since been converted to double.
+        if (info.needsSpill() || info.spillFormat() == DataFormatJSDouble) {
+            unboxDouble(canTrample, info.fpr());
+            return;
+        }
+
+        JITCompiler::Jump isInteger = m_jit.branchPtr(MacroAssembler::AboveOrEqual, reg, JITCompiler::tagTypeNumberRegister);
+        unboxDouble(canTrample, info.fpr());
+        JITCompiler::Jump hasUnboxedDouble = m_jit.jump();
+        isInteger.link(&m_jit);
+        m_jit.convertInt32ToDouble(reg, fpReg);
+        hasUnboxedDouble.link(&m_jit);
+    }
+
+    void silentSpillAllRegisters(GPRReg exclude, GPRReg preserve = InvalidGPRReg)
+    {
+        GPRReg canTrample = (preserve == gpr0) ? gpr1 : gpr0;
+        
+        for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
+            VirtualRegister name = m_gprs.name(gpr);
+            if (name != InvalidVirtualRegister)
+                silentSpillGPR(name, exclude);
+        }
+        for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
+            VirtualRegister name = m_fprs.name(fpr);
+            if (name != InvalidVirtualRegister)
+                silentSpillFPR(name, canTrample);
+        }
+    }
+    void silentSpillAllRegisters(FPRReg exclude, GPRReg preserve = InvalidGPRReg)
+    {
+        GPRReg canTrample = (preserve == gpr0) ? gpr1 : gpr0;
+        
+        for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
+            VirtualRegister name = m_gprs.name(gpr);
+            if (name != InvalidVirtualRegister)
+                silentSpillGPR(name);
+        }
+        for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
+            VirtualRegister name = m_fprs.name(fpr);
+            if (name != InvalidVirtualRegister)
+                silentSpillFPR(name, canTrample, exclude);
+        }
+    }
+    void silentFillAllRegisters(GPRReg exclude)
+    {
+        GPRReg canTrample = (exclude == gpr0) ? gpr1 : gpr0;
+        
+        for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
+            VirtualRegister name = m_fprs.name(fpr);
+            if (name != InvalidVirtualRegister)
+                silentFillFPR(name, canTrample);
+        }
+        for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
+            VirtualRegister name = m_gprs.name(gpr);
+            if (name != InvalidVirtualRegister)
+                silentFillGPR(name, exclude);
+        }
+    }
+    void silentFillAllRegisters(FPRReg exclude)
+    {
+        GPRReg canTrample = gpr0;
+        
+        for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
+            VirtualRegister name = m_fprs.name(fpr);
+            if (name != InvalidVirtualRegister) {
+#ifndef NDEBUG
+                ASSERT(fpr != exclude);
+#else
+                UNUSED_PARAM(exclude);
+#endif
+                silentFillFPR(name, canTrample, exclude);
+            }
+        }
+        for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
+            VirtualRegister name = m_gprs.name(gpr);
+            if (name != InvalidVirtualRegister)
+                silentFillGPR(name);
+        }
+    }
+
+    // These methods are used to plant calls out to C++
+    // helper routines to convert between types.
+    void valueToNumber(JSValueOperand&, FPRReg result);
+    void valueToInt32(JSValueOperand&, GPRReg result);
+    void numberToInt32(FPRReg, GPRReg result);
+
+    // Check whether a value is statically known to be an integer, or a number,
+    // from the format it has been filled or spilled in.
+    bool isKnownInteger(NodeIndex);
+    bool isKnownNumeric(NodeIndex);
+
+    // These methods generate code for a node making no assumptions about the
+    // types of its operands. The NonSpeculativeJIT uses these for every node,
+    // and the SpeculativeJIT for nodes where the value profiles show that
+    // speculating would fail.
+    void nonSpeculativeValueToNumber(Node&);
+    void nonSpeculativeValueToInt32(Node&);
+    void nonSpeculativeUInt32ToNumber(Node&);
+    void nonSpeculativeArithmetic(Node&);
+    void nonSpeculativeArithMod(Node&);
+    void nonSpeculativeValueAdd(Node&);
+    void nonSpeculativeLogicalNot(Node&);
+    void nonSpeculativeCompare(Node&, Z_DFGOperation_EJJ helperFunction);
+    void nonSpeculativeGetByVal(Node&);
+    void nonSpeculativePutByVal(Node&);
+    void nonSpeculativeConvertThis(Node&);
+    void nonSpeculativeBranch(Node&);
 
     // These methods used to sort arguments into the correct registers.
     template<GPRReg destA, GPRReg destB>
@@ -473,7 +735,7 @@ protected:
             m_jit.move(JITCompiler::gprToRegisterID(srcB), JITCompiler::gprToRegisterID(destB));
             m_jit.move(JITCompiler::gprToRegisterID(srcA), JITCompiler::gprToRegisterID(destA));
         } else
-            m_jit.swap(JITCompiler::gprToRegisterID(destB), JITCompiler::gprToRegisterID(destB));
+            m_jit.swap(JITCompiler::gprToRegisterID(destA), JITCompiler::gprToRegisterID(destB));
     }
     template<FPRReg destA, FPRReg destB>
     void setupTwoStubArgs(FPRReg srcA, FPRReg srcB)
@@ -669,6 +931,7 @@ protected:
     void appendCallWithExceptionCheck(const FunctionPtr& function)
     {
         m_jit.appendCallWithExceptionCheck(function, m_jit.graph()[m_compileIndex].exceptionInfo);
+        m_lastNodeThatCalledOut = m_compileIndex;
     }
 
     void addBranch(const MacroAssembler::Jump& jump, BlockIndex destination)
@@ -701,11 +964,10 @@ protected:
     // from the RegisterFile. When spilling we attempt to store information
     // as to the type of boxed value being stored (int32, double, cell), and
     // when filling on the speculative path we will retrieve this type info
-    // where available. On the non-speculative path, however, we cannot rely
-    // on the spill format info, since the a value being loaded might have
-    // been spilled by either the speculative or non-speculative paths (where
-    // we entered the non-speculative path on an intervening bail-out), and
-    // the value may have been boxed differently on the two paths.
+    // where available. On the non-speculative path, however, we do not rely
+    // on the spill format info, since values are only ever loaded from the
+    // RegisterFile as JSValues (the register file is shared with the baseline
+    // JIT, which may have written any value there before an OSR entry).
     bool m_isSpeculative;
     // The current node being generated.
     BlockIndex m_block;
@@ -716,6 +978,14 @@ protected:
     RegisterBank<FPRReg, numberOfFPRs, SpillOrder, SpillOrderNone, SpillOrderMax> m_fprs;
 
     Vector<MacroAssembler::Label> m_blockHeads;
+    // The number of values stored to and loaded from the RegisterFile by the register
+    // allocator, and of constants materialized into registers.
+    unsigned m_spillCount;
+    unsigned m_fillCount;
+    unsigned m_rematerializationCount;
+    // The last node whose code calls a helper that may run JavaScript (a valueOf
+    // or a getter, say), or NoNode.
+    NodeIndex m_lastNodeThatCalledOut;
     struct BranchRecord {
         BranchRecord(MacroAssembler::Jump jump, BlockIndex destination)
             : jump(jump)
@@ -39,182 +39,29 @@
 
 namespace JSC { namespace DFG {
 
-// This method used to fill a numeric value to a FPR when linking speculative -> non-speculative.
-void JITCompiler::fillNumericToDouble(NodeIndex nodeIndex, FPRReg fpr, GPRReg temporary)
+void JITCompiler::linkOSRExits(SpeculativeJIT& speculative)
 {
-    Node& node = graph()[nodeIndex];
-    MacroAssembler::RegisterID tempReg = gprToRegisterID(temporary);
+    CodeBlock* baselineCodeBlock = m_codeBlock->alternative();
+    ASSERT(baselineCodeBlock);
 
-    if (node.isConstant()) {
-        ASSERT(node.op == DoubleConstant);
-        move(MacroAssembler::ImmPtr(reinterpret_cast<void*>(reinterpretDoubleToIntptr(valueOfDoubleConstant(nodeIndex)))), tempReg);
-        movePtrToDouble(tempReg, fprToRegisterID(fpr));
-    } else {
-        loadPtr(addressFor(node.virtualRegister), tempReg);
-        Jump isInteger = branchPtr(MacroAssembler::AboveOrEqual, tempReg, tagTypeNumberRegister);
-        jitAssertIsJSDouble(gpr0);
-        addPtr(tagTypeNumberRegister, tempReg);
-        movePtrToDouble(tempReg, fprToRegisterID(fpr));
-        Jump hasUnboxedDouble = jump();
-        isInteger.link(this);
-        convertInt32ToDouble(tempReg, fprToRegisterID(fpr));
-        hasUnboxedDouble.link(this);
-    }
-}
-
-// This method used to fill an integer value to a GPR when linking speculative -> non-speculative.
-void JITCompiler::fillInt32ToInteger(NodeIndex nodeIndex, GPRReg gpr)
-{
-    Node& node = graph()[nodeIndex];
-
-    if (node.isConstant()) {
-        ASSERT(node.op == Int32Constant);
-        move(MacroAssembler::Imm32(valueOfInt32Constant(nodeIndex)), gprToRegisterID(gpr));
-    } else {
-#if DFG_JIT_ASSERT
-        // Redundant load, just so we can check the tag!
-        loadPtr(addressFor(node.virtualRegister), gprToRegisterID(gpr));
-        jitAssertIsJSInt32(gpr);
-#endif
-        load32(addressFor(node.virtualRegister), gprToRegisterID(gpr));
-    }
-}
-
-// This method used to fill a JSValue to a GPR when linking speculative -> non-speculative.
-void JITCompiler::fillToJS(NodeIndex nodeIndex, GPRReg gpr)
-{
-    Node& node = graph()[nodeIndex];
-
-    if (node.isConstant()) {
-        if (isInt32Constant(nodeIndex)) {
-            JSValue jsValue = jsNumber(valueOfInt32Constant(nodeIndex));
-            move(MacroAssembler::ImmPtr(JSValue::encode(jsValue)), gprToRegisterID(gpr));
-        } else if (isDoubleConstant(nodeIndex)) {
-            JSValue jsValue(JSValue::EncodeAsDouble, valueOfDoubleConstant(nodeIndex));
-            move(MacroAssembler::ImmPtr(JSValue::encode(jsValue)), gprToRegisterID(gpr));
-        } else {
-            ASSERT(isJSConstant(nodeIndex));
-            JSValue jsValue = valueOfJSConstant(nodeIndex);
-            move(MacroAssembler::ImmPtr(JSValue::encode(jsValue)), gprToRegisterID(gpr));
-        }
-        return;
-    }
-
-    loadPtr(addressFor(node.virtualRegister), gprToRegisterID(gpr));
-}
-
-void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& check, const EntryLocation& entry, SpeculationRecovery* recovery)
-{
-    ASSERT(check.m_nodeIndex == entry.m_nodeIndex);
-
-    // Link the jump from the Speculative path to here.
-    check.m_check.link(this);
-
-    // Does this speculation check require any additional recovery to be performed,
-    // to restore any state that has been overwritten before we enter back in to the
-    // non-speculative path.
-    if (recovery) {
-        // The only additional recovery we currently support is for integer add operation
-        ASSERT(recovery->type() == SpeculativeAdd);
-        // Revert the add.
-        sub32(gprToRegisterID(recovery->src()), gprToRegisterID(recovery->dest()));
-    }
-
-    // FIXME: - This is hideously inefficient!
-    // Where a value is live in a register in the speculative path, and is required in a register
-    // on the non-speculative path, we should not need to be spilling it and reloading (we may
-    // need to spill anyway, if the value is marked as spilled on the non-speculative path).
-    // This may also be spilling values that don't need spilling, e.g. are already spilled,
-    // are constants, or are arguments.
-
-    // Spill all GPRs in use by the speculative path.
-    for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
-        NodeIndex nodeIndex = check.m_gprInfo[gpr].nodeIndex;
-        if (nodeIndex == NoNode)
-            continue;
-
-        DataFormat dataFormat = check.m_gprInfo[gpr].format;
-        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
-
-        ASSERT(dataFormat == DataFormatInteger || DataFormatCell || dataFormat & DataFormatJS);
-        if (dataFormat == DataFormatInteger)
-            orPtr(tagTypeNumberRegister, gprToRegisterID(gpr));
-        storePtr(gprToRegisterID(gpr), addressFor(virtualRegister));
-    }
-
-    // Spill all FPRs in use by the speculative path.
-    for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
-        NodeIndex nodeIndex = check.m_fprInfo[fpr];
-        if (nodeIndex == NoNode)
-            continue;
-
-        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
-
-        moveDoubleToPtr(fprToRegisterID(fpr), regT0);
-        subPtr(tagTypeNumberRegister, regT0);
-        storePtr(regT0, addressFor(virtualRegister));
-    }
-
-    // Fill all FPRs in use by the non-speculative path.
-    for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
-        NodeIndex nodeIndex = entry.m_fprInfo[fpr];
-        if (nodeIndex == NoNode)
-            continue;
-
-        fillNumericToDouble(nodeIndex, fpr, gpr0);
-    }
-
-    // Fill all GPRs in use by the non-speculative path.
-    for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
-        NodeIndex nodeIndex = entry.m_gprInfo[gpr].nodeIndex;
-        if (nodeIndex == NoNode)
-            continue;
-
-        DataFormat dataFormat = entry.m_gprInfo[gpr].format;
-        if (dataFormat == DataFormatInteger)
-            fillInt32ToInteger(nodeIndex, gpr);
-        else {
-            ASSERT(dataFormat & DataFormatJS || dataFormat == DataFormatCell); // Treat cell as JSValue for now!
-            fillToJS(nodeIndex, gpr);
-            // FIXME: For subtypes of DataFormatJS, should jitAssert the subtype?
-        }
-    }
-
-    // Jump into the non-speculative path.
-    jump(entry.m_entry);
-}
-
-void JITCompiler::linkSpeculationChecks(SpeculativeJIT& speculative, NonSpeculativeJIT& nonSpeculative)
-{
-    // Iterators to walk over the set of bail outs & corresponding entry points.
-    SpeculationCheckVector::Iterator checksIter = speculative.speculationChecks().begin();
     SpeculationCheckVector::Iterator checksEnd = speculative.speculationChecks().end();
-    NonSpeculativeJIT::EntryLocationVector::Iterator entriesIter = nonSpeculative.entryLocations().begin();
-    NonSpeculativeJIT::EntryLocationVector::Iterator entriesEnd = nonSpeculative.entryLocations().end();
-
-    // Iterate over the speculation checks.
-    while (checksIter != checksEnd) {
-        // For every bail out from the speculative path, we must have provided an entry point
-        // into the non-speculative one.
-        ASSERT(checksIter->m_nodeIndex == entriesIter->m_nodeIndex);
-
-        // There may be multiple bail outs that map to the same entry point!
-        do {
-            ASSERT(checksIter != checksEnd);
-            ASSERT(entriesIter != entriesEnd);
-
-            // Plant code to link this speculation failure.
-            const SpeculationCheck& check = *checksIter;
-            const EntryLocation& entry = *entriesIter;
-            jumpFromSpeculativeToNonSpeculative(check, entry, speculative.speculationRecovery(check.m_recoveryIndex));
-             ++checksIter;
-        } while (checksIter != checksEnd && checksIter->m_nodeIndex == entriesIter->m_nodeIndex);
-         ++entriesIter;
+    for (SpeculationCheckVector::Iterator checksIter = speculative.speculationChecks().begin(); checksIter != checksEnd; ++checksIter) {
+        // Link the jump from the Speculative path to here.
+        checksIter->m_check.link(this);
+
+        // Count the failure, so that code whose speculations keep failing gets
+        // thrown away and recompiled with the types seen since.
+        add32(TrustedImm32(1), AbsoluteAddress(m_codeBlock->addressOfSpeculativeFailCounter()));
+
+        // All of the state of the bytecode is in the RegisterFile at the start of
+        // each instruction, so the baseline JIT code can pick up from there,
+        // re-executing the instruction that the check failed in.
+        void* target = baselineCodeBlock->machineCodeForBytecodeIndex(graph()[checksIter->m_nodeIndex].exceptionInfo);
+        ASSERT(target);
+        emitPutImmediateToCallFrameHeader(baselineCodeBlock, RegisterFile::CodeBlock);
+        move(TrustedImmPtr(target), regT1);
+        jump(regT1);
     }
-
-    // FIXME: https://bugs.webkit.org/show_bug.cgi?id=56289
-    ASSERT(!(checksIter != checksEnd));
-    ASSERT(!(entriesIter != entriesEnd));
 }
 
 void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
@@ -236,6 +83,12 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // so enter after this.
     Label fromArityCheck(this);
 
+    // If the speculations made by this code have failed too often, run the
+    // baseline JIT code instead, which will throw this code away once it gets
+    // hot again.
+    move(TrustedImmPtr(m_codeBlock->addressOfSpeculativeFailCounter()), regT1);
+    Jump speculationsFailing = branch32(AboveOrEqual, Address(regT1), TrustedImm32(CodeBlock::speculativeFailCounterThreshold));
+
     // Setup a pointer to the codeblock in the CallFrameHeader.
     emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
 
@@ -249,12 +102,11 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
 
     // === Stage 2 - Function body code generation ===
     //
-    // We generate the speculative code path, followed by the non-speculative
-    // code for the function. Next we need to link the two together, making
-    // bail-outs from the speculative path jump to the corresponding point on
-    // the non-speculative one (and generating any code necessary to juggle
-    // register values around, rebox values, and ensure spilled, to match the
-    // non-speculative path's requirements).
+    // We generate the speculative code path, guided by the types predicted from
+    // the baseline JIT's value profiles. Bail-outs from the speculative path are
+    // OSR exits, which jump into the baseline JIT code for the instruction that
+    // failed. If the speculative path cannot be generated at all we instead
+    // generate the non-speculative code for the function.
 
 #if DFG_JIT_BREAK_ON_EVERY_FUNCTION
     // Handy debug tool!
@@ -264,27 +116,24 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // First generate the speculative path.
     Label speculativePathBegin = label();
     SpeculativeJIT speculative(*this);
-    bool compiledSpeculative = speculative.compile();
-
-    // Next, generate the non-speculative path. We pass this a SpeculationCheckIndexIterator
-    // to allow it to check which nodes in the graph may bail out, and may need to reenter the
-    // non-speculative path.
-    if (compiledSpeculative) {
-        SpeculationCheckIndexIterator checkIterator(speculative.speculationChecks());
-        NonSpeculativeJIT nonSpeculative(*this);
-        nonSpeculative.compile(checkIterator);
-
-        // Link the bail-outs from the speculative path to the corresponding entry points into the non-speculative one.
-        linkSpeculationChecks(speculative, nonSpeculative);
+    Vector<Label> blockHeads;
+    if (speculative.compile()) {
+        linkOSRExits(speculative);
+        blockHeads = speculative.blockHeads();
+#if DFG_SPILL_STATS
+        speculative.dumpSpillStats("SpeculativeJIT");
+#endif
     } else {
         // If compilation through the SpeculativeJIT failed, throw away the code we generated.
         m_calls.clear();
         rewindToLabel(speculativePathBegin);
 
-        SpeculationCheckVector noChecks;
-        SpeculationCheckIndexIterator checkIterator(noChecks);
         NonSpeculativeJIT nonSpeculative(*this);
-        nonSpeculative.compile(checkIterator);
+        nonSpeculative.compile();
+        blockHeads = nonSpeculative.blockHeads();
+#if DFG_SPILL_STATS
+        nonSpeculative.dumpSpillStats("NonSpeculativeJIT");
+#endif
     }
 
     // === Stage 3 - Function footer code generation ===
@@ -318,6 +167,11 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
         jump(returnValueRegister2);
     }
 
+    // Continue in the baseline JIT code, just after it has stored the return address.
+    speculationsFailing.link(this);
+    move(TrustedImmPtr(m_codeBlock->alternative()->jitCodeEntryAfterReturnPC()), regT1);
+    jump(regT1);
+
     // Generate the register file check; if the fast check in the function head fails,
     // we need to call out to a helper function to check whether more space is available.
     // FIXME: change this from a cti call to a DFG style operation (normal C calling conventions).
@@ -372,8 +226,16 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     linkBuffer.link(callRegisterFileCheck, cti_register_file_check);
     linkBuffer.link(callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
 
+    // Record where the code for each basic block starts, so that loops running
+    // in the baseline JIT code can enter the optimized code at their header.
+    Vector<BasicBlock>& blocks = graph().m_blocks;
+    for (BlockIndex block = 0; block < blocks.size(); ++block)
+        m_codeBlock->addJITCodeMapEntry(blocks[block].bytecodeBegin, linkBuffer.offsetOf(blockHeads[block]));
+    m_codeBlock->setJITCodeEntryAfterReturnPCOffset(linkBuffer.offsetOf(fromArityCheck));
+
     entryWithArityCheck = linkBuffer.locationOf(arityCheck);
     entry = linkBuffer.finalizeCode();
+    m_codeBlock->setJITCode(entry, entryWithArityCheck);
 }
 
 #if DFG_JIT_ASSERT
@@ -42,12 +42,7 @@ class JSGlobalData;
 namespace DFG {
 
 class JITCodeGenerator;
-class NonSpeculativeJIT;
 class SpeculativeJIT;
-class SpeculationRecovery;
-
-struct EntryLocation;
-struct SpeculationCheck;
 
 // Abstracted sequential numbering of available machine registers (as opposed to MacroAssembler::RegisterID,
 // which are non-sequential, and not abstracted from the register numbering used by the underlying processor).
@@ -301,13 +296,24 @@ public:
     void emitCount(AbstractSamplingCounter&, uint32_t increment = 1);
 #endif
 
+#if ENABLE(GGC)
+    // Must accompany every store of a JSValue into a cell, as in the baseline JIT.
+    void writeBarrier(RegisterID owner, RegisterID scratch)
+    {
+        move(owner, scratch);
+        andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+        store32(TrustedImm32(1), Address(scratch, MarkedBlock::offsetOfIsDirty()));
+    }
+
+    void writeBarrier(JSCell* owner)
+    {
+        store32(TrustedImm32(1), MarkedBlock::blockFor(owner)->addressOfIsDirty());
+    }
+#endif
+
 private:
-    // These methods used in linking the speculative & non-speculative paths together.
-    void fillNumericToDouble(NodeIndex, FPRReg, GPRReg temporary);
-    void fillInt32ToInteger(NodeIndex, GPRReg);
-    void fillToJS(NodeIndex, GPRReg);
-    void jumpFromSpeculativeToNonSpeculative(const SpeculationCheck&, const EntryLocation&, SpeculationRecovery*);
-    void linkSpeculationChecks(SpeculativeJIT&, NonSpeculativeJIT&);
+    // Plants the OSR exits from the speculative path into the baseline JIT code.
+    void linkOSRExits(SpeculativeJIT&);
 
     // The globalData, used to access constants such as the vPtrs.
     JSGlobalData* m_globalData;
@@ -42,10 +42,13 @@
 #define DFG_DEBUG_LOCAL_DISBALE 0
 // Generate stats on how successful we were in making use of the DFG jit, and remaining on the hot path.
 #define DFG_SUCCESS_STATS 0
+// Dump the number of values spilled, filled and rematerialized by the register allocator for each function.
+#define DFG_SPILL_STATS 0
 
 
 #if ENABLE(DFG_JIT)
 
+#include "ValueProfile.h"
 #include <wtf/Vector.h>
 
 namespace JSC { namespace DFG {
@@ -179,6 +182,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
     {
     }
 
@@ -191,6 +195,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
         , m_opInfo(imm.m_value)
     {
     }
@@ -204,6 +209,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
         , m_opInfo(imm1.m_value)
     {
         m_constantValue.opInfo2 = imm2.m_value;
@@ -337,6 +343,9 @@ struct Node {
     VirtualRegister virtualRegister;
     // The number of uses of the result of this operation (+1 for 'must generate' nodes, which have side-effects).
     unsigned refCount;
+    // The kinds of value this node is expected to produce, from the types the
+    // baseline JIT has seen; the SpeculativeJIT only speculates on these.
+    PredictedType prediction;
 
 private:
     // An immediate value, accesses type-checked via accessors above.
@@ -74,61 +74,63 @@ public:
     }
 
     // Allocate a register - this function finds an unlocked register,
-    // locks it, and returns it. If any named registers exist, one
+    // locks it, and returns it. If any unnamed registers exist, one
     // of these should be selected to be allocated. If all unlocked
     // registers are named, then one of the named registers will need
     // to be spilled. In this case the register selected to be spilled
-    // will be one of the registers that has the lowest 'spillOrder'
-    // cost associated with it.
+    // will be the one for which the allocator's 'spillCost' is lowest;
+    // the allocator is passed the register's name and the 'spillOrder'
+    // hint associated with it.
     //
     // This method select the register to be allocated, and calls the
     // private 'allocateInternal' method to update internal data
     // structures accordingly.
-    RegID allocate(VirtualRegister &spillMe)
+    template<typename Allocator>
+    RegID allocate(VirtualRegister &spillMe, Allocator& allocator)
     {
-        uint32_t currentLowest = NUM_REGS;
-        SpillHint currentSpillOrder = SpillHintMax;
-
         // Scan through all register, starting at the last allocated & looping around.
         ASSERT(m_lastAllocated < NUM_REGS);
 
-        // This loop is broken into two halves, looping from the last allocated
+        // These loops are broken into two halves, looping from the last allocated
         // register (the register returned last time this method was called) to
         // the maximum register value, then from 0 to the last allocated.
         // This implements a simple round-robin like approach to try to reduce
         // thrash, and minimize time spent scanning locked registers in allocation.
-        // If a unlocked and unnamed register is found return it immediately.
-        // Otherwise, find the first unlocked register with the lowest spillOrder.
+        // If a unlocked and unnamed register is found return it immediately –
+        // unassigned registers have spill order 0.
+        for (uint32_t i = m_lastAllocated + 1; i < NUM_REGS; ++i) {
+            if (!m_data[i].lockCount && !m_data[i].spillOrder)
+                return allocateInternal(i, spillMe);
+        }
+        for (uint32_t i = 0; i <= m_lastAllocated; ++i) {
+            if (!m_data[i].lockCount && !m_data[i].spillOrder)
+                return allocateInternal(i, spillMe);
+        }
+
+        // Otherwise, find the first unlocked register with the lowest spill cost.
+        uint32_t currentLowest = NUM_REGS;
+        uint32_t currentSpillCost = UINT_MAX;
         for (uint32_t i = m_lastAllocated + 1; i < NUM_REGS; ++i) {
-            // (1) If the current register is locked, it is not a candidate.
             if (m_data[i].lockCount)
                 continue;
-            // (2) If the current register's spill order is 0, pick this! – unassigned registers have spill order 0.
-            SpillHint spillOrder = m_data[i].spillOrder;
-            if (!spillOrder)
-                return allocateInternal(i, spillMe);
-            // If this register is better (has a lower spill order value) than any prior
-            // candidate, then record it.
-            if (spillOrder < currentSpillOrder) {
-                currentSpillOrder = spillOrder;
+            uint32_t spillCost = allocator.spillCost(m_data[i].name, m_data[i].spillOrder);
+            if (spillCost < currentSpillCost) {
+                currentSpillCost = spillCost;
                 currentLowest = i;
             }
         }
-        // Loop over the remaining entries.
         for (uint32_t i = 0; i <= m_lastAllocated; ++i) {
             if (m_data[i].lockCount)
                 continue;
-            SpillHint spillOrder = m_data[i].spillOrder;
-            if (!spillOrder)
-                return allocateInternal(i, spillMe);
-            if (spillOrder < currentSpillOrder) {
-                currentSpillOrder = spillOrder;
+            uint32_t spillCost = allocator.spillCost(m_data[i].name, m_data[i].spillOrder);
+            if (spillCost < currentSpillCost) {
+                currentSpillCost = spillCost;
                 currentLowest = i;
             }
         }
 
         // Deadlock check - this could only occur is all registers are locked!
-        ASSERT(currentLowest != NUM_REGS && currentSpillOrder != SpillHintMax);
+        ASSERT(currentLowest != NUM_REGS);
         // There were no available registers; currentLowest will need to be spilled.
         return allocateInternal(currentLowest, spillMe);
     }
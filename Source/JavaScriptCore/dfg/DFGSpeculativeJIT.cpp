@@ -44,33 +44,43 @@ GPRReg SpeculativeJIT::fillSpeculateIntInternal(NodeIndex nodeIndex, DataFormat&
 
         if (node.isConstant()) {
             m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+            ++m_rematerializationCount;
             if (isInt32Constant(nodeIndex)) {
                 m_jit.move(MacroAssembler::Imm32(valueOfInt32Constant(nodeIndex)), reg);
                 info.fillInteger(gpr);
                 returnFormat = DataFormatInteger;
                 return gpr;
             }
+            // Integral doubles are predicted to be int32s, so may be used as integers.
+            int32_t value;
+            if (isDoubleConstantWithInt32Value(nodeIndex, value)) {
+                m_jit.move(MacroAssembler::Imm32(value), reg);
+                info.fillInteger(gpr);
+                returnFormat = DataFormatInteger;
+                return gpr;
+            }
             m_jit.move(constantAsJSValueAsImmPtr(nodeIndex), reg);
         } else {
             DataFormat spillFormat = info.spillFormat();
             ASSERT(spillFormat & DataFormatJS);
 
             m_gprs.retain(gpr, virtualRegister, SpillOrderSpilled);
+            ++m_fillCount;
 
             if (spillFormat == DataFormatJSInteger) {
                 // If we know this was spilled as an integer we can fill without checking.
                 if (strict) {
-                    m_jit.load32(JITCompiler::addressFor(virtualRegister), reg);
+                    m_jit.load32(spillSlotFor(virtualRegister), reg);
                     info.fillInteger(gpr);
                     returnFormat = DataFormatInteger;
                     return gpr;
                 }
-                m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+                m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
                 info.fillJSValue(gpr, DataFormatJSInteger);
                 returnFormat = DataFormatJSInteger;
                 return gpr;
             }
-            m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+            m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
         }
 
         // Fill as JSValue, and fall through.
@@ -140,29 +150,10 @@ GPRReg SpeculativeJIT::fillSpeculateIntInternal(NodeIndex nodeIndex, DataFormat&
     return InvalidGPRReg;
 }
 
-SpeculationCheck::SpeculationCheck(MacroAssembler::Jump check, SpeculativeJIT* jit, unsigned recoveryIndex)
+SpeculationCheck::SpeculationCheck(MacroAssembler::Jump check, SpeculativeJIT* jit)
     : m_check(check)
     , m_nodeIndex(jit->m_compileIndex)
-    , m_recoveryIndex(recoveryIndex)
 {
-    for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
-        VirtualRegister virtualRegister = jit->m_gprs.name(gpr);
-        if (virtualRegister != InvalidVirtualRegister) {
-            GenerationInfo& info =  jit->m_generationInfo[virtualRegister];
-            m_gprInfo[gpr].nodeIndex = info.nodeIndex();
-            m_gprInfo[gpr].format = info.registerFormat();
-        } else
-            m_gprInfo[gpr].nodeIndex = NoNode;
-    }
-    for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
-        VirtualRegister virtualRegister = jit->m_fprs.name(fpr);
-        if (virtualRegister != InvalidVirtualRegister) {
-            GenerationInfo& info =  jit->m_generationInfo[virtualRegister];
-            ASSERT(info.registerFormat() == DataFormatDouble);
-            m_fprInfo[fpr] = info.nodeIndex();
-        } else
-            m_fprInfo[fpr] = NoNode;
-    }
 }
 
 GPRReg SpeculativeJIT::fillSpeculateInt(NodeIndex nodeIndex, DataFormat& returnFormat)
@@ -191,6 +182,7 @@ GPRReg SpeculativeJIT::fillSpeculateCell(NodeIndex nodeIndex)
 
         if (node.isConstant()) {
             m_gprs.retain(gpr, virtualRegister, SpillOrderConstant);
+            ++m_rematerializationCount;
             JSValue jsValue = constantAsJSValue(nodeIndex);
             if (jsValue.isCell()) {
                 m_jit.move(MacroAssembler::TrustedImmPtr(jsValue.asCell()), reg);
@@ -202,7 +194,8 @@ GPRReg SpeculativeJIT::fillSpeculateCell(NodeIndex nodeIndex)
         }
         ASSERT(info.spillFormat() & DataFormatJS);
         m_gprs.retain(gpr, virtualRegister, SpillOrderSpilled);
-        m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), reg);
+        ++m_fillCount;
+        m_jit.loadPtr(spillSlotFor(virtualRegister), reg);
 
         if (info.spillFormat() != DataFormatJSCell)
             speculationCheck(m_jit.branchTestPtr(MacroAssembler::NonZero, reg, JITCompiler::tagMaskRegister));
@@ -239,6 +232,56 @@ GPRReg SpeculativeJIT::fillSpeculateCell(NodeIndex nodeIndex)
     return InvalidGPRReg;
 }
 
+static JITCompiler::Condition invert(JITCompiler::Condition condition)
+{
+    switch (condition) {
+    case JITCompiler::LessThan:
+        return JITCompiler::GreaterThanOrEqual;
+    case JITCompiler::LessThanOrEqual:
+        return JITCompiler::GreaterThan;
+    case JITCompiler::Equal:
+        return JITCompiler::NotEqual;
+    default:
+        ASSERT_NOT_REACHED();
+        return condition;
+    }
+}
+
+bool SpeculativeJIT::compilePeepHoleBranch(Node& node, JITCompiler::Condition condition)
+{
+    // Fuse the compare with the Branch that follows it if that is its only use
+    // (besides the artificial one from being MustGenerate).
+    NodeIndex branchNodeIndex = m_compileIndex + 1;
+    if (node.refCount != 2 || branchNodeIndex >= m_jit.graph().m_blocks[m_block].end)
+        return false;
+    Node& branchNode = m_jit.graph()[branchNodeIndex];
+    if (branchNode.op != Branch || branchNode.child1 != m_compileIndex)
+        return false;
+
+    BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(branchNode.takenBytecodeOffset());
+    BlockIndex notTaken = m_jit.graph().blockIndexForBytecodeOffset(branchNode.notTakenBytecodeOffset());
+
+    // If we can fall through to the taken block, branch to the other one instead.
+    if (taken == (m_block + 1)) {
+        condition = invert(condition);
+        std::swap(taken, notTaken);
+    }
+
+    SpeculateIntegerOperand op1(this, node.child1);
+    SpeculateIntegerOperand op2(this, node.child2);
+
+    addBranch(m_jit.branch32(condition, op1.registerID(), op2.registerID()), taken);
+    if (notTaken != (m_block + 1))
+        addBranch(m_jit.jump(), notTaken);
+
+    // The compare's boolean result is never materialized; the Branch is its last use.
+    noResult(m_compileIndex);
+    use(m_compileIndex);
+    m_compileIndex = branchNodeIndex;
+    noResult(m_compileIndex);
+    return true;
+}
+
 bool SpeculativeJIT::compile(Node& node)
 {
     checkConsistency();
@@ -252,8 +295,15 @@ bool SpeculativeJIT::compile(Node& node)
         break;
 
     case GetLocal: {
+        // Values that can be filled from the local are loaded only where they are used.
+        if (m_jit.graph().canReloadFromLocal(m_compileIndex, node.local(), m_compileIndex)) {
+            initLocalInfo(m_compileIndex);
+            break;
+        }
+
         GPRTemporary result(this);
         m_jit.loadPtr(JITCompiler::addressFor(node.local()), result.registerID());
+        ++m_fillCount;
         jsValueResult(result.gpr(), m_compileIndex);
         break;
     }
@@ -261,6 +311,7 @@ bool SpeculativeJIT::compile(Node& node)
     case SetLocal: {
         JSValueOperand value(this, node.child1);
         m_jit.storePtr(value.registerID(), JITCompiler::addressFor(node.local()));
+        storedToLocal(node);
         noResult(m_compileIndex);
         break;
     }
@@ -320,6 +371,11 @@ bool SpeculativeJIT::compile(Node& node)
         break;
 
     case UInt32ToNumber: {
+        if (!isInteger(m_compileIndex) || instructionHasCalledOut()) {
+            nonSpeculativeUInt32ToNumber(node);
+            break;
+        }
+
         IntegerOperand op1(this, node.child1);
         GPRTemporary result(this, op1);
 
@@ -332,6 +388,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case NumberToInt32: {
+        if (!isInteger(node.child1)) {
+            nonSpeculativeValueToInt32(node);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         GPRTemporary result(this, op1);
         m_jit.move(op1.registerID(), result.registerID());
@@ -348,6 +409,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ValueToInt32: {
+        if (!isInteger(node.child1) || instructionHasCalledOut()) {
+            nonSpeculativeValueToInt32(node);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         GPRTemporary result(this, op1);
         m_jit.move(op1.registerID(), result.registerID());
@@ -356,6 +422,12 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ValueToNumber: {
+        // Values that have not been seen yet are speculated to be integers.
+        if ((!isInteger(node.child1) && m_jit.graph()[node.child1].prediction) || instructionHasCalledOut()) {
+            nonSpeculativeValueToNumber(node);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         GPRTemporary result(this, op1);
         m_jit.move(op1.registerID(), result.registerID());
@@ -365,6 +437,14 @@ bool SpeculativeJIT::compile(Node& node)
 
     case ValueAdd:
     case ArithAdd: {
+        if (!isInteger(m_compileIndex)) {
+            if (op == ValueAdd)
+                nonSpeculativeValueAdd(node);
+            else
+                nonSpeculativeArithmetic(node);
+            break;
+        }
+
         int32_t imm1;
         if (isDoubleConstantWithInt32Value(node.child1, imm1)) {
             SpeculateIntegerOperand op2(this, node.child2);
@@ -393,23 +473,20 @@ bool SpeculativeJIT::compile(Node& node)
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
 
-        GPRReg gpr1 = op1.gpr();
-        GPRReg gpr2 = op2.gpr();
-        GPRReg gprResult = result.gpr();
-        MacroAssembler::Jump check = m_jit.branchAdd32(MacroAssembler::Overflow, JITCompiler::gprToRegisterID(gpr1), JITCompiler::gprToRegisterID(gpr2), JITCompiler::gprToRegisterID(gprResult));
-
-        if (gpr1 == gprResult)
-            speculationCheck(check, SpeculationRecovery(SpeculativeAdd, gprResult, gpr2));
-        else if (gpr2 == gprResult)
-            speculationCheck(check, SpeculationRecovery(SpeculativeAdd, gprResult, gpr1));
-        else
-            speculationCheck(check);
+        MacroAssembler::RegisterID reg1 = op1.registerID();
+        MacroAssembler::RegisterID reg2 = op2.registerID();
+        speculationCheck(m_jit.branchAdd32(MacroAssembler::Overflow, reg1, reg2, result.registerID()));
 
-        integerResult(gprResult, m_compileIndex);
+        integerResult(result.gpr(), m_compileIndex);
         break;
     }
 
     case ArithSub: {
+        if (!isInteger(m_compileIndex)) {
+            nonSpeculativeArithmetic(node);
+            break;
+        }
+
         int32_t imm2;
         if (isDoubleConstantWithInt32Value(node.child2, imm2)) {
             SpeculateIntegerOperand op1(this, node.child1);
@@ -435,6 +512,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ArithMul: {
+        if (!isInteger(m_compileIndex)) {
+            nonSpeculativeArithmetic(node);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this);
@@ -452,29 +534,48 @@ bool SpeculativeJIT::compile(Node& node)
         break;
     }
 
-    case ArithDiv: {
-        SpeculateIntegerOperand op1(this, node.child1);
-        SpeculateIntegerOperand op2(this, node.child2);
-        GPRTemporary result(this, op1, op2);
-
-        terminateSpeculativeExecution();
-
-        integerResult(result.gpr(), m_compileIndex);
+    case ArithDiv:
+        // The quotient of two integers is rarely an integer, so is never speculated to be one.
+        nonSpeculativeArithmetic(node);
         break;
-    }
 
     case ArithMod: {
+        if (!isInteger(m_compileIndex)) {
+            nonSpeculativeArithMod(node);
+            break;
+        }
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
-        GPRTemporary result(this, op1, op2);
+        FPRTemporary arg1(this);
+        FPRTemporary arg2(this);
+        m_jit.convertInt32ToDouble(op1.registerID(), arg1.registerID());
+        m_jit.convertInt32ToDouble(op2.registerID(), arg2.registerID());
+        FPRReg arg1FPR = arg1.fpr();
+        FPRReg arg2FPR = arg2.fpr();
+        flushRegisters();
 
-        terminateSpeculativeExecution();
+        FPRResult remainder(this);
+        callOperation(fmod, remainder.fpr(), arg1FPR, arg2FPR);
+
+        // The remainder is not an int32 if the divisor was zero (NaN), or if it is -0.
+        GPRTemporary result(this);
+        speculationCheck(m_jit.branchTruncateDoubleToInt32(remainder.registerID(), result.registerID(), MacroAssembler::BranchIfTruncateFailed));
+        MacroAssembler::Jump nonZero = m_jit.branchTest32(MacroAssembler::NonZero, result.registerID());
+        m_jit.moveDoubleToPtr(remainder.registerID(), result.registerID());
+        speculationCheck(m_jit.branchTestPtr(MacroAssembler::NonZero, result.registerID()));
+        nonZero.link(&m_jit);
 
         integerResult(result.gpr(), m_compileIndex);
         break;
     }
 
     case LogicalNot: {
+        if (!isBooleanPrediction(m_jit.graph()[node.child1].prediction) && m_jit.graph()[node.child1].prediction) {
+            nonSpeculativeLogicalNot(node);
+            break;
+        }
+
         JSValueOperand value(this, node.child1);
         GPRTemporary result(this); // FIXME: We could reuse, but on speculation fail would need recovery to restore tag (akin to add).
 
@@ -489,6 +590,13 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareLess: {
+        if (!shouldSpeculateInteger(node.child1, node.child2)) {
+            nonSpeculativeCompare(node, operationCompareLess);
+            break;
+        }
+        if (compilePeepHoleBranch(node, JITCompiler::LessThan))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -502,6 +610,13 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareLessEq: {
+        if (!shouldSpeculateInteger(node.child1, node.child2)) {
+            nonSpeculativeCompare(node, operationCompareLessEq);
+            break;
+        }
+        if (compilePeepHoleBranch(node, JITCompiler::LessThanOrEqual))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -515,6 +630,13 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareEq: {
+        if (!shouldSpeculateInteger(node.child1, node.child2)) {
+            nonSpeculativeCompare(node, operationCompareEq);
+            break;
+        }
+        if (compilePeepHoleBranch(node, JITCompiler::Equal))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -528,6 +650,13 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case CompareStrictEq: {
+        if (!shouldSpeculateInteger(node.child1, node.child2)) {
+            nonSpeculativeCompare(node, operationCompareStrictEq);
+            break;
+        }
+        if (compilePeepHoleBranch(node, JITCompiler::Equal))
+            break;
+
         SpeculateIntegerOperand op1(this, node.child1);
         SpeculateIntegerOperand op2(this, node.child2);
         GPRTemporary result(this, op1, op2);
@@ -541,6 +670,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case GetByVal: {
+        if (!shouldSpeculateArrayAccess(node)) {
+            nonSpeculativeGetByVal(node);
+            break;
+        }
+
         NodeIndex alias = node.child3;
         if (alias != NoNode) {
             // FIXME: result should be able to reuse child1, child2. Should have an 'UnusedOperand' type.
@@ -579,6 +713,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case PutByVal: {
+        if (!shouldSpeculateArrayAccess(node)) {
+            nonSpeculativePutByVal(node);
+            break;
+        }
+
         SpeculateCellOperand base(this, node.child1);
         SpeculateStrictInt32Operand property(this, node.child2);
         JSValueOperand value(this, node.child3);
@@ -594,6 +733,10 @@ bool SpeculativeJIT::compile(Node& node)
         speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseReg), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
         speculationCheck(m_jit.branch32(MacroAssembler::AboveOrEqual, propertyReg, MacroAssembler::Address(baseReg, JSArray::vectorLengthOffset())));
 
+#if ENABLE(GGC)
+        m_jit.writeBarrier(baseReg, storageReg);
+#endif
+
         // Get the array storage.
         m_jit.loadPtr(MacroAssembler::Address(baseReg, JSArray::storageOffset()), storageReg);
 
@@ -618,9 +761,23 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case PutByValAlias: {
+        // The GetByVal this aliases checked the base and property only if it speculated too.
+        if (!shouldSpeculateArrayAccess(node)) {
+            nonSpeculativePutByVal(node);
+            break;
+        }
+
         SpeculateCellOperand base(this, node.child1);
         SpeculateStrictInt32Operand property(this, node.child2);
         JSValueOperand value(this, node.child3);
+
+#if ENABLE(GGC)
+        {
+            GPRTemporary scratch(this);
+            m_jit.writeBarrier(base.registerID(), scratch.registerID());
+        }
+#endif
+
         GPRTemporary storage(this, base); // storage may overwrite base.
 
         // Get the array storage.
@@ -647,6 +804,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case Branch: {
+        if (m_jit.graph()[node.child1].prediction & ~(PredictInt32 | PredictBoolean)) {
+            nonSpeculativeBranch(node);
+            break;
+        }
+
         JSValueOperand value(this, node.child1);
         MacroAssembler::RegisterID valueReg = value.registerID();
 
@@ -699,6 +861,11 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case ConvertThis: {
+        if (!isCellPrediction(m_jit.graph()[node.child1].prediction)) {
+            nonSpeculativeConvertThis(node);
+            break;
+        }
+
         SpeculateCellOperand thisValue(this, node.child1);
         GPRTemporary temp(this);
 
@@ -710,6 +877,24 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case GetById: {
+        if (isArrayPrediction(m_jit.graph()[node.child1].prediction) && *identifier(node.identifierNumber()) == m_jit.globalData()->propertyNames->length) {
+            SpeculateCellOperand base(this, node.child1);
+            GPRTemporary result(this, base);
+
+            MacroAssembler::RegisterID baseReg = base.registerID();
+            MacroAssembler::RegisterID resultReg = result.registerID();
+
+            // Array lengths are loaded inline; anything that isn't a JSArray, or whose length
+            // does not fit in an int32, is left to the baseline JIT's get_by_id.
+            speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseReg), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
+            m_jit.loadPtr(MacroAssembler::Address(baseReg, JSArray::storageOffset()), resultReg);
+            m_jit.load32(MacroAssembler::Address(resultReg, OBJECT_OFFSETOF(ArrayStorage, m_length)), resultReg);
+            speculationCheck(m_jit.branch32(MacroAssembler::LessThan, resultReg, MacroAssembler::TrustedImm32(0)));
+
+            integerResult(result.gpr(), m_compileIndex);
+            break;
+        }
+
         JSValueOperand base(this, node.child1);
         GPRReg baseGPR = base.gpr();
         flushRegisters();
@@ -760,6 +945,9 @@ bool SpeculativeJIT::compile(Node& node)
         GPRTemporary temp(this);
 
         JSVariableObject* globalObject = m_jit.codeBlock()->globalObject();
+#if ENABLE(GGC)
+        m_jit.writeBarrier(globalObject);
+#endif
         m_jit.loadPtr(globalObject->addressOfRegisters(), temp.registerID());
         m_jit.storePtr(value.registerID(), JITCompiler::addressForGlobalVar(temp.registerID(), node.varNumber()));
 
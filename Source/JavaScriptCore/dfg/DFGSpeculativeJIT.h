@@ -34,59 +34,18 @@ namespace JSC { namespace DFG {
 
 class SpeculativeJIT;
 
-// This enum describes the types of additional recovery that
-// may need be performed should a speculation check fail.
-enum SpeculationRecoveryType {
-    SpeculativeAdd
-};
-
-// === SpeculationRecovery ===
-//
-// This class provides additional information that may be associated with a
-// speculation check - for example 
-class SpeculationRecovery {
-public:
-    SpeculationRecovery(SpeculationRecoveryType type, GPRReg dest, GPRReg src)
-        : m_type(type)
-        , m_dest(dest)
-        , m_src(src)
-    {
-    }
-
-    SpeculationRecoveryType type() { return m_type; }
-    GPRReg dest() { return m_dest; }
-    GPRReg src() { return m_src; }
-
-private:
-    // Indicates the type of additional recovery to be performed.
-    SpeculationRecoveryType m_type;
-    // different recovery types may required different additional information here.
-    GPRReg m_dest;
-    GPRReg m_src;
-};
-
 // === SpeculationCheck ===
 //
-// This structure records a bail-out from the speculative path,
-// which will need to be linked in to the non-speculative one.
+// This structure records a bail-out from the speculative path. Each bail-out
+// is an OSR exit: it leaves the optimized code for the baseline JIT code of
+// the instruction that the node was generated for.
 struct SpeculationCheck {
-    SpeculationCheck(MacroAssembler::Jump, SpeculativeJIT*, unsigned recoveryIndex = 0);
+    SpeculationCheck(MacroAssembler::Jump, SpeculativeJIT*);
 
     // The location of the jump out from the speculative path, 
     // and the node we were generating code for.
     MacroAssembler::Jump m_check;
     NodeIndex m_nodeIndex;
-    // Used to record any additional recovery to be performed; this
-    // value is an index into the SpeculativeJIT's m_speculationRecoveryList
-    // array, offset by 1. (m_recoveryIndex == 0) means no recovery.
-    unsigned m_recoveryIndex;
-
-    struct RegisterInfo {
-        NodeIndex nodeIndex;
-        DataFormat format;
-    };
-    RegisterInfo m_gprInfo[numberOfGPRs];
-    NodeIndex m_fprInfo[numberOfFPRs];
 };
 typedef SegmentedVector<SpeculationCheck, 16> SpeculationCheckVector;
 
@@ -95,12 +54,13 @@ typedef SegmentedVector<SpeculationCheck, 16> SpeculationCheckVector;
 //
 // The SpeculativeJIT is used to generate a fast, but potentially
 // incomplete code path for the dataflow. When code generating
-// we may make assumptions about operand types, dynamically check,
-// and bail-out to an alternate code path if these checks fail.
-// Importantly, the speculative code path cannot be reentered once
-// a speculative check has failed. This allows the SpeculativeJIT
-// to propagate type information (including information that has
-// only speculatively been asserted) through the dataflow.
+// we make assumptions about operand types where the value profiles
+// gathered by the baseline JIT predict them, dynamically check, and
+// bail-out to the baseline JIT code if these checks fail. Importantly,
+// the speculative code path cannot be reentered once a speculative
+// check has failed. This allows the SpeculativeJIT to propagate type
+// information (including information that has only speculatively been
+// asserted) through the dataflow.
 class SpeculativeJIT : public JITCodeGenerator {
     friend struct SpeculationCheck;
 public:
@@ -112,18 +72,11 @@ public:
 
     bool compile();
 
-    // Retrieve the list of bail-outs from the speculative path,
-    // and additional recovery information.
+    // Retrieve the list of bail-outs from the speculative path.
     SpeculationCheckVector& speculationChecks()
     {
         return m_speculationChecks;
     }
-    SpeculationRecovery* speculationRecovery(size_t index)
-    {
-        // SpeculationCheck::m_recoveryIndex is offset by 1,
-        // 0 means no recovery.
-        return index ? &m_speculationRecoveryList[index - 1] : 0;
-    }
 
     // Called by the speculative operand types, below, to fill operand to
     // machine registers, implicitly generating speculation checks as needed.
@@ -135,6 +88,10 @@ private:
     bool compile(Node&);
     bool compile(BasicBlock&);
 
+    // Generates a compare and the Branch that uses it as a single conditional
+    // jump. Returns false if the compare's result is needed for anything else.
+    bool compilePeepHoleBranch(Node&, JITCompiler::Condition);
+
     bool isDoubleConstantWithInt32Value(NodeIndex nodeIndex, int32_t& out)
     {
         if (!m_jit.isDoubleConstant(nodeIndex))
@@ -151,16 +108,38 @@ private:
         return true;
     }
 
-    // Add a speculation check without additional recovery.
-    void speculationCheck(MacroAssembler::Jump jumpToFail)
+    // Check the predictions the ByteCodeParser made from the value profiles.
+    bool isInteger(NodeIndex nodeIndex)
     {
-        m_speculationChecks.append(SpeculationCheck(jumpToFail, this));
+        return isInt32Prediction(m_jit.graph()[nodeIndex].prediction);
+    }
+    bool shouldSpeculateInteger(NodeIndex op1, NodeIndex op2)
+    {
+        return isInteger(op1) && isInteger(op2);
+    }
+    bool shouldSpeculateArrayAccess(Node& node)
+    {
+        return isArrayPrediction(m_jit.graph()[node.child1].prediction) && isInteger(node.child2);
     }
-    // Add a speculation check with additional recovery.
-    void speculationCheck(MacroAssembler::Jump jumpToFail, const SpeculationRecovery& recovery)
+
+    // Since a failed check re-executes the whole instruction, nothing may
+    // speculate after the instruction has called a helper that may have run
+    // JavaScript, or its effects would happen twice. For example, in 'x - y'
+    // with an object x, ToNumber(x) calls x.valueOf, so ToNumber(y) must not
+    // then speculate that y is an integer.
+    bool instructionHasCalledOut()
+    {
+        return m_lastNodeThatCalledOut != NoNode
+            && m_jit.graph()[m_lastNodeThatCalledOut].exceptionInfo == m_jit.graph()[m_compileIndex].exceptionInfo;
+    }
+
+    // Add a speculation check. No recovery is needed when the check fails,
+    // since the baseline JIT code re-executes the whole instruction from the
+    // state in the RegisterFile, which is only written by SetLocal nodes after
+    // all the checks for the instruction.
+    void speculationCheck(MacroAssembler::Jump jumpToFail)
     {
-        m_speculationRecoveryList.append(recovery);
-        m_speculationChecks.append(SpeculationCheck(jumpToFail, this, m_speculationRecoveryList.size()));
+        m_speculationChecks.append(SpeculationCheck(jumpToFail, this));
     }
 
     // Called when we statically determine that a speculation will fail.
@@ -180,12 +159,8 @@ private:
     // will make conflicting speculations about the same operand). In such cases this
     // flag is set, indicating no further code generation should take place.
     bool m_didTerminate;
-    // This vector tracks bail-outs from the speculative path to the non-speculative one.
+    // This vector tracks bail-outs from the speculative path to the baseline JIT code.
     SpeculationCheckVector m_speculationChecks;
-    // Some bail-outs need to record additional information recording specific recovery
-    // to be performed (for example, on detected overflow from an add, we may need to
-    // reverse the addition if an operand is being overwritten).
-    Vector<SpeculationRecovery, 16> m_speculationRecoveryList;
 };
 
 
@@ -197,7 +172,7 @@ private:
 // SpeculativeJIT. The classes operate like those provided by the JITCodeGenerator,
 // however these will perform a speculative check for a more restrictive type than
 // we can statically determine the operand to have. If the operand does not have
-// the requested type, a bail-out to the non-speculative path will be taken.
+// the requested type, a bail-out to the baseline JIT code will be taken.
 
 class SpeculateIntegerOperand {
 public:
@@ -334,37 +309,6 @@ private:
 };
 
 
-// === SpeculationCheckIndexIterator ===
-//
-// This class is used by the non-speculative JIT to check which
-// nodes require entry points from the speculative path.
-class SpeculationCheckIndexIterator {
-public:
-    SpeculationCheckIndexIterator(SpeculationCheckVector& speculationChecks)
-        : m_speculationChecks(speculationChecks)
-        , m_iter(m_speculationChecks.begin())
-        , m_end(m_speculationChecks.end())
-    {
-    }
-
-    bool hasCheckAtIndex(NodeIndex nodeIndex)
-    {
-        while (m_iter != m_end) {
-            NodeIndex current = m_iter->m_nodeIndex;
-            if (current >= nodeIndex)
-                return current == nodeIndex;
-            ++m_iter;
-        }
-        return false;
-    }
-
-private:
-    SpeculationCheckVector& m_speculationChecks;
-    SpeculationCheckVector::Iterator m_iter;
-    SpeculationCheckVector::Iterator m_end;
-};
-
-
 } } // namespace JSC::DFG
 
 #endif
@@ -48,6 +48,12 @@ public:
     size_t size();
     JSCell** roots();
 
+    // Every word add() was given, and how many of those the MarkedSpace's
+    // block filter could not rule out, so they cost a hash lookup. Lookups
+    // that did not produce a root are the filter's false positives.
+    size_t candidateCount() const { return m_candidateCount; }
+    size_t blockLookupCount() const { return m_blockLookupCount; }
+
 private:
     static const size_t inlineCapacity = 128;
     static const size_t nonInlineCapacity = 8192 / sizeof(JSCell*);
@@ -58,6 +64,8 @@ private:
     JSCell** m_roots;
     size_t m_size;
     size_t m_capacity;
+    size_t m_candidateCount;
+    size_t m_blockLookupCount;
     JSCell* m_inlineRoots[inlineCapacity];
 };
 
@@ -66,6 +74,8 @@ inline ConservativeRoots::ConservativeRoots(Heap* heap)
     , m_roots(m_inlineRoots)
     , m_size(0)
     , m_capacity(inlineCapacity)
+    , m_candidateCount(0)
+    , m_blockLookupCount(0)
 {
 }
 
@@ -77,7 +87,15 @@ inline ConservativeRoots::~ConservativeRoots()
 
 inline void ConservativeRoots::add(void* p)
 {
-    if (!m_heap->contains(p))
+    ++m_candidateCount;
+    m_heap->copiedSpace().pinIfNecessary(p);
+
+    MarkedSpace& markedSpace = m_heap->markedSpace();
+    if (!markedSpace.mayContain(p))
+        return;
+
+    ++m_blockLookupCount;
+    if (!markedSpace.contains(p))
         return;
 
     if (m_size == m_capacity)
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "CopiedSpace.h"
+
+#include "Heap.h"
+
+namespace JSC {
+
+CopiedBlock* CopiedBlock::create()
+{
+    PageAllocationAligned allocation = PageAllocationAligned::allocate(blockSize, blockSize, OSAllocator::JSGCHeapPages);
+    if (!static_cast<bool>(allocation))
+        CRASH();
+    return new (allocation.base()) CopiedBlock(allocation);
+}
+
+void CopiedBlock::destroy(CopiedBlock* block)
+{
+    block->m_allocation.deallocate();
+}
+
+CopiedBlock::CopiedBlock(const PageAllocationAligned& allocation)
+    : m_allocation(allocation)
+    , m_offset(payload())
+    , m_isPinned(false)
+    , m_isEvacuating(false)
+    , m_prev(0)
+    , m_next(0)
+{
+}
+
+CopiedSpace::CopiedSpace(Heap* heap)
+    : m_heap(heap)
+    , m_currentBlock(0)
+    , m_blockCount(0)
+    , m_isCompacting(false)
+    , m_copyingEpoch(0)
+{
+}
+
+CopiedSpace::~CopiedSpace()
+{
+    ASSERT(m_fromSpace.isEmpty());
+    while (CopiedBlock* block = m_toSpace.head()) {
+        m_toSpace.remove(block);
+        m_blockSet.remove(block);
+        CopiedBlock::destroy(block);
+    }
+    shrink();
+}
+
+CopiedBlock* CopiedSpace::getFreeBlock()
+{
+    if (m_freeBlocks.isEmpty())
+        return 0;
+    CopiedBlock* block = m_freeBlocks.last();
+    m_freeBlocks.removeLast();
+    return block;
+}
+
+void* CopiedSpace::allocateSlowCase(size_t bytes)
+{
+    CopiedBlock* block = getFreeBlock();
+    if (!block) {
+        block = CopiedBlock::create();
+        m_blockSet.add(block);
+        m_blockFilter.add(reinterpret_cast<Bits>(block));
+    }
+    m_toSpace.append(block);
+    ++m_blockCount;
+    m_currentBlock = block;
+
+    // Backing stores count towards the next collection a block at a time.
+    m_heap->markedSpace().addToWaterMark(CopiedBlock::blockSize);
+
+    void* result = block->tryAllocate(bytes);
+    ASSERT(result);
+    return result;
+}
+
+void CopiedSpace::startedCopying(bool shouldCompact)
+{
+    ASSERT(m_fromSpace.isEmpty());
+    ASSERT(m_newBlocksForCopying.isEmpty());
+
+    m_isCompacting = shouldCompact;
+    if (!shouldCompact)
+        return;
+
+    ++m_copyingEpoch;
+    m_currentBlock = 0;
+    while (CopiedBlock* block = m_toSpace.head()) {
+        m_toSpace.remove(block);
+        block->m_isPinned = false;
+        block->m_isEvacuating = true;
+        m_fromSpace.append(block);
+    }
+}
+
+CopiedBlock* CopiedSpace::allocateBlockForCopying()
+{
+    ASSERT(m_isCompacting);
+#if ENABLE(PARALLEL_GC)
+    MutexLocker locker(m_copyingLock);
+#endif
+
+    // Other marking threads may be looking blocks up in m_blockSet, so new
+    // blocks only join it once copying is done.
+    CopiedBlock* block = getFreeBlock();
+    if (!block) {
+        block = CopiedBlock::create();
+        m_newBlocksForCopying.append(block);
+    }
+    m_toSpace.append(block);
+    ++m_blockCount;
+    return block;
+}
+
+void CopiedSpace::doneCopying()
+{
+    if (!m_isCompacting)
+        return;
+
+    while (CopiedBlock* block = m_fromSpace.head()) {
+        m_fromSpace.remove(block);
+        block->m_isEvacuating = false;
+        if (block->m_isPinned) {
+            // Nothing was copied out of this block, so it stays in use,
+            // whatever garbage it holds, until it is no longer pinned.
+            m_toSpace.append(block);
+            continue;
+        }
+        block->clear();
+        m_freeBlocks.append(block);
+        --m_blockCount;
+    }
+
+    for (size_t i = 0; i < m_newBlocksForCopying.size(); ++i) {
+        m_blockSet.add(m_newBlocksForCopying[i]);
+        m_blockFilter.add(reinterpret_cast<Bits>(m_newBlocksForCopying[i]));
+    }
+    m_newBlocksForCopying.clear();
+
+    m_isCompacting = false;
+}
+
+void CopiedSpace::shrink()
+{
+    if (m_freeBlocks.isEmpty())
+        return;
+
+    for (size_t i = 0; i < m_freeBlocks.size(); ++i) {
+        m_blockSet.remove(m_freeBlocks[i]);
+        CopiedBlock::destroy(m_freeBlocks[i]);
+    }
+    m_freeBlocks.clear();
+
+    m_blockFilter.reset();
+    HashSet<CopiedBlock*>::iterator end = m_blockSet.end();
+    for (HashSet<CopiedBlock*>::iterator it = m_blockSet.begin(); it != end; ++it)
+        m_blockFilter.add(reinterpret_cast<Bits>(*it));
+}
+
+size_t CopiedSpace::size() const
+{
+    size_t result = 0;
+    for (CopiedBlock* block = const_cast<DoublyLinkedList<CopiedBlock>&>(m_toSpace).head(); block; block = block->next())
+        result += block->usedBytes();
+    for (CopiedBlock* block = const_cast<DoublyLinkedList<CopiedBlock>&>(m_fromSpace).head(); block; block = block->next())
+        result += block->usedBytes();
+    return result;
+}
+
+} // namespace JSC
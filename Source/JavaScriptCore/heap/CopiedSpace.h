@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CopiedSpace_h
+#define CopiedSpace_h
+
+#include "TinyBloomFilter.h"
+#include <wtf/DoublyLinkedList.h>
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PageAllocationAligned.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Vector.h>
+
+#if ENABLE(PARALLEL_GC)
+#include <wtf/Threading.h>
+#endif
+
+namespace JSC {
+
+    class Heap;
+
+    // A block that hands out backing stores by bumping a pointer. Nothing in
+    // a block is freed on its own; a compacting collection copies what is
+    // still referenced into other blocks and frees whole blocks instead.
+    class CopiedBlock {
+    public:
+        static const size_t blockSize = 64 * 1024;
+        static const size_t blockMask = ~(blockSize - 1);
+
+        static CopiedBlock* create();
+        static void destroy(CopiedBlock*);
+
+        static CopiedBlock* blockFor(const void* p) { return reinterpret_cast<CopiedBlock*>(reinterpret_cast<uintptr_t>(p) & blockMask); }
+        static bool isAtBlockStart(const void* p) { return !(reinterpret_cast<uintptr_t>(p) & ~blockMask); }
+
+        void* tryAllocate(size_t);
+        bool tryExtend(void*, size_t oldBytes, size_t newBytes); // Only works for the last allocation in the block.
+        void clear() { m_offset = payload(); }
+
+        size_t usedBytes() const { return m_offset - payload(); }
+
+        bool isPinned() const { return m_isPinned; }
+        void pin() { m_isPinned = true; }
+
+        // True for blocks whose contents are being copied out by the current collection.
+        bool isEvacuating() const { return m_isEvacuating; }
+
+        void setPrev(CopiedBlock* prev) { m_prev = prev; }
+        void setNext(CopiedBlock* next) { m_next = next; }
+        CopiedBlock* prev() const { return m_prev; }
+        CopiedBlock* next() const { return m_next; }
+
+    private:
+        friend class CopiedSpace;
+
+        CopiedBlock(const PageAllocationAligned&);
+
+        char* payload() const { return const_cast<char*>(reinterpret_cast<const char*>(this)) + WTF::roundUpToMultipleOf<8>(sizeof(CopiedBlock)); }
+        char* payloadEnd() const { return const_cast<char*>(reinterpret_cast<const char*>(this)) + blockSize; }
+
+        PageAllocationAligned m_allocation;
+        char* m_offset;
+        bool m_isPinned;
+        bool m_isEvacuating;
+        CopiedBlock* m_prev;
+        CopiedBlock* m_next;
+    };
+
+    // Bump allocation for the backing stores of cells: property storage and
+    // array storage. The owner of a backing store must pass it to
+    // MarkStack::copyStorage() whenever the owner is visited, and use the
+    // result from then on, since a full collection moves every backing store
+    // that is not pinned by a conservative root into fresh blocks.
+    //
+    // Storage of LargeObjectSpace::minimumAllocationSize bytes or more goes to
+    // the LargeObjectSpace instead.
+    class CopiedSpace {
+        WTF_MAKE_NONCOPYABLE(CopiedSpace);
+    public:
+        CopiedSpace(Heap*);
+        ~CopiedSpace();
+
+        void* allocate(size_t); // Crashes if out of memory.
+        bool tryReallocateInPlace(void*, size_t oldBytes, size_t newBytes);
+
+        bool contains(const void*);
+
+        // Called for every conservative root, before anything is marked.
+        void pinIfNecessary(const void*);
+
+        void startedCopying(bool shouldCompact); // Before conservative roots are gathered.
+        bool isCompacting() const { return m_isCompacting; }
+        unsigned copyingEpoch() const { return m_copyingEpoch; }
+        CopiedBlock* allocateBlockForCopying(); // May be called from any marking thread.
+        void doneCopying();
+
+        void shrink(); // Gives free blocks back to the system.
+
+        size_t size() const; // Bytes handed out from blocks that are in use.
+        size_t capacity() const { return m_blockCount * CopiedBlock::blockSize; } // Excludes free blocks.
+
+    private:
+        void* allocateSlowCase(size_t);
+        CopiedBlock* getFreeBlock();
+
+        Heap* m_heap;
+        DoublyLinkedList<CopiedBlock> m_toSpace;
+        DoublyLinkedList<CopiedBlock> m_fromSpace;
+        Vector<CopiedBlock*> m_freeBlocks;
+        HashSet<CopiedBlock*> m_blockSet; // In use or free.
+        TinyBloomFilter m_blockFilter; // A superset of m_blockSet, rebuilt by shrink().
+        Vector<CopiedBlock*> m_newBlocksForCopying; // Added to m_blockSet by doneCopying().
+        CopiedBlock* m_currentBlock;
+        size_t m_blockCount;
+        bool m_isCompacting;
+        unsigned m_copyingEpoch;
+#if ENABLE(PARALLEL_GC)
+        Mutex m_copyingLock;
+#endif
+    };
+
+    inline void* CopiedBlock::tryAllocate(size_t bytes)
+    {
+        ASSERT(!(bytes & 7));
+        if (static_cast<size_t>(payloadEnd() - m_offset) < bytes)
+            return 0;
+        void* result = m_offset;
+        m_offset += bytes;
+        return result;
+    }
+
+    inline bool CopiedBlock::tryExtend(void* p, size_t oldBytes, size_t newBytes)
+    {
+        ASSERT(!(oldBytes & 7) && !(newBytes & 7));
+        if (static_cast<char*>(p) + oldBytes != m_offset)
+            return false;
+        if (static_cast<size_t>(payloadEnd() - static_cast<char*>(p)) < newBytes)
+            return false;
+        m_offset = static_cast<char*>(p) + newBytes;
+        return true;
+    }
+
+    inline void* CopiedSpace::allocate(size_t bytes)
+    {
+        ASSERT(bytes < CopiedBlock::blockSize / 2);
+        bytes = WTF::roundUpToMultipleOf<8>(bytes);
+        if (m_currentBlock) {
+            if (void* result = m_currentBlock->tryAllocate(bytes))
+                return result;
+        }
+        return allocateSlowCase(bytes);
+    }
+
+    inline bool CopiedSpace::tryReallocateInPlace(void* p, size_t oldBytes, size_t newBytes)
+    {
+        ASSERT(newBytes < CopiedBlock::blockSize / 2);
+        if (!m_currentBlock || CopiedBlock::blockFor(p) != m_currentBlock)
+            return false;
+        return m_currentBlock->tryExtend(p, WTF::roundUpToMultipleOf<8>(oldBytes), WTF::roundUpToMultipleOf<8>(newBytes));
+    }
+
+    inline bool CopiedSpace::contains(const void* p)
+    {
+        CopiedBlock* block = CopiedBlock::blockFor(p);
+        return !m_blockFilter.ruleOut(reinterpret_cast<Bits>(block)) && m_blockSet.contains(block);
+    }
+
+    inline void CopiedSpace::pinIfNecessary(const void* p)
+    {
+        if (!m_isCompacting)
+            return;
+
+        // A pointer just past the end of a block's last backing store lands
+        // on the next block's header, so it pins the block it came from.
+        if (CopiedBlock::isAtBlockStart(p))
+            p = static_cast<const char*>(p) - 1;
+        CopiedBlock* block = CopiedBlock::blockFor(p);
+        if (!m_blockFilter.ruleOut(reinterpret_cast<Bits>(block)) && m_blockSet.contains(block))
+            block->pin();
+    }
+
+} // namespace JSC
+
+#endif // CopiedSpace_h
@@ -31,6 +31,7 @@
 #include "JSONObject.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 #define COLLECT_ON_EVERY_SLOW_ALLOCATION 0
 
@@ -38,18 +39,25 @@ using namespace std;
 
 namespace JSC {
 
-const size_t minBytesPerCycle = 512 * 1024;
-
 Heap::Heap(JSGlobalData* globalData)
     : m_operationInProgress(NoOperation)
     , m_markedSpace(globalData)
+    , m_copiedSpace(this)
     , m_markListSet(0)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
+    , m_sizingPolicy(DefaultHeapSizingPolicy::create())
     , m_globalData(globalData)
     , m_machineThreads(this)
-    , m_markStack(globalData->jsArrayVPtr)
+    , m_markStackSharedData(globalData->jsArrayVPtr, &m_copiedSpace, &m_largeObjectSpace)
+    , m_markStack(m_markStackSharedData)
     , m_handleHeap(globalData)
     , m_extraCost(0)
+    , m_sizeAfterLastCollection(0)
+    , m_lastCollectionEndTime(currentTime())
+#if ENABLE(GGC)
+    , m_sizeAfterLastFullCollection(0)
+    , m_shouldCollectYoungGeneration(false)
+#endif
 {
     m_markedSpace.setHighWaterMark(minBytesPerCycle);
     (*m_activityCallback)();
@@ -79,6 +87,8 @@ void Heap::destroy()
     m_globalData->jitStubs->clearHostFunctionStubs();
 #endif
 
+    m_markStackSharedData.setNumberOfMarkers(1);
+
     delete m_markListSet;
     m_markListSet = 0;
     m_markedSpace.clearMarks();
@@ -119,16 +129,58 @@ void* Heap::allocateSlowCase(size_t bytes)
     ASSERT(m_operationInProgress == NoOperation);
 #endif
 
-    reset(DoNotSweep);
+#if ENABLE(GGC)
+    collect(DoNotSweep, m_shouldCollectYoungGeneration ? YoungCollection : FullCollection);
+#else
+    collect(DoNotSweep);
+#endif
 
     m_operationInProgress = Allocation;
     void* result = m_markedSpace.allocate(bytes);
+    if (!result) {
+        // The survivors are spread over more blocks than the sizing policy
+        // allowed for, so grow the heap rather than fail.
+        m_markedSpace.setHighWaterMark(m_markedSpace.waterMark() + minBytesPerCycle);
+        result = m_markedSpace.allocate(bytes);
+    }
     m_operationInProgress = NoOperation;
 
     ASSERT(result);
     return result;
 }
 
+void* Heap::allocateLargeStorage(size_t bytes)
+{
+    ASSERT(bytes >= LargeObjectSpace::minimumAllocationSize);
+
+    // The owner is often half built at this point, so rather than collect
+    // here, we let the next cell allocation do it.
+    void* result = m_largeObjectSpace.allocate(bytes);
+    m_markedSpace.addToWaterMark(LargeObjectSpace::allocationSize(result));
+    return result;
+}
+
+void* Heap::reallocateStorage(void* storage, size_t oldBytes, size_t newBytes)
+{
+    ASSERT(newBytes > oldBytes);
+
+    bool isCopied = m_copiedSpace.contains(storage);
+    if (isCopied) {
+        if (newBytes < LargeObjectSpace::minimumAllocationSize && m_copiedSpace.tryReallocateInPlace(storage, oldBytes, newBytes))
+            return storage;
+    } else if (newBytes <= LargeObjectSpace::allocationSize(storage))
+        return storage;
+
+    void* result = allocateStorage(newBytes);
+    memcpy(result, storage, oldBytes);
+
+    // What is left behind in the CopiedSpace goes away at the next full
+    // collection, but large storage is worth giving back right away.
+    if (!isCopied)
+        m_largeObjectSpace.deallocate(storage);
+    return result;
+}
+
 void Heap::protect(JSValue k)
 {
     ASSERT(k);
@@ -190,7 +242,7 @@ inline RegisterFile& Heap::registerFile()
     return m_globalData->interpreter->registerFile();
 }
 
-void Heap::markRoots()
+void Heap::markRoots(CollectionScope scope)
 {
 #ifndef NDEBUG
     if (m_globalData->isSharedInstance()) {
@@ -208,18 +260,49 @@ void Heap::markRoots()
     m_operationInProgress = Collection;
 
     MarkStack& markStack = m_markStack;
+#if ENABLE(PARALLEL_GC)
+    markStack.setIsInParallelMode(m_markStackSharedData.numberOfMarkers() > 1);
+#endif
     HeapRootMarker heapRootMarker(markStack);
     
+    // Conservative roots pin the backing stores they point into, so copying
+    // has to start before we gather them.
+    m_copiedSpace.startedCopying(scope == FullCollection);
+
     // We gather conservative roots before clearing mark bits because
     // conservative gathering uses the mark bits from our last mark pass to
     // determine whether a reference is valid.
+    double rootGatheringStartTime = currentTime();
+
     ConservativeRoots machineThreadRoots(this);
     m_machineThreads.gatherConservativeRoots(machineThreadRoots, &dummy);
 
     ConservativeRoots registerFileRoots(this);
     registerFile().gatherConservativeRoots(registerFileRoots);
 
+    m_timingStatistics.lastRootGatheringTime = currentTime() - rootGatheringStartTime;
+    m_timingStatistics.totalRootGatheringTime += m_timingStatistics.lastRootGatheringTime;
+    m_timingStatistics.lastConservativeCandidateCount = machineThreadRoots.candidateCount() + registerFileRoots.candidateCount();
+    m_timingStatistics.lastConservativeBlockLookupCount = machineThreadRoots.blockLookupCount() + registerFileRoots.blockLookupCount();
+    m_timingStatistics.lastConservativeRootCount = machineThreadRoots.size() + registerFileRoots.size();
+
+#if ENABLE(GGC)
+    // Old cells keep their marks through a young collection, so only the
+    // remembered set leads from them to the young cells they reference.
+    if (scope == YoungCollection) {
+        m_markedSpace.clearYoungMarks();
+        m_largeObjectSpace.clearYoungMarks();
+        m_markedSpace.markRememberedSet(markStack);
+        markStack.drain();
+    } else {
+        m_markedSpace.clearMarks();
+        m_largeObjectSpace.clearMarks();
+    }
+#else
+    ASSERT_UNUSED(scope, scope == FullCollection);
     m_markedSpace.clearMarks();
+    m_largeObjectSpace.clearMarks();
+#endif
 
     markStack.append(machineThreadRoots);
     markStack.drain();
@@ -262,6 +345,9 @@ void Heap::markRoots()
     } while (lastOpaqueRootCount != markStack.opaqueRootCount());
 
     markStack.reset();
+#if ENABLE(PARALLEL_GC)
+    markStack.setIsInParallelMode(false);
+#endif
 
     m_operationInProgress = NoOperation;
 }
@@ -273,12 +359,12 @@ size_t Heap::objectCount() const
 
 size_t Heap::size() const
 {
-    return m_markedSpace.size();
+    return m_markedSpace.size() + m_copiedSpace.size() + m_largeObjectSpace.size();
 }
 
 size_t Heap::capacity() const
 {
-    return m_markedSpace.capacity();
+    return m_markedSpace.capacity() + m_copiedSpace.capacity() + m_largeObjectSpace.capacity();
 }
 
 size_t Heap::globalObjectCount()
@@ -376,6 +462,12 @@ PassOwnPtr<TypeCountSet> Heap::objectTypeCounts()
     return typeCounter.take();
 }
 
+void Heap::setNumberOfMarkerThreads(unsigned numberOfMarkerThreads)
+{
+    ASSERT(m_operationInProgress == NoOperation);
+    m_markStackSharedData.setNumberOfMarkers(numberOfMarkerThreads);
+}
+
 bool Heap::isBusy()
 {
     return m_operationInProgress != NoOperation;
@@ -383,19 +475,63 @@ bool Heap::isBusy()
 
 void Heap::collectAllGarbage()
 {
-    reset(DoSweep);
+    collect(DoSweep);
 }
 
-void Heap::reset(SweepToggle sweepToggle)
+bool Heap::sweepIncrementally(double timeLimit)
+{
+    ASSERT(m_operationInProgress == NoOperation);
+    if (!m_markedSpace.hasPendingSweep())
+        return false;
+
+    double startTime = currentTime();
+    m_operationInProgress = Collection;
+    bool finished = m_markedSpace.sweepSome(startTime + timeLimit);
+    if (finished) {
+        m_copiedSpace.shrink();
+        m_largeObjectSpace.shrink();
+    }
+    m_operationInProgress = NoOperation;
+    m_timingStatistics.totalSweepTime += currentTime() - startTime;
+
+    return !finished;
+}
+
+void Heap::collect(SweepToggle sweepToggle)
+{
+    collect(sweepToggle, FullCollection);
+}
+
+void Heap::collect(SweepToggle sweepToggle, CollectionScope scope)
 {
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     JAVASCRIPTCORE_GC_BEGIN();
 
-    markRoots();
+    m_markedSpace.recordCellsBeforeCollection();
+
+    HeapSizingInput sizingInput;
+    sizingInput.bytesBeforeCollection = size();
+    sizingInput.bytesAllocated = sizingInput.bytesBeforeCollection - min(m_sizeAfterLastCollection, sizingInput.bytesBeforeCollection) + m_extraCost;
+
+    double markStartTime = currentTime();
+    sizingInput.mutatorTime = markStartTime - m_lastCollectionEndTime;
+
+    markRoots(scope);
     m_handleHeap.finalizeWeakHandles();
 
+    // Weak handle finalizers may still look at dead cells' backing stores.
+    // Only a full collection visits every owner, so only it can tell which
+    // large backing stores are garbage.
+    m_copiedSpace.doneCopying();
+    if (scope == FullCollection)
+        m_largeObjectSpace.sweep();
+
     JAVASCRIPTCORE_GC_MARKED();
 
+    m_markedSpace.recordCellsAfterCollection();
+
+    double sweepStartTime = currentTime();
+
     m_markedSpace.reset();
     m_extraCost = 0;
 
@@ -403,17 +539,47 @@ void Heap::reset(SweepToggle sweepToggle)
     sweepToggle = DoSweep;
 #endif
 
+    // Without DoSweep, dead cells are destroyed as the allocator reuses them,
+    // and the rest of each block is swept, and empty blocks given back, either
+    // by sweepIncrementally() when the embedder has idle time for it, or by the
+    // allocator a block at a time as it fills blocks.
     if (sweepToggle == DoSweep) {
         m_markedSpace.sweep();
         m_markedSpace.shrink();
-    }
+        m_copiedSpace.shrink();
+        m_largeObjectSpace.shrink();
+    } else
+        m_markedSpace.scheduleSweep();
+
+    size_t survivingBytes = size();
+
+#if ENABLE(GGC)
+    // Everything that survived is now old. Dead old cells stay marked until
+    // the next full collection, so we do one once the old generation has
+    // doubled in size since the last.
+    m_markedSpace.promoteSurvivors();
+    m_largeObjectSpace.promoteSurvivors();
+    if (scope == FullCollection)
+        m_sizeAfterLastFullCollection = survivingBytes;
+    m_shouldCollectYoungGeneration = survivingBytes < max(2 * m_sizeAfterLastFullCollection, minBytesPerCycle);
+#endif
+
+    double endTime = currentTime();
+    m_timingStatistics.collectionCount++;
+    if (scope == YoungCollection)
+        m_timingStatistics.youngCollectionCount++;
+    m_timingStatistics.lastMarkTime = sweepStartTime - markStartTime;
+    m_timingStatistics.lastSweepTime = endTime - sweepStartTime;
+    m_timingStatistics.totalMarkTime += m_timingStatistics.lastMarkTime;
+    m_timingStatistics.totalSweepTime += m_timingStatistics.lastSweepTime;
+    m_timingStatistics.maxPauseTime = max(m_timingStatistics.maxPauseTime, endTime - markStartTime);
+
+    m_lastCollectionEndTime = endTime;
+    m_sizeAfterLastCollection = survivingBytes;
 
-    // To avoid pathological GC churn in large heaps, we set the allocation high
-    // water mark to be proportional to the current size of the heap. The exact
-    // proportion is a bit arbitrary. A 2X multiplier gives a 1:1 (heap size :
-    // new bytes allocated) proportion, and seems to work well in benchmarks.
-    size_t proportionalBytes = 2 * m_markedSpace.size();
-    m_markedSpace.setHighWaterMark(max(proportionalBytes, minBytesPerCycle));
+    sizingInput.bytesAfterCollection = survivingBytes;
+    sizingInput.pauseTime = endTime - markStartTime;
+    m_markedSpace.setHighWaterMark(m_sizingPolicy->highWaterMark(sizingInput));
 
     JAVASCRIPTCORE_GC_END();
 
@@ -430,4 +596,10 @@ GCActivityCallback* Heap::activityCallback()
     return m_activityCallback.get();
 }
 
+void Heap::setSizingPolicy(PassOwnPtr<HeapSizingPolicy> sizingPolicy)
+{
+    ASSERT(sizingPolicy);
+    m_sizingPolicy = sizingPolicy;
+}
+
 } // namespace JSC
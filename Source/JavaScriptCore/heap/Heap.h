@@ -22,8 +22,11 @@
 #ifndef Heap_h
 #define Heap_h
 
+#include "CopiedSpace.h"
 #include "HandleHeap.h"
 #include "HandleStack.h"
+#include "HeapSizingPolicy.h"
+#include "LargeObjectSpace.h"
 #include "MarkStack.h"
 #include "MarkedSpace.h"
 #include <wtf/Forward.h>
@@ -51,6 +54,41 @@ namespace JSC {
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
 
+    // Times are in seconds.
+    struct GCTimingStatistics {
+        GCTimingStatistics()
+            : collectionCount(0)
+            , youngCollectionCount(0)
+            , lastMarkTime(0)
+            , lastSweepTime(0)
+            , totalMarkTime(0)
+            , totalSweepTime(0)
+            , maxPauseTime(0)
+            , lastRootGatheringTime(0)
+            , totalRootGatheringTime(0)
+            , lastConservativeCandidateCount(0)
+            , lastConservativeBlockLookupCount(0)
+            , lastConservativeRootCount(0)
+        {
+        }
+
+        size_t collectionCount;
+        size_t youngCollectionCount; // Included in collectionCount.
+        double lastMarkTime;
+        double lastSweepTime; // Only the sweeping done during the last collection's pause.
+        double totalMarkTime;
+        double totalSweepTime; // Includes incremental sweeping.
+        double maxPauseTime;
+
+        // Conservative root gathering, from the machine stacks and the
+        // register file. It is part of the mark time.
+        double lastRootGatheringTime;
+        double totalRootGatheringTime;
+        size_t lastConservativeCandidateCount;
+        size_t lastConservativeBlockLookupCount;
+        size_t lastConservativeRootCount;
+    };
+
     class Heap {
         WTF_MAKE_NONCOPYABLE(Heap);
     public:
@@ -59,6 +97,9 @@ namespace JSC {
 
         static bool isMarked(const JSCell*);
         static bool testAndSetMarked(const JSCell*);
+#if ENABLE(PARALLEL_GC)
+        static bool concurrentTestAndSetMarked(const JSCell*);
+#endif
         static void setMarked(JSCell*);
         
         Heap(JSGlobalData*);
@@ -67,17 +108,47 @@ namespace JSC {
 
         JSGlobalData* globalData() const { return m_globalData; }
         MarkedSpace& markedSpace() { return m_markedSpace; }
+        CopiedSpace& copiedSpace() { return m_copiedSpace; }
+        LargeObjectSpace& largeObjectSpace() { return m_largeObjectSpace; }
         MachineThreads& machineThreads() { return m_machineThreads; }
 
         GCActivityCallback* activityCallback();
         void setActivityCallback(PassOwnPtr<GCActivityCallback>);
 
+        // Decides how much the heap may grow between collections.
+        HeapSizingPolicy* sizingPolicy() { return m_sizingPolicy.get(); }
+        void setSizingPolicy(PassOwnPtr<HeapSizingPolicy>);
+
+        // Number of threads that mark in parallel during a collection, including
+        // the collecting thread. 1 (the default) marks serially.
+        unsigned numberOfMarkerThreads() const { return m_markStackSharedData.numberOfMarkers(); }
+        void setNumberOfMarkerThreads(unsigned);
+
         bool isBusy(); // true if an allocation or collection is in progress
         void* allocate(size_t);
         void collectAllGarbage();
 
+        // DoNotSweep leaves dead cells for the allocator and sweepIncrementally()
+        // to deal with, which keeps sweeping out of the collection pause.
+        enum SweepToggle { DoNotSweep, DoSweep };
+        void collect(SweepToggle); // Always collects the whole heap.
+
+        // Sweeps blocks left over from the last collection for at most timeLimit
+        // seconds. Returns true if there is still sweeping left to do.
+        bool sweepIncrementally(double timeLimit);
+
+        const GCTimingStatistics& timingStatistics() const { return m_timingStatistics; }
+
         void reportExtraMemoryCost(size_t cost);
 
+        // Backing stores for cells, like property storage and array storage.
+        // They are never freed explicitly: the owning cell passes its backing
+        // store to MarkStack::copyStorage() whenever it is visited, and uses
+        // the result from then on, since the collector may move it.
+        void* allocateStorage(size_t);
+        // Grows a backing store, in place if possible, keeping its first oldBytes bytes.
+        void* reallocateStorage(void*, size_t oldBytes, size_t newBytes);
+
         void protect(JSValue);
         bool unprotect(JSValue); // True when the protect count drops to 0.
 
@@ -110,20 +181,26 @@ namespace JSC {
         static const size_t minExtraCost = 256;
         static const size_t maxExtraCost = 1024 * 1024;
 
+        // A young collection only marks cells allocated since the last
+        // collection. It requires ENABLE(GGC).
+        enum CollectionScope { YoungCollection, FullCollection };
+
         void* allocateSlowCase(size_t);
+        void* allocateLargeStorage(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
 
-        void markRoots();
+        void collect(SweepToggle, CollectionScope);
+        void markRoots(CollectionScope);
         void markProtectedObjects(HeapRootMarker&);
         void markTempSortVectors(HeapRootMarker&);
 
-        enum SweepToggle { DoNotSweep, DoSweep };
-        void reset(SweepToggle);
 
         RegisterFile& registerFile();
 
         OperationInProgress m_operationInProgress;
         MarkedSpace m_markedSpace;
+        CopiedSpace m_copiedSpace;
+        LargeObjectSpace m_largeObjectSpace;
 
         ProtectCountSet m_protectedValues;
         Vector<Vector<ValueStringPair>* > m_tempSortingVectors;
@@ -131,15 +208,24 @@ namespace JSC {
         HashSet<MarkedArgumentBuffer*>* m_markListSet;
 
         OwnPtr<GCActivityCallback> m_activityCallback;
+        OwnPtr<HeapSizingPolicy> m_sizingPolicy;
 
         JSGlobalData* m_globalData;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_markStackSharedData;
         MarkStack m_markStack;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
 
         size_t m_extraCost;
+        GCTimingStatistics m_timingStatistics;
+        size_t m_sizeAfterLastCollection;
+        double m_lastCollectionEndTime;
+#if ENABLE(GGC)
+        size_t m_sizeAfterLastFullCollection;
+        bool m_shouldCollectYoungGeneration;
+#endif
     };
 
     inline bool Heap::isMarked(const JSCell* cell)
@@ -152,6 +238,13 @@ namespace JSC {
         return MarkedSpace::testAndSetMarked(cell);
     }
 
+#if ENABLE(PARALLEL_GC)
+    inline bool Heap::concurrentTestAndSetMarked(const JSCell* cell)
+    {
+        return MarkedSpace::concurrentTestAndSetMarked(cell);
+    }
+#endif
+
     inline void Heap::setMarked(JSCell* cell)
     {
         MarkedSpace::setMarked(cell);
@@ -168,6 +261,13 @@ namespace JSC {
             reportExtraMemoryCostSlowCase(cost);
     }
 
+    inline void* Heap::allocateStorage(size_t bytes)
+    {
+        if (bytes >= LargeObjectSpace::minimumAllocationSize)
+            return allocateLargeStorage(bytes);
+        return m_copiedSpace.allocate(bytes);
+    }
+
     template <typename Functor> inline void Heap::forEach(Functor& functor)
     {
         m_markedSpace.forEach(functor);
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "HeapSizingPolicy.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace JSC {
+
+DefaultHeapSizingPolicy::DefaultHeapSizingPolicy()
+{
+}
+
+size_t DefaultHeapSizingPolicy::highWaterMark(const HeapSizingInput& input)
+{
+    // To avoid pathological GC churn in large heaps, we set the allocation high
+    // water mark to be proportional to the current size of the heap. The exact
+    // proportion is a bit arbitrary. A 2X multiplier gives a 1:1 (heap size :
+    // new bytes allocated) proportion, and seems to work well in benchmarks.
+    return max(2 * input.bytesAfterCollection, minBytesPerCycle);
+}
+
+static const size_t minHeadroom = 128 * 1024;
+static const double allocationRateWeight = 0.5; // How much the latest measurement counts against the history.
+
+AdaptiveHeapSizingPolicy::AdaptiveHeapSizingPolicy(double pauseTimeBudget, size_t memoryBudget)
+    : m_pauseTimeBudget(pauseTimeBudget)
+    , m_memoryBudget(memoryBudget)
+    , m_allocationRate(0)
+{
+    ASSERT(pauseTimeBudget > 0 && pauseTimeBudget < 1);
+}
+
+size_t AdaptiveHeapSizingPolicy::highWaterMark(const HeapSizingInput& input)
+{
+    size_t liveBytes = input.bytesAfterCollection;
+
+    if (input.mutatorTime > 0) {
+        double allocationRate = input.bytesAllocated / input.mutatorTime;
+        m_allocationRate = m_allocationRate ? allocationRateWeight * allocationRate + (1 - allocationRateWeight) * m_allocationRate : allocationRate;
+    }
+
+    // Pause time grows with the live data, so for the next pause to be
+    // pauseTimeBudget of the time until it ends, the mutator needs to run
+    // pauseTime * (1 - budget) / budget between collections. That much
+    // running allocates this many bytes.
+    double headroom = m_allocationRate * input.pauseTime * (1 - m_pauseTimeBudget) / m_pauseTimeBudget;
+
+    // When most of the heap survives, collecting frees little, so there is
+    // no point in collecting sooner than the default policy would.
+    double survivalRate = input.bytesBeforeCollection ? static_cast<double>(liveBytes) / input.bytesBeforeCollection : 0;
+    if (survivalRate > 0.5)
+        headroom = max(headroom, static_cast<double>(liveBytes));
+
+    // Don't let a burst of allocation balloon the heap.
+    headroom = min(headroom, 4.0 * max(liveBytes, minBytesPerCycle));
+    headroom = max(headroom, static_cast<double>(minHeadroom));
+
+    if (m_memoryBudget && liveBytes + headroom > m_memoryBudget)
+        headroom = m_memoryBudget > liveBytes + minHeadroom ? m_memoryBudget - liveBytes : minHeadroom;
+
+    return liveBytes + static_cast<size_t>(headroom);
+}
+
+} // namespace JSC
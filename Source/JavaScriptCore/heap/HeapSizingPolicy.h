@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef HeapSizingPolicy_h
+#define HeapSizingPolicy_h
+
+#include <wtf/PassOwnPtr.h>
+
+namespace JSC {
+
+// The heap never triggers a collection with less than this allocated.
+const size_t minBytesPerCycle = 512 * 1024;
+
+// What a collection tells the sizing policy. Sizes are in bytes, times in seconds.
+struct HeapSizingInput {
+    size_t bytesBeforeCollection;
+    size_t bytesAfterCollection;
+    size_t bytesAllocated; // Since the previous collection.
+    double pauseTime;
+    double mutatorTime; // Time between the end of the previous collection and the start of this one.
+};
+
+// Decides, after each collection, how large the heap may grow before the
+// next collection is triggered.
+class HeapSizingPolicy {
+public:
+    virtual ~HeapSizingPolicy() { }
+    virtual size_t highWaterMark(const HeapSizingInput&) = 0;
+
+protected:
+    HeapSizingPolicy() { }
+};
+
+// Lets the heap grow to twice the size of what survived.
+class DefaultHeapSizingPolicy : public HeapSizingPolicy {
+public:
+    static PassOwnPtr<DefaultHeapSizingPolicy> create();
+
+    DefaultHeapSizingPolicy();
+    virtual size_t highWaterMark(const HeapSizingInput&);
+};
+
+// Sizes the heap so that collection pauses take up roughly pauseTimeBudget
+// of the running time at the measured allocation rate, without growing
+// past memoryBudget bytes (0 for no limit) unless the live data alone
+// needs more.
+class AdaptiveHeapSizingPolicy : public HeapSizingPolicy {
+public:
+    static PassOwnPtr<AdaptiveHeapSizingPolicy> create(double pauseTimeBudget = 0.1, size_t memoryBudget = 0);
+
+    AdaptiveHeapSizingPolicy(double pauseTimeBudget, size_t memoryBudget);
+    virtual size_t highWaterMark(const HeapSizingInput&);
+
+private:
+    double m_pauseTimeBudget;
+    size_t m_memoryBudget;
+    double m_allocationRate; // Bytes per second, smoothed across collections.
+};
+
+inline PassOwnPtr<DefaultHeapSizingPolicy> DefaultHeapSizingPolicy::create()
+{
+    return adoptPtr(new DefaultHeapSizingPolicy);
+}
+
+inline PassOwnPtr<AdaptiveHeapSizingPolicy> AdaptiveHeapSizingPolicy::create(double pauseTimeBudget, size_t memoryBudget)
+{
+    return adoptPtr(new AdaptiveHeapSizingPolicy(pauseTimeBudget, memoryBudget));
+}
+
+} // namespace JSC
+
+#endif // HeapSizingPolicy_h
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "LargeObjectSpace.h"
+
+#include <wtf/PageBlock.h>
+
+namespace JSC {
+
+LargeObjectSpace::LargeObject::LargeObject(const PageAllocation& allocation, size_t size)
+    : m_allocation(allocation)
+    , m_size(size)
+    , m_isMarked(true)
+#if ENABLE(GGC)
+    , m_isOld(false)
+#endif
+    , m_prev(0)
+    , m_next(0)
+{
+}
+
+LargeObjectSpace::LargeObjectSpace()
+    : m_capacity(0)
+    , m_freeCapacity(0)
+    , m_objectCount(0)
+{
+}
+
+LargeObjectSpace::~LargeObjectSpace()
+{
+    while (LargeObject* object = m_objects.head()) {
+        m_objects.remove(object);
+        m_objectSet.remove(object);
+        object->m_allocation.deallocate();
+    }
+    shrink();
+}
+
+void* LargeObjectSpace::allocate(size_t bytes)
+{
+    size_t pageMask = pageSize() - 1;
+    size_t allocationSize = (LargeObject::headerSize() + bytes + pageMask) & ~pageMask;
+    if (allocationSize < bytes)
+        CRASH();
+
+    // Take the smallest free allocation that fits, as long as it does not
+    // waste more than it holds.
+    PageAllocation allocation;
+    size_t bestIndex = notFound;
+    for (size_t i = 0; i < m_freeAllocations.size(); ++i) {
+        size_t size = m_freeAllocations[i].size();
+        if (size < allocationSize || size > 2 * allocationSize)
+            continue;
+        if (bestIndex == notFound || size < m_freeAllocations[bestIndex].size())
+            bestIndex = i;
+    }
+    if (bestIndex != notFound) {
+        allocation = m_freeAllocations[bestIndex];
+        m_freeAllocations.remove(bestIndex);
+        m_freeCapacity -= allocation.size();
+    } else {
+        allocation = PageAllocation::allocate(allocationSize, OSAllocator::JSGCHeapPages);
+        if (!static_cast<bool>(allocation))
+            CRASH();
+    }
+
+    LargeObject* object = new (allocation.base()) LargeObject(allocation, allocation.size() - LargeObject::headerSize());
+    m_objects.append(object);
+    m_objectSet.add(object);
+    m_capacity += allocation.size();
+    ++m_objectCount;
+    return object->payload();
+}
+
+void LargeObjectSpace::deallocate(void* p)
+{
+    LargeObject* object = LargeObject::headerFor(p);
+    ASSERT(m_objectSet.contains(object));
+    m_objects.remove(object);
+    m_objectSet.remove(object);
+    m_capacity -= object->m_allocation.size();
+    --m_objectCount;
+
+    PageAllocation allocation = object->m_allocation;
+    if (m_freeCapacity + allocation.size() > maxFreeCapacity) {
+        allocation.deallocate();
+        return;
+    }
+    m_freeAllocations.append(allocation);
+    m_freeCapacity += allocation.size();
+}
+
+void LargeObjectSpace::shrink()
+{
+    for (size_t i = 0; i < m_freeAllocations.size(); ++i)
+        m_freeAllocations[i].deallocate();
+    m_freeAllocations.clear();
+    m_freeCapacity = 0;
+}
+
+void LargeObjectSpace::clearMarks()
+{
+    for (LargeObject* object = m_objects.head(); object; object = object->next()) {
+        object->m_isMarked = false;
+#if ENABLE(GGC)
+        object->m_isOld = false;
+#endif
+    }
+}
+
+void LargeObjectSpace::sweep()
+{
+    LargeObject* next;
+    for (LargeObject* object = m_objects.head(); object; object = next) {
+        next = object->next();
+        if (!object->m_isMarked)
+            deallocate(object->payload());
+    }
+}
+
+#if ENABLE(GGC)
+void LargeObjectSpace::clearYoungMarks()
+{
+    // Old owners are not visited by a young collection, so what they own
+    // has to stay marked.
+    for (LargeObject* object = m_objects.head(); object; object = object->next()) {
+        if (!object->m_isOld)
+            object->m_isMarked = false;
+    }
+}
+
+void LargeObjectSpace::promoteSurvivors()
+{
+    for (LargeObject* object = m_objects.head(); object; object = object->next())
+        object->m_isOld = object->m_isMarked;
+}
+#endif
+
+size_t LargeObjectSpace::size() const
+{
+    size_t result = 0;
+    for (LargeObject* object = const_cast<DoublyLinkedList<LargeObject>&>(m_objects).head(); object; object = object->next()) {
+        if (object->m_isMarked)
+            result += object->m_size;
+    }
+    return result;
+}
+
+} // namespace JSC
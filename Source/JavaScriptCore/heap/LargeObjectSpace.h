@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef LargeObjectSpace_h
+#define LargeObjectSpace_h
+
+#include <wtf/DoublyLinkedList.h>
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PageAllocation.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    // Holds backing stores too big for the CopiedSpace, each in its own run of
+    // pages. Allocations are marked along with their owners, and sweep() frees
+    // the ones a full collection did not reach. An owner that replaces its
+    // backing store may free the old one right away.
+    class LargeObjectSpace {
+        WTF_MAKE_NONCOPYABLE(LargeObjectSpace);
+    public:
+        // Below this, rounding up to whole pages wastes too much.
+        static const size_t minimumAllocationSize = 16 * 1024;
+
+        LargeObjectSpace();
+        ~LargeObjectSpace();
+
+        void* allocate(size_t); // Crashes if out of memory. The result starts out marked.
+        void deallocate(void*);
+        void shrink(); // Gives pages kept for reuse back to the system.
+        static size_t allocationSize(void*); // Usable bytes, at least what was asked for.
+
+        // Answers whether a pointer is the start of an allocation in this
+        // space. It can be called from any marking thread.
+        bool contains(void*) const;
+
+        static void setMarked(void*);
+        static bool isMarked(void*);
+        void clearMarks();
+        void sweep(); // Frees unmarked allocations.
+#if ENABLE(GGC)
+        void clearYoungMarks();
+        void promoteSurvivors();
+#endif
+
+        size_t size() const; // Usable bytes in marked allocations.
+        size_t capacity() const { return m_capacity; } // Bytes of pages in use, headers included.
+        size_t objectCount() const { return m_objectCount; }
+
+    private:
+        class LargeObject {
+        public:
+            LargeObject(const PageAllocation&, size_t);
+
+            static LargeObject* headerFor(void* p) { return reinterpret_cast<LargeObject*>(static_cast<char*>(p) - headerSize()); }
+            static size_t headerSize() { return (sizeof(LargeObject) + alignment - 1) & ~(alignment - 1); }
+
+            void* payload() { return reinterpret_cast<char*>(this) + headerSize(); }
+
+            void setPrev(LargeObject* prev) { m_prev = prev; }
+            void setNext(LargeObject* next) { m_next = next; }
+            LargeObject* prev() const { return m_prev; }
+            LargeObject* next() const { return m_next; }
+
+            static const size_t alignment = 16;
+
+            PageAllocation m_allocation;
+            size_t m_size;
+            bool m_isMarked;
+#if ENABLE(GGC)
+            bool m_isOld;
+#endif
+            LargeObject* m_prev;
+            LargeObject* m_next;
+        };
+
+        // Storage that grows is reallocated over and over, so we keep some
+        // freed pages around rather than map and unmap them each time.
+        static const size_t maxFreeCapacity = 1024 * 1024;
+
+        DoublyLinkedList<LargeObject> m_objects;
+        HashSet<LargeObject*> m_objectSet; // The same as m_objects.
+        Vector<PageAllocation> m_freeAllocations;
+        size_t m_capacity;
+        size_t m_freeCapacity;
+        size_t m_objectCount;
+    };
+
+    inline size_t LargeObjectSpace::allocationSize(void* p)
+    {
+        return LargeObject::headerFor(p)->m_size;
+    }
+
+    inline bool LargeObjectSpace::contains(void* p) const
+    {
+        return m_objectSet.contains(LargeObject::headerFor(p));
+    }
+
+    inline void LargeObjectSpace::setMarked(void* p)
+    {
+        // Parallel markers may race here, but they all store the same value.
+        LargeObject::headerFor(p)->m_isMarked = true;
+    }
+
+    inline bool LargeObjectSpace::isMarked(void* p)
+    {
+        return LargeObject::headerFor(p)->m_isMarked;
+    }
+
+} // namespace JSC
+
+#endif // LargeObjectSpace_h
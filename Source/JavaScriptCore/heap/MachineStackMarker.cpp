@@ -28,6 +28,7 @@
 #include "JSGlobalData.h"
 #include <setjmp.h>
 #include <stdlib.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/StdLibExtras.h>
 
 #if USE(PTHREAD_BASED_QT) && !defined(WTF_USE_PTHREADS)
@@ -459,9 +460,43 @@ void MachineThreads::gatherFromOtherThread(ConservativeRoots& conservativeRoots,
 
 #endif
 
+class ThreadRootStatisticsScope {
+public:
+    ThreadRootStatisticsScope(ConservativeRoots& conservativeRoots, ThreadRootStatistics& statistics)
+        : m_conservativeRoots(conservativeRoots)
+        , m_statistics(statistics)
+        , m_candidateCount(conservativeRoots.candidateCount())
+        , m_blockLookupCount(conservativeRoots.blockLookupCount())
+        , m_rootCount(conservativeRoots.size())
+        , m_startTime(currentTime())
+    {
+    }
+
+    ~ThreadRootStatisticsScope()
+    {
+        m_statistics.candidateCount = m_conservativeRoots.candidateCount() - m_candidateCount;
+        m_statistics.blockLookupCount = m_conservativeRoots.blockLookupCount() - m_blockLookupCount;
+        m_statistics.rootCount = m_conservativeRoots.size() - m_rootCount;
+        m_statistics.time = currentTime() - m_startTime;
+    }
+
+private:
+    ConservativeRoots& m_conservativeRoots;
+    ThreadRootStatistics& m_statistics;
+    size_t m_candidateCount;
+    size_t m_blockLookupCount;
+    size_t m_rootCount;
+    double m_startTime;
+};
+
 void MachineThreads::gatherConservativeRoots(ConservativeRoots& conservativeRoots, void* stackCurrent)
 {
-    gatherFromCurrentThread(conservativeRoots, stackCurrent);
+    m_lastGatheringStatistics.shrink(0);
+    m_lastGatheringStatistics.append(ThreadRootStatistics());
+    {
+        ThreadRootStatisticsScope scope(conservativeRoots, m_lastGatheringStatistics.last());
+        gatherFromCurrentThread(conservativeRoots, stackCurrent);
+    }
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
 
@@ -469,6 +504,13 @@ void MachineThreads::gatherConservativeRoots(ConservativeRoots& conservativeRoot
 
         MutexLocker lock(m_registeredThreadsMutex);
 
+        // Make room for every thread's statistics now; we can't malloc once
+        // threads are suspended.
+        size_t threadCount = 1;
+        for (Thread* thread = m_registeredThreads; thread; thread = thread->next)
+            ++threadCount;
+        m_lastGatheringStatistics.reserveCapacity(threadCount);
+
 #ifndef NDEBUG
         // Forbid malloc during the gather phase. The gather phase suspends
         // threads, so a malloc during gather would risk a deadlock with a
@@ -478,8 +520,11 @@ void MachineThreads::gatherConservativeRoots(ConservativeRoots& conservativeRoot
         // It is safe to access the registeredThreads list, because we earlier asserted that locks are being held,
         // and since this is a shared heap, they are real locks.
         for (Thread* thread = m_registeredThreads; thread; thread = thread->next) {
-            if (!pthread_equal(thread->posixThread, pthread_self()))
-                gatherFromOtherThread(conservativeRoots, thread);
+            if (pthread_equal(thread->posixThread, pthread_self()))
+                continue;
+            m_lastGatheringStatistics.append(ThreadRootStatistics());
+            ThreadRootStatisticsScope scope(conservativeRoots, m_lastGatheringStatistics.last());
+            gatherFromOtherThread(conservativeRoots, thread);
         }
 #ifndef NDEBUG
         fastMallocAllow();
@@ -24,6 +24,7 @@
 
 #include <wtf/Noncopyable.h>
 #include <wtf/ThreadingPrimitives.h>
+#include <wtf/Vector.h>
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
 #include <pthread.h>
@@ -34,6 +35,21 @@ namespace JSC {
     class Heap;
     class ConservativeRoots;
 
+    struct ThreadRootStatistics {
+        ThreadRootStatistics()
+            : candidateCount(0)
+            , blockLookupCount(0)
+            , rootCount(0)
+            , time(0)
+        {
+        }
+
+        size_t candidateCount; // Words scanned.
+        size_t blockLookupCount; // Words the block filter could not rule out.
+        size_t rootCount;
+        double time;
+    };
+
     class MachineThreads {
         WTF_MAKE_NONCOPYABLE(MachineThreads);
     public:
@@ -42,6 +58,10 @@ namespace JSC {
 
         void gatherConservativeRoots(ConservativeRoots&, void* stackCurrent);
 
+        // One entry per thread scanned by the last gatherConservativeRoots(),
+        // the current thread first.
+        const Vector<ThreadRootStatistics>& lastGatheringStatistics() const { return m_lastGatheringStatistics; }
+
 #if ENABLE(JSC_MULTIPLE_THREADS)
         void makeUsableFromMultipleThreads();
         void addCurrentThread(); // Only needs to be called by clients that can use the same heap from multiple threads.
@@ -60,6 +80,7 @@ namespace JSC {
 #endif
 
         Heap* m_heap;
+        Vector<ThreadRootStatistics> m_lastGatheringStatistics;
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
         Mutex m_registeredThreadsMutex;
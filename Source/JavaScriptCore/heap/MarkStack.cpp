@@ -33,9 +33,83 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "Structure.h"
+#include <algorithm>
 
 namespace JSC {
 
+#if ENABLE(PARALLEL_GC)
+// How many cells a marker scans before it considers sharing its work.
+static const unsigned minimumNumberOfScansBetweenRebalance = 100;
+// A marker never donates cells unless it has at least twice this many.
+static const size_t minimumNumberOfCellsToKeep = 32;
+#endif
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(void* jsArrayVPtr, CopiedSpace* copiedSpace, LargeObjectSpace* largeObjectSpace)
+    : m_jsArrayVPtr(jsArrayVPtr)
+    , m_copiedSpace(copiedSpace)
+    , m_largeObjectSpace(largeObjectSpace)
+    , m_numberOfMarkers(1)
+#if ENABLE(PARALLEL_GC)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+#endif
+{
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    stopMarkingThreads();
+#endif
+}
+
+void MarkStackThreadSharedData::setNumberOfMarkers(unsigned numberOfMarkers)
+{
+#if ENABLE(PARALLEL_GC)
+    numberOfMarkers = std::min(std::max(numberOfMarkers, 1u), maximumNumberOfMarkers);
+    if (numberOfMarkers == m_numberOfMarkers)
+        return;
+
+    stopMarkingThreads();
+    m_numberOfMarkers = numberOfMarkers;
+    for (unsigned i = 1; i < m_numberOfMarkers; ++i)
+        m_markingThreads.append(createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking"));
+#else
+    UNUSED_PARAM(numberOfMarkers);
+#endif
+}
+
+#if ENABLE(PARALLEL_GC)
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* shared)
+{
+    static_cast<MarkStackThreadSharedData*>(shared)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    MarkStack markStack(*this);
+    markStack.setIsInParallelMode(true);
+    markStack.drainFromShared(MarkStack::SlaveDrain);
+}
+
+void MarkStackThreadSharedData::stopMarkingThreads()
+{
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+
+    for (size_t i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+    m_markingThreads.clear();
+
+    m_parallelMarkersShouldExit = false;
+    m_numberOfMarkers = 1;
+}
+#endif
+
 size_t MarkStack::s_pageSize = 0;
 
 void MarkStack::reset()
@@ -43,7 +117,7 @@ void MarkStack::reset()
     ASSERT(s_pageSize);
     m_values.shrinkAllocation(s_pageSize);
     m_markSets.shrinkAllocation(s_pageSize);
-    m_opaqueRoots.clear();
+    m_shared.m_opaqueRoots.clear();
 }
 
 void MarkStack::append(ConservativeRoots& conservativeRoots)
@@ -54,6 +128,35 @@ void MarkStack::append(ConservativeRoots& conservativeRoots)
         internalAppend(roots[i]);
 }
 
+void* MarkStack::copyStorage(void* storage, size_t bytes)
+{
+    CopiedSpace& copiedSpace = *m_shared.m_copiedSpace;
+    if (!copiedSpace.contains(storage)) {
+        if (m_shared.m_largeObjectSpace->contains(storage))
+            LargeObjectSpace::setMarked(storage);
+        return storage;
+    }
+
+    CopiedBlock* block = CopiedBlock::blockFor(storage);
+    if (!block->isEvacuating() || block->isPinned())
+        return storage;
+
+    if (m_copyingEpoch != copiedSpace.copyingEpoch()) {
+        m_copyingBlock = 0;
+        m_copyingEpoch = copiedSpace.copyingEpoch();
+    }
+
+    bytes = WTF::roundUpToMultipleOf<8>(bytes);
+    void* result = m_copyingBlock ? m_copyingBlock->tryAllocate(bytes) : 0;
+    if (!result) {
+        m_copyingBlock = copiedSpace.allocateBlockForCopying();
+        result = m_copyingBlock->tryAllocate(bytes);
+        ASSERT(result);
+    }
+    memcpy(result, storage, bytes);
+    return result;
+}
+
 inline void MarkStack::markChildren(JSCell* cell)
 {
     ASSERT(Heap::isMarked(cell));
@@ -83,10 +186,22 @@ inline void MarkStack::markChildren(JSCell* cell)
 }
 
 void MarkStack::drain()
+{
+    drainLocal();
+#if ENABLE(PARALLEL_GC)
+    if (m_isInParallelMode)
+        drainFromShared(MasterDrain);
+#endif
+}
+
+void MarkStack::drainLocal()
 {
 #if !ASSERT_DISABLED
     ASSERT(!m_isDraining);
     m_isDraining = true;
+#endif
+#if ENABLE(PARALLEL_GC)
+    unsigned scansUntilRebalance = minimumNumberOfScansBetweenRebalance;
 #endif
     while (!m_markSets.isEmpty() || !m_values.isEmpty()) {
         while (!m_markSets.isEmpty() && m_values.size() < 50) {
@@ -102,7 +217,7 @@ void MarkStack::drain()
             current.m_values++;
 
             JSCell* cell;
-            if (!value || !value.isCell() || Heap::testAndSetMarked(cell = value.asCell())) {
+            if (!value || !value.isCell() || testAndSetMarked(cell = value.asCell())) {
                 if (current.m_values == end) {
                     m_markSets.removeLast();
                     continue;
@@ -124,12 +239,98 @@ void MarkStack::drain()
 
             markChildren(cell);
         }
-        while (!m_values.isEmpty())
+        while (!m_values.isEmpty()) {
             markChildren(m_values.removeLast());
+#if ENABLE(PARALLEL_GC)
+            if (m_isInParallelMode && !--scansUntilRebalance) {
+                donateKnownParallel();
+                scansUntilRebalance = minimumNumberOfScansBetweenRebalance;
+            }
+#endif
+        }
     }
 #if !ASSERT_DISABLED
     m_isDraining = false;
 #endif
 }
 
+#if ENABLE(PARALLEL_GC)
+void MarkStack::donateKnownParallel()
+{
+    if (m_values.size() < 2 * minimumNumberOfCellsToKeep)
+        return;
+
+    // Never wait for the lock: if another marker holds it, we'll try again
+    // after the next batch of scans.
+    if (!m_shared.m_markingLock.tryLock())
+        return;
+
+    if (m_shared.m_sharedCells.size() < m_values.size()) {
+        size_t cellsToDonate = m_values.size() / 2;
+        for (size_t i = 0; i < cellsToDonate; ++i)
+            m_shared.m_sharedCells.append(m_values.removeLast());
+        m_shared.m_markingCondition.broadcast();
+    }
+
+    m_shared.m_markingLock.unlock();
+}
+
+void MarkStack::stealSomeCellsFromShared()
+{
+    // Called with m_shared.m_markingLock held.
+    Vector<JSCell*>& sharedCells = m_shared.m_sharedCells;
+    size_t cellsToSteal = std::min(sharedCells.size(), sharedCells.size() / m_shared.m_numberOfMarkers + 1);
+    for (size_t i = 0; i < cellsToSteal; ++i) {
+        m_values.append(sharedCells.last());
+        sharedCells.removeLast();
+    }
+}
+
+void MarkStack::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+    ASSERT(m_isInParallelMode);
+    ASSERT(m_markSets.isEmpty());
+    ASSERT(m_values.isEmpty());
+
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+
+    while (true) {
+        {
+            MutexLocker locker(m_shared.m_markingLock);
+            m_shared.m_numberOfActiveParallelMarkers--;
+
+            if (sharedDrainMode == MasterDrain) {
+                // Wait until either marking has terminated or there is work to steal.
+                while (true) {
+                    if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedCells.isEmpty())
+                        return;
+                    if (!m_shared.m_sharedCells.isEmpty())
+                        break;
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                }
+            } else {
+                ASSERT(sharedDrainMode == SlaveDrain);
+                // If we were the last busy marker, let the master know marking is done.
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedCells.isEmpty())
+                    m_shared.m_markingCondition.broadcast();
+
+                while (m_shared.m_sharedCells.isEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+
+                if (m_shared.m_parallelMarkersShouldExit)
+                    return;
+            }
+
+            stealSomeCellsFromShared();
+            m_shared.m_numberOfActiveParallelMarkers++;
+        }
+
+        drainLocal();
+    }
+}
+#endif
+
 } // namespace JSC
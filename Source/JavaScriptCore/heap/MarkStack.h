@@ -34,19 +34,75 @@
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
 
+#if ENABLE(PARALLEL_GC)
+#include <wtf/Threading.h>
+#endif
+
 namespace JSC {
 
     class ConservativeRoots;
+    class CopiedBlock;
+    class CopiedSpace;
     class JSGlobalData;
+    class LargeObjectSpace;
+    class MarkStack;
     class Register;
     
     enum MarkSetProperties { MayContainNullValues, NoNullValues };
+
+    // State shared by all the MarkStacks taking part in a collection. With
+    // ENABLE(PARALLEL_GC), this also owns the helper marking threads and the
+    // pool of cells they steal work from.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        static const unsigned maximumNumberOfMarkers = 16;
+
+        MarkStackThreadSharedData(void* jsArrayVPtr, CopiedSpace*, LargeObjectSpace*);
+        ~MarkStackThreadSharedData();
+
+        unsigned numberOfMarkers() const { return m_numberOfMarkers; }
+        void setNumberOfMarkers(unsigned); // Includes the thread running the collection.
+
+    private:
+        friend class MarkStack;
+
+#if ENABLE(PARALLEL_GC)
+        static void* markingThreadStartFunc(void*);
+        void markingThreadMain();
+        void stopMarkingThreads();
+#endif
+
+        void* m_jsArrayVPtr;
+        CopiedSpace* m_copiedSpace;
+        LargeObjectSpace* m_largeObjectSpace;
+        unsigned m_numberOfMarkers;
+        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+
+#if ENABLE(PARALLEL_GC)
+        Mutex m_opaqueRootsLock;
+
+        // m_markingLock guards everything below it.
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        Vector<JSCell*> m_sharedCells;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+        Vector<ThreadIdentifier> m_markingThreads;
+#endif
+    };
     
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
     public:
-        MarkStack(void* jsArrayVPtr)
-            : m_jsArrayVPtr(jsArrayVPtr)
+        MarkStack(MarkStackThreadSharedData& shared)
+            : m_jsArrayVPtr(shared.m_jsArrayVPtr)
+            , m_shared(shared)
+            , m_copyingBlock(0)
+            , m_copyingEpoch(0)
+#if ENABLE(PARALLEL_GC)
+            , m_isInParallelMode(false)
+#endif
 #if !ASSERT_DISABLED
             , m_isCheckingForDefaultMarkViolation(false)
             , m_isDraining(false)
@@ -72,22 +128,50 @@ namespace JSC {
         
         void append(ConservativeRoots&);
 
-        bool addOpaqueRoot(void* root) { return m_opaqueRoots.add(root).second; }
-        bool containsOpaqueRoot(void* root) { return m_opaqueRoots.contains(root); }
-        int opaqueRootCount() { return m_opaqueRoots.size(); }
+        // Returns where the backing store of the cell being visited lives
+        // from now on. A backing store that came from Heap::allocateStorage()
+        // must be exactly 'bytes' long; any other is left where it is.
+        void* copyStorage(void* storage, size_t bytes);
+
+#if ENABLE(GGC)
+        // Rescans a cell that is already marked because it belongs to the old
+        // generation, so that the young cells it points to get marked too.
+        void appendRememberedCell(JSCell* cell) { m_values.append(cell); }
+#endif
+
+        bool addOpaqueRoot(void*);
+        bool containsOpaqueRoot(void* root) { return m_shared.m_opaqueRoots.contains(root); }
+        int opaqueRootCount() { return m_shared.m_opaqueRoots.size(); }
 
         void drain();
         void reset();
 
+#if ENABLE(PARALLEL_GC)
+        // In parallel mode, drain() shares surplus cells with the helper
+        // marking threads and only returns once all of them are idle.
+        void setIsInParallelMode(bool isInParallelMode) { m_isInParallelMode = isInParallelMode; }
+#endif
+
     private:
         friend class HeapRootMarker; // Allowed to mark a JSValue* or JSCell** directly.
+        friend class MarkStackThreadSharedData;
+
         void append(JSValue*);
         void append(JSValue*, size_t count);
         void append(JSCell**);
 
+        bool testAndSetMarked(JSCell*);
         void internalAppend(JSCell*);
         void internalAppend(JSValue);
         void markChildren(JSCell*);
+        void drainLocal();
+
+#if ENABLE(PARALLEL_GC)
+        enum SharedDrainMode { MasterDrain, SlaveDrain };
+        void drainFromShared(SharedDrainMode);
+        void donateKnownParallel();
+        void stealSomeCellsFromShared();
+#endif
 
         struct MarkSet {
             MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
@@ -190,10 +274,15 @@ namespace JSC {
         };
 
         void* m_jsArrayVPtr;
+        MarkStackThreadSharedData& m_shared;
         MarkStackArray<MarkSet> m_markSets;
         MarkStackArray<JSCell*> m_values;
+        CopiedBlock* m_copyingBlock;
+        unsigned m_copyingEpoch; // m_copyingBlock is stale if this is not the CopiedSpace's.
         static size_t s_pageSize;
-        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+#if ENABLE(PARALLEL_GC)
+        bool m_isInParallelMode;
+#endif
 
 #if !ASSERT_DISABLED
     public:
@@ -202,6 +291,17 @@ namespace JSC {
 #endif
     };
 
+    inline bool MarkStack::addOpaqueRoot(void* root)
+    {
+#if ENABLE(PARALLEL_GC)
+        if (m_isInParallelMode) {
+            MutexLocker locker(m_shared.m_opaqueRootsLock);
+            return m_shared.m_opaqueRoots.add(root).second;
+        }
+#endif
+        return m_shared.m_opaqueRoots.add(root).second;
+    }
+
     inline void MarkStack::append(JSValue* slot, size_t count)
     {
         if (!count)
@@ -29,6 +29,7 @@
 #include "JSCell.h"
 #include "JSObject.h"
 #include "JSZombie.h"
+#include "MarkStack.h"
 #include "ScopeChain.h"
 
 namespace JSC {
@@ -50,6 +51,9 @@ void MarkedBlock::destroy(MarkedBlock* block)
 
 MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, JSGlobalData* globalData, size_t cellSize)
     : m_nextAtom(firstAtom())
+#if ENABLE(GGC)
+    , m_isDirty(0)
+#endif
     , m_allocation(allocation)
     , m_heap(&globalData->heap)
     , m_prev(0)
@@ -86,4 +90,22 @@ void MarkedBlock::sweep()
     }
 }
 
+#if ENABLE(GGC)
+void MarkedBlock::markRememberedCells(MarkStack& markStack)
+{
+    ASSERT(m_isDirty);
+
+    // We don't know which of our old cells were written to, so we rescan all
+    // of them. Cells that can't hold references are never scanned, just as in
+    // MarkStack::internalAppend().
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        if (!m_oldMarks.get(i))
+            continue;
+        JSCell* cell = reinterpret_cast<JSCell*>(&atoms()[i]);
+        if (cell->structure()->typeInfo().type() >= CompoundType)
+            markStack.appendRememberedCell(cell);
+    }
+}
+#endif
+
 } // namespace JSC
@@ -31,6 +31,7 @@ namespace JSC {
     class Heap;
     class JSCell;
     class JSGlobalData;
+    class MarkStack;
 
     typedef uintptr_t Bits;
 
@@ -39,6 +40,8 @@ namespace JSC {
     class MarkedBlock {
     public:
         static const size_t atomSize = sizeof(double); // Ensures natural alignment for all built-in types.
+        static const size_t blockSize = 16 * KB;
+        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
 
         static MarkedBlock* create(JSGlobalData*, size_t cellSize);
         static void destroy(MarkedBlock*);
@@ -64,6 +67,7 @@ namespace JSC {
         size_t markCount();
 
         size_t cellSize();
+        size_t cellCount();
 
         size_t size();
         size_t capacity();
@@ -72,14 +76,29 @@ namespace JSC {
         size_t atomNumber(const void*);
         bool isMarked(const void*);
         bool testAndSetMarked(const void*);
+#if ENABLE(PARALLEL_GC)
+        bool concurrentTestAndSetMarked(const void*);
+#endif
         void setMarked(const void*);
         
         template <typename Functor> void forEach(Functor&);
 
-    private:
-        static const size_t blockSize = 16 * KB;
-        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
+#if ENABLE(GGC)
+        // Cells that survived the last collection form the old generation.
+        // A young collection only clears the marks of cells allocated since
+        // then, and rescans the old cells of dirty blocks, which are the ones
+        // that have been written to through a write barrier.
+        bool isDirty() { return m_isDirty; }
+        void setDirty() { m_isDirty = 1; }
+        static ptrdiff_t offsetOfIsDirty() { return OBJECT_OFFSETOF(MarkedBlock, m_isDirty); }
+        int32_t* addressOfIsDirty() { return &m_isDirty; }
+
+        void clearYoungMarks();
+        void markRememberedCells(MarkStack&);
+        void promoteSurvivors();
+#endif
 
+    private:
         static const size_t atomMask = ~(atomSize - 1); // atomSize must be a power of two.
         
         static const size_t atomsPerBlock = blockSize / atomSize;
@@ -93,6 +112,10 @@ namespace JSC {
         size_t m_endAtom; // This is a fuzzy end. Always test for < m_endAtom.
         size_t m_atomsPerCell;
         WTF::Bitmap<blockSize / atomSize> m_marks;
+#if ENABLE(GGC)
+        WTF::Bitmap<blockSize / atomSize> m_oldMarks;
+        int32_t m_isDirty; // Set from JIT code with a 32-bit store.
+#endif
         PageAllocationAligned m_allocation;
         Heap* m_heap;
         MarkedBlock* m_prev;
@@ -157,7 +180,23 @@ namespace JSC {
     inline void MarkedBlock::clearMarks()
     {
         m_marks.clearAll();
+#if ENABLE(GGC)
+        m_oldMarks.clearAll();
+#endif
+    }
+
+#if ENABLE(GGC)
+    inline void MarkedBlock::clearYoungMarks()
+    {
+        m_marks = m_oldMarks;
     }
+
+    inline void MarkedBlock::promoteSurvivors()
+    {
+        m_oldMarks = m_marks;
+        m_isDirty = 0;
+    }
+#endif
     
     inline size_t MarkedBlock::markCount()
     {
@@ -169,6 +208,11 @@ namespace JSC {
         return m_atomsPerCell * atomSize;
     }
 
+    inline size_t MarkedBlock::cellCount()
+    {
+        return (m_endAtom - firstAtom() + m_atomsPerCell - 1) / m_atomsPerCell;
+    }
+
     inline size_t MarkedBlock::size()
     {
         return markCount() * cellSize();
@@ -205,6 +249,13 @@ namespace JSC {
         return m_marks.testAndSet(atomNumber(p));
     }
 
+#if ENABLE(PARALLEL_GC)
+    inline bool MarkedBlock::concurrentTestAndSetMarked(const void* p)
+    {
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+    }
+#endif
+
     inline void MarkedBlock::setMarked(const void* p)
     {
         m_marks.set(atomNumber(p));
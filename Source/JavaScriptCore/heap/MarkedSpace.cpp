@@ -26,6 +26,7 @@
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
@@ -56,6 +57,7 @@ MarkedBlock* MarkedSpace::allocateBlock(SizeClass& sizeClass)
     sizeClass.blockList.append(block);
     sizeClass.nextBlock = block;
     m_blocks.add(block);
+    m_blockFilter.add(reinterpret_cast<Bits>(block));
 
     return block;
 }
@@ -79,6 +81,13 @@ void* MarkedSpace::allocateFromSizeClass(SizeClass& sizeClass)
             return result;
 
         m_waterMark += block->capacity();
+
+        // Pay for the blocks left over from the last collection a little at
+        // a time, so that they get swept even where no activity callback
+        // calls Heap::sweepIncrementally(). The block we just filled is not
+        // empty, so this never frees it out from under the loop.
+        if (!m_blocksToSweep.isEmpty())
+            sweepPendingBlock();
     }
 
     if (m_waterMark < m_highWaterMark)
@@ -87,8 +96,26 @@ void* MarkedSpace::allocateFromSizeClass(SizeClass& sizeClass)
     return 0;
 }
 
+void MarkedSpace::addToWaterMark(size_t bytes)
+{
+    m_waterMark += bytes;
+    if (m_waterMark < m_highWaterMark)
+        return;
+
+    // The allocator only checks the water mark when it runs out of blocks;
+    // reset() gives them back after the collection.
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        sizeClassFor(cellSize).nextBlock = 0;
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        sizeClassFor(cellSize).nextBlock = 0;
+}
+
 void MarkedSpace::shrink()
 {
+    // Blocks we free here may still be waiting for an incremental sweep.
+    m_blocksToSweep.clear();
+
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     DoublyLinkedList<MarkedBlock> empties;
 
@@ -105,6 +132,12 @@ void MarkedSpace::shrink()
     
     freeBlocks(empties);
     ASSERT(empties.isEmpty());
+
+    // Freed blocks may have left bits in the filter that no live block needs.
+    m_blockFilter.reset();
+    end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        m_blockFilter.add(reinterpret_cast<Bits>(*it));
 }
 
 void MarkedSpace::clearMarks()
@@ -114,13 +147,74 @@ void MarkedSpace::clearMarks()
         (*it)->clearMarks();
 }
 
+#if ENABLE(GGC)
+void MarkedSpace::clearYoungMarks()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->clearYoungMarks();
+}
+
+void MarkedSpace::markRememberedSet(MarkStack& markStack)
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it) {
+        if ((*it)->isDirty())
+            (*it)->markRememberedCells(markStack);
+    }
+}
+
+void MarkedSpace::promoteSurvivors()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->promoteSurvivors();
+}
+#endif
+
 void MarkedSpace::sweep()
 {
+    m_blocksToSweep.clear();
+
     BlockIterator end = m_blocks.end();
     for (BlockIterator it = m_blocks.begin(); it != end; ++it)
         (*it)->sweep();
 }
 
+void MarkedSpace::scheduleSweep()
+{
+    m_blocksToSweep.clear();
+    copyToVector(m_blocks, m_blocksToSweep);
+}
+
+void MarkedSpace::sweepPendingBlock()
+{
+    MarkedBlock* block = m_blocksToSweep.last();
+    m_blocksToSweep.removeLast();
+
+    if (block->isEmpty()) {
+        // Nothing in an empty block has been allocated since the last
+        // collection, so at most the allocator is about to start on it.
+        SizeClass& sizeClass = sizeClassFor(block->cellSize());
+        if (sizeClass.nextBlock == block)
+            sizeClass.nextBlock = block->next();
+        sizeClass.blockList.remove(block);
+        m_blocks.remove(block);
+        MarkedBlock::destroy(block);
+    } else
+        block->sweep();
+}
+
+bool MarkedSpace::sweepSome(double deadline)
+{
+    while (!m_blocksToSweep.isEmpty()) {
+        sweepPendingBlock();
+        if (currentTime() >= deadline)
+            break;
+    }
+    return m_blocksToSweep.isEmpty();
+}
+
 size_t MarkedSpace::objectCount() const
 {
     size_t result = 0;
@@ -148,6 +242,63 @@ size_t MarkedSpace::capacity() const
     return result;
 }
 
+size_t MarkedSpace::SizeClass::markCount()
+{
+    size_t result = 0;
+    for (MarkedBlock* block = blockList.head(); block; block = block->next())
+        result += block->markCount();
+    return result;
+}
+
+void MarkedSpace::recordCellsBeforeCollection()
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        sizeClassFor(cellSize).cellsBeforeLastCollection = sizeClassFor(cellSize).markCount();
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        sizeClassFor(cellSize).cellsBeforeLastCollection = sizeClassFor(cellSize).markCount();
+}
+
+void MarkedSpace::recordCellsAfterCollection()
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        sizeClassFor(cellSize).cellsAfterLastCollection = sizeClassFor(cellSize).markCount();
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        sizeClassFor(cellSize).cellsAfterLastCollection = sizeClassFor(cellSize).markCount();
+}
+
+void MarkedSpace::sizeClassStatistics(Vector<SizeClassStatistics>& result)
+{
+    result.clear();
+    result.reserveCapacity(preciseCount + impreciseCount);
+
+    for (size_t i = 0; i < preciseCount + impreciseCount; ++i) {
+        SizeClass& sizeClass = i < preciseCount ? m_preciseSizeClasses[i] : m_impreciseSizeClasses[i - preciseCount];
+
+        SizeClassStatistics statistics;
+        statistics.cellSize = sizeClass.cellSize;
+        statistics.blockCount = 0;
+        statistics.liveCells = 0;
+        statistics.freeCells = 0;
+        for (MarkedBlock* block = sizeClass.blockList.head(); block; block = block->next()) {
+            size_t markCount = block->markCount();
+            statistics.blockCount++;
+            statistics.liveCells += markCount;
+            statistics.freeCells += block->cellCount() - markCount;
+        }
+
+        // Nothing clears a mark between collections, so every mark set since
+        // the last one is an allocation.
+        size_t allocatedCells = statistics.liveCells > sizeClass.cellsAfterLastCollection ? statistics.liveCells - sizeClass.cellsAfterLastCollection : 0;
+        statistics.bytesAllocatedSinceLastCollection = allocatedCells * sizeClass.cellSize;
+        statistics.cellsBeforeLastCollection = sizeClass.cellsBeforeLastCollection;
+        statistics.cellsAfterLastCollection = sizeClass.cellsAfterLastCollection;
+
+        result.append(statistics);
+    }
+}
+
 void MarkedSpace::reset()
 {
     m_waterMark = 0;
@@ -25,6 +25,7 @@
 #include "MachineStackMarker.h"
 #include "MarkedBlock.h"
 #include "PageAllocationAligned.h"
+#include "TinyBloomFilter.h"
 #include <wtf/Bitmap.h>
 #include <wtf/DoublyLinkedList.h>
 #include <wtf/FixedArray.h>
@@ -43,6 +44,18 @@ namespace JSC {
     class MarkStack;
     class WeakGCHandle;
 
+    struct SizeClassStatistics {
+        double survivalRate() const { return cellsBeforeLastCollection ? static_cast<double>(cellsAfterLastCollection) / cellsBeforeLastCollection : 0; }
+
+        size_t cellSize;
+        size_t blockCount;
+        size_t liveCells; // Cells allocated since the last collection count as live.
+        size_t freeCells;
+        size_t bytesAllocatedSinceLastCollection;
+        size_t cellsBeforeLastCollection;
+        size_t cellsAfterLastCollection;
+    };
+
     class MarkedSpace {
         WTF_MAKE_NONCOPYABLE(MarkedSpace);
     public:
@@ -53,6 +66,9 @@ namespace JSC {
 
         static bool isMarked(const JSCell*);
         static bool testAndSetMarked(const JSCell*);
+#if ENABLE(PARALLEL_GC)
+        static bool concurrentTestAndSetMarked(const JSCell*);
+#endif
         static void setMarked(const JSCell*);
 
         MarkedSpace(JSGlobalData*);
@@ -60,9 +76,15 @@ namespace JSC {
 
         JSGlobalData* globalData() { return m_globalData; }
 
+        size_t waterMark() { return m_waterMark; } // Capacity of the blocks filled since the last reset().
         size_t highWaterMark() { return m_highWaterMark; }
         void setHighWaterMark(size_t highWaterMark) { m_highWaterMark = highWaterMark; }
 
+        // Counts memory allocated outside the MarkedBlocks, such as large
+        // storage, towards the next collection. Once past the high water
+        // mark, the next allocation takes the slow path.
+        void addToWaterMark(size_t);
+
         void* allocate(size_t);
 
         void clearMarks();
@@ -71,10 +93,36 @@ namespace JSC {
         void sweep();
         void shrink();
 
+        // Incremental sweeping: scheduleSweep() records every block as needing
+        // a sweep, and sweepSome() sweeps them, freeing the ones that turned out
+        // to be empty, until the deadline passes. Returns true when done. The
+        // allocator also sweeps one of them whenever it fills a block, so they
+        // all get swept on ports without a timer to call sweepSome().
+        void scheduleSweep();
+        bool sweepSome(double deadline);
+        bool hasPendingSweep() const { return !m_blocksToSweep.isEmpty(); }
+
+#if ENABLE(GGC)
+        // Generational collection: see MarkedBlock. promoteSurvivors() must
+        // follow every collection, young or full.
+        void clearYoungMarks();
+        void markRememberedSet(MarkStack&);
+        void promoteSurvivors();
+#endif
+
         size_t size() const;
         size_t capacity() const;
         size_t objectCount() const;
 
+        // Collections bracket their marking with these so that the statistics
+        // can report how many cells of each size class survived.
+        void recordCellsBeforeCollection();
+        void recordCellsAfterCollection();
+        void sizeClassStatistics(Vector<SizeClassStatistics>&);
+
+        // A cheap test that rules out most non-pointers before contains()
+        // hashes them. False positives are possible, false negatives are not.
+        bool mayContain(const void*);
         bool contains(const void*);
 
         template<typename Functor> void forEach(Functor&);
@@ -96,9 +144,13 @@ namespace JSC {
             SizeClass();
             void reset();
 
+            size_t markCount();
+
             MarkedBlock* nextBlock;
             DoublyLinkedList<MarkedBlock> blockList;
             size_t cellSize;
+            size_t cellsBeforeLastCollection;
+            size_t cellsAfterLastCollection;
         };
 
         MarkedBlock* allocateBlock(SizeClass&);
@@ -106,12 +158,15 @@ namespace JSC {
 
         SizeClass& sizeClassFor(size_t);
         void* allocateFromSizeClass(SizeClass&);
+        void sweepPendingBlock();
 
         void clearMarks(MarkedBlock*);
 
         SizeClass m_preciseSizeClasses[preciseCount];
         SizeClass m_impreciseSizeClasses[impreciseCount];
         HashSet<MarkedBlock*> m_blocks;
+        TinyBloomFilter m_blockFilter; // A superset of m_blocks, rebuilt by shrink().
+        Vector<MarkedBlock*> m_blocksToSweep;
         size_t m_waterMark;
         size_t m_highWaterMark;
         JSGlobalData* m_globalData;
@@ -132,18 +187,33 @@ namespace JSC {
         return MarkedBlock::blockFor(cell)->testAndSetMarked(cell);
     }
 
+#if ENABLE(PARALLEL_GC)
+    inline bool MarkedSpace::concurrentTestAndSetMarked(const JSCell* cell)
+    {
+        return MarkedBlock::blockFor(cell)->concurrentTestAndSetMarked(cell);
+    }
+#endif
+
     inline void MarkedSpace::setMarked(const JSCell* cell)
     {
         MarkedBlock::blockFor(cell)->setMarked(cell);
     }
 
-    inline bool MarkedSpace::contains(const void* x)
+    inline bool MarkedSpace::mayContain(const void* x)
     {
         if (!MarkedBlock::isAtomAligned(x))
             return false;
 
+        return !m_blockFilter.ruleOut(reinterpret_cast<Bits>(MarkedBlock::blockFor(x)));
+    }
+
+    inline bool MarkedSpace::contains(const void* x)
+    {
+        if (!mayContain(x))
+            return false;
+
         MarkedBlock* block = MarkedBlock::blockFor(x);
-        if (!block || !m_blocks.contains(block))
+        if (!m_blocks.contains(block))
             return false;
 
         return block->contains(x);
@@ -159,6 +229,8 @@ namespace JSC {
     inline MarkedSpace::SizeClass::SizeClass()
         : nextBlock(0)
         , cellSize(0)
+        , cellsBeforeLastCollection(0)
+        , cellsAfterLastCollection(0)
     {
     }
 
@@ -68,6 +68,9 @@
 #if ENABLE(JIT)
 #include "JIT.h"
 #endif
+#if ENABLE(TIERED_COMPILATION)
+#include "ThunkGenerators.h"
+#endif
 
 #define WTF_USE_GCC_COMPUTED_GOTO_WORKAROUND (ENABLE(COMPUTED_GOTO_INTERPRETER) && !defined(__llvm__))
 
@@ -539,6 +542,28 @@ bool Interpreter::isOpcode(Opcode opcode)
 #endif
 }
 
+// Finds the bytecode offset that callFrame returns to in its caller.
+static unsigned bytecodeOffsetOfReturn(CallFrame* callFrame, CodeBlock* callerCodeBlock)
+{
+#if ENABLE(TIERED_COMPILATION)
+    // The caller may be running in the interpreter or in machine code; only a
+    // return address into its instructions belongs to the interpreter.
+    Instruction* returnVPC = callFrame->returnVPC();
+    Vector<Instruction>& instructions = callerCodeBlock->instructions();
+    if (returnVPC >= instructions.begin() && returnVPC < instructions.end())
+        return callerCodeBlock->bytecodeOffset(returnVPC);
+    return callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+#elif ENABLE(JIT) && ENABLE(INTERPRETER)
+    if (callFrame->globalData().canUseJIT())
+        return callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+    return callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
+#elif ENABLE(JIT)
+    return callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+#else
+    return callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
+#endif
+}
+
 NEVER_INLINE bool Interpreter::unwindCallFrame(CallFrame*& callFrame, JSValue exceptionValue, unsigned& bytecodeOffset, CodeBlock*& codeBlock)
 {
     CodeBlock* oldCodeBlock = codeBlock;
@@ -578,16 +603,7 @@ NEVER_INLINE bool Interpreter::unwindCallFrame(CallFrame*& callFrame, JSValue ex
         return false;
 
     codeBlock = callerFrame->codeBlock();
-#if ENABLE(JIT) && ENABLE(INTERPRETER)
-    if (callerFrame->globalData().canUseJIT())
-        bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
-    else
-        bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnVPC());
-#elif ENABLE(JIT)
-    bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
-#else
-    bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnVPC());
-#endif
+    bytecodeOffset = bytecodeOffsetOfReturn(callFrame, codeBlock);
 
     callFrame = callerFrame;
     return true;
@@ -725,6 +741,27 @@ static inline JSObject* checkedReturn(JSObject* returnValue)
     return returnValue;
 }
 
+#if ENABLE(JIT)
+// Decides whether code that is about to be entered runs as machine code. With
+// tiered compilation, code runs in the interpreter until it has been entered
+// or has looped often enough to be worth compiling.
+static inline bool shouldRunJITCode(JSGlobalData& globalData, CodeBlock* codeBlock)
+{
+    if (!globalData.canUseJIT())
+        return false;
+#if ENABLE(TIERED_COMPILATION)
+    if (!codeBlock->getJITCode()) {
+        if (!codeBlock->checkIfJITThresholdReached())
+            return false;
+        codeBlock->jitCompile(globalData);
+    }
+#else
+    UNUSED_PARAM(codeBlock);
+#endif
+    return true;
+}
+#endif
+
 JSValue Interpreter::execute(ProgramExecutable* program, CallFrame* callFrame, ScopeChainNode* scopeChain, JSObject* thisObj)
 {
     ASSERT(!scopeChain->globalData->exception);
@@ -763,7 +800,7 @@ JSValue Interpreter::execute(ProgramExecutable* program, CallFrame* callFrame, S
 
         m_reentryDepth++;  
 #if ENABLE(JIT)
-        if (callFrame->globalData().canUseJIT())
+        if (shouldRunJITCode(callFrame->globalData(), codeBlock))
             result = program->generatedJITCode().execute(&m_registerFile, newCallFrame, scopeChain->globalData);
         else
 #endif
@@ -834,7 +871,7 @@ JSValue Interpreter::executeCall(CallFrame* callFrame, JSObject* function, CallT
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
-            if (callFrame->globalData().canUseJIT())
+            if (shouldRunJITCode(callFrame->globalData(), newCodeBlock))
                 result = callData.js.functionExecutable->generatedJITCodeForCall().execute(&m_registerFile, newCallFrame, callDataScopeChain->globalData);
             else
 #endif
@@ -923,7 +960,7 @@ JSObject* Interpreter::executeConstruct(CallFrame* callFrame, JSObject* construc
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
-            if (callFrame->globalData().canUseJIT())
+            if (shouldRunJITCode(callFrame->globalData(), newCodeBlock))
                 result = constructData.js.functionExecutable->generatedJITCodeForConstruct().execute(&m_registerFile, newCallFrame, constructDataScopeChain->globalData);
             else
 #endif
@@ -1026,7 +1063,7 @@ JSValue Interpreter::execute(CallFrameClosure& closure)
         m_reentryDepth++;  
 #if ENABLE(JIT)
 #if ENABLE(INTERPRETER)
-        if (closure.newCallFrame->globalData().canUseJIT())
+        if (shouldRunJITCode(closure.newCallFrame->globalData(), closure.newCallFrame->codeBlock()))
 #endif
             result = closure.functionExecutable->generatedJITCodeForCall().execute(&m_registerFile, closure.newCallFrame, closure.globalData);
 #if ENABLE(INTERPRETER)
@@ -1049,6 +1086,41 @@ void Interpreter::endRepeatCall(CallFrameClosure& closure)
     m_registerFile.shrink(closure.oldEnd);
 }
 
+#if ENABLE(TIERED_COMPILATION)
+JSValue Interpreter::executeFromMachineCode(CallFrame* callFrame, CodeBlock* codeBlock)
+{
+    CallFrame* callerFrame = callFrame->callerFrame();
+    ReturnAddressPtr returnPC = callFrame->returnPC();
+
+    if (m_reentryDepth >= MaxSmallThreadReentryDepth && m_reentryDepth >= callFrame->globalData().maxReentryDepth)
+        return checkedReturn(throwStackOverflowError(callerFrame));
+    if (!m_registerFile.grow(callFrame->registers() + codeBlock->m_numCalleeRegisters))
+        return checkedReturn(throwStackOverflowError(callerFrame));
+
+    // The frame now returns, and unwinds exceptions, to here rather than to
+    // the caller's machine code, which checks for an exception itself. Both
+    // links are put back for the trampoline that returns to the caller.
+    callFrame->setCodeBlock(codeBlock);
+    callFrame->setCallerFrame(callerFrame->addHostCallFrameFlag());
+
+    JSValue result;
+    {
+        SamplingTool::CallRecord callRecord(m_sampler.get());
+
+        m_reentryDepth++;
+        if (shouldRunJITCode(callFrame->globalData(), codeBlock))
+            result = codeBlock->getJITCode().execute(&m_registerFile, callFrame, &callFrame->globalData());
+        else
+            result = privateExecute(Normal, &m_registerFile, callFrame);
+        m_reentryDepth--;
+    }
+
+    callFrame->setCallerFrame(callerFrame);
+    callFrame->setReturnPC(returnPC.value());
+    return checkedReturn(result);
+}
+#endif
+
 JSValue Interpreter::execute(EvalExecutable* eval, CallFrame* callFrame, JSObject* thisObj, ScopeChainNode* scopeChain)
 {
     JSObject* compileError = eval->compile(callFrame, scopeChain);
@@ -1133,7 +1205,7 @@ JSValue Interpreter::execute(EvalExecutable* eval, CallFrame* callFrame, JSObjec
         
 #if ENABLE(JIT)
 #if ENABLE(INTERPRETER)
-        if (callFrame->globalData().canUseJIT())
+        if (shouldRunJITCode(callFrame->globalData(), codeBlock))
 #endif
             result = eval->generatedJITCode().execute(&m_registerFile, newCallFrame, scopeChain->globalData);
 #if ENABLE(INTERPRETER)
@@ -1250,12 +1322,15 @@ NEVER_INLINE void Interpreter::tryCachePutByID(CallFrame* callFrame, CodeBlock*
 
         // put_by_id_transition checks the prototype chain for setters.
         normalizePrototypeChain(callFrame, baseCell);
+        // Getting the prototype chain may allocate, and so collect, which
+        // must not see the instruction half specialized.
+        StructureChain* prototypeChain = structure->prototypeChain(callFrame);
         JSCell* owner = codeBlock->ownerExecutable();
         JSGlobalData& globalData = callFrame->globalData();
         vPC[0] = getOpcode(op_put_by_id_transition);
         vPC[4].u.structure.set(globalData, owner, structure->previousID());
         vPC[5].u.structure.set(globalData, owner, structure);
-        vPC[6].u.structureChain.set(callFrame->globalData(), codeBlock->ownerExecutable(), structure->prototypeChain(callFrame));
+        vPC[6].u.structureChain.set(globalData, owner, prototypeChain);
         ASSERT(vPC[6].u.structureChain);
         vPC[7] = slot.cachedOffset();
         return;
@@ -1386,7 +1461,8 @@ NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock*
         return;
     }
 
-    
+    // As for put_by_id transitions, allocate the prototype chain before specializing.
+    StructureChain* prototypeChain = structure->prototypeChain(callFrame);
     switch (slot.cachedPropertyType()) {
     case PropertySlot::Getter:
         vPC[0] = getOpcode(op_get_by_id_getter_chain);
@@ -1402,7 +1478,7 @@ NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock*
         break;
     }
     vPC[4].u.structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), structure);
-    vPC[5].u.structureChain.set(callFrame->globalData(), codeBlock->ownerExecutable(), structure->prototypeChain(callFrame));
+    vPC[5].u.structureChain.set(callFrame->globalData(), codeBlock->ownerExecutable(), prototypeChain);
     vPC[6] = count;
 }
 
@@ -1429,7 +1505,7 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         return JSValue();
     }
     
-#if ENABLE(JIT)
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
 #if ENABLE(INTERPRETER)
     // Mixing Interpreter + JIT is not supported.
     if (callFrame->globalData().canUseJIT())
@@ -1473,6 +1549,16 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         } \
         tickCount = globalData->timeoutChecker.ticksUntilNextCheck(); \
     }
+
+#if ENABLE(TIERED_COMPILATION)
+    // Loops that get hot carry on in the machine code, from the loop header
+    // they have just jumped back to.
+#define CHECK_FOR_HOT_LOOP() \
+    if (UNLIKELY(shouldRunJITCode(*globalData, codeBlock))) \
+        goto vm_enter_machine_code;
+#else
+#define CHECK_FOR_HOT_LOOP()
+#endif
     
 #if ENABLE(OPCODE_SAMPLING)
     #define SAMPLE(codeBlock, vPC) m_sampler->sample(codeBlock, vPC)
@@ -3410,6 +3496,7 @@ skip_id_custom_self:
         int target = vPC[1].u.operand;
         CHECK_FOR_TIMEOUT();
         vPC += target;
+        CHECK_FOR_HOT_LOOP();
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_jmp) {
@@ -3440,6 +3527,7 @@ skip_id_custom_self:
         if (callFrame->r(cond).jsValue().toBoolean(callFrame)) {
             vPC += target;
             CHECK_FOR_TIMEOUT();
+            CHECK_FOR_HOT_LOOP();
             NEXT_INSTRUCTION();
         }
         
@@ -3460,6 +3548,7 @@ skip_id_custom_self:
         if (!callFrame->r(cond).jsValue().toBoolean(callFrame)) {
             vPC += target;
             CHECK_FOR_TIMEOUT();
+            CHECK_FOR_HOT_LOOP();
             NEXT_INSTRUCTION();
         }
         
@@ -3572,6 +3661,7 @@ skip_id_custom_self:
         if (result) {
             vPC += target;
             CHECK_FOR_TIMEOUT();
+            CHECK_FOR_HOT_LOOP();
             NEXT_INSTRUCTION();
         }
         
@@ -3599,6 +3689,7 @@ skip_id_custom_self:
         if (result) {
             vPC += target;
             CHECK_FOR_TIMEOUT();
+            CHECK_FOR_HOT_LOOP();
             NEXT_INSTRUCTION();
         }
         
@@ -3892,6 +3983,10 @@ skip_id_custom_self:
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             vPC = newCodeBlock->instructions().begin();
+#if ENABLE(TIERED_COMPILATION)
+            if (shouldRunJITCode(*globalData, codeBlock))
+                goto vm_enter_machine_code;
+#endif
 
 #if ENABLE(OPCODE_STATS)
             OpcodeStats::resetLastInstruction();
@@ -4051,6 +4146,10 @@ skip_id_custom_self:
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             vPC = newCodeBlock->instructions().begin();
+#if ENABLE(TIERED_COMPILATION)
+            if (shouldRunJITCode(*globalData, codeBlock))
+                goto vm_enter_machine_code;
+#endif
             
 #if ENABLE(OPCODE_STATS)
             OpcodeStats::resetLastInstruction();
@@ -4391,6 +4490,10 @@ skip_id_custom_self:
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_construct), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
             codeBlock = newCodeBlock;
             vPC = newCodeBlock->instructions().begin();
+#if ENABLE(TIERED_COMPILATION)
+            if (shouldRunJITCode(*globalData, codeBlock))
+                goto vm_enter_machine_code;
+#endif
 #if ENABLE(OPCODE_STATS)
             OpcodeStats::resetLastInstruction();
 #endif
@@ -4758,6 +4861,43 @@ skip_id_custom_self:
         vPC += OPCODE_LENGTH(op_profile_did_call);
         NEXT_INSTRUCTION();
     }
+#if ENABLE(TIERED_COMPILATION)
+    vm_enter_machine_code: {
+        /* Leaves the interpreter for the machine code of the current frame,
+           which carries on from vPC: the entry point of a function that has
+           just been called, or the header of a hot loop. While the machine
+           code runs, the frame looks as if it had been entered from native
+           code, so that it returns, and unwinds exceptions, to here; the
+           interpreter then continues in its caller.
+        */
+        Instruction* returnVPC = callFrame->returnVPC();
+        CallFrame* callerFrame = callFrame->callerFrame();
+        callFrame->setCallerFrame(callerFrame->addHostCallFrameFlag());
+
+        JSValue returnValue;
+        // Every code block starts with op_enter, so a loop header is never
+        // the first instruction.
+        if (vPC == codeBlock->instructions().begin())
+            returnValue = codeBlock->getJITCode().execute(registerFile, callFrame, globalData);
+        else {
+            void* loopHeader = codeBlock->machineCodeForBytecodeIndex(vPC - codeBlock->instructions().begin());
+            ASSERT(loopHeader);
+            callFrame->setReturnPC(loopHeader);
+            MacroAssemblerCodePtr entryThunk = globalData->jitStubs->ctiStub(globalData, interpreterOSREntryThunkGenerator);
+            returnValue = JSValue::decode(ctiTrampoline(entryThunk.executableAddress(), registerFile, callFrame, 0, enabledProfilerReference, globalData));
+        }
+
+        if (callerFrame->hasHostCallFrameFlag())
+            return globalData->exception ? jsNull() : returnValue;
+
+        callFrame = callerFrame;
+        codeBlock = callFrame->codeBlock();
+        vPC = returnVPC;
+        CHECK_FOR_EXCEPTION();
+        functionReturnValue = returnValue;
+        NEXT_INSTRUCTION();
+    }
+#endif
     vm_throw: {
         globalData->exception = JSValue();
         if (!tickCount) {
@@ -4785,6 +4925,7 @@ skip_id_custom_self:
     #undef DEFINE_OPCODE
     #undef CHECK_FOR_EXCEPTION
     #undef CHECK_FOR_TIMEOUT
+    #undef CHECK_FOR_HOT_LOOP
 #endif // ENABLE(INTERPRETER)
 }
 
@@ -4819,8 +4960,18 @@ JSValue Interpreter::retrieveCaller(CallFrame* callFrame, JSFunction* function)
         return jsNull();
 
     CallFrame* callerFrame = functionCallFrame->callerFrame();
+#if ENABLE(TIERED_COMPILATION)
+    // Calls between the interpreter and machine code look like calls from
+    // native code, but the caller is still a JavaScript frame.
+    if (callerFrame->hasHostCallFrameFlag()) {
+        callerFrame = callerFrame->removeHostCallFrameFlag();
+        if (!callerFrame || !callerFrame->codeBlock())
+            return jsNull();
+    }
+#else
     if (callerFrame->hasHostCallFrameFlag())
         return jsNull();
+#endif
 
     JSValue caller = callerFrame->callee();
     if (!caller)
@@ -4842,17 +4993,7 @@ void Interpreter::retrieveLastCaller(CallFrame* callFrame, int& lineNumber, intp
     CodeBlock* callerCodeBlock = callerFrame->codeBlock();
     if (!callerCodeBlock)
         return;
-    unsigned bytecodeOffset = 0;
-#if ENABLE(INTERPRETER)
-    if (!callerFrame->globalData().canUseJIT())
-        bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
-#if ENABLE(JIT)
-    else
-        bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnPC());
-#endif
-#else
-    bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnPC());
-#endif
+    unsigned bytecodeOffset = bytecodeOffsetOfReturn(callFrame, callerCodeBlock);
     lineNumber = callerCodeBlock->lineNumberForBytecodeOffset(bytecodeOffset - 1);
     sourceID = callerCodeBlock->ownerExecutable()->sourceID();
     sourceURL = callerCodeBlock->ownerExecutable()->sourceURL();
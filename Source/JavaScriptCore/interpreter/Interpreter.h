@@ -98,6 +98,11 @@ namespace JSC {
         JSValue executeCall(CallFrame*, JSObject* function, CallType, const CallData&, JSValue thisValue, const ArgList&);
         JSObject* executeConstruct(CallFrame*, JSObject* function, ConstructType, const ConstructData&, const ArgList&);
         JSValue execute(EvalExecutable* evalNode, CallFrame* exec, JSObject* thisObj, ScopeChainNode* scopeChain);
+#if ENABLE(TIERED_COMPILATION)
+        // Runs a function that machine code has called before the function
+        // itself has been compiled, in a call frame the caller has set up.
+        JSValue executeFromMachineCode(CallFrame*, CodeBlock*);
+#endif
 
         JSValue retrieveArguments(CallFrame*, JSFunction*) const;
         JSValue retrieveCaller(CallFrame*, JSFunction*) const;
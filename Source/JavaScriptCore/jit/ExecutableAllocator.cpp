@@ -29,10 +29,135 @@
 
 #if ENABLE(ASSEMBLER)
 
+#include "TCSpinLock.h"
+
 namespace JSC {
 
 size_t ExecutableAllocator::pageSize = 0;
 
+#if ENABLE(JIT)
+
+// An ExecutablePool's blocks are freed only once all of the code in the pool
+// has died. Rather than going straight back to the system, blocks of up to
+// maxFreeListBlockPages pages are kept committed on free lists, one list per
+// size in pages, and handed to the next pool that asks for that size. Code
+// never moves, so this reuses space without compacting it; trim() hands the
+// free lists back to the system when memory is tight.
+static const size_t maxFreeListBlockPages = 16;
+static const size_t maxFreeListBytes = 2 * 1024 * 1024;
+
+static SpinLock freeListLock = SPINLOCK_INITIALIZER;
+static Vector<ExecutablePool::Allocation>* freeLists = 0; // Indexed by size in pages.
+static ExecutableAllocatorStatistics allocatorStatistics;
+
+// Called with freeListLock held.
+size_t ExecutablePool::releaseFreeLists()
+{
+    if (!freeLists)
+        return 0;
+
+    size_t releasedBytes = 0;
+    for (size_t pages = 1; pages <= maxFreeListBlockPages; ++pages) {
+        Vector<ExecutablePool::Allocation>& freeList = freeLists[pages];
+        for (size_t i = 0; i < freeList.size(); ++i) {
+            releasedBytes += freeList[i].size();
+            systemRelease(freeList[i]);
+        }
+        freeList.clear();
+    }
+
+    ASSERT(releasedBytes == allocatorStatistics.freeBytes);
+    allocatorStatistics.committedBytes -= releasedBytes;
+    allocatorStatistics.freeBytes = 0;
+    allocatorStatistics.trimmedBytes += releasedBytes;
+    return releasedBytes;
+}
+
+ExecutablePool::Allocation ExecutablePool::allocateBlock(size_t n)
+{
+    ASSERT(!(n % JIT_ALLOCATOR_PAGE_SIZE));
+
+    SpinLockHolder lockHolder(&freeListLock);
+    ++allocatorStatistics.allocationCount;
+
+    size_t pages = n / JIT_ALLOCATOR_PAGE_SIZE;
+    if (freeLists && pages <= maxFreeListBlockPages && !freeLists[pages].isEmpty()) {
+        Allocation result = freeLists[pages].last();
+        freeLists[pages].removeLast();
+        allocatorStatistics.freeBytes -= result.size();
+        ++allocatorStatistics.reuseCount;
+        return result;
+    }
+
+    Allocation result = systemAlloc(n);
+    if (!result.base()) {
+        // The platform is out of memory for code; the free lists are all
+        // that's left, and they may be fragmenting what the platform has.
+        releaseFreeLists();
+        result = systemAlloc(n);
+        if (!result.base())
+            return result;
+    }
+    allocatorStatistics.committedBytes += result.size();
+    return result;
+}
+
+void ExecutablePool::releaseBlock(Allocation& allocation)
+{
+    SpinLockHolder lockHolder(&freeListLock);
+
+    size_t size = allocation.size();
+    size_t pages = size / JIT_ALLOCATOR_PAGE_SIZE;
+    if (pages <= maxFreeListBlockPages && allocatorStatistics.freeBytes + size <= maxFreeListBytes) {
+        if (!freeLists)
+            freeLists = new Vector<Allocation>[maxFreeListBlockPages + 1];
+        freeLists[pages].append(allocation);
+        allocatorStatistics.freeBytes += size;
+        return;
+    }
+
+    allocatorStatistics.committedBytes -= size;
+    systemRelease(allocation);
+}
+
+size_t ExecutableAllocator::committedByteCount()
+{
+    SpinLockHolder lockHolder(&freeListLock);
+    return allocatorStatistics.committedBytes;
+}
+
+size_t ExecutableAllocator::freeListByteCount()
+{
+    // Read without the lock; callers only use this as a heuristic.
+    return allocatorStatistics.freeBytes;
+}
+
+ExecutableAllocatorStatistics ExecutableAllocator::statistics()
+{
+    SpinLockHolder lockHolder(&freeListLock);
+
+    ExecutableAllocatorStatistics result = allocatorStatistics;
+    result.freeBlockCount = 0;
+    result.largestFreeBlock = 0;
+    if (freeLists) {
+        for (size_t pages = 1; pages <= maxFreeListBlockPages; ++pages) {
+            Vector<ExecutablePool::Allocation>& freeList = freeLists[pages];
+            result.freeBlockCount += freeList.size();
+            if (!freeList.isEmpty())
+                result.largestFreeBlock = pages * JIT_ALLOCATOR_PAGE_SIZE;
+        }
+    }
+    return result;
+}
+
+size_t ExecutableAllocator::trim()
+{
+    SpinLockHolder lockHolder(&freeListLock);
+    return ExecutablePool::releaseFreeLists();
+}
+
+#endif // ENABLE(JIT)
+
 #if ENABLE(EXECUTABLE_ALLOCATOR_DEMAND)
 
 void ExecutableAllocator::intializePageSize()
@@ -71,11 +196,6 @@ bool ExecutableAllocator::underMemoryPressure()
 {
     return false;
 }
-    
-size_t ExecutableAllocator::committedByteCount()
-{
-    return 0;
-} 
 
 #endif
 
@@ -97,7 +97,26 @@ inline size_t roundUpAllocationSize(size_t request, size_t granularity)
 
 namespace JSC {
 
+// Only kept when the JIT is enabled, since otherwise there is no executable
+// memory. The figures count whole blocks: the unused space at the end of a block
+// that an ExecutablePool still holds counts as committed, not as free.
+struct ExecutableAllocatorStatistics {
+    size_t committedBytes; // Memory committed for JIT code, including the free lists.
+    size_t freeBytes; // Memory on the free lists, waiting to be reused.
+    size_t freeBlockCount;
+    size_t largestFreeBlock;
+    size_t allocationCount; // Blocks handed to ExecutablePools.
+    size_t reuseCount; // Blocks handed out from the free lists.
+    size_t trimmedBytes; // Memory returned to the system by trim() so far.
+
+    // How much of the memory on the free lists is in blocks other than the
+    // largest one. Space left over inside blocks that are in use is not counted.
+    double freeListFragmentation() const { return freeBytes ? 1.0 - static_cast<double>(largestFreeBlock) / freeBytes : 0; }
+};
+
 class ExecutablePool : public RefCounted<ExecutablePool> {
+    friend class ExecutableAllocator;
+
 public:
 #if ENABLE(EXECUTABLE_ALLOCATOR_DEMAND)
     typedef PageAllocation Allocation;
@@ -155,12 +174,18 @@ public:
     {
         AllocationList::iterator end = m_pools.end();
         for (AllocationList::iterator ptr = m_pools.begin(); ptr != end; ++ptr)
-            ExecutablePool::systemRelease(*ptr);
+            ExecutablePool::releaseBlock(*ptr);
     }
 
     size_t available() const { return (m_pools.size() > 1) ? 0 : m_end - m_freePtr; }
 
 private:
+    // Blocks are taken from the size-segregated free lists when possible, and
+    // go back to them when the pool dies; systemAlloc and systemRelease get
+    // memory from, and return it to, the platform.
+    static Allocation allocateBlock(size_t n);
+    static void releaseBlock(Allocation&);
+    static size_t releaseFreeLists();
     static Allocation systemAlloc(size_t n);
     static void systemRelease(Allocation& alloc);
 
@@ -330,8 +355,14 @@ public:
     #error "The cacheFlush support is missing on this platform."
 #endif
     static size_t committedByteCount();
+    static ExecutableAllocatorStatistics statistics();
+
+    // Returns the memory on the free lists to the system, and answers how
+    // many bytes that was.
+    static size_t trim();
 
 private:
+    static size_t freeListByteCount();
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
     static void reprotectRegion(void*, size_t, ProtectionSetting);
@@ -344,7 +375,7 @@ private:
 inline ExecutablePool::ExecutablePool(size_t n)
 {
     size_t allocSize = roundUpAllocationSize(n, JIT_ALLOCATOR_PAGE_SIZE);
-    Allocation mem = systemAlloc(allocSize);
+    Allocation mem = allocateBlock(allocSize);
     m_pools.append(mem);
     m_freePtr = static_cast<char*>(mem.base());
     if (!m_freePtr)
@@ -356,7 +387,7 @@ inline void* ExecutablePool::poolAllocate(size_t n)
 {
     size_t allocSize = roundUpAllocationSize(n, JIT_ALLOCATOR_PAGE_SIZE);
     
-    Allocation result = systemAlloc(allocSize);
+    Allocation result = allocateBlock(allocSize);
     if (!result.base())
         CRASH(); // Failed to allocate
     
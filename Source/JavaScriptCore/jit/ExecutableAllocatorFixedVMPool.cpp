@@ -423,14 +423,16 @@ public:
         size_t size = sizeClass.size();
         ASSERT(size);
 
+        // Let the caller decide what to do when the pool is exhausted; it may
+        // be able to free some memory and try again.
         if (size >= FixedVMPoolPageTables::size())
-            CRASH();
+            return ExecutablePool::Allocation(0, 0);
         if (m_pages.isFull())
-            CRASH();
+            return ExecutablePool::Allocation(0, 0);
 
         size_t offset = m_pages.allocate(sizeClass);
         if (offset == notFound)
-            CRASH();
+            return ExecutablePool::Allocation(0, 0);
 
         void* pointer = offsetToPointer(offset);
         m_reservation.commit(pointer, size);
@@ -485,12 +487,6 @@ static SpinLock spinlock = SPINLOCK_INITIALIZER;
 static FixedVMPoolAllocator* allocator = 0;
 
 
-size_t ExecutableAllocator::committedByteCount()
-{
-    SpinLockHolder lockHolder(&spinlock);
-    return allocator ? allocator->allocated() : 0;
-}   
-
 void ExecutableAllocator::intializePageSize()
 {
     ExecutableAllocator::pageSize = getpagesize();
@@ -507,8 +503,13 @@ bool ExecutableAllocator::isValid() const
 bool ExecutableAllocator::underMemoryPressure()
 {
     // Technically we should take the spin lock here, but we don't care if we get stale data.
-    // This is only really a heuristic anyway.
-    return allocator && (allocator->allocated() > (FixedVMPoolPageTables::size() / 2));
+    // This is only really a heuristic anyway. Memory on the free lists can be
+    // given back at any time, so it doesn't count.
+    if (!allocator)
+        return false;
+    size_t allocated = allocator->allocated();
+    size_t reusable = std::min(allocated, freeListByteCount());
+    return allocated - reusable > FixedVMPoolPageTables::size() / 2;
 }
 
 ExecutablePool::Allocation ExecutablePool::systemAlloc(size_t size)
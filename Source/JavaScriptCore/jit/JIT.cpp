@@ -46,6 +46,10 @@ JSC::MacroAssemblerX86Common::SSE2CheckState JSC::MacroAssemblerX86Common::s_sse
 #include "SamplingTool.h"
 #include "dfg/DFGNode.h" // for DFG_SUCCESS_STATS
 
+#if ENABLE(DFG_JIT)
+#include "DFGByteCodeParser.h"
+#endif
+
 using namespace std;
 
 namespace JSC {
@@ -87,6 +91,9 @@ JIT::JIT(JSGlobalData* globalData, CodeBlock* codeBlock, void* linkerOffset)
     , m_jumpTargetsPosition(0)
 #endif
     , m_linkerOffset(linkerOffset)
+#if ENABLE(DFG_JIT)
+    , m_canBeOptimized(false)
+#endif
 {
 }
 
@@ -111,6 +118,125 @@ void JIT::emitTimeoutCheck()
 }
 #endif
 
+#if ENABLE(VALUE_PROFILER)
+void JIT::emitValueProfilingSite(RegisterID value)
+{
+    if (!shouldEmitProfiling())
+        return;
+    if (ValueProfile* valueProfile = m_codeBlock->valueProfileForBytecodeOffset(m_bytecodeOffset))
+        emitValueProfilingSite(valueProfile, value);
+}
+
+void JIT::emitValueProfilingSite(ValueProfile* valueProfile, RegisterID value)
+{
+    // Classifies the value without needing a scratch register, since the value
+    // is often still needed in its register afterwards.
+    AbsoluteAddress observedTypes(&valueProfile->m_observedTypes);
+    JumpList done;
+
+    Jump notInt32 = branchPtr(Below, value, tagTypeNumberRegister);
+    or32(TrustedImm32(PredictInt32), observedTypes);
+    done.append(jump());
+    notInt32.link(this);
+
+    Jump notNumber = branchTestPtr(Zero, value, tagTypeNumberRegister);
+    or32(TrustedImm32(PredictDouble), observedTypes);
+    done.append(jump());
+    notNumber.link(this);
+
+    Jump notCell = branchTestPtr(NonZero, value, tagMaskRegister);
+    Jump notArray = branchPtr(NotEqual, Address(value), TrustedImmPtr(m_globalData->jsArrayVPtr));
+    or32(TrustedImm32(PredictArray), observedTypes);
+    done.append(jump());
+    notArray.link(this);
+    Jump notString = branchPtr(NotEqual, Address(value), TrustedImmPtr(m_globalData->jsStringVPtr));
+    or32(TrustedImm32(PredictString), observedTypes);
+    done.append(jump());
+    notString.link(this);
+    or32(TrustedImm32(PredictObjectOther), observedTypes);
+    done.append(jump());
+    notCell.link(this);
+
+    Jump isFalse = branchPtr(Equal, value, TrustedImmPtr(JSValue::encode(jsBoolean(false))));
+    Jump notTrue = branchPtr(NotEqual, value, TrustedImmPtr(JSValue::encode(jsBoolean(true))));
+    isFalse.link(this);
+    or32(TrustedImm32(PredictBoolean), observedTypes);
+    done.append(jump());
+    notTrue.link(this);
+    or32(TrustedImm32(PredictOther), observedTypes);
+
+    done.link(this);
+}
+
+static bool hasValueProfile(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_get_by_id:
+    case op_get_by_val:
+    case op_get_global_var:
+    case op_add:
+    case op_sub:
+    case op_mul:
+    case op_mod:
+    case op_urshift:
+    case op_pre_inc:
+    case op_pre_dec:
+    case op_post_inc:
+    case op_post_dec:
+        return true;
+    default:
+        return false;
+    }
+}
+#endif
+
+#if ENABLE(DFG_JIT)
+void JIT::emitOptimizationCheck(OptimizationCheckKind kind)
+{
+    move(TrustedImmPtr(m_codeBlock->addressOfExecuteCounter()), regT1);
+    Jump skipOptimize = branchAdd32(Signed, TrustedImm32(1), Address(regT1));
+    JITStubCall stubCall(this, kind == EntryOptimizationCheck ? cti_optimize_from_entry : cti_optimize_from_loop);
+    if (kind == LoopOptimizationCheck)
+        stubCall.addArgument(TrustedImm32(m_bytecodeOffset));
+    stubCall.call();
+    // The stub returns where to continue in the optimized code, if anywhere.
+    Jump stayInBaseline = branchTestPtr(Zero, regT0);
+    jump(regT0);
+    stayInBaseline.link(this);
+    skipOptimize.link(this);
+}
+#endif
+
+#if ENABLE(DFG_JIT) || ENABLE(TIERED_COMPILATION)
+void JIT::findLoopHeaders()
+{
+    Instruction* instructionsBegin = m_codeBlock->instructions().begin();
+    unsigned instructionCount = m_codeBlock->instructions().size();
+
+    m_isLoopHeader.fill(false, instructionCount);
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
+        Instruction* currentInstruction = instructionsBegin + bytecodeOffset;
+        OpcodeID opcodeID = m_interpreter->getOpcodeID(currentInstruction->u.opcode);
+        switch (opcodeID) {
+        case op_loop:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[1].u.operand] = true;
+            break;
+        case op_loop_if_true:
+        case op_loop_if_false:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[2].u.operand] = true;
+            break;
+        case op_loop_if_less:
+        case op_loop_if_lesseq:
+            m_isLoopHeader[bytecodeOffset + currentInstruction[3].u.operand] = true;
+            break;
+        default:
+            break;
+        }
+        bytecodeOffset += opcodeLengths[opcodeID];
+    }
+}
+#endif
+
 #define NEXT_OPCODE(name) \
     m_bytecodeOffset += OPCODE_LENGTH(name); \
     break;
@@ -184,12 +310,26 @@ void JIT::privateCompileMainPass()
 #endif
 
 #if USE(JSVALUE64)
-        if (m_labels[m_bytecodeOffset].isUsed())
+        bool isJumpTarget = m_labels[m_bytecodeOffset].isUsed();
+#if ENABLE(DFG_JIT)
+        // Optimized code can exit into the start of any instruction.
+        isJumpTarget |= m_canBeOptimized;
+#endif
+        if (isJumpTarget)
             killLastResultRegister();
 #endif
 
         m_labels[m_bytecodeOffset] = label();
 
+#if ENABLE(DFG_JIT)
+        if (m_canBeOptimized && m_isLoopHeader[m_bytecodeOffset])
+            emitOptimizationCheck(LoopOptimizationCheck);
+#endif
+#if ENABLE(VALUE_PROFILER)
+        if (shouldEmitProfiling() && hasValueProfile(m_interpreter->getOpcodeID(currentInstruction->u.opcode)))
+            m_codeBlock->addValueProfile(m_bytecodeOffset);
+#endif
+
         switch (m_interpreter->getOpcodeID(currentInstruction->u.opcode)) {
         DEFINE_BINARY_OP(op_del_by_val)
         DEFINE_BINARY_OP(op_in)
@@ -459,6 +599,12 @@ void JIT::privateCompileSlowCases()
 
 JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 {
+#if ENABLE(TIERED_COMPILATION)
+    // The code may have been running in the interpreter, which specializes
+    // property accesses in place.
+    m_codeBlock->unspecializePropertyAccessInstructions();
+#endif
+
     // Could use a pop_m, but would need to offset the following instruction if so.
     preserveReturnAddressAfterCall(regT2);
     emitPutToCallFrameHeader(regT2, RegisterFile::ReturnPC);
@@ -470,6 +616,17 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
     sampleInstruction(m_codeBlock->instructions().begin());
 #endif
 
+#if ENABLE(DFG_JIT)
+    m_canBeOptimized = m_codeBlock->codeType() == FunctionCode && !m_codeBlock->m_isConstructor && DFG::canCompile(m_globalData, m_codeBlock);
+    m_codeBlock->setCanBeOptimized(m_canBeOptimized);
+#endif
+#if ENABLE(TIERED_COMPILATION)
+    findLoopHeaders();
+#elif ENABLE(DFG_JIT)
+    if (m_canBeOptimized)
+        findLoopHeaders();
+#endif
+
     Jump registerFileCheck;
     if (m_codeBlock->codeType() == FunctionCode) {
 #if DFG_SUCCESS_STATS
@@ -486,6 +643,22 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 
     Label functionBody = label();
 
+#if ENABLE(VALUE_PROFILER)
+    if (m_codeBlock->codeType() == FunctionCode && shouldEmitProfiling()) {
+        for (int argument = 0; argument < m_codeBlock->m_numParameters; ++argument) {
+            ValueProfile* valueProfile = m_codeBlock->addValueProfile(-1);
+            loadPtr(Address(callFrameRegister, (argument - m_codeBlock->m_numParameters - RegisterFile::CallFrameHeaderSize) * static_cast<int>(sizeof(Register))), regT0);
+            emitValueProfilingSite(valueProfile, regT0);
+        }
+    }
+#endif
+#if ENABLE(DFG_JIT)
+    if (m_canBeOptimized) {
+        m_bytecodeOffset = 0;
+        emitOptimizationCheck(EntryOptimizationCheck);
+    }
+#endif
+
     privateCompileMainPass();
     privateCompileLinkPass();
     privateCompileSlowCases();
@@ -569,6 +742,9 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
         info.callReturnLocation = patchBuffer.locationOf(m_propertyAccessCompilationInfo[i].callReturnLocation);
         info.hotPathBegin = patchBuffer.locationOf(m_propertyAccessCompilationInfo[i].hotPathBegin);
     }
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    PropertyAccessSampling::addCodeBlock(m_codeBlock);
+#endif
 #endif
 #if ENABLE(JIT_OPTIMIZE_CALL)
     for (unsigned i = 0; i < m_codeBlock->numberOfCallLinkInfos(); ++i) {
@@ -586,10 +762,38 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
         info.callReturnLocation = m_codeBlock->structureStubInfo(m_methodCallCompilationInfo[i].propertyAccessIndex).callReturnLocation;
     }
 
-    if (m_codeBlock->codeType() == FunctionCode && functionEntryArityCheck)
-        *functionEntryArityCheck = patchBuffer.locationOf(arityCheck);
+#if ENABLE(DFG_JIT)
+    if (m_canBeOptimized)
+        m_codeBlock->setJITCodeEntryAfterReturnPCOffset(patchBuffer.offsetOf(beginLabel));
+#endif
+#if ENABLE(DFG_JIT) || ENABLE(TIERED_COMPILATION)
+    Instruction* instructionsBegin = m_codeBlock->instructions().begin();
+    unsigned instructionCount = m_codeBlock->instructions().size();
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; bytecodeOffset += opcodeLengths[m_interpreter->getOpcodeID(instructionsBegin[bytecodeOffset].u.opcode)]) {
+        bool isEntryPoint = false;
+#if ENABLE(DFG_JIT)
+        // Optimized code can exit into the start of any instruction.
+        isEntryPoint |= m_canBeOptimized;
+#endif
+#if ENABLE(TIERED_COMPILATION)
+        // Frames that were running in the interpreter come in at loop headers.
+        isEntryPoint |= m_isLoopHeader[bytecodeOffset];
+#endif
+        if (isEntryPoint)
+            m_codeBlock->addJITCodeMapEntry(bytecodeOffset, patchBuffer.offsetOf(m_labels[bytecodeOffset]));
+    }
+#endif
+
+    CodePtr withArityCheck;
+    if (m_codeBlock->codeType() == FunctionCode) {
+        withArityCheck = patchBuffer.locationOf(arityCheck);
+        if (functionEntryArityCheck)
+            *functionEntryArityCheck = withArityCheck;
+    }
 
-    return patchBuffer.finalizeCode();
+    JITCode code = patchBuffer.finalizeCode();
+    m_codeBlock->setJITCode(code, withArityCheck);
+    return code;
 }
 
 #if ENABLE(JIT_OPTIMIZE_CALL)
@@ -217,6 +217,12 @@ namespace JSC {
             jit.privateCompilePutByIdTransition(stubInfo, oldStructure, newStructure, cachedOffset, chain, returnAddress, direct);
         }
 
+        static void compilePutByIdReplaceList(JSGlobalData* globalData, CodeBlock* codeBlock, StructureStubInfo* stubInfo, PolymorphicAccessStructureList* polymorphicStructures, int listSize, const Identifier& ident, ReturnAddressPtr returnAddress, bool direct)
+        {
+            JIT jit(globalData, codeBlock);
+            jit.privateCompilePutByIdReplaceList(stubInfo, polymorphicStructures, listSize, ident, returnAddress, direct);
+        }
+
         static void compileCTIMachineTrampolines(JSGlobalData* globalData, RefPtr<ExecutablePool>* executablePool, TrampolineStructure *trampolines)
         {
             if (!globalData->canUseJIT())
@@ -270,6 +276,7 @@ namespace JSC {
         void privateCompileGetByIdChainList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, StructureChain* chain, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, CallFrame* callFrame);
         void privateCompileGetByIdChain(StructureStubInfo*, Structure*, StructureChain*, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame);
         void privateCompilePutByIdTransition(StructureStubInfo*, Structure*, Structure*, size_t cachedOffset, StructureChain*, ReturnAddressPtr returnAddress, bool direct);
+        void privateCompilePutByIdReplaceList(StructureStubInfo*, PolymorphicAccessStructureList*, int listSize, const Identifier&, ReturnAddressPtr returnAddress, bool direct);
 
         void privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executablePool, JSGlobalData* data, TrampolineStructure *trampolines);
         Label privateCompileCTINativeCall(JSGlobalData*, bool isConstruct = false);
@@ -933,6 +940,13 @@ namespace JSC {
         void emitLoadCharacterString(RegisterID src, RegisterID dst, JumpList& failures);
         
         void emitTimeoutCheck();
+
+#if ENABLE(GGC)
+        // Must accompany every store of a JSValue into a cell. Clobbers scratch,
+        // which may be owner.
+        void emitWriteBarrier(RegisterID owner, RegisterID scratch);
+        void emitWriteBarrier(JSCell* owner);
+#endif
 #ifndef NDEBUG
         void printBytecodeOperandTypes(unsigned src1, unsigned src2);
 #endif
@@ -946,6 +960,34 @@ namespace JSC {
         void emitCount(AbstractSamplingCounter&, uint32_t = 1);
 #endif
 
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+        void emitCountPropertyAccess(unsigned propertyAccessInstructionIndex);
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+        // Ors the kind of the value in the register into the value profile of
+        // the current instruction, if it has one.
+        void emitValueProfilingSite(RegisterID);
+        void emitValueProfilingSite(ValueProfile*, RegisterID);
+#if ENABLE(DFG_JIT)
+        bool shouldEmitProfiling() { return m_canBeOptimized; }
+#else
+        bool shouldEmitProfiling() { return true; }
+#endif
+#else
+        void emitValueProfilingSite(RegisterID) { }
+#endif
+
+#if ENABLE(DFG_JIT)
+        // Counts executions of function entries and loop headers, and asks for
+        // the function to be optimized once they get hot.
+        enum OptimizationCheckKind { EntryOptimizationCheck, LoopOptimizationCheck };
+        void emitOptimizationCheck(OptimizationCheckKind);
+#endif
+#if ENABLE(DFG_JIT) || ENABLE(TIERED_COMPILATION)
+        void findLoopHeaders();
+#endif
+
 #if ENABLE(OPCODE_SAMPLING)
         void sampleInstruction(Instruction*, bool = false);
 #endif
@@ -994,6 +1036,12 @@ namespace JSC {
 #endif
 #endif
         void* m_linkerOffset;
+#if ENABLE(DFG_JIT)
+        bool m_canBeOptimized;
+#endif
+#if ENABLE(DFG_JIT) || ENABLE(TIERED_COMPILATION)
+        Vector<bool> m_isLoopHeader;
+#endif
         static CodePtr stringGetByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool);
     } JIT_CLASS_ALIGNMENT;
 
@@ -204,6 +204,7 @@ void JIT::emitSlow_op_urshift(Instruction* currentInstruction, Vector<SlowCaseEn
             if (shift < 0 || !(shift & 31))
                 failures.append(branch32(LessThan, regT0, TrustedImm32(0)));
             emitFastArithReTagImmediate(regT0, regT0);
+            emitValueProfilingSite(regT0);
             emitPutVirtualRegister(dst, regT0);
             emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_rshift));
             failures.link(this);
@@ -226,6 +227,7 @@ void JIT::emitSlow_op_urshift(Instruction* currentInstruction, Vector<SlowCaseEn
                 urshift32(regT1, regT0);
                 failures.append(branch32(LessThan, regT0, TrustedImm32(0)));
                 emitFastArithReTagImmediate(regT0, regT0);
+                emitValueProfilingSite(regT0);
                 emitPutVirtualRegister(dst, regT0);
                 emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_rshift));
                 failures.link(this);
@@ -240,6 +242,7 @@ void JIT::emitSlow_op_urshift(Instruction* currentInstruction, Vector<SlowCaseEn
     stubCall.addArgument(op1, regT0);
     stubCall.addArgument(op2, regT1);
     stubCall.call(dst);
+    emitValueProfilingSite(regT0);
 }
 
 void JIT::emit_op_jnless(Instruction* currentInstruction)
@@ -790,6 +793,8 @@ void JIT::emitSlow_op_post_inc(Instruction* currentInstruction, Vector<SlowCaseE
     stubCall.addArgument(regT0);
     stubCall.addArgument(Imm32(srcDst));
     stubCall.call(result);
+    loadPtr(addressFor(srcDst), regT1);
+    emitValueProfilingSite(regT1);
 }
 
 void JIT::emit_op_post_dec(Instruction* currentInstruction)
@@ -817,6 +822,8 @@ void JIT::emitSlow_op_post_dec(Instruction* currentInstruction, Vector<SlowCaseE
     stubCall.addArgument(regT0);
     stubCall.addArgument(Imm32(srcDst));
     stubCall.call(result);
+    loadPtr(addressFor(srcDst), regT1);
+    emitValueProfilingSite(regT1);
 }
 
 void JIT::emit_op_pre_inc(Instruction* currentInstruction)
@@ -841,6 +848,7 @@ void JIT::emitSlow_op_pre_inc(Instruction* currentInstruction, Vector<SlowCaseEn
     JITStubCall stubCall(this, cti_op_pre_inc);
     stubCall.addArgument(regT0);
     stubCall.call(srcDst);
+    emitValueProfilingSite(regT0);
 }
 
 void JIT::emit_op_pre_dec(Instruction* currentInstruction)
@@ -865,6 +873,7 @@ void JIT::emitSlow_op_pre_dec(Instruction* currentInstruction, Vector<SlowCaseEn
     JITStubCall stubCall(this, cti_op_pre_dec);
     stubCall.addArgument(regT0);
     stubCall.call(srcDst);
+    emitValueProfilingSite(regT0);
 }
 
 /* ------------------------------ BEGIN: OP_MOD ------------------------------ */
@@ -906,6 +915,7 @@ void JIT::emitSlow_op_mod(Instruction* currentInstruction, Vector<SlowCaseEntry>
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT2);
     stubCall.call(result);
+    emitValueProfilingSite(regT0);
 }
 
 #else // CPU(X86) || CPU(X86_64) || CPU(MIPS)
@@ -993,6 +1003,7 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
     stubCall.call(result);
+    emitValueProfilingSite(regT0);
     Jump end = jump();
 
     if (op1HasImmediateIntFastCase) {
@@ -1047,6 +1058,7 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     }
     moveDoubleToPtr(fpRegT1, regT0);
     subPtr(tagTypeNumberRegister, regT0);
+    emitValueProfilingSite(regT0);
     emitPutVirtualRegister(result, regT0);
 
     end.link(this);
@@ -1064,6 +1076,7 @@ void JIT::emit_op_add(Instruction* currentInstruction)
         stubCall.addArgument(op1, regT2);
         stubCall.addArgument(op2, regT2);
         stubCall.call(result);
+        emitValueProfilingSite(regT0);
         return;
     }
 
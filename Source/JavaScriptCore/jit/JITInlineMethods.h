@@ -298,6 +298,20 @@ ALWAYS_INLINE void JIT::emitJumpSlowToHot(Jump jump, int relativeOffset)
     jump.linkTo(m_labels[m_bytecodeOffset + relativeOffset], this);
 }
 
+#if ENABLE(GGC)
+ALWAYS_INLINE void JIT::emitWriteBarrier(RegisterID owner, RegisterID scratch)
+{
+    move(owner, scratch);
+    andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+    store32(TrustedImm32(1), Address(scratch, MarkedBlock::offsetOfIsDirty()));
+}
+
+ALWAYS_INLINE void JIT::emitWriteBarrier(JSCell* owner)
+{
+    store32(TrustedImm32(1), MarkedBlock::blockFor(owner)->addressOfIsDirty());
+}
+#endif
+
 #if ENABLE(SAMPLING_FLAGS)
 ALWAYS_INLINE void JIT::setSamplingFlag(int32_t flag)
 {
@@ -329,6 +343,17 @@ ALWAYS_INLINE void JIT::emitCount(AbstractSamplingCounter& counter, uint32_t cou
 }
 #endif
 
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+ALWAYS_INLINE void JIT::emitCountPropertyAccess(unsigned propertyAccessInstructionIndex)
+{
+    // The CodeBlock's StructureStubInfos are all allocated before we compile,
+    // so the counter's address is fixed.
+    StructureStubInfo& stubInfo = m_codeBlock->structureStubInfo(propertyAccessInstructionIndex);
+    stubInfo.bytecodeOffset = m_bytecodeOffset;
+    add32(TrustedImm32(1), AbsoluteAddress(&stubInfo.executionCount));
+}
+#endif
+
 #if ENABLE(OPCODE_SAMPLING)
 #if CPU(X86_64)
 ALWAYS_INLINE void JIT::sampleInstruction(Instruction* instruction, bool inHostFunction)
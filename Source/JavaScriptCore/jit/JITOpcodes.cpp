@@ -102,7 +102,12 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
 
     loadPtr(Address(regT0, OBJECT_OFFSETOF(JSFunction, m_executable)), regT2);
 
+#if ENABLE(TIERED_COMPILATION)
+    // The callee may have bytecode but no machine code yet, in which case the interpreter runs it.
+    Jump hasCodeBlock3 = branchTestPtr(NonZero, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_jitCodeForCallWithArityCheck)));
+#else
     Jump hasCodeBlock3 = branch32(GreaterThanOrEqual, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParametersForCall)), TrustedImm32(0));
+#endif
     preserveReturnAddressAfterCall(regT3);
     restoreArgumentReference();
     Call callCompileCall = call();
@@ -113,6 +118,9 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     hasCodeBlock3.link(this);
 
     loadPtr(Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_jitCodeForCallWithArityCheck)), regT0);
+#if ENABLE(TIERED_COMPILATION)
+    Jump interpretCall = branchTestPtr(Zero, regT0);
+#endif
     jump(regT0);
 
     // VirtualConstruct Trampoline
@@ -122,7 +130,11 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
 
     loadPtr(Address(regT0, OBJECT_OFFSETOF(JSFunction, m_executable)), regT2);
 
+#if ENABLE(TIERED_COMPILATION)
+    Jump hasCodeBlock4 = branchTestPtr(NonZero, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_jitCodeForConstructWithArityCheck)));
+#else
     Jump hasCodeBlock4 = branch32(GreaterThanOrEqual, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParametersForConstruct)), TrustedImm32(0));
+#endif
     preserveReturnAddressAfterCall(regT3);
     restoreArgumentReference();
     Call callCompileConstruct = call();
@@ -133,8 +145,70 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     hasCodeBlock4.link(this);
 
     loadPtr(Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_jitCodeForConstructWithArityCheck)), regT0);
+#if ENABLE(TIERED_COMPILATION)
+    Jump interpretConstruct = branchTestPtr(Zero, regT0);
+#endif
     jump(regT0);
     
+#if ENABLE(TIERED_COMPILATION)
+    // InterpretCall Trampoline
+    // Entered in place of a callee's machine code, with its frame set up as for the arity check entry.
+    Label interpretCallBegin = align();
+    interpretCall.link(this);
+    preserveReturnAddressAfterCall(regT3);
+    emitPutToCallFrameHeader(regT3, RegisterFile::ReturnPC);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::Callee, regT0);
+    loadPtr(Address(regT0, OBJECT_OFFSETOF(JSFunction, m_executable)), regT2);
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT1);
+    Jump interpretCallArityOkay = branch32(Equal, regT1, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParametersForCall)));
+    restoreArgumentReference();
+    Call callInterpretCallArityCheck = call();
+    move(regT0, callFrameRegister);
+    interpretCallArityOkay.link(this);
+    restoreArgumentReference();
+    Call callInterpretCall = call();
+    loadPtr(&(globalData->exception), regT2);
+    Jump interpretCallException = branchTestPtr(NonZero, regT2);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::ReturnPC, regT1);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+    restoreReturnAddressBeforeReturn(regT1);
+    ret();
+
+    // InterpretConstruct Trampoline
+    Label interpretConstructBegin = align();
+    interpretConstruct.link(this);
+    preserveReturnAddressAfterCall(regT3);
+    emitPutToCallFrameHeader(regT3, RegisterFile::ReturnPC);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::Callee, regT0);
+    loadPtr(Address(regT0, OBJECT_OFFSETOF(JSFunction, m_executable)), regT2);
+    emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT1);
+    Jump interpretConstructArityOkay = branch32(Equal, regT1, Address(regT2, OBJECT_OFFSETOF(FunctionExecutable, m_numParametersForConstruct)));
+    restoreArgumentReference();
+    Call callInterpretConstructArityCheck = call();
+    move(regT0, callFrameRegister);
+    interpretConstructArityOkay.link(this);
+    restoreArgumentReference();
+    Call callInterpretConstruct = call();
+    loadPtr(&(globalData->exception), regT2);
+    Jump interpretConstructException = branchTestPtr(NonZero, regT2);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::ReturnPC, regT1);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+    restoreReturnAddressBeforeReturn(regT1);
+    ret();
+
+    // An exception thrown by the interpreted callee is rethrown from the call in the caller's machine code.
+    interpretCallException.link(this);
+    interpretConstructException.link(this);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::ReturnPC, regT1);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, callFrameRegister);
+    move(TrustedImmPtr(&globalData->exceptionLocation), regT2);
+    storePtr(regT1, regT2);
+    poke(callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
+    move(TrustedImmPtr(FunctionPtr(ctiVMThrowTrampoline).value()), regT1);
+    restoreReturnAddressBeforeReturn(regT1);
+    ret();
+#endif
+
     // If the parser fails we want to be able to be able to keep going,
     // So we handle this as a parse failure.
     callLinkFailures.link(this);
@@ -171,6 +245,12 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
 #endif
     patchBuffer.link(callCompileCall, FunctionPtr(cti_op_call_jitCompile));
     patchBuffer.link(callCompileConstruct, FunctionPtr(cti_op_construct_jitCompile));
+#if ENABLE(TIERED_COMPILATION)
+    patchBuffer.link(callInterpretCallArityCheck, FunctionPtr(cti_op_call_arityCheck));
+    patchBuffer.link(callInterpretCall, FunctionPtr(cti_vm_interpretCall));
+    patchBuffer.link(callInterpretConstructArityCheck, FunctionPtr(cti_op_construct_arityCheck));
+    patchBuffer.link(callInterpretConstruct, FunctionPtr(cti_vm_interpretConstruct));
+#endif
 
     CodeRef finalCode = patchBuffer.finalizeCode();
     *executablePool = finalCode.m_executablePool;
@@ -181,6 +261,10 @@ void JIT::privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executable
     trampolines->ctiVirtualConstruct = patchBuffer.trampolineAt(virtualConstructBegin);
     trampolines->ctiNativeCall = patchBuffer.trampolineAt(nativeCallThunk);
     trampolines->ctiNativeConstruct = patchBuffer.trampolineAt(nativeConstructThunk);
+#if ENABLE(TIERED_COMPILATION)
+    trampolines->ctiInterpretCall = patchBuffer.trampolineAt(interpretCallBegin);
+    trampolines->ctiInterpretConstruct = patchBuffer.trampolineAt(interpretConstructBegin);
+#endif
 #if ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
     trampolines->ctiStringLengthTrampoline = patchBuffer.trampolineAt(stringLengthBegin);
 #endif
@@ -454,6 +538,7 @@ void JIT::emit_op_get_global_var(Instruction* currentInstruction)
     JSVariableObject* globalObject = m_codeBlock->globalObject();
     loadPtr(&globalObject->m_registers, regT0);
     loadPtr(Address(regT0, currentInstruction[2].u.operand * sizeof(Register)), regT0);
+    emitValueProfilingSite(regT0);
     emitPutVirtualRegister(currentInstruction[1].u.operand);
 }
 
@@ -461,6 +546,9 @@ void JIT::emit_op_put_global_var(Instruction* currentInstruction)
 {
     emitGetVirtualRegister(currentInstruction[2].u.operand, regT1);
     JSVariableObject* globalObject = m_codeBlock->globalObject();
+#if ENABLE(GGC)
+    emitWriteBarrier(globalObject);
+#endif
     loadPtr(&globalObject->m_registers, regT0);
     storePtr(regT1, Address(regT0, currentInstruction[1].u.operand * sizeof(Register)));
 }
@@ -507,6 +595,9 @@ void JIT::emit_op_put_scoped_var(Instruction* currentInstruction)
         loadPtr(Address(regT1, OBJECT_OFFSETOF(ScopeChainNode, next)), regT1);
 
     loadPtr(Address(regT1, OBJECT_OFFSETOF(ScopeChainNode, object)), regT1);
+#if ENABLE(GGC)
+    emitWriteBarrier(regT1, regT2);
+#endif
     loadPtr(Address(regT1, OBJECT_OFFSETOF(JSVariableObject, m_registers)), regT1);
     storePtr(regT0, Address(regT1, currentInstruction[1].u.operand * sizeof(Register)));
 }
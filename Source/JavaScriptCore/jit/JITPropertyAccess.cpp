@@ -107,6 +107,7 @@ void JIT::emit_op_get_by_val(Instruction* currentInstruction)
     loadPtr(BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])), regT0);
     addSlowCase(branchTestPtr(Zero, regT0));
 
+    emitValueProfilingSite(regT0);
     emitPutVirtualRegister(dst);
 }
 
@@ -123,6 +124,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     Jump notString = branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr));
     emitNakedCall(m_globalData->getCTIStub(stringGetByValStubGenerator));
     Jump failed = branchTestPtr(Zero, regT0);
+    emitValueProfilingSite(regT0);
     emitPutVirtualRegister(dst, regT0);
     emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
     failed.link(this);
@@ -136,6 +138,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     stubCall.addArgument(base, regT2);
     stubCall.addArgument(property, regT2);
     stubCall.call(dst);
+    emitValueProfilingSite(regT0);
 }
 
 void JIT::compileGetDirectOffset(RegisterID base, RegisterID result, RegisterID offset, RegisterID scratch)
@@ -200,6 +203,10 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT1, Address(regT0, JSArray::vectorLengthOffset())));
 
+#if ENABLE(GGC)
+    emitWriteBarrier(regT0, regT2);
+#endif
+
     loadPtr(Address(regT0, JSArray::storageOffset()), regT2);
     Jump empty = branchTestPtr(Zero, BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
@@ -327,6 +334,9 @@ void JIT::emit_op_method_check(Instruction* currentInstruction)
     Identifier* ident = &(m_codeBlock->identifier(currentInstruction[3].u.operand));
 
     emitGetVirtualRegister(baseVReg, regT0);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(m_propertyAccessInstructionIndex);
+#endif
 
     // Do the method check - check the object & its prototype's structure inline (this is the common case).
     m_methodCallCompilationInfo.append(MethodCallCompilationInfo(m_propertyAccessInstructionIndex));
@@ -395,7 +405,11 @@ void JIT::emit_op_get_by_id(Instruction* currentInstruction)
     Identifier* ident = &(m_codeBlock->identifier(currentInstruction[3].u.operand));
 
     emitGetVirtualRegister(baseVReg, regT0);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(m_propertyAccessInstructionIndex);
+#endif
     compileGetByIdHotPath(resultVReg, baseVReg, ident, m_propertyAccessInstructionIndex++);
+    emitValueProfilingSite(regT0);
     emitPutVirtualRegister(resultVReg);
 }
 
@@ -467,6 +481,8 @@ void JIT::compileGetByIdSlowCase(int resultVReg, int baseVReg, Identifier* ident
     // Track the location of the call; this will be used to recover patch information.
     m_propertyAccessCompilationInfo[m_propertyAccessInstructionIndex].callReturnLocation = call;
     m_propertyAccessInstructionIndex++;
+
+    emitValueProfilingSite(regT0);
 }
 
 void JIT::emit_op_put_by_id(Instruction* currentInstruction)
@@ -481,10 +497,18 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     // such that the Structure & offset are always at the same distance from this.
 
     emitGetVirtualRegisters(baseVReg, regT0, valueVReg, regT1);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(propertyAccessInstructionIndex);
+#endif
 
     // Jump to a slow case if either the base object is an immediate, or if the Structure does not match.
     emitJumpSlowCaseIfNotJSCell(regT0, baseVReg);
 
+#if ENABLE(GGC)
+    // Done outside the patchable sequence, whose layout is fixed.
+    emitWriteBarrier(regT0, regT2);
+#endif
+
     BEGIN_UNINTERRUPTED_SEQUENCE(sequencePutById);
 
     Label hotPathBegin(this);
@@ -551,7 +575,9 @@ void JIT::compileGetDirectOffset(RegisterID base, RegisterID result, Structure*
 
 void JIT::compileGetDirectOffset(JSObject* base, RegisterID result, size_t cachedOffset)
 {
-    loadPtr(static_cast<void*>(&base->m_propertyStorage[cachedOffset]), result);
+    // The collector may move the property storage, so it cannot be baked in.
+    loadPtr(static_cast<void*>(&base->m_propertyStorage), result);
+    loadPtr(Address(result, cachedOffset * sizeof(JSValue)), result);
 }
 
 void JIT::testPrototype(JSValue prototype, JumpList& failureCases)
@@ -606,6 +632,9 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
         restoreReturnAddressBeforeReturn(regT3);
     }
 
+#if ENABLE(GGC)
+    emitWriteBarrier(regT0, regT2);
+#endif
     storePtrWithWriteBarrier(TrustedImmPtr(newStructure), regT0, Address(regT0, JSCell::structureOffset()));
 
     // write the value
@@ -670,9 +699,9 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
 {
     RepatchBuffer repatchBuffer(codeBlock);
 
-    // We don't want to patch more than once - in future go to cti_op_put_by_id_generic.
-    // Should probably go to cti_op_put_by_id_fail, but that doesn't do anything interesting right now.
-    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+    // We don't want to patch more than once - objects with other Structures
+    // go to cti_op_put_by_id_replace_list, which builds a polymorphic stub.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_replace_list : cti_op_put_by_id_replace_list));
 
     int offset = sizeof(JSValue) * cachedOffset;
 
@@ -681,6 +710,46 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
     repatchBuffer.repatch(stubInfo->hotPathBegin.dataLabel32AtOffset(patchOffsetPutByIdPropertyMapOffset), offset);
 }
 
+void JIT::privateCompilePutByIdReplaceList(StructureStubInfo* stubInfo, PolymorphicAccessStructureList* polymorphicStructures, int listSize, const Identifier& ident, ReturnAddressPtr returnAddress, bool direct)
+{
+    // The slow case calls this stub in place of a JIT stub function, with the
+    // base in regT0 and the value in regT1. The hot path already checks for
+    // the first Structure in the list, so we dispatch on the rest, loading
+    // the base's Structure once.
+    JumpList failureCases;
+    failureCases.append(emitJumpIfNotJSCell(regT0));
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+
+    for (int i = 1; i < listSize; ++i) {
+        Structure* structure = polymorphicStructures->list[i].base.get();
+        size_t cachedOffset = structure->get(*m_globalData, ident);
+        ASSERT(cachedOffset != WTF::notFound);
+
+        Jump nextCase = branchPtr(NotEqual, regT2, TrustedImmPtr(structure));
+        compilePutDirectOffset(regT0, regT1, structure, cachedOffset);
+        ret();
+        nextCase.link(this);
+    }
+
+    // Objects with other Structures go back to the JIT stub function, which
+    // may add another case, until the list is full.
+    failureCases.link(this);
+    restoreArgumentReferenceForTrampoline();
+    Call failureCall = tailRecursiveCall();
+
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool(), 0);
+
+    if (listSize < POLYMORPHIC_LIST_CACHE_SIZE)
+        patchBuffer.link(failureCall, FunctionPtr(direct ? cti_op_put_by_id_direct_replace_list : cti_op_put_by_id_replace_list));
+    else
+        patchBuffer.link(failureCall, FunctionPtr(direct ? cti_op_put_by_id_direct_fail : cti_op_put_by_id_fail));
+
+    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    stubInfo->stubRoutine = entryLabel;
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
 void JIT::privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress)
 {
     StructureStubInfo* stubInfo = &m_codeBlock->getStubInfo(returnAddress);
@@ -209,6 +209,9 @@ void JIT::emit_op_method_check(Instruction* currentInstruction)
     int base = currentInstruction[2].u.operand;
     
     emitLoad(base, regT1, regT0);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(m_propertyAccessInstructionIndex);
+#endif
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     
     BEGIN_UNINTERRUPTED_SEQUENCE(sequenceMethodCheck);
@@ -363,6 +366,10 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT2, Address(regT0, JSArray::vectorLengthOffset())));
+
+#if ENABLE(GGC)
+    emitWriteBarrier(regT0, regT3);
+#endif
     
     loadPtr(Address(regT0, JSArray::storageOffset()), regT3);
     
@@ -409,6 +416,9 @@ void JIT::emit_op_get_by_id(Instruction* currentInstruction)
     int base = currentInstruction[2].u.operand;
     
     emitLoad(base, regT1, regT0);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(m_propertyAccessInstructionIndex);
+#endif
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     compileGetByIdHotPath();
     emitStore(dst, regT1, regT0);
@@ -494,6 +504,9 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     int value = currentInstruction[3].u.operand;
     
     emitLoad2(base, regT1, regT0, value, regT3, regT2);
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    emitCountPropertyAccess(m_propertyAccessInstructionIndex);
+#endif
     
     emitJumpSlowCaseIfNotJSCell(base, regT1);
     
@@ -516,6 +529,13 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     
     ASSERT_JIT_OFFSET(differenceBetween(hotPathBegin, displacementLabel1), patchOffsetPutByIdPropertyMapOffset1);
     ASSERT_JIT_OFFSET(differenceBetween(hotPathBegin, displacementLabel2), patchOffsetPutByIdPropertyMapOffset2);
+
+#if ENABLE(GGC)
+    // The slow case needs every register we have, and the patchable sequence
+    // has a fixed layout, so we reload the base once the store is done.
+    emitLoadPayload(base, regT1);
+    emitWriteBarrier(regT1, regT1);
+#endif
 }
 
 void JIT::emitSlow_op_put_by_id(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
@@ -565,8 +585,10 @@ void JIT::compileGetDirectOffset(RegisterID base, RegisterID resultTag, Register
 
 void JIT::compileGetDirectOffset(JSObject* base, RegisterID resultTag, RegisterID resultPayload, size_t cachedOffset)
 {
-    load32(reinterpret_cast<char*>(&base->m_propertyStorage[cachedOffset]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload), resultPayload);
-    load32(reinterpret_cast<char*>(&base->m_propertyStorage[cachedOffset]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag), resultTag);
+    // The collector may move the property storage, so it cannot be baked in.
+    RegisterID temp = resultPayload;
+    loadPtr(static_cast<void*>(&base->m_propertyStorage), temp);
+    emitLoad(cachedOffset, resultTag, resultPayload, temp);
 }
 
 void JIT::testPrototype(JSValue prototype, JumpList& failureCases)
@@ -620,6 +642,9 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
         restoreReturnAddressBeforeReturn(regT3);
     }
 
+#if ENABLE(GGC)
+    emitWriteBarrier(regT0, regT2);
+#endif
     storePtrWithWriteBarrier(TrustedImmPtr(newStructure), regT0, Address(regT0, JSCell::structureOffset()));
     
 #if CPU(MIPS) || CPU(SH4)
@@ -693,9 +718,9 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
 {
     RepatchBuffer repatchBuffer(codeBlock);
     
-    // We don't want to patch more than once - in future go to cti_op_put_by_id_generic.
-    // Should probably go to cti_op_put_by_id_fail, but that doesn't do anything interesting right now.
-    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+    // We don't want to patch more than once - objects with other Structures
+    // go to cti_op_put_by_id_replace_list, which builds a polymorphic stub.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_replace_list : cti_op_put_by_id_replace_list));
     
     int offset = sizeof(JSValue) * cachedOffset;
 
@@ -705,6 +730,56 @@ void JIT::patchPutByIdReplace(CodeBlock* codeBlock, StructureStubInfo* stubInfo,
     repatchBuffer.repatch(stubInfo->hotPathBegin.dataLabel32AtOffset(patchOffsetPutByIdPropertyMapOffset2), offset + OBJECT_OFFSETOF(JSValue, u.asBits.tag)); // tag
 }
 
+void JIT::privateCompilePutByIdReplaceList(StructureStubInfo* stubInfo, PolymorphicAccessStructureList* polymorphicStructures, int listSize, const Identifier& ident, ReturnAddressPtr returnAddress, bool direct)
+{
+    // It is assumed that regT0 contains the basePayload and regT1 contains the baseTag.  The value can be found on the stack.
+    // The hot path already checks for the first Structure in the list, so we dispatch on the rest.
+    JumpList failureCases;
+    failureCases.append(branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag)));
+
+    for (int i = 1; i < listSize; ++i) {
+        Structure* structure = polymorphicStructures->list[i].base.get();
+        size_t cachedOffset = structure->get(*m_globalData, ident);
+        ASSERT(cachedOffset != WTF::notFound);
+
+        Jump nextCase = branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(structure));
+
+#if ENABLE(GGC)
+        emitWriteBarrier(regT0, regT2);
+#endif
+
+#if CPU(MIPS) || CPU(SH4)
+        // For MIPS, we don't add sizeof(void*) to the stack offset.
+        load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[2]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT3);
+        load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[2]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT2);
+#else
+        load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[2]) + sizeof(void*) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT3);
+        load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[2]) + sizeof(void*) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT2);
+#endif
+        compilePutDirectOffset(regT0, regT2, regT3, structure, cachedOffset);
+        ret();
+        nextCase.link(this);
+    }
+
+    // Objects with other Structures go back to the JIT stub function, which
+    // may add another case, until the list is full.
+    failureCases.link(this);
+    restoreArgumentReferenceForTrampoline();
+    Call failureCall = tailRecursiveCall();
+
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool(), 0);
+
+    if (listSize < POLYMORPHIC_LIST_CACHE_SIZE)
+        patchBuffer.link(failureCall, FunctionPtr(direct ? cti_op_put_by_id_direct_replace_list : cti_op_put_by_id_replace_list));
+    else
+        patchBuffer.link(failureCall, FunctionPtr(direct ? cti_op_put_by_id_direct_fail : cti_op_put_by_id_fail));
+
+    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    stubInfo->stubRoutine = entryLabel;
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, entryLabel);
+}
+
 void JIT::privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress)
 {
     StructureStubInfo* stubInfo = &m_codeBlock->getStubInfo(returnAddress);
@@ -58,6 +58,7 @@
 #include "RegExpObject.h"
 #include "RegExpPrototype.h"
 #include "Register.h"
+#include "RepatchBuffer.h"
 #include "SamplingTool.h"
 #include <wtf/StdLibExtras.h>
 #include <stdarg.h>
@@ -1023,6 +1024,11 @@ static NEVER_INLINE void throwStackOverflowError(CallFrame* callFrame, JSGlobalD
         if (UNLIKELY(stackFrame.globalData->exception)) \
             VM_THROW_EXCEPTION_AT_END(); \
     } while (0)
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+#define COUNT_PROPERTY_ACCESS_SLOW_CASE() PropertyAccessSampling::countSlowCase(stackFrame.callFrame->codeBlock(), ReturnAddressPtr(STUB_RETURN_ADDRESS).value())
+#else
+#define COUNT_PROPERTY_ACCESS_SLOW_CASE()
+#endif
 #define CHECK_FOR_EXCEPTION_VOID() \
     do { \
         if (UNLIKELY(stackFrame.globalData->exception)) { \
@@ -1374,6 +1380,95 @@ DEFINE_STUB_FUNCTION(void*, register_file_check)
     return callFrame;
 }
 
+#if ENABLE(DFG_JIT)
+// Called from baseline code whose execute counter has run out. Returns the
+// optimized code block to continue in, or 0 to stay in the baseline code.
+static CodeBlock* optimizedCodeBlockForBaselineCodeBlock(CallFrame* callFrame, CodeBlock* codeBlock)
+{
+    JSFunction* callee = asFunction(callFrame->callee());
+    FunctionExecutable* executable = callee->jsExecutable();
+    CodeBlock* optimizedCodeBlock = &executable->generatedBytecodeForCall();
+
+    if (optimizedCodeBlock == codeBlock) {
+        if (!executable->compileOptimizedForCall(callFrame, callee->scope())) {
+            codeBlock->dontOptimizeAnytimeSoon();
+            return 0;
+        }
+        optimizedCodeBlock = &executable->generatedBytecodeForCall();
+    } else if (optimizedCodeBlock->alternative() != codeBlock) {
+        codeBlock->dontOptimizeAnytimeSoon();
+        return 0;
+    } else if (optimizedCodeBlock->shouldReoptimizeNow()) {
+        // The optimized code keeps exiting, so its speculations were wrong. Go
+        // back to the baseline code, which has been profiling the new types in
+        // the meantime, and try again later.
+        executable->jettisonOptimizedCodeForCall();
+        codeBlock->countReoptimization();
+        if (codeBlock->hasExhaustedReoptimizations())
+            codeBlock->dontOptimizeAnytimeSoon();
+        else
+            codeBlock->optimizeAfterWarmUp();
+        return 0;
+    }
+
+    // Keep coming back here for as long as the optimized code is installed,
+    // so that calls linked to the baseline code and loops already running in
+    // it move over to the optimized code.
+    codeBlock->optimizeNextInvocation();
+    return optimizedCodeBlock;
+}
+
+DEFINE_STUB_FUNCTION(void*, optimize_from_entry)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+
+    CodeBlock* optimizedCodeBlock = optimizedCodeBlockForBaselineCodeBlock(callFrame, callFrame->codeBlock());
+    if (!optimizedCodeBlock)
+        return 0;
+
+#if ENABLE(JIT_OPTIMIZE_CALL)
+    // Relink the call that got us here, if it was linked to the baseline code.
+    CallFrame* callerFrame = callFrame->callerFrame();
+    if (!callerFrame->hasHostCallFrameFlag() && callerFrame->codeBlock()) {
+        CodeBlock* callerCodeBlock = callerFrame->codeBlock();
+        JSFunction* callee = asFunction(callFrame->callee());
+        void* returnAddress = callFrame->returnPC().value();
+        for (unsigned i = 0; i < callerCodeBlock->numberOfCallLinkInfos(); ++i) {
+            CallLinkInfo& callLinkInfo = callerCodeBlock->callLinkInfo(i);
+            if (callLinkInfo.isLinked() && callLinkInfo.callee.get() == callee && callLinkInfo.hotPathOther.executableAddress() == returnAddress) {
+                RepatchBuffer repatchBuffer(callerCodeBlock);
+                repatchBuffer.relink(callLinkInfo.hotPathOther, optimizedCodeBlock->getJITCode().addressForCall());
+                break;
+            }
+        }
+    }
+#endif
+
+    return optimizedCodeBlock->jitCodeEntryAfterReturnPC();
+}
+
+DEFINE_STUB_FUNCTION(void*, optimize_from_loop)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    unsigned bytecodeIndex = stackFrame.args[0].int32();
+
+    CodeBlock* optimizedCodeBlock = optimizedCodeBlockForBaselineCodeBlock(callFrame, callFrame->codeBlock());
+    if (!optimizedCodeBlock)
+        return 0;
+
+    // Enter the optimized code at the head of the loop. All of the frame's
+    // state is in its registers at this point, which the optimized code can
+    // pick up, but it needs room for its own temporaries.
+    void* address = optimizedCodeBlock->machineCodeForBytecodeIndex(bytecodeIndex);
+    if (!address || !stackFrame.registerFile->grow(&callFrame->registers()[optimizedCodeBlock->m_numCalleeRegisters]))
+        return 0;
+    callFrame->setCodeBlock(optimizedCodeBlock);
+    return address;
+}
+#endif
+
 DEFINE_STUB_FUNCTION(int, op_loop_if_lesseq)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1397,6 +1492,7 @@ DEFINE_STUB_FUNCTION(JSObject*, op_new_object)
 DEFINE_STUB_FUNCTION(void, op_put_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     PutPropertySlot slot(stackFrame.callFrame->codeBlock()->isStrictMode());
     stackFrame.args[0].jsValue().put(stackFrame.callFrame, stackFrame.args[1].identifier(), stackFrame.args[2].jsValue(), slot);
@@ -1406,6 +1502,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_generic)
 DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
     
     PutPropertySlot slot(stackFrame.callFrame->codeBlock()->isStrictMode());
     stackFrame.args[0].jsValue().putDirect(stackFrame.callFrame, stackFrame.args[1].identifier(), stackFrame.args[2].jsValue(), slot);
@@ -1415,6 +1512,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_generic)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
@@ -1432,6 +1530,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
 DEFINE_STUB_FUNCTION(void, op_put_by_id)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
     
@@ -1451,6 +1550,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id)
 DEFINE_STUB_FUNCTION(void, op_put_by_id_direct)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
     
@@ -1470,6 +1570,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct)
 DEFINE_STUB_FUNCTION(void, op_put_by_id_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
@@ -1483,6 +1584,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_fail)
 DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
     
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
@@ -1493,6 +1595,77 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_fail)
     CHECK_FOR_EXCEPTION_AT_END();
 }
 
+// Called by put_by_id replace sites whose inline cache missed, once they have
+// cached one Structure. Adds the base's Structure to the site's list and
+// regenerates its dispatch stub.
+static void tryCachePutByIdReplaceList(CallFrame* callFrame, ReturnAddressPtr returnAddress, JSValue baseValue, const Identifier& ident, const PutPropertySlot& slot, bool direct)
+{
+    if (!baseValue.isCell())
+        return;
+
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    JSCell* baseCell = baseValue.asCell();
+    Structure* structure = baseCell->structure();
+    if (!slot.isCacheable() || slot.type() != PutPropertySlot::ExistingProperty || baseCell != slot.base() || structure->isDictionary()) {
+        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+        return;
+    }
+
+    StructureStubInfo* stubInfo = &codeBlock->getStubInfo(returnAddress);
+    PolymorphicAccessStructureList* polymorphicStructures;
+    int listSize;
+    if (stubInfo->accessType == access_put_by_id_replace) {
+        polymorphicStructures = new PolymorphicAccessStructureList(callFrame->globalData(), codeBlock->ownerExecutable(), CodeLocationLabel(), stubInfo->u.putByIdReplace.baseObjectStructure.get());
+        listSize = 1;
+    } else {
+        ASSERT(stubInfo->accessType == access_put_by_id_replace_list);
+        polymorphicStructures = stubInfo->u.putByIdReplaceList.structureList;
+        listSize = stubInfo->u.putByIdReplaceList.listSize;
+    }
+    ASSERT(listSize < POLYMORPHIC_LIST_CACHE_SIZE);
+
+    for (int i = 0; i < listSize; ++i) {
+        if (polymorphicStructures->list[i].base.get() == structure) {
+            stubInfo->initPutByIdReplaceList(polymorphicStructures, listSize);
+            return;
+        }
+    }
+
+    polymorphicStructures->list[listSize++].set(callFrame->globalData(), codeBlock->ownerExecutable(), CodeLocationLabel(), structure);
+    stubInfo->initPutByIdReplaceList(polymorphicStructures, listSize);
+    JIT::compilePutByIdReplaceList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructures, listSize, ident, returnAddress, direct);
+}
+
+DEFINE_STUB_FUNCTION(void, op_put_by_id_replace_list)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    Identifier& ident = stackFrame.args[1].identifier();
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
+
+    JSValue baseValue = stackFrame.args[0].jsValue();
+    PutPropertySlot slot(callFrame->codeBlock()->isStrictMode());
+    baseValue.put(callFrame, ident, stackFrame.args[2].jsValue(), slot);
+    CHECK_FOR_EXCEPTION_VOID();
+
+    tryCachePutByIdReplaceList(callFrame, STUB_RETURN_ADDRESS, baseValue, ident, slot, false);
+}
+
+DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_replace_list)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    Identifier& ident = stackFrame.args[1].identifier();
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
+
+    JSValue baseValue = stackFrame.args[0].jsValue();
+    PutPropertySlot slot(callFrame->codeBlock()->isStrictMode());
+    baseValue.putDirect(callFrame, ident, stackFrame.args[2].jsValue(), slot);
+    CHECK_FOR_EXCEPTION_VOID();
+
+    tryCachePutByIdReplaceList(callFrame, STUB_RETURN_ADDRESS, baseValue, ident, slot, true);
+}
+
 DEFINE_STUB_FUNCTION(JSObject*, op_put_by_id_transition_realloc)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1511,6 +1684,7 @@ DEFINE_STUB_FUNCTION(JSObject*, op_put_by_id_transition_realloc)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_method_check)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
@@ -1584,6 +1758,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_method_check)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
 
@@ -1605,6 +1780,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
@@ -1712,6 +1888,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_custom_stub)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     CallFrame* callFrame = stackFrame.callFrame;
     const Identifier& propertyName = stackFrame.args[1].identifier();
@@ -1776,6 +1953,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list_full)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
     PropertySlot slot(baseValue);
@@ -1788,6 +1966,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list_full)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
     PropertySlot slot(baseValue);
@@ -1800,6 +1979,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_fail)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_array_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
     PropertySlot slot(baseValue);
@@ -1812,6 +1992,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_array_fail)
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_string_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
+    COUNT_PROPERTY_ACCESS_SLOW_CASE();
 
     JSValue baseValue = stackFrame.args[0].jsValue();
     PropertySlot slot(baseValue);
@@ -1965,6 +2146,26 @@ DEFINE_STUB_FUNCTION(void*, op_construct_jitCompile)
     return function;
 }
 
+#if ENABLE(TIERED_COMPILATION)
+DEFINE_STUB_FUNCTION(EncodedJSValue, vm_interpretCall)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+
+    CallFrame* callFrame = stackFrame.callFrame;
+    FunctionExecutable* executable = asFunction(callFrame->callee())->jsExecutable();
+    return JSValue::encode(stackFrame.globalData->interpreter->executeFromMachineCode(callFrame, &executable->generatedBytecodeForCall()));
+}
+
+DEFINE_STUB_FUNCTION(EncodedJSValue, vm_interpretConstruct)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+
+    CallFrame* callFrame = stackFrame.callFrame;
+    FunctionExecutable* executable = asFunction(callFrame->callee())->jsExecutable();
+    return JSValue::encode(stackFrame.globalData->interpreter->executeFromMachineCode(callFrame, &executable->generatedBytecodeForConstruct()));
+}
+#endif
+
 DEFINE_STUB_FUNCTION(void*, op_call_arityCheck)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -2103,6 +2304,11 @@ DEFINE_STUB_FUNCTION(void*, vm_lazyLinkCall)
             return 0;
         }
         codeBlock = &functionExecutable->generatedBytecodeForCall();
+#if ENABLE(TIERED_COMPILATION)
+        // Leave the call unlinked until the callee is warm enough to have been compiled.
+        if (!codeBlock->getJITCode())
+            return stackFrame.globalData->jitStubs->ctiInterpretCall().executableAddress();
+#endif
         if (callFrame->argumentCountIncludingThis() == static_cast<size_t>(codeBlock->m_numParameters))
             codePtr = functionExecutable->generatedJITCodeForCall().addressForCall();
         else
@@ -2137,6 +2343,11 @@ DEFINE_STUB_FUNCTION(void*, vm_lazyLinkConstruct)
             return 0;
         }
         codeBlock = &functionExecutable->generatedBytecodeForConstruct();
+#if ENABLE(TIERED_COMPILATION)
+        // Leave the call unlinked until the callee is warm enough to have been compiled.
+        if (!codeBlock->getJITCode())
+            return stackFrame.globalData->jitStubs->ctiInterpretConstruct().executableAddress();
+#endif
         if (callFrame->argumentCountIncludingThis() == static_cast<size_t>(codeBlock->m_numParameters))
             codePtr = functionExecutable->generatedJITCodeForConstruct().addressForCall();
         else
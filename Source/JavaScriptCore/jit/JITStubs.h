@@ -86,6 +86,10 @@ namespace JSC {
         MacroAssemblerCodePtr ctiNativeCall;
         MacroAssemblerCodePtr ctiNativeConstruct;
         MacroAssemblerCodePtr ctiSoftModulo;
+#if ENABLE(TIERED_COMPILATION)
+        MacroAssemblerCodePtr ctiInterpretCall;
+        MacroAssemblerCodePtr ctiInterpretConstruct;
+#endif
     };
 
 #if CPU(X86_64)
@@ -293,6 +297,12 @@ namespace JSC {
         MacroAssemblerCodePtr ctiNativeCall() { return m_trampolineStructure.ctiNativeCall; }
         MacroAssemblerCodePtr ctiNativeConstruct() { return m_trampolineStructure.ctiNativeConstruct; }
         MacroAssemblerCodePtr ctiSoftModulo() { return m_trampolineStructure.ctiSoftModulo; }
+#if ENABLE(TIERED_COMPILATION)
+        // Entered like the machine code of a function that has not been
+        // compiled yet, these run the function's bytecode in the interpreter.
+        MacroAssemblerCodePtr ctiInterpretCall() { return m_trampolineStructure.ctiInterpretCall; }
+        MacroAssemblerCodePtr ctiInterpretConstruct() { return m_trampolineStructure.ctiInterpretConstruct; }
+#endif
 
         MacroAssemblerCodePtr ctiStub(JSGlobalData* globalData, ThunkGenerator generator);
 
@@ -318,6 +328,10 @@ extern "C" {
     EncodedJSValue JIT_STUB cti_op_bitor(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_bitxor(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_call_NotJSFunction(STUB_ARGS_DECLARATION);
+#if ENABLE(TIERED_COMPILATION)
+    EncodedJSValue JIT_STUB cti_vm_interpretCall(STUB_ARGS_DECLARATION);
+    EncodedJSValue JIT_STUB cti_vm_interpretConstruct(STUB_ARGS_DECLARATION);
+#endif
     EncodedJSValue JIT_STUB cti_op_call_eval(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_construct_NotJSConstruct(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_create_this(STUB_ARGS_DECLARATION);
@@ -408,9 +422,11 @@ extern "C" {
     void JIT_STUB cti_op_put_by_id(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_fail(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_generic(STUB_ARGS_DECLARATION);
+    void JIT_STUB cti_op_put_by_id_replace_list(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_direct(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_direct_fail(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_id_direct_generic(STUB_ARGS_DECLARATION);
+    void JIT_STUB cti_op_put_by_id_direct_replace_list(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_index(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_val(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_put_by_val_byte_array(STUB_ARGS_DECLARATION);
@@ -427,6 +443,10 @@ extern "C" {
     void* JIT_STUB cti_op_switch_imm(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_switch_string(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_throw(STUB_ARGS_DECLARATION);
+#if ENABLE(DFG_JIT)
+    void* JIT_STUB cti_optimize_from_entry(STUB_ARGS_DECLARATION);
+    void* JIT_STUB cti_optimize_from_loop(STUB_ARGS_DECLARATION);
+#endif
     void* JIT_STUB cti_register_file_check(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_lazyLinkCall(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_lazyLinkConstruct(STUB_ARGS_DECLARATION);
@@ -157,6 +157,25 @@ MacroAssemblerCodePtr powThunkGenerator(JSGlobalData* globalData, ExecutablePool
     return jit.finalize(globalData->jitStubs->ctiNativeCall());
 }
 
+#if ENABLE(TIERED_COMPILATION)
+// Continues a frame that was running in the interpreter in its machine code.
+// The interpreter puts the machine code to jump to in the frame's return
+// address slot, and calls this through ctiTrampoline; the return address into
+// ctiTrampoline takes its place, so the frame returns from there.
+MacroAssemblerCodePtr interpreterOSREntryThunkGenerator(JSGlobalData*, ExecutablePool* pool)
+{
+    JSInterfaceJIT jit;
+    JSInterfaceJIT::Address returnPCAddress(JSInterfaceJIT::callFrameRegister, RegisterFile::ReturnPC * static_cast<int>(sizeof(Register)));
+    jit.loadPtr(returnPCAddress, JSInterfaceJIT::regT1);
+    jit.pop(JSInterfaceJIT::regT0);
+    jit.storePtr(JSInterfaceJIT::regT0, returnPCAddress);
+    jit.jump(JSInterfaceJIT::regT1);
+
+    LinkBuffer patchBuffer(&jit, pool, 0);
+    return patchBuffer.finalizeCode().m_code;
+}
+#endif
+
 }
 
 #endif // ENABLE(JIT)
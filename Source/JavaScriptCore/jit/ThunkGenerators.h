@@ -39,6 +39,9 @@ namespace JSC {
     MacroAssemblerCodePtr fromCharCodeThunkGenerator(JSGlobalData*, ExecutablePool*);
     MacroAssemblerCodePtr sqrtThunkGenerator(JSGlobalData*, ExecutablePool*);
     MacroAssemblerCodePtr powThunkGenerator(JSGlobalData*, ExecutablePool*);
+#if ENABLE(TIERED_COMPILATION)
+    MacroAssemblerCodePtr interpreterOSREntryThunkGenerator(JSGlobalData*, ExecutablePool*);
+#endif
 }
 #endif
 
@@ -22,6 +22,8 @@
 
 #include "config.h"
 
+#include "BackgroundPreparser.h"
+#include "BytecodeCache.h"
 #include "BytecodeGenerator.h"
 #include "Completion.h"
 #include "CurrentTime.h"
@@ -31,6 +33,10 @@
 #include "JSFunction.h"
 #include "JSLock.h"
 #include "JSString.h"
+#include "MemoryStatistics.h"
+#include "Options.h"
+#include "Parser.h"
+#include "RegExpCache.h"
 #include "SamplingTool.h"
 #include <math.h>
 #include <stdio.h>
@@ -74,9 +80,24 @@ static bool fillBufferWithContentsOfFile(const UString& fileName, Vector<char>&
 static EncodedJSValue JSC_HOST_CALL functionPrint(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDebug(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionGCStatistics(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionHeapStatistics(ExecState*);
+#if ENABLE(PARSER_STATS)
+static EncodedJSValue JSC_HOST_CALL functionParserStatistics(ExecState*);
+#endif
+static EncodedJSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionMallocStatistics(ExecState*);
+#if ENABLE(JIT) && ENABLE(ASSEMBLER)
+static EncodedJSValue JSC_HOST_CALL functionExecutableMemoryStatistics(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionTrimExecutableMemory(ExecState*);
+#endif
 static EncodedJSValue JSC_HOST_CALL functionVersion(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionRun(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionLoad(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionEvaluateWithBytecodeCache(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionBeginBackgroundPreparse(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionAppendToBackgroundPreparse(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionEvaluateWithBackgroundPreparse(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionReadline(ExecState*);
 static NO_RETURN_WITH_VALUE EncodedJSValue JSC_HOST_CALL functionQuit(ExecState*);
@@ -97,15 +118,23 @@ struct Script {
     }
 };
 
-struct Options {
-    Options()
+struct CommandLine {
+    CommandLine()
         : interactive(false)
         , dump(false)
+        , numberOfMarkerThreads(1)
+        , adaptiveHeapSizing(false)
+        , heapMemoryBudget(0)
+        , regExpCacheBudget(0)
     {
     }
 
     bool interactive;
     bool dump;
+    unsigned numberOfMarkerThreads;
+    bool adaptiveHeapSizing;
+    size_t heapMemoryBudget;
+    size_t regExpCacheBudget;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -154,9 +183,24 @@ GlobalObject::GlobalObject(JSGlobalData& globalData, const Vector<UString>& argu
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "print"), functionPrint));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "quit"), functionQuit));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "gc"), functionGC));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "gcStatistics"), functionGCStatistics));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "heapStatistics"), functionHeapStatistics));
+#if ENABLE(PARSER_STATS)
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "parserStatistics"), functionParserStatistics));
+#endif
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "regExpCacheStatistics"), functionRegExpCacheStatistics));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "mallocStatistics"), functionMallocStatistics));
+#if ENABLE(JIT) && ENABLE(ASSEMBLER)
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "executableMemoryStatistics"), functionExecutableMemoryStatistics));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "trimExecutableMemory"), functionTrimExecutableMemory));
+#endif
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "version"), functionVersion));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "run"), functionRun));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "load"), functionLoad));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 2, Identifier(globalExec(), "evaluateWithBytecodeCache"), functionEvaluateWithBytecodeCache));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "beginBackgroundPreparse"), functionBeginBackgroundPreparse));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "appendToBackgroundPreparse"), functionAppendToBackgroundPreparse));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "evaluateWithBackgroundPreparse"), functionEvaluateWithBackgroundPreparse));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "checkSyntax"), functionCheckSyntax));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "readline"), functionReadline));
 
@@ -198,6 +242,130 @@ EncodedJSValue JSC_HOST_CALL functionGC(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+EncodedJSValue JSC_HOST_CALL functionGCStatistics(ExecState* exec)
+{
+    const GCTimingStatistics& statistics = exec->heap()->timingStatistics();
+    JSGlobalData& globalData = exec->globalData();
+
+    // Times are in milliseconds.
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "collectionCount"), jsNumber(statistics.collectionCount));
+    result->putDirect(globalData, Identifier(exec, "youngCollectionCount"), jsNumber(statistics.youngCollectionCount));
+    result->putDirect(globalData, Identifier(exec, "totalMarkTime"), jsNumber(statistics.totalMarkTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "totalSweepTime"), jsNumber(statistics.totalSweepTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "maxPauseTime"), jsNumber(statistics.maxPauseTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "capacity"), jsNumber(exec->heap()->capacity()));
+
+    result->putDirect(globalData, Identifier(exec, "lastRootGatheringTime"), jsNumber(statistics.lastRootGatheringTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "totalRootGatheringTime"), jsNumber(statistics.totalRootGatheringTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "lastConservativeCandidateCount"), jsNumber(statistics.lastConservativeCandidateCount));
+    result->putDirect(globalData, Identifier(exec, "lastConservativeBlockLookupCount"), jsNumber(statistics.lastConservativeBlockLookupCount));
+    result->putDirect(globalData, Identifier(exec, "lastConservativeRootCount"), jsNumber(statistics.lastConservativeRootCount));
+
+    const Vector<ThreadRootStatistics>& threadStatistics = exec->heap()->machineThreads().lastGatheringStatistics();
+    JSArray* threads = constructEmptyArray(exec);
+    for (size_t i = 0; i < threadStatistics.size(); ++i) {
+        JSObject* thread = constructEmptyObject(exec);
+        thread->putDirect(globalData, Identifier(exec, "candidates"), jsNumber(threadStatistics[i].candidateCount));
+        thread->putDirect(globalData, Identifier(exec, "blockLookups"), jsNumber(threadStatistics[i].blockLookupCount));
+        thread->putDirect(globalData, Identifier(exec, "roots"), jsNumber(threadStatistics[i].rootCount));
+        thread->putDirect(globalData, Identifier(exec, "time"), jsNumber(threadStatistics[i].time * 1000));
+        threads->push(exec, thread);
+    }
+    result->putDirect(globalData, Identifier(exec, "lastRootGatheringThreads"), threads);
+    return JSValue::encode(result);
+}
+
+EncodedJSValue JSC_HOST_CALL functionHeapStatistics(ExecState* exec)
+{
+    dumpHeapStatistics(*exec->heap());
+    return JSValue::encode(jsUndefined());
+}
+
+#if ENABLE(PARSER_STATS)
+EncodedJSValue JSC_HOST_CALL functionParserStatistics(ExecState* exec)
+{
+    const ParserStatistics& statistics = exec->globalData().parser->statistics();
+    JSGlobalData& globalData = exec->globalData();
+
+    // Times are in milliseconds, sizes in characters.
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "parseCount"), jsNumber(statistics.parseCount));
+    result->putDirect(globalData, Identifier(exec, "parseTime"), jsNumber(statistics.parseTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "fullyParsedBytes"), jsNumber(statistics.fullyParsedBytes));
+    result->putDirect(globalData, Identifier(exec, "preparsedFunctions"), jsNumber(statistics.preparsedFunctionCount));
+    result->putDirect(globalData, Identifier(exec, "preparsedBytes"), jsNumber(statistics.preparsedBytes));
+    result->putDirect(globalData, Identifier(exec, "preparseTime"), jsNumber(statistics.preparseTime * 1000));
+    result->putDirect(globalData, Identifier(exec, "skippedFunctions"), jsNumber(statistics.skippedFunctionCount));
+    result->putDirect(globalData, Identifier(exec, "skippedBytes"), jsNumber(statistics.skippedBytes));
+    result->putDirect(globalData, Identifier(exec, "functions"), jsNumber(statistics.functionCount));
+    result->putDirect(globalData, Identifier(exec, "calledFunctions"), jsNumber(statistics.calledFunctionCount));
+    result->putDirect(globalData, Identifier(exec, "uncalledFunctions"), jsNumber(statistics.functionCount - statistics.calledFunctionCount));
+    return JSValue::encode(result);
+}
+#endif
+
+EncodedJSValue JSC_HOST_CALL functionRegExpCacheStatistics(ExecState* exec)
+{
+    RegExpCache* cache = exec->globalData().regExpCache();
+    const RegExpCacheStatistics& statistics = cache->statistics();
+    JSGlobalData& globalData = exec->globalData();
+
+    // Sizes are in bytes of compiled code and bytecode.
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "hits"), jsNumber(statistics.hitCount));
+    result->putDirect(globalData, Identifier(exec, "misses"), jsNumber(statistics.missCount));
+    result->putDirect(globalData, Identifier(exec, "evictions"), jsNumber(statistics.evictionCount));
+    result->putDirect(globalData, Identifier(exec, "evictedBytes"), jsNumber(statistics.evictedBytes));
+    result->putDirect(globalData, Identifier(exec, "invalidated"), jsNumber(statistics.invalidatedCount));
+    result->putDirect(globalData, Identifier(exec, "entries"), jsNumber(statistics.entryCount));
+    result->putDirect(globalData, Identifier(exec, "bytes"), jsNumber(statistics.cachedBytes));
+    result->putDirect(globalData, Identifier(exec, "budget"), jsNumber(cache->byteBudget()));
+    return JSValue::encode(result);
+}
+
+// Free pages are returned to the system first, so that committed memory is
+// memory that is in use or cached in free lists. All zero when built with the
+// system malloc.
+EncodedJSValue JSC_HOST_CALL functionMallocStatistics(ExecState* exec)
+{
+    releaseFastMallocFreeMemory();
+    FastMallocStatistics statistics = fastMallocStatistics();
+    JSGlobalData& globalData = exec->globalData();
+
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "reserved"), jsNumber(statistics.reservedVMBytes));
+    result->putDirect(globalData, Identifier(exec, "committed"), jsNumber(statistics.committedVMBytes));
+    result->putDirect(globalData, Identifier(exec, "free"), jsNumber(statistics.freeListBytes));
+    result->putDirect(globalData, Identifier(exec, "inUse"), jsNumber(statistics.committedVMBytes - statistics.freeListBytes));
+    return JSValue::encode(result);
+}
+
+#if ENABLE(JIT) && ENABLE(ASSEMBLER)
+EncodedJSValue JSC_HOST_CALL functionExecutableMemoryStatistics(ExecState* exec)
+{
+    ExecutableAllocatorStatistics statistics = ExecutableAllocator::statistics();
+    JSGlobalData& globalData = exec->globalData();
+
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "committed"), jsNumber(statistics.committedBytes));
+    result->putDirect(globalData, Identifier(exec, "free"), jsNumber(statistics.freeBytes));
+    result->putDirect(globalData, Identifier(exec, "freeBlocks"), jsNumber(statistics.freeBlockCount));
+    result->putDirect(globalData, Identifier(exec, "largestFreeBlock"), jsNumber(statistics.largestFreeBlock));
+    result->putDirect(globalData, Identifier(exec, "freeListFragmentation"), jsNumber(statistics.freeListFragmentation()));
+    result->putDirect(globalData, Identifier(exec, "allocations"), jsNumber(statistics.allocationCount));
+    result->putDirect(globalData, Identifier(exec, "reuses"), jsNumber(statistics.reuseCount));
+    result->putDirect(globalData, Identifier(exec, "trimmed"), jsNumber(statistics.trimmedBytes));
+    result->putDirect(globalData, Identifier(exec, "underMemoryPressure"), jsBoolean(ExecutableAllocator::underMemoryPressure()));
+    return JSValue::encode(result);
+}
+
+EncodedJSValue JSC_HOST_CALL functionTrimExecutableMemory(ExecState*)
+{
+    return JSValue::encode(jsNumber(ExecutableAllocator::trim()));
+}
+#endif
+
 EncodedJSValue JSC_HOST_CALL functionVersion(ExecState*)
 {
     // We need this function for compatibility with the Mozilla JS tests but for now
@@ -236,6 +404,105 @@ EncodedJSValue JSC_HOST_CALL functionLoad(ExecState* exec)
     return JSValue::encode(result.value());
 }
 
+// Evaluates a script in a new global object, loading its code from the
+// bytecode cache given as the second argument if there is one, and returns the
+// result with the bytecode cache as it is after evaluation. A cache is stored
+// in a string with one byte in each character.
+EncodedJSValue JSC_HOST_CALL functionEvaluateWithBytecodeCache(ExecState* exec)
+{
+    UString source = exec->argument(0).toString(exec);
+    RefPtr<BytecodeCache> bytecodeCache;
+    if (exec->argument(1).isUndefined())
+        bytecodeCache = BytecodeCache::create();
+    else {
+        UString serializedCache = exec->argument(1).toString(exec);
+        Vector<char> data(serializedCache.length());
+        for (unsigned i = 0; i < serializedCache.length(); ++i)
+            data[i] = static_cast<char>(serializedCache.characters()[i]);
+        bytecodeCache = BytecodeCache::create(data.data(), data.size());
+    }
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+
+    RefPtr<UStringSourceProvider> provider = UStringSourceProvider::create(source, "[bytecode cache]");
+    provider->setBytecodeCache(bytecodeCache);
+
+    GlobalObject* globalObject = new (&exec->globalData()) GlobalObject(exec->globalData(), Vector<UString>());
+    Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), SourceCode(provider.release()));
+    if (completion.complType() == Throw)
+        return JSValue::encode(throwError(exec, completion.value()));
+
+    Vector<char> data;
+    bytecodeCache->serialize(data);
+    Vector<UChar> characters(data.size());
+    for (size_t i = 0; i < data.size(); ++i)
+        characters[i] = static_cast<unsigned char>(data[i]);
+
+    JSGlobalData& globalData = exec->globalData();
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "result"), completion.value());
+    result->putDirect(globalData, Identifier(exec, "bytecodeCache"), jsString(exec, UString(characters.data(), characters.size())));
+    result->putDirect(globalData, Identifier(exec, "codeBlocks"), jsNumber(bytecodeCache->numberOfCodeBlocks()));
+    result->putDirect(globalData, Identifier(exec, "loadedCodeBlocks"), jsNumber(bytecodeCache->numberOfLoadedCodeBlocks()));
+    return JSValue::encode(result);
+}
+
+// The script being pre-parsed in the background, as its source is appended to
+// it by calls to appendToBackgroundPreparse().
+static RefPtr<BackgroundPreparser>& streamedScriptPreparser()
+{
+    DEFINE_STATIC_LOCAL(RefPtr<BackgroundPreparser>, preparser, ());
+    return preparser;
+}
+
+EncodedJSValue JSC_HOST_CALL functionBeginBackgroundPreparse(ExecState*)
+{
+    RefPtr<BackgroundPreparser>& preparser = streamedScriptPreparser();
+    if (preparser)
+        preparser->finish();
+    preparser = BackgroundPreparser::create();
+    return JSValue::encode(jsUndefined());
+}
+
+EncodedJSValue JSC_HOST_CALL functionAppendToBackgroundPreparse(ExecState* exec)
+{
+    UString source = exec->argument(0).toString(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (BackgroundPreparser* preparser = streamedScriptPreparser().get())
+        preparser->appendSource(source.characters(), source.length());
+    return JSValue::encode(jsUndefined());
+}
+
+// Evaluates a script in a new global object, with the functions that were
+// pre-parsed since beginBackgroundPreparse() was called, if it was, and
+// returns the result with the number of functions that the main thread did
+// not have to parse.
+EncodedJSValue JSC_HOST_CALL functionEvaluateWithBackgroundPreparse(ExecState* exec)
+{
+    UString source = exec->argument(0).toString(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+
+    RefPtr<UStringSourceProvider> provider = UStringSourceProvider::create(source, "[background preparse]");
+    RefPtr<BackgroundPreparser> preparser = streamedScriptPreparser().release();
+    if (preparser) {
+        preparser->finish();
+        provider->setBackgroundPreparser(preparser);
+    }
+
+    GlobalObject* globalObject = new (&exec->globalData()) GlobalObject(exec->globalData(), Vector<UString>());
+    Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), SourceCode(provider.release()));
+    if (completion.complType() == Throw)
+        return JSValue::encode(throwError(exec, completion.value()));
+
+    JSGlobalData& globalData = exec->globalData();
+    JSObject* result = constructEmptyObject(exec);
+    result->putDirect(globalData, Identifier(exec, "result"), completion.value());
+    result->putDirect(globalData, Identifier(exec, "transferredFunctions"), jsNumber(preparser ? preparser->numberOfTransferredFunctions() : 0));
+    return JSValue::encode(result);
+}
+
 EncodedJSValue JSC_HOST_CALL functionCheckSyntax(ExecState* exec)
 {
     UString fileName = exec->argument(0).toString(exec);
@@ -420,6 +687,9 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
 #if ENABLE(SAMPLING_COUNTERS)
     AbstractSamplingCounter::dump();
 #endif
+#if ENABLE(PROPERTY_ACCESS_SAMPLING)
+    PropertyAccessSampling::dump();
+#endif
 #if ENABLE(REGEXP_TRACING)
     globalData.dumpRegExpTrace();
 #endif
@@ -472,15 +742,21 @@ static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help =
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+    fprintf(stderr, "  -m <n>     Marks in parallel on n threads during garbage collection (where supported)\n");
+    fprintf(stderr, "  -p <p>     Sizes the heap with policy p: default, or adaptive[=<MB>] to adapt to the allocation rate within a memory budget\n");
+    fprintf(stderr, "  -r <KB>    Limits the compiled code and bytecode kept by the regular expression cache to KB kilobytes\n");
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
+#if ENABLE(TIERED_COMPILATION)
+    fprintf(stderr, "  -t <n>     Compiles code with the JIT once it has been entered or has looped n times (0 compiles all code before it runs)\n");
+#endif
 
     cleanupGlobalData(globalData);
     exit(help ? EXIT_SUCCESS : EXIT_FAILURE);
 }
 
-static void parseArguments(int argc, char** argv, Options& options, JSGlobalData* globalData)
+static void parseArguments(int argc, char** argv, CommandLine& options, JSGlobalData* globalData)
 {
     int i = 1;
     for (; i < argc; ++i) {
@@ -505,6 +781,30 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-m")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.numberOfMarkerThreads = atoi(argv[i]);
+            continue;
+        }
+        if (!strcmp(arg, "-p")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            if (!strcmp(argv[i], "default"))
+                options.adaptiveHeapSizing = false;
+            else if (!strncmp(argv[i], "adaptive", 8) && (!argv[i][8] || argv[i][8] == '=')) {
+                options.adaptiveHeapSizing = true;
+                options.heapMemoryBudget = argv[i][8] ? static_cast<size_t>(atoi(argv[i] + 9)) * 1024 * 1024 : 0;
+            } else
+                printUsageStatement(globalData);
+            continue;
+        }
+        if (!strcmp(arg, "-r")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.regExpCacheBudget = static_cast<size_t>(atoi(argv[i])) * 1024;
+            continue;
+        }
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -514,6 +814,14 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
 #endif
             continue;
         }
+#if ENABLE(TIERED_COMPILATION)
+        if (!strcmp(arg, "-t")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            Options::thresholdForJITAfterWarmUp = atoi(argv[i]);
+            continue;
+        }
+#endif
         if (!strcmp(arg, "--")) {
             ++i;
             break;
@@ -534,8 +842,13 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
 {
     JSLock lock(SilenceAssertionsOnly);
 
-    Options options;
+    CommandLine options;
     parseArguments(argc, argv, options, globalData);
+    globalData->heap.setNumberOfMarkerThreads(options.numberOfMarkerThreads);
+    if (options.adaptiveHeapSizing)
+        globalData->setHeapSizingPolicy(AdaptiveHeapSizingPolicy::create(0.1, options.heapMemoryBudget));
+    if (options.regExpCacheBudget)
+        globalData->regExpCache()->setByteBudget(options.regExpCacheBudget);
 
     GlobalObject* globalObject = new (globalData) GlobalObject(*globalData, options.arguments);
     bool success = runWithScripts(globalObject, options.scripts, options.dump);
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "config.h"
+#include "BackgroundPreparser.h"
+
+#include "Identifier.h"
+#include "JSGlobalData.h"
+#include "JSLock.h"
+#include "Parser.h"
+#include "SourceCode.h"
+#include "SourceProvider.h"
+#include "SourceProviderCacheItem.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/Deque.h>
+#include <wtf/HashMap.h>
+
+namespace JSC {
+
+#if ENABLE(JSC_MULTIPLE_THREADS)
+
+// The source that has arrived so far, parsed with the function cache of the
+// preparser instead of a cache of its own. The source belongs to the
+// preparser, and does not change during a pass.
+class PreparseSourceProvider : public SourceProvider {
+public:
+    static PassRefPtr<PreparseSourceProvider> create(const Vector<UChar>& source, SourceProviderCache* cache)
+    {
+        return adoptRef(new PreparseSourceProvider(source, cache));
+    }
+
+    UString getRange(int start, int end) const
+    {
+        return UString(m_source.data() + start, end - start);
+    }
+    const UChar* data() const { return m_source.data(); }
+    int length() const { return m_source.size(); }
+
+private:
+    PreparseSourceProvider(const Vector<UChar>& source, SourceProviderCache* cache)
+        : SourceProvider(UString(), cache)
+        , m_source(source)
+    {
+    }
+
+    const Vector<UChar>& m_source;
+};
+
+// A single thread pre-parses the scripts of every JSGlobalData, one pass at a
+// time, in the order that their source arrived.
+class PreparseThread {
+    WTF_MAKE_NONCOPYABLE(PreparseThread); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static PreparseThread& shared()
+    {
+        AtomicallyInitializedStatic(PreparseThread&, thread = *new PreparseThread);
+        return thread;
+    }
+
+    void enqueue(BackgroundPreparser* preparser)
+    {
+        MutexLocker locker(m_lock);
+        m_queue.append(preparser);
+        m_condition.signal();
+    }
+
+private:
+    PreparseThread()
+    {
+        detachThread(createThread(threadEntryPoint, this, "JavaScriptCore::BackgroundPreparser"));
+    }
+
+    static void* threadEntryPoint(void* thread)
+    {
+        static_cast<PreparseThread*>(thread)->run();
+        return 0;
+    }
+
+    void run()
+    {
+        // The JSGlobalData is made on this thread, so that its identifier
+        // table is the one that this thread's strings are added to.
+        RefPtr<JSGlobalData> globalData = JSGlobalData::create(ThreadStackTypeSmall);
+        while (true) {
+            RefPtr<BackgroundPreparser> preparser;
+            {
+                MutexLocker locker(m_lock);
+                while (m_queue.isEmpty())
+                    m_condition.wait(m_lock);
+                preparser = m_queue.takeFirst();
+            }
+            preparser->preparse(globalData.get());
+        }
+    }
+
+    Mutex m_lock;
+    ThreadCondition m_condition;
+    Deque<RefPtr<BackgroundPreparser> > m_queue;
+};
+
+#endif
+
+PassRefPtr<BackgroundPreparser> BackgroundPreparser::create(int firstLine)
+{
+    RefPtr<BackgroundPreparser> preparser = adoptRef(new BackgroundPreparser(firstLine));
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    // Released by the background thread once it has pre-parsed all the source.
+    preparser->ref();
+#endif
+    return preparser.release();
+}
+
+BackgroundPreparser::BackgroundPreparser(int firstLine)
+    : m_isFinished(false)
+    , m_isScheduled(false)
+    , m_isDone(false)
+    , m_preparsedLength(0)
+    , m_preparseTime(0)
+    , m_resumePoint(firstLine)
+    , m_verifiedLength(0)
+    , m_sourceMismatch(false)
+    , m_numberOfTransferredFunctions(0)
+{
+}
+
+BackgroundPreparser::~BackgroundPreparser()
+{
+    ASSERT(!m_cache);
+}
+
+void BackgroundPreparser::appendSource(const UChar* characters, unsigned length)
+{
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    MutexLocker locker(m_lock);
+    ASSERT(!m_isFinished);
+    m_source.append(characters, length);
+    schedule();
+#else
+    UNUSED_PARAM(characters);
+    UNUSED_PARAM(length);
+#endif
+}
+
+void BackgroundPreparser::finish()
+{
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    MutexLocker locker(m_lock);
+    if (m_isFinished)
+        return;
+    m_isFinished = true;
+    schedule();
+#endif
+}
+
+void BackgroundPreparser::schedule()
+{
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    // A pass that is already scheduled picks up the new source when it ends.
+    if (m_isScheduled)
+        return;
+    m_isScheduled = true;
+    PreparseThread::shared().enqueue(this);
+#endif
+}
+
+#if ENABLE(JSC_MULTIPLE_THREADS)
+
+void BackgroundPreparser::preparse(JSGlobalData* globalData)
+{
+    bool isFinished;
+    {
+        MutexLocker locker(m_lock);
+        m_preparseSource.append(m_source.data() + m_preparseSource.size(), m_source.size() - m_preparseSource.size());
+        isFinished = m_isFinished;
+    }
+
+    double startTime = currentTime();
+    Vector<PreparsedFunction> functions;
+    if (m_preparseSource.size() > m_preparsedLength) {
+        if (!m_cache)
+            m_cache = adoptPtr(new SourceProviderCache);
+
+        // Unless all the source has arrived this fails at its end, which is
+        // expected; the functions that ended before it are still cached.
+        JSLock lock(SilenceAssertionsOnly);
+        SourceCode source(PreparseSourceProvider::create(m_preparseSource, m_cache.get()), m_resumePoint.offset, m_preparseSource.size(), m_resumePoint.line);
+        globalData->parser->preparse(globalData, source, m_resumePoint);
+        collectNewFunctions(functions);
+    }
+
+    bool isDone = false;
+    {
+        MutexLocker locker(m_lock);
+        // Once published, the strings in the functions are used only by the
+        // main thread, so this thread drops its references before unlocking.
+        if (m_preparsedFunctions.isEmpty())
+            m_preparsedFunctions.swap(functions);
+        else {
+            m_preparsedFunctions.append(functions);
+            functions.clear();
+        }
+        m_preparsedLength = m_preparseSource.size();
+        m_preparseTime += currentTime() - startTime;
+
+        if (m_source.size() > m_preparseSource.size() || m_isFinished != isFinished) {
+            PreparseThread::shared().enqueue(this);
+            return;
+        }
+
+        m_isScheduled = false;
+        if (isFinished) {
+            m_preparseSource.clear();
+            m_cache.clear();
+            m_publishedFunctions.clear();
+            m_isDone = true;
+            isDone = true;
+        }
+    }
+
+    if (isDone)
+        deref();
+}
+
+static void copyNames(const Vector<RefPtr<StringImpl> >& identifiers, Vector<UString>& names, HashMap<StringImpl*, UString>& copies)
+{
+    names.reserveInitialCapacity(identifiers.size());
+    for (size_t i = 0; i < identifiers.size(); ++i) {
+        StringImpl* identifier = identifiers[i].get();
+        pair<HashMap<StringImpl*, UString>::iterator, bool> result = copies.add(identifier, UString());
+        if (result.second)
+            result.first->second = UString(identifier->characters(), identifier->length());
+        names.uncheckedAppend(result.first->second);
+    }
+}
+
+void BackgroundPreparser::collectNewFunctions(Vector<PreparsedFunction>& functions)
+{
+    // The identifiers of this thread can not be used on the main thread, so
+    // the names are copied, once each per pass. Later passes start at the
+    // resume point, so the functions before it are not needed again.
+    HashMap<StringImpl*, UString> copies;
+    Vector<int> passedFunctions;
+    SourceProviderCache::const_iterator end = m_cache->end();
+    for (SourceProviderCache::const_iterator it = m_cache->begin(); it != end; ++it) {
+        if (it->first < m_resumePoint.offset)
+            passedFunctions.append(it->first);
+        if (!m_publishedFunctions.add(it->first).second)
+            continue;
+        const SourceProviderCacheItem* item = it->second;
+        functions.append(PreparsedFunction());
+        PreparsedFunction& function = functions.last();
+        function.openBracePos = it->first;
+        function.closeBracePos = item->closeBracePos;
+        function.closeBraceLine = item->closeBraceLine;
+        function.usesEval = item->usesEval;
+        copyNames(item->usedVariables, function.usedVariables, copies);
+        copyNames(item->writtenVariables, function.writtenVariables, copies);
+    }
+
+    for (size_t i = 0; i < passedFunctions.size(); ++i) {
+        m_cache->remove(passedFunctions[i]);
+        m_publishedFunctions.remove(passedFunctions[i]);
+    }
+}
+
+#endif
+
+bool BackgroundPreparser::sourceMatches(SourceProvider* provider, unsigned length)
+{
+    if (static_cast<unsigned>(provider->length()) < length)
+        return false;
+    if (length > m_verifiedLength) {
+        if (memcmp(provider->data() + m_verifiedLength, m_source.data() + m_verifiedLength, (length - m_verifiedLength) * sizeof(UChar)))
+            return false;
+        m_verifiedLength = length;
+    }
+    return true;
+}
+
+void BackgroundPreparser::transferPreparsedFunctions(JSGlobalData* globalData, SourceProvider* provider)
+{
+    if (m_sourceMismatch)
+        return;
+
+    Vector<PreparsedFunction> functions;
+    {
+        MutexLocker locker(m_lock);
+        if (!sourceMatches(provider, m_preparsedLength)) {
+            m_sourceMismatch = true;
+            m_preparsedFunctions.clear();
+            return;
+        }
+        functions.swap(m_preparsedFunctions);
+        // Once everything has been pre-parsed and checked the source is no
+        // longer needed.
+        if (m_isDone)
+            m_source.clear();
+    }
+    if (functions.isEmpty())
+        return;
+
+    SourceProviderCache* cache = provider->cache();
+    unsigned oldCacheSize = cache->byteSize();
+    for (size_t i = 0; i < functions.size(); ++i) {
+        const PreparsedFunction& function = functions[i];
+        if (cache->get(function.openBracePos))
+            continue;
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(function.closeBraceLine, function.closeBracePos));
+        item->usesEval = function.usesEval;
+        item->usedVariables.reserveInitialCapacity(function.usedVariables.size());
+        for (size_t j = 0; j < function.usedVariables.size(); ++j)
+            item->usedVariables.uncheckedAppend(Identifier(globalData, function.usedVariables[j]).impl());
+        item->writtenVariables.reserveInitialCapacity(function.writtenVariables.size());
+        for (size_t j = 0; j < function.writtenVariables.size(); ++j)
+            item->writtenVariables.uncheckedAppend(Identifier(globalData, function.writtenVariables[j]).impl());
+        unsigned approximateByteSize = item->approximateByteSize();
+        cache->add(function.openBracePos, item.release(), approximateByteSize);
+        m_numberOfTransferredFunctions++;
+    }
+    unsigned newCacheSize = cache->byteSize();
+    if (newCacheSize != oldCacheSize)
+        provider->notifyCacheSizeChanged(newCacheSize - oldCacheSize);
+}
+
+} // namespace JSC
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BackgroundPreparser_h
+#define BackgroundPreparser_h
+
+#include "JSParser.h"
+#include "UString.h"
+#include <wtf/HashSet.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    class JSGlobalData;
+    class SourceProvider;
+    class SourceProviderCache;
+
+    // Pre-parses a script on a background thread while its source is still
+    // arriving, so that by the time the whole script has loaded the functions
+    // in it have been syntax checked and their cache items built. Before the
+    // script is parsed on the main thread, the items are moved into the
+    // SourceProviderCache of its SourceProvider, and the parser skips the
+    // bodies of those functions; only the code that runs is parsed and
+    // generated on the main thread.
+    //
+    // The background thread has its own JSGlobalData, and so its own parser,
+    // arena and identifier table. Each time more source arrives it parses
+    // from the first top-level statement that the earlier passes did not see
+    // the end of, up to the end of the source that has arrived so far. This
+    // fails at the end of the source but caches every function whose closing
+    // brace was seen; the functions cached by earlier passes are skipped. The
+    // names used by the functions are copied out of the identifier table of
+    // the background thread, and made identifiers again on the main thread.
+    //
+    // Source is appended and the functions are taken on the main thread. The
+    // background thread keeps a reference to the preparser until finish() is
+    // called, which must be done even if the script is not going to run.
+    class BackgroundPreparser : public ThreadSafeRefCounted<BackgroundPreparser> {
+    public:
+        static PassRefPtr<BackgroundPreparser> create(int firstLine = 1);
+        ~BackgroundPreparser();
+
+        void appendSource(const UChar* characters, unsigned length);
+        void finish();
+
+        // Moves the functions pre-parsed so far into the cache of the provider,
+        // after checking that the provider starts with the source they were
+        // found in. Called on the main thread before the source is parsed.
+        void transferPreparsedFunctions(JSGlobalData*, SourceProvider*);
+
+        unsigned numberOfTransferredFunctions() const { return m_numberOfTransferredFunctions; }
+        double preparseTime()
+        {
+            MutexLocker locker(m_lock);
+            return m_preparseTime;
+        }
+
+    private:
+        friend class PreparseThread;
+
+        BackgroundPreparser(int firstLine);
+
+        // The part of a SourceProviderCacheItem that does not depend on the
+        // identifier table it was made in.
+        struct PreparsedFunction {
+            int openBracePos;
+            int closeBracePos;
+            int closeBraceLine;
+            bool usesEval;
+            Vector<UString> usedVariables;
+            Vector<UString> writtenVariables;
+        };
+
+        void schedule();
+        void preparse(JSGlobalData*);
+        void collectNewFunctions(Vector<PreparsedFunction>&);
+        bool sourceMatches(SourceProvider*, unsigned length);
+
+        // Shared between the threads, and guarded by m_lock.
+        Mutex m_lock;
+        Vector<UChar> m_source;
+        bool m_isFinished;
+        bool m_isScheduled;
+        bool m_isDone;
+        unsigned m_preparsedLength;
+        Vector<PreparsedFunction> m_preparsedFunctions;
+        double m_preparseTime;
+
+        // Only used on the background thread. The cache holds identifiers of
+        // the background thread, so it is deleted there too. The source is
+        // copied from m_source as it arrives, and only holds the functions
+        // after the resume point.
+        Vector<UChar> m_preparseSource;
+        JSParserResumePoint m_resumePoint;
+        OwnPtr<SourceProviderCache> m_cache;
+        HashSet<int> m_publishedFunctions;
+
+        // Only used on the main thread.
+        unsigned m_verifiedLength;
+        bool m_sourceMismatch;
+        unsigned m_numberOfTransferredFunctions;
+    };
+
+} // namespace JSC
+
+#endif // BackgroundPreparser_h
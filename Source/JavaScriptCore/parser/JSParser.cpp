@@ -33,8 +33,10 @@ using namespace JSC;
 #include "JSGlobalData.h"
 #include "NodeInfo.h"
 #include "ASTBuilder.h"
+#include "Parser.h"
 #include "SourceProvider.h"
 #include "SourceProviderCacheItem.h"
+#include <wtf/CurrentTime.h>
 #include <wtf/HashFunctions.h>
 #include <wtf/OwnPtr.h>
 #include <wtf/WTFThreadData.h>
@@ -70,7 +72,7 @@ COMPILE_ASSERT(LastUntaggedToken < 64, LessThan64UntaggedTokens);
 
 class JSParser {
 public:
-    JSParser(Lexer*, JSGlobalData*, FunctionParameters*, bool isStrictContext, bool isFunction, SourceProvider*);
+    JSParser(Lexer*, JSGlobalData*, FunctionParameters*, bool isStrictContext, bool isFunction, SourceProvider*, JSParserResumePoint*);
     const char* parseProgram();
 private:
     struct AllowInOverride {
@@ -244,6 +246,20 @@ private:
         return m_lastTokenEnd;
     }
 
+    // Called after each statement in a list. A top-level statement is known to
+    // have ended only if the token after it was read in full; the source after
+    // it may still change where an earlier token ends.
+    void updateResumePoint()
+    {
+        if (m_statementDepth || m_scopeStack.size() != 1 || match(ERRORTOK))
+            return;
+        if (m_token.m_info.endOffset >= m_lexer->sourceProvider()->length())
+            return;
+        m_resumePoint->offset = tokenStart();
+        m_resumePoint->line = tokenLine();
+        m_resumePoint->strictMode = strictMode();
+    }
+
     ParserArena m_arena;
     Lexer* m_lexer;
     StackBounds m_stack;
@@ -260,6 +276,7 @@ private:
     int m_statementDepth;
     int m_nonTrivialExpressionCount;
     const Identifier* m_lastIdentifier;
+    JSParserResumePoint* m_resumePoint;
 
     struct DepthManager {
         DepthManager(int* depth)
@@ -610,13 +627,13 @@ private:
     SourceProviderCache* m_functionCache;
 };
 
-const char* jsParse(JSGlobalData* globalData, FunctionParameters* parameters, JSParserStrictness strictness, JSParserMode parserMode, const SourceCode* source)
+const char* jsParse(JSGlobalData* globalData, FunctionParameters* parameters, JSParserStrictness strictness, JSParserMode parserMode, const SourceCode* source, JSParserResumePoint* resumePoint)
 {
-    JSParser parser(globalData->lexer, globalData, parameters, strictness == JSParseStrict, parserMode == JSParseFunctionCode, source->provider());
+    JSParser parser(globalData->lexer, globalData, parameters, strictness == JSParseStrict, parserMode == JSParseFunctionCode, source->provider(), resumePoint);
     return parser.parseProgram();
 }
 
-JSParser::JSParser(Lexer* lexer, JSGlobalData* globalData, FunctionParameters* parameters, bool inStrictContext, bool isFunction, SourceProvider* provider)
+JSParser::JSParser(Lexer* lexer, JSGlobalData* globalData, FunctionParameters* parameters, bool inStrictContext, bool isFunction, SourceProvider* provider, JSParserResumePoint* resumePoint)
     : m_lexer(lexer)
     , m_stack(globalData->stack())
     , m_error(false)
@@ -631,6 +648,7 @@ JSParser::JSParser(Lexer* lexer, JSGlobalData* globalData, FunctionParameters* p
     , m_statementDepth(0)
     , m_nonTrivialExpressionCount(0)
     , m_lastIdentifier(0)
+    , m_resumePoint(resumePoint)
     , m_functionCache(m_lexer->sourceProvider()->cache())
 {
     ScopeRef scope = pushScope();
@@ -653,7 +671,13 @@ const char* JSParser::parseProgram()
     if (m_lexer->isReparsing())
         m_statementDepth--;
     ScopeRef scope = currentScope();
-    SourceElements* sourceElements = parseSourceElements<CheckForStrictMode>(context);
+    // A program parsed again from one of its later statements is past its
+    // directive prologue.
+    SourceElements* sourceElements;
+    if (m_resumePoint && m_resumePoint->offset)
+        sourceElements = parseSourceElements<DontCheckForStrictMode>(context);
+    else
+        sourceElements = parseSourceElements<CheckForStrictMode>(context);
     if (!sourceElements || !consume(EOFTOK))
         return m_errorMessage;
     IdentifierSet capturedVariables;
@@ -701,6 +725,8 @@ template <JSParser::SourceElementsMode mode, class TreeBuilder> TreeSourceElemen
                 seenNonDirective = true;
         }
         context.appendStatement(sourceElements, statement);
+        if (m_resumePoint && (mode == DontCheckForStrictMode || seenNonDirective))
+            updateResumePoint();
     }
 
     if (m_error)
@@ -1319,6 +1345,13 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
         failIfFalse(popScope(functionScope, TreeBuilder::NeedsFreeVariableInfo));
 
         closeBracePos = cachedInfo->closeBracePos;
+#if ENABLE(PARSER_STATS)
+        if (TreeBuilder::CreatesAST) {
+            ParserStatistics& statistics = m_globalData->parser->statistics();
+            statistics.skippedFunctionCount++;
+            statistics.skippedBytes += closeBracePos - openBracePos;
+        }
+#endif
         m_token = cachedInfo->closeBraceToken();
         m_lexer->setOffset(m_token.m_info.endOffset);
         m_lexer->setLineNumber(m_token.m_info.line);
@@ -1329,6 +1362,11 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
 
     next();
 
+#if ENABLE(PARSER_STATS)
+    // Only the outermost function bodies count as pre-parsed; the functions
+    // nested in them are part of their source.
+    double preparseStartTime = TreeBuilder::CreatesAST ? currentTime() : 0;
+#endif
     body = parseFunctionBody(context);
     failIfFalse(body);
     if (functionScope->strictMode() && name) {
@@ -1336,6 +1374,14 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
         failIfTrue(m_globalData->propertyNames->eval == *name);
     }
     closeBracePos = m_token.m_data.intValue;
+#if ENABLE(PARSER_STATS)
+    if (TreeBuilder::CreatesAST) {
+        ParserStatistics& statistics = m_globalData->parser->statistics();
+        statistics.preparsedFunctionCount++;
+        statistics.preparsedBytes += closeBracePos - openBracePos;
+        statistics.preparseTime += currentTime() - preparseStartTime;
+    }
+#endif
     
     // Cache the tokenizer state and the function scope the first time the function is parsed.
     // Any future reparsing can then skip the function.
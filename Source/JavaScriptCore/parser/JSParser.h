@@ -159,6 +159,21 @@ struct JSToken {
 enum JSParserStrictness { JSParseNormal, JSParseStrict };
 enum JSParserMode { JSParseProgramCode, JSParseFunctionCode };
 
-const char* jsParse(JSGlobalData*, FunctionParameters*, JSParserStrictness, JSParserMode, const SourceCode*);
+// Where a program whose source is still arriving can be parsed again from: the
+// start of the first top-level statement that was not seen to end.
+struct JSParserResumePoint {
+    JSParserResumePoint(int firstLine)
+        : offset(0)
+        , line(firstLine)
+        , strictMode(false)
+    {
+    }
+
+    int offset;
+    int line;
+    bool strictMode;
+};
+
+const char* jsParse(JSGlobalData*, FunctionParameters*, JSParserStrictness, JSParserMode, const SourceCode*, JSParserResumePoint* = 0);
 }
 #endif // JSParser_h
@@ -35,6 +35,7 @@
 #include <limits.h>
 #include <string.h>
 #include <wtf/Assertions.h>
+#include <wtf/SIMDHelpers.h>
 
 using namespace WTF;
 using namespace Unicode;
@@ -221,6 +222,82 @@ static const unsigned short typesOfASCIICharacters[128] = {
 /* 127 - Delete             */ CharacterInvalid,
 };
 
+// Long runs of characters that the lexer does not need to look at one by one
+// (indentation, comment text and string literal bodies) are skipped eight
+// UChars at a time. Each matcher recognizes the characters that end a run,
+// both one at a time and in a whole vector.
+#if USE(UCHAR_VECTORS)
+static ALWAYS_INLINE UCharVector lineTerminatorMask(UCharVector characters)
+{
+    UCharVector newlines = orVector(equalVector(characters, splatVector('\n')), equalVector(characters, splatVector('\r')));
+    return orVector(newlines, equalVector(andVector(characters, splatVector(0xFFFE)), splatVector(0x2028)));
+}
+#endif
+
+// Ends a run of spaces and tabs.
+struct IndentationEnd {
+    bool operator()(UChar character) const { return character != ' ' && character != '\t'; }
+#if USE(UCHAR_VECTORS)
+    bool operator()(UCharVector characters) const { return !allLanesSet(orVector(equalVector(characters, splatVector(' ')), equalVector(characters, splatVector('\t')))); }
+#endif
+};
+
+// Ends the text of a single line comment.
+struct SingleLineCommentEnd {
+    bool operator()(UChar character) const { return Lexer::isLineTerminator(character); }
+#if USE(UCHAR_VECTORS)
+    bool operator()(UCharVector characters) const { return anyLaneSet(lineTerminatorMask(characters)); }
+#endif
+};
+
+// Ends a run of multiline comment text that can be skipped without counting lines.
+struct MultilineCommentEnd {
+    bool operator()(UChar character) const { return character == '*' || Lexer::isLineTerminator(character); }
+#if USE(UCHAR_VECTORS)
+    bool operator()(UCharVector characters) const { return anyLaneSet(orVector(equalVector(characters, splatVector('*')), lineTerminatorMask(characters))); }
+#endif
+};
+
+// Ends a run of string literal characters that need no escaping.
+struct StringBodyEnd {
+    StringBodyEnd(UChar quote)
+        : quote(quote)
+#if USE(UCHAR_VECTORS)
+        , quoteVector(splatVector(quote))
+#endif
+    {
+    }
+
+    bool operator()(UChar character) const { return character == quote || character == '\\' || Lexer::isLineTerminator(character); }
+#if USE(UCHAR_VECTORS)
+    bool operator()(UCharVector characters) const
+    {
+        UCharVector quoteOrEscape = orVector(equalVector(characters, quoteVector), equalVector(characters, splatVector('\\')));
+        return anyLaneSet(orVector(quoteOrEscape, lineTerminatorMask(characters)));
+    }
+#endif
+
+    UChar quote;
+#if USE(UCHAR_VECTORS)
+    UCharVector quoteVector;
+#endif
+};
+
+// Returns the first character in [position, end) that ends the run, or end.
+template <typename RunEnd> static ALWAYS_INLINE const UChar* scanRun(const UChar* position, const UChar* end, const RunEnd& runEnd)
+{
+#if USE(UCHAR_VECTORS)
+    while (static_cast<size_t>(end - position) >= ucharVectorLength) {
+        if (runEnd(loadVector(position)))
+            break;
+        position += ucharVectorLength;
+    }
+#endif
+    while (position < end && !runEnd(*position))
+        ++position;
+    return position;
+}
+
 Lexer::Lexer(JSGlobalData* globalData)
     : m_isReparsing(false)
     , m_globalData(globalData)
@@ -281,6 +358,26 @@ ALWAYS_INLINE void Lexer::shift()
         m_current = *m_code;
 }
 
+ALWAYS_INLINE void Lexer::shiftTo(const UChar* position)
+{
+    ASSERT(position >= m_code && position <= m_codeEnd);
+    m_code = position;
+    m_current = -1;
+    if (LIKELY(m_code < m_codeEnd))
+        m_current = *m_code;
+}
+
+ALWAYS_INLINE void Lexer::skipWhiteSpace()
+{
+    if (!isWhiteSpace(m_current))
+        return;
+    shift();
+    if (m_current == ' ' || m_current == '\t')
+        shiftTo(scanRun(m_code, m_codeEnd, IndentationEnd()));
+    while (isWhiteSpace(m_current))
+        shift();
+}
+
 ALWAYS_INLINE int Lexer::peek(int offset)
 {
     // Only use if necessary
@@ -459,9 +556,13 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
     shift();
 
     const UChar* stringStart = currentCharacter();
+    StringBodyEnd stringBodyEnd(stringQuoteCharacter);
 
-    while (m_current != stringQuoteCharacter) {
-        if (UNLIKELY(m_current == '\\')) {
+    while (true) {
+        shiftTo(scanRun(currentCharacter(), m_codeEnd, stringBodyEnd));
+        if (m_current == stringQuoteCharacter)
+            break;
+        if (LIKELY(m_current == '\\')) {
             if (stringStart != currentCharacter())
                 m_buffer16.append(stringStart, currentCharacter() - stringStart);
             shift();
@@ -523,16 +624,9 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
             stringStart = currentCharacter();
             continue;
         }
-        // Fast check for characters that require special handling.
-        // Catches -1, \n, \r, 0x2028, and 0x2029 as efficiently
-        // as possible, and lets through all common ASCII characters.
-        if (UNLIKELY(((static_cast<unsigned>(m_current) - 0xE) & 0x2000))) {
-            // New-line or end of input is not allowed
-            if (UNLIKELY(isLineTerminator(m_current)) || UNLIKELY(m_current == -1))
-                return false;
-            // Anything else is just a normal character
-        }
-        shift();
+        // New-line or end of input is not allowed
+        ASSERT(isLineTerminator(m_current) || m_current == -1);
+        return false;
     }
 
     if (currentCharacter() != stringStart)
@@ -685,6 +779,7 @@ ALWAYS_INLINE bool Lexer::parseNumberAfterExponentIndicator()
 ALWAYS_INLINE bool Lexer::parseMultilineComment()
 {
     while (true) {
+        shiftTo(scanRun(currentCharacter(), m_codeEnd, MultilineCommentEnd()));
         while (UNLIKELY(m_current == '*')) {
             shift();
             if (m_current == '/') {
@@ -722,8 +817,7 @@ JSTokenType Lexer::lex(JSTokenData* lvalp, JSTokenInfo* llocp, LexType lexType,
     m_terminator = false;
 
 start:
-    while (isWhiteSpace(m_current))
-        shift();
+    skipWhiteSpace();
 
     int startOffset = currentOffset();
 
@@ -1054,11 +1148,9 @@ inNumberAfterDecimalPoint:
     goto returnToken;
 
 inSingleLineComment:
-    while (!isLineTerminator(m_current)) {
-        if (UNLIKELY(m_current == -1))
-            return EOFTOK;
-        shift();
-    }
+    shiftTo(scanRun(currentCharacter(), m_codeEnd, SingleLineCommentEnd()));
+    if (UNLIKELY(m_current == -1))
+        return EOFTOK;
     shiftLineTerminator();
     m_atLineStart = true;
     m_terminator = true;
@@ -98,6 +98,8 @@ namespace JSC {
         void copyCodeWithoutBOMs();
 
         ALWAYS_INLINE void shift();
+        ALWAYS_INLINE void shiftTo(const UChar*);
+        ALWAYS_INLINE void skipWhiteSpace();
         ALWAYS_INLINE int peek(int offset);
         int getUnicodeCharacter();
         void shiftLineTerminator();
@@ -1476,9 +1476,11 @@ namespace JSC {
     class FunctionParameters : public Vector<Identifier>, public RefCounted<FunctionParameters> {
         WTF_MAKE_FAST_ALLOCATED;
     public:
+        static PassRefPtr<FunctionParameters> create() { return adoptRef(new FunctionParameters); }
         static PassRefPtr<FunctionParameters> create(ParameterNode* firstParameter) { return adoptRef(new FunctionParameters(firstParameter)); }
 
     private:
+        FunctionParameters() { }
         FunctionParameters(ParameterNode*);
     };
 
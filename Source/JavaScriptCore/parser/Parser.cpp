@@ -26,10 +26,11 @@
 #include "Debugger.h"
 #include "JSParser.h"
 #include "Lexer.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
-void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSParserStrictness strictness, JSParserMode mode, int* errLine, UString* errMsg)
+void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSParserStrictness strictness, JSParserMode mode, int* errLine, UString* errMsg, JSParserResumePoint* resumePoint)
 {
     ASSERT(globalData);
     m_sourceElements = 0;
@@ -45,10 +46,23 @@ void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSP
     *errLine = -1;
     *errMsg = UString();
 
+    SourceProvider* provider = m_source->provider();
+    if (BackgroundPreparser* backgroundPreparser = provider->backgroundPreparser())
+        backgroundPreparser->transferPreparsedFunctions(globalData, provider);
+
     Lexer& lexer = *globalData->lexer;
     lexer.setCode(*m_source, m_arena);
 
-    const char* parseError = jsParse(globalData, parameters, strictness, mode, m_source);
+#if ENABLE(PARSER_STATS)
+    size_t lazyBytes = m_statistics.preparsedBytes + m_statistics.skippedBytes;
+    double startTime = currentTime();
+#endif
+    const char* parseError = jsParse(globalData, parameters, strictness, mode, m_source, resumePoint);
+#if ENABLE(PARSER_STATS)
+    m_statistics.parseTime += currentTime() - startTime;
+    m_statistics.parseCount++;
+    m_statistics.fullyParsedBytes += m_source->length() - (m_statistics.preparsedBytes + m_statistics.skippedBytes - lazyBytes);
+#endif
     int lineNumber = lexer.lineNumber();
     bool lexError = lexer.sawError();
     lexer.clear();
@@ -60,6 +74,22 @@ void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSP
     }
 }
 
+bool Parser::preparse(JSGlobalData* globalData, const SourceCode& source, JSParserResumePoint& resumePoint)
+{
+    m_source = &source;
+    parse(globalData, 0, resumePoint.strictMode ? JSParseStrict : JSParseNormal, JSParseProgramCode, 0, 0, &resumePoint);
+    bool succeeded = m_sourceElements;
+
+    m_arena.reset();
+
+    m_source = 0;
+    m_sourceElements = 0;
+    m_varDeclarations = 0;
+    m_funcDeclarations = 0;
+    m_capturedVariables.clear();
+    return succeeded;
+}
+
 void Parser::didFinishParsing(SourceElements* sourceElements, ParserArenaData<DeclarationStacks::VarStack>* varStack, 
                               ParserArenaData<DeclarationStacks::FunctionStack>* funcStack, CodeFeatures features, int lastLine, int numConstants, IdentifierSet& capturedVars)
 {
@@ -45,6 +45,44 @@ namespace JSC {
 
     template <typename T> struct ParserArenaData : ParserArenaDeletable { T data; };
 
+#if ENABLE(PARSER_STATS)
+    // Program, eval and function code is parsed into an AST, but the bodies of
+    // the functions it contains are only syntax checked ("pre-parsed"), or
+    // skipped if the SourceProviderCache already knows about them. A function
+    // is parsed again, and compiled, the first time it is called.
+    struct ParserStatistics {
+        ParserStatistics()
+            : parseCount(0)
+            , parseTime(0)
+            , fullyParsedBytes(0)
+            , preparsedFunctionCount(0)
+            , preparsedBytes(0)
+            , preparseTime(0)
+            , skippedFunctionCount(0)
+            , skippedBytes(0)
+            , functionCount(0)
+            , calledFunctionCount(0)
+        {
+        }
+
+        unsigned parseCount;
+        double parseTime; // In seconds, including preparseTime.
+        size_t fullyParsedBytes;
+
+        unsigned preparsedFunctionCount;
+        size_t preparsedBytes;
+        double preparseTime;
+
+        unsigned skippedFunctionCount;
+        size_t skippedBytes;
+
+        // Functions that have been created from parsed code, and how many of
+        // them have been compiled because they were called.
+        unsigned functionCount;
+        unsigned calledFunctionCount;
+    };
+#endif
+
     class Parser {
         WTF_MAKE_NONCOPYABLE(Parser); WTF_MAKE_FAST_ALLOCATED;
     public:
@@ -56,10 +94,20 @@ namespace JSC {
                               ParserArenaData<DeclarationStacks::FunctionStack>*, CodeFeatures features,
                               int lastLine, int numConstants, IdentifierSet&);
 
+        // Parses program code only to fill the function cache of its source
+        // provider; the tree is thrown away. Needs no global object, so can
+        // be used with a JSGlobalData that has none. The code is parsed in the
+        // strict mode of the resume point, which is moved past each top-level
+        // statement that ends.
+        bool preparse(JSGlobalData*, const SourceCode&, JSParserResumePoint&);
+
         ParserArena& arena() { return m_arena; }
+#if ENABLE(PARSER_STATS)
+        ParserStatistics& statistics() { return m_statistics; }
+#endif
 
     private:
-        void parse(JSGlobalData*, FunctionParameters*, JSParserStrictness strictness, JSParserMode mode, int* errLine, UString* errMsg);
+        void parse(JSGlobalData*, FunctionParameters*, JSParserStrictness strictness, JSParserMode mode, int* errLine, UString* errMsg, JSParserResumePoint* = 0);
 
         // Used to determine type of error to report.
         bool isFunctionBodyNode(ScopeNode*) { return false; }
@@ -74,6 +122,9 @@ namespace JSC {
         CodeFeatures m_features;
         int m_lastLine;
         int m_numConstants;
+#if ENABLE(PARSER_STATS)
+        ParserStatistics m_statistics;
+#endif
     };
 
     template <class ParsedNode>
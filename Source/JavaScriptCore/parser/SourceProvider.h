@@ -29,6 +29,8 @@
 #ifndef SourceProvider_h
 #define SourceProvider_h
 
+#include "BackgroundPreparser.h"
+#include "BytecodeCache.h"
 #include "SourceProviderCache.h"
 #include "UString.h"
 #include <wtf/PassOwnPtr.h>
@@ -66,6 +68,22 @@ namespace JSC {
 
         SourceProviderCache* cache() const { return m_cache; }
         void notifyCacheSizeChanged(int delta) { if (!m_cacheOwned) cacheSizeChanged(delta); }
+
+        // Code generated from this source is added to the bytecode cache, and
+        // loaded from it instead of being parsed again. Setting the cache
+        // reads the source, so a subclass can only set it once constructed.
+        BytecodeCache* bytecodeCache() const { return m_bytecodeCache.get(); }
+        void setBytecodeCache(PassRefPtr<BytecodeCache> bytecodeCache)
+        {
+            m_bytecodeCache = bytecodeCache;
+            if (m_bytecodeCache)
+                m_bytecodeCache->setSource(data(), length());
+        }
+
+        // The functions that a BackgroundPreparser has pre-parsed while the
+        // source was arriving are added to the cache before each parse.
+        BackgroundPreparser* backgroundPreparser() const { return m_backgroundPreparser.get(); }
+        void setBackgroundPreparser(PassRefPtr<BackgroundPreparser> backgroundPreparser) { m_backgroundPreparser = backgroundPreparser; }
         
     private:
         virtual void cacheSizeChanged(int delta) { UNUSED_PARAM(delta); }
@@ -74,6 +92,8 @@ namespace JSC {
         bool m_validated;
         SourceProviderCache* m_cache;
         bool m_cacheOwned;
+        RefPtr<BytecodeCache> m_bytecodeCache;
+        RefPtr<BackgroundPreparser> m_backgroundPreparser;
     };
 
     class UStringSourceProvider : public SourceProvider {
@@ -53,4 +53,13 @@ void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCache
     m_contentByteSize += size;
 }
 
+void SourceProviderCache::remove(int sourcePosition)
+{
+    SourceProviderCacheItem* item = m_map.take(sourcePosition);
+    if (!item)
+        return;
+    m_contentByteSize -= item->approximateByteSize();
+    delete item;
+}
+
 }
@@ -31,17 +31,24 @@ namespace JSC {
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
+    typedef HashMap<int, SourceProviderCacheItem*> ItemMap;
 public:
+    typedef ItemMap::const_iterator const_iterator;
+
     SourceProviderCache() : m_contentByteSize(0) {}
     ~SourceProviderCache();
 
     void clear();
     unsigned byteSize() const;
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
+    void remove(int sourcePosition);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    const_iterator begin() const { return m_map.begin(); }
+    const_iterator end() const { return m_map.end(); }
+
 private:
-    HashMap<int, SourceProviderCacheItem*> m_map;
+    ItemMap m_map;
     unsigned m_contentByteSize;
 };
 
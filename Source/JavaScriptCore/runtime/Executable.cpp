@@ -26,6 +26,7 @@
 #include "config.h"
 #include "Executable.h"
 
+#include "BytecodeCache.h"
 #include "BytecodeGenerator.h"
 #include "CodeBlock.h"
 #include "JIT.h"
@@ -76,24 +77,36 @@ FunctionExecutable::FunctionExecutable(JSGlobalData* globalData, const Identifie
     : ScriptExecutable(globalData->functionExecutableStructure.get(), globalData, source, inStrictContext)
     , m_numCapturedVariables(0)
     , m_forceUsesArguments(forceUsesArguments)
+#if ENABLE(PARSER_STATS)
+    , m_hasBeenCompiled(false)
+#endif
     , m_parameters(parameters)
     , m_name(name)
     , m_symbolTable(0)
 {
     m_firstLine = firstLine;
     m_lastLine = lastLine;
+#if ENABLE(PARSER_STATS)
+    globalData->parser->statistics().functionCount++;
+#endif
 }
 
 FunctionExecutable::FunctionExecutable(ExecState* exec, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, bool inStrictContext, int firstLine, int lastLine)
     : ScriptExecutable(exec->globalData().functionExecutableStructure.get(), exec, source, inStrictContext)
     , m_numCapturedVariables(0)
     , m_forceUsesArguments(forceUsesArguments)
+#if ENABLE(PARSER_STATS)
+    , m_hasBeenCompiled(false)
+#endif
     , m_parameters(parameters)
     , m_name(name)
     , m_symbolTable(0)
 {
     m_firstLine = firstLine;
     m_lastLine = lastLine;
+#if ENABLE(PARSER_STATS)
+    exec->globalData().parser->statistics().functionCount++;
+#endif
 }
 
 
@@ -122,19 +135,31 @@ JSObject* EvalExecutable::compileInternal(ExecState* exec, ScopeChainNode* scope
 
     evalNode->destroyData();
 
-#if ENABLE(JIT)
-    if (exec->globalData().canUseJIT()) {
-        m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_evalCodeBlock.get());
-#if !ENABLE(OPCODE_SAMPLING)
-        if (!BytecodeGenerator::dumpsGeneratedCode())
-            m_evalCodeBlock->discardBytecode();
-#endif
-    }
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+    if (exec->globalData().canUseJIT())
+        jitCompile(*globalData);
 #endif
 
     return 0;
 }
 
+#if ENABLE(JIT)
+void EvalExecutable::jitCompile(JSGlobalData& globalData)
+{
+    ASSERT(m_evalCodeBlock);
+    if (!!m_jitCodeForCall)
+        return;
+
+    m_jitCodeForCall = JIT::compile(&globalData, m_evalCodeBlock.get());
+    // Frames that started out in the interpreter may still be running the
+    // bytecode, so tiered compilation keeps it.
+#if !ENABLE(OPCODE_SAMPLING) && !ENABLE(TIERED_COMPILATION)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        m_evalCodeBlock->discardBytecode();
+#endif
+}
+#endif
+
 void EvalExecutable::markChildren(MarkStack& markStack)
 {
     ScriptExecutable::markChildren(markStack);
@@ -160,6 +185,15 @@ JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* sc
 
     JSObject* exception = 0;
     JSGlobalData* globalData = &exec->globalData();
+    BytecodeCache* bytecodeCache = m_source.provider()->bytecodeCache();
+    if (bytecodeCache && bytecodeCache->loadProgram(exec, scopeChainNode, this)) {
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+        if (exec->globalData().canUseJIT())
+            jitCompile(*globalData);
+#endif
+        return 0;
+    }
+
     JSGlobalObject* lexicalGlobalObject = exec->lexicalGlobalObject();
     RefPtr<ProgramNode> programNode = globalData->parser->parse<ProgramNode>(lexicalGlobalObject, lexicalGlobalObject->debugger(), exec, m_source, 0, isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
     if (!programNode) {
@@ -178,45 +212,29 @@ JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* sc
         return exception;
     }
 
+    if (bytecodeCache)
+        bytecodeCache->addProgram(this, programNode.get());
     programNode->destroyData();
 
-#if ENABLE(JIT)
-    if (exec->globalData().canUseJIT()) {
-        m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_programCodeBlock.get());
-#if !ENABLE(OPCODE_SAMPLING)
-        if (!BytecodeGenerator::dumpsGeneratedCode())
-            m_programCodeBlock->discardBytecode();
-#endif
-    }
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+    if (exec->globalData().canUseJIT())
+        jitCompile(*globalData);
 #endif
 
    return 0;
 }
 
 #if ENABLE(JIT)
-static bool tryDFGCompile(JSGlobalData* globalData, CodeBlock* codeBlock, JITCode& jitCode, MacroAssemblerCodePtr& jitCodeWithArityCheck)
+void ProgramExecutable::jitCompile(JSGlobalData& globalData)
 {
-#if ENABLE(DFG_JIT)
-#if ENABLE(DFG_JIT_RESTRICTIONS)
-    // FIXME: No flow control yet supported, don't bother scanning the bytecode if there are any jump targets.
-    // FIXME: temporarily disable property accesses until we fix regressions.
-    if (codeBlock->numberOfJumpTargets() || codeBlock->numberOfStructureStubInfos())
-        return false;
-#endif
-
-    DFG::Graph dfg;
-    if (!parse(dfg, globalData, codeBlock))
-        return false;
-
-    DFG::JITCompiler dataFlowJIT(globalData, dfg, codeBlock);
-    dataFlowJIT.compileFunction(jitCode, jitCodeWithArityCheck);
-    return true;
-#else
-    UNUSED_PARAM(globalData);
-    UNUSED_PARAM(codeBlock);
-    UNUSED_PARAM(jitCode);
-    UNUSED_PARAM(jitCodeWithArityCheck);
-    return false;
+    ASSERT(m_programCodeBlock);
+    if (!!m_jitCodeForCall)
+        return;
+
+    m_jitCodeForCall = JIT::compile(&globalData, m_programCodeBlock.get());
+#if !ENABLE(OPCODE_SAMPLING) && !ENABLE(TIERED_COMPILATION)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        m_programCodeBlock->discardBytecode();
 #endif
 }
 #endif
@@ -228,10 +246,32 @@ void ProgramExecutable::markChildren(MarkStack& markStack)
         m_programCodeBlock->markAggregate(markStack);
 }
 
+#if ENABLE(PARSER_STATS)
+void FunctionExecutable::didCompile(JSGlobalData* globalData)
+{
+    if (m_hasBeenCompiled)
+        return;
+    m_hasBeenCompiled = true;
+    globalData->parser->statistics().calledFunctionCount++;
+}
+#endif
+
 JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
 {
     JSObject* exception = 0;
     JSGlobalData* globalData = scopeChainNode->globalData;
+#if ENABLE(PARSER_STATS)
+    didCompile(globalData);
+#endif
+    BytecodeCache* bytecodeCache = m_source.provider()->bytecodeCache();
+    if (bytecodeCache && bytecodeCache->loadFunction(exec, scopeChainNode, this, false)) {
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+        if (exec->globalData().canUseJIT())
+            jitCompileForCall(*globalData);
+#endif
+        return 0;
+    }
+
     RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
     if (!body) {
         ASSERT(exception);
@@ -258,28 +298,132 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
     m_numCapturedVariables = m_codeBlockForCall->m_numCapturedVars;
     m_symbolTable = m_codeBlockForCall->sharedSymbolTable();
 
+    if (bytecodeCache)
+        bytecodeCache->addFunction(this, false);
     body->destroyData();
 
-#if ENABLE(JIT)
-    if (exec->globalData().canUseJIT()) {
-        bool dfgCompiled = tryDFGCompile(&exec->globalData(), m_codeBlockForCall.get(), m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
-        if (!dfgCompiled)
-            m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+    if (exec->globalData().canUseJIT())
+        jitCompileForCall(*globalData);
+#endif
 
-#if !ENABLE(OPCODE_SAMPLING)
-        if (!BytecodeGenerator::dumpsGeneratedCode())
-            m_codeBlockForCall->discardBytecode();
+    return 0;
+}
+
+#if ENABLE(JIT)
+void FunctionExecutable::jitCompileForCall(JSGlobalData& globalData)
+{
+    ASSERT(m_codeBlockForCall);
+    if (!!m_jitCodeForCall)
+        return;
+
+    m_jitCodeForCall = JIT::compile(&globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
+#if !ENABLE(OPCODE_SAMPLING) && !ENABLE(TIERED_COMPILATION)
+    // The bytecode of a function that may be optimized later is kept, to
+    // check that the bytecode regenerated for the DFG JIT matches it.
+    bool keepsBytecode = false;
+#if ENABLE(DFG_JIT)
+    keepsBytecode = m_codeBlockForCall->canBeOptimized();
+#endif
+    if (!BytecodeGenerator::dumpsGeneratedCode() && !keepsBytecode)
+        m_codeBlockForCall->discardBytecode();
+#endif
+}
 #endif
+
+#if ENABLE(DFG_JIT)
+// Optimized code exits into the baseline code by bytecode offset, so the two
+// must have been generated from the same bytecode.
+static bool hasSameBytecode(Interpreter* interpreter, CodeBlock* codeBlock, CodeBlock* otherCodeBlock)
+{
+    if (codeBlock->m_numCalleeRegisters != otherCodeBlock->m_numCalleeRegisters || codeBlock->m_numParameters != otherCodeBlock->m_numParameters)
+        return false;
+
+    Vector<Instruction>& instructions = codeBlock->instructions();
+    Vector<Instruction>& otherInstructions = otherCodeBlock->instructions();
+    if (instructions.size() != otherInstructions.size())
+        return false;
+    for (size_t i = 0; i < instructions.size(); i += opcodeLengths[interpreter->getOpcodeID(instructions[i].u.opcode)]) {
+        if (instructions[i].u.opcode != otherInstructions[i].u.opcode)
+            return false;
+    }
+    return true;
+}
+
+bool FunctionExecutable::compileOptimizedForCall(ExecState* exec, ScopeChainNode* scopeChainNode)
+{
+    ASSERT(m_codeBlockForCall && m_codeBlockForCall->canBeOptimized() && !m_codeBlockForCall->alternative());
+
+    JSObject* exception = 0;
+    JSGlobalData* globalData = scopeChainNode->globalData;
+    RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
+    if (!body)
+        return false;
+    if (m_forceUsesArguments)
+        body->setUsesArguments();
+    body->finishParsing(m_parameters, m_name);
+
+    JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
+
+    // The new code block is installed while it is generated so that the
+    // collector can find the cells it refers to; the baseline code block stays
+    // reachable as its alternative.
+    OwnPtr<FunctionCodeBlock> codeBlock = adoptPtr(new FunctionCodeBlock(this, FunctionCode, globalObject, source().provider(), source().startOffset(), false));
+    codeBlock->setAlternative(m_codeBlockForCall.release());
+    m_codeBlockForCall = codeBlock.release();
+    FunctionCodeBlock* optimizedCodeBlock = m_codeBlockForCall.get();
+    CodeBlock* baselineCodeBlock = optimizedCodeBlock->alternative();
+
+    OwnPtr<BytecodeGenerator> generator(adoptPtr(new BytecodeGenerator(body.get(), scopeChainNode, optimizedCodeBlock->symbolTable(), optimizedCodeBlock)));
+    exception = generator->generate();
+    body->destroyData();
+
+    DFG::Graph dfg;
+    if (exception || !hasSameBytecode(globalData->interpreter, optimizedCodeBlock, baselineCodeBlock) || !DFG::parse(dfg, globalData, optimizedCodeBlock, baselineCodeBlock)) {
+        m_codeBlockForCall = adoptPtr(static_cast<FunctionCodeBlock*>(optimizedCodeBlock->releaseAlternative().leakPtr()));
+        return false;
     }
+
+    DFG::JITCompiler dataFlowJIT(globalData, dfg, optimizedCodeBlock);
+    dataFlowJIT.compileFunction(m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+#if !ENABLE(OPCODE_SAMPLING)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        optimizedCodeBlock->discardBytecode();
 #endif
+    return true;
+}
 
-    return 0;
+void FunctionExecutable::jettisonOptimizedCodeForCall()
+{
+    ASSERT(m_codeBlockForCall && m_codeBlockForCall->alternative());
+
+    OwnPtr<FunctionCodeBlock> optimizedCodeBlock = m_codeBlockForCall.release();
+    m_codeBlockForCall = adoptPtr(static_cast<FunctionCodeBlock*>(optimizedCodeBlock->releaseAlternative().leakPtr()));
+    m_jitCodeForCall = m_codeBlockForCall->getJITCode();
+    m_jitCodeForCallWithArityCheck = m_codeBlockForCall->getJITCodeWithArityCheck();
+
+    // Frames may still be running the optimized code, and exit from it into
+    // the baseline code, so it lives for as long as the baseline code does.
+    m_codeBlockForCall->addJettisonedCodeBlock(optimizedCodeBlock.release());
 }
+#endif
 
 JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
 {
     JSObject* exception = 0;
     JSGlobalData* globalData = scopeChainNode->globalData;
+#if ENABLE(PARSER_STATS)
+    didCompile(globalData);
+#endif
+    BytecodeCache* bytecodeCache = m_source.provider()->bytecodeCache();
+    if (bytecodeCache && bytecodeCache->loadFunction(exec, scopeChainNode, this, true)) {
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+        if (exec->globalData().canUseJIT())
+            jitCompileForConstruct(*globalData);
+#endif
+        return 0;
+    }
+
     RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
     if (!body) {
         ASSERT(exception);
@@ -306,21 +450,33 @@ JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, Scope
     m_numCapturedVariables = m_codeBlockForConstruct->m_numCapturedVars;
     m_symbolTable = m_codeBlockForConstruct->sharedSymbolTable();
 
+    if (bytecodeCache)
+        bytecodeCache->addFunction(this, true);
     body->destroyData();
 
-#if ENABLE(JIT)
-    if (exec->globalData().canUseJIT()) {
-        m_jitCodeForConstruct = JIT::compile(scopeChainNode->globalData, m_codeBlockForConstruct.get(), &m_jitCodeForConstructWithArityCheck);
-#if !ENABLE(OPCODE_SAMPLING)
-        if (!BytecodeGenerator::dumpsGeneratedCode())
-            m_codeBlockForConstruct->discardBytecode();
-#endif
-    }
+#if ENABLE(JIT) && !ENABLE(TIERED_COMPILATION)
+    if (exec->globalData().canUseJIT())
+        jitCompileForConstruct(*globalData);
 #endif
 
     return 0;
 }
 
+#if ENABLE(JIT)
+void FunctionExecutable::jitCompileForConstruct(JSGlobalData& globalData)
+{
+    ASSERT(m_codeBlockForConstruct);
+    if (!!m_jitCodeForConstruct)
+        return;
+
+    m_jitCodeForConstruct = JIT::compile(&globalData, m_codeBlockForConstruct.get(), &m_jitCodeForConstructWithArityCheck);
+#if !ENABLE(OPCODE_SAMPLING) && !ENABLE(TIERED_COMPILATION)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        m_codeBlockForConstruct->discardBytecode();
+#endif
+}
+#endif
+
 void FunctionExecutable::markChildren(MarkStack& markStack)
 {
     ScriptExecutable::markChildren(markStack);
@@ -339,6 +495,8 @@ void FunctionExecutable::discardCode()
 #if ENABLE(JIT)
     m_jitCodeForCall = JITCode();
     m_jitCodeForConstruct = JITCode();
+    m_jitCodeForCallWithArityCheck = MacroAssemblerCodePtr();
+    m_jitCodeForConstructWithArityCheck = MacroAssemblerCodePtr();
 #endif
 }
 
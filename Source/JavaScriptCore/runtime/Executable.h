@@ -147,6 +147,7 @@ namespace JSC {
     };
 
     class ScriptExecutable : public ExecutableBase {
+        friend class BytecodeCache;
     public:
         ScriptExecutable(Structure* structure, JSGlobalData* globalData, const SourceCode& source, bool isInStrictContext)
             : ExecutableBase(*globalData, structure, NUM_PARAMETERS_NOT_COMPILED)
@@ -231,6 +232,11 @@ namespace JSC {
         {
             return generatedJITCodeForCall();
         }
+
+        // Compiles the bytecode with the baseline JIT, unless that has been
+        // done already. With tiered compilation, this waits until the code is
+        // warm; otherwise it happens as soon as the bytecode is generated.
+        void jitCompile(JSGlobalData&);
 #endif
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
 
@@ -246,6 +252,7 @@ namespace JSC {
     };
 
     class ProgramExecutable : public ScriptExecutable {
+        friend class BytecodeCache;
     public:
         static ProgramExecutable* create(ExecState* exec, const SourceCode& source)
         {
@@ -277,6 +284,8 @@ namespace JSC {
         {
             return generatedJITCodeForCall();
         }
+
+        void jitCompile(JSGlobalData&);
 #endif
         
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
@@ -293,6 +302,7 @@ namespace JSC {
     };
 
     class FunctionExecutable : public ScriptExecutable {
+        friend class BytecodeCache;
         friend class JIT;
     public:
         static FunctionExecutable* create(ExecState* exec, const Identifier& name, const SourceCode& source, bool forceUsesArguments, FunctionParameters* parameters, bool isInStrictContext, int firstLine, int lastLine)
@@ -342,6 +352,23 @@ namespace JSC {
             return *m_codeBlockForCall;
         }
 
+#if ENABLE(JIT)
+        // Compiles the bytecode for calls with the baseline JIT, unless that has
+        // been done already.
+        void jitCompileForCall(JSGlobalData&);
+#endif
+
+#if ENABLE(DFG_JIT)
+        // Replaces the baseline code for calls with code from the DFG JIT,
+        // which speculates on the types the baseline code has profiled.
+        // Returns false if the function could not be optimized.
+        bool compileOptimizedForCall(ExecState*, ScopeChainNode*);
+
+        // Goes back to the baseline code for calls, for when the optimized
+        // code's speculations keep failing.
+        void jettisonOptimizedCodeForCall();
+#endif
+
         JSObject* compileForConstruct(ExecState* exec, ScopeChainNode* scopeChainNode)
         {
             ASSERT(exec->globalData().dynamicGlobalObject);
@@ -363,6 +390,10 @@ namespace JSC {
             return *m_codeBlockForConstruct;
         }
 
+#if ENABLE(JIT)
+        void jitCompileForConstruct(JSGlobalData&);
+#endif
+
         const Identifier& name() { return m_name; }
         size_t parameterCount() const { return m_parameters->size(); }
         unsigned capturedVariableCount() const { return m_numCapturedVariables; }
@@ -380,11 +411,17 @@ namespace JSC {
 
         JSObject* compileForCallInternal(ExecState*, ScopeChainNode*);
         JSObject* compileForConstructInternal(ExecState*, ScopeChainNode*);
+#if ENABLE(PARSER_STATS)
+        void didCompile(JSGlobalData*);
+#endif
         
         static const unsigned StructureFlags = OverridesMarkChildren | ScriptExecutable::StructureFlags;
         static const ClassInfo s_info;
         unsigned m_numCapturedVariables : 31;
         bool m_forceUsesArguments : 1;
+#if ENABLE(PARSER_STATS)
+        bool m_hasBeenCompiled;
+#endif
 
         RefPtr<FunctionParameters> m_parameters;
         OwnPtr<FunctionCodeBlock> m_codeBlockForCall;
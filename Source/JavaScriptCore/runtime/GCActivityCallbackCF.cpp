@@ -46,23 +46,35 @@ namespace JSC {
 
 struct DefaultGCActivityCallbackPlatformData {
     static void trigger(CFRunLoopTimerRef, void *info);
+    static void sweep(CFRunLoopTimerRef, void *info);
 
     RetainPtr<CFRunLoopTimerRef> timer;
+    RetainPtr<CFRunLoopTimerRef> sweepTimer;
     RetainPtr<CFRunLoopRef> runLoop;
     CFRunLoopTimerContext context;
 };
 
 const CFTimeInterval decade = 60 * 60 * 24 * 365 * 10;
 const CFTimeInterval triggerInterval = 2; // seconds
+const CFTimeInterval sweepInterval = 0.1; // seconds
+const double sweepTimeSlice = 0.01; // seconds
 
 void DefaultGCActivityCallbackPlatformData::trigger(CFRunLoopTimerRef timer, void *info)
 {
     Heap* heap = static_cast<Heap*>(info);
     APIEntryShim shim(heap->globalData());
-    heap->collectAllGarbage();
+    heap->collect(Heap::DoNotSweep);
     CFRunLoopTimerSetNextFireDate(timer, CFAbsoluteTimeGetCurrent() + decade);
 }
 
+void DefaultGCActivityCallbackPlatformData::sweep(CFRunLoopTimerRef timer, void *info)
+{
+    Heap* heap = static_cast<Heap*>(info);
+    APIEntryShim shim(heap->globalData());
+    bool hasMoreWork = heap->sweepIncrementally(sweepTimeSlice);
+    CFRunLoopTimerSetNextFireDate(timer, CFAbsoluteTimeGetCurrent() + (hasMoreWork ? sweepInterval : decade));
+}
+
 DefaultGCActivityCallback::DefaultGCActivityCallback(Heap* heap)
 {
     commonConstructor(heap, CFRunLoopGetCurrent());
@@ -77,9 +89,12 @@ DefaultGCActivityCallback::~DefaultGCActivityCallback()
 {
     CFRunLoopRemoveTimer(d->runLoop.get(), d->timer.get(), kCFRunLoopCommonModes);
     CFRunLoopTimerInvalidate(d->timer.get());
+    CFRunLoopRemoveTimer(d->runLoop.get(), d->sweepTimer.get(), kCFRunLoopCommonModes);
+    CFRunLoopTimerInvalidate(d->sweepTimer.get());
     d->context.info = 0;
     d->runLoop = 0;
     d->timer = 0;
+    d->sweepTimer = 0;
 }
 
 void DefaultGCActivityCallback::commonConstructor(Heap* heap, CFRunLoopRef runLoop)
@@ -91,11 +106,17 @@ void DefaultGCActivityCallback::commonConstructor(Heap* heap, CFRunLoopRef runLo
     d->runLoop = runLoop;
     d->timer.adoptCF(CFRunLoopTimerCreate(0, decade, decade, 0, 0, DefaultGCActivityCallbackPlatformData::trigger, &d->context));
     CFRunLoopAddTimer(d->runLoop.get(), d->timer.get(), kCFRunLoopCommonModes);
+    d->sweepTimer.adoptCF(CFRunLoopTimerCreate(0, decade, decade, 0, 0, DefaultGCActivityCallbackPlatformData::sweep, &d->context));
+    CFRunLoopAddTimer(d->runLoop.get(), d->sweepTimer.get(), kCFRunLoopCommonModes);
 }
 
 void DefaultGCActivityCallback::operator()()
 {
-    CFRunLoopTimerSetNextFireDate(d->timer.get(), CFAbsoluteTimeGetCurrent() + triggerInterval);
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    CFRunLoopTimerSetNextFireDate(d->timer.get(), now + triggerInterval);
+    // Sweep whatever the collection that just finished left behind in small
+    // slices, until the next full collection.
+    CFRunLoopTimerSetNextFireDate(d->sweepTimer.get(), now + sweepInterval);
 }
 
 void DefaultGCActivityCallback::synchronize()
@@ -103,8 +124,10 @@ void DefaultGCActivityCallback::synchronize()
     if (CFRunLoopGetCurrent() == d->runLoop.get())
         return;
     CFRunLoopRemoveTimer(d->runLoop.get(), d->timer.get(), kCFRunLoopCommonModes);
+    CFRunLoopRemoveTimer(d->runLoop.get(), d->sweepTimer.get(), kCFRunLoopCommonModes);
     d->runLoop = CFRunLoopGetCurrent();
     CFRunLoopAddTimer(d->runLoop.get(), d->timer.get(), kCFRunLoopCommonModes);
+    CFRunLoopAddTimer(d->runLoop.get(), d->sweepTimer.get(), kCFRunLoopCommonModes);
 }
 
 }
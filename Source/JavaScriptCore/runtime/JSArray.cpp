@@ -138,14 +138,20 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure)
 
     unsigned initialCapacity = 0;
 
-    m_storage = static_cast<ArrayStorage*>(fastZeroedMalloc(storageSize(initialCapacity)));
+    m_storage = static_cast<ArrayStorage*>(Heap::heap(this)->allocateStorage(storageSize(initialCapacity)));
     m_storage->m_allocBase = m_storage;
+    m_storage->m_length = 0;
+    m_storage->m_numValuesInVector = 0;
+#if CHECK_ARRAY_CONSISTENCY
+    m_storage->m_inCompactInitialization = false;
+#endif
     m_indexBias = 0;
     m_vectorLength = initialCapacity;
+    m_sparseValueMap = 0;
+    m_subclassData = 0;
+    m_reportedMapCapacity = 0;
 
     checkConsistency();
-
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(0));
 }
 
 JSArray::JSArray(JSGlobalData& globalData, Structure* structure, unsigned initialLength, ArrayCreationMode creationMode)
@@ -159,14 +165,14 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, unsigned initia
     else
         initialCapacity = min(BASE_VECTOR_LEN, MIN_SPARSE_ARRAY_INDEX);
     
-    m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
+    m_storage = static_cast<ArrayStorage*>(Heap::heap(this)->allocateStorage(storageSize(initialCapacity)));
     m_storage->m_allocBase = m_storage;
     m_storage->m_length = initialLength;
     m_indexBias = 0;
     m_vectorLength = initialCapacity;
-    m_storage->m_sparseValueMap = 0;
-    m_storage->subclassData = 0;
-    m_storage->reportedMapCapacity = 0;
+    m_sparseValueMap = 0;
+    m_subclassData = 0;
+    m_reportedMapCapacity = 0;
 
     if (creationMode == CreateCompact) {
 #if CHECK_ARRAY_CONSISTENCY
@@ -186,8 +192,6 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, unsigned initia
     }
 
     checkConsistency();
-    
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(initialCapacity));
 }
 
 JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList& list)
@@ -205,15 +209,15 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
     else
         initialStorage = initialCapacity;
     
-    m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialStorage)));
+    m_storage = static_cast<ArrayStorage*>(Heap::heap(this)->allocateStorage(storageSize(initialStorage)));
     m_storage->m_allocBase = m_storage;
     m_indexBias = 0;
     m_storage->m_length = initialCapacity;
     m_vectorLength = initialStorage;
     m_storage->m_numValuesInVector = initialCapacity;
-    m_storage->m_sparseValueMap = 0;
-    m_storage->subclassData = 0;
-    m_storage->reportedMapCapacity = 0;
+    m_sparseValueMap = 0;
+    m_subclassData = 0;
+    m_reportedMapCapacity = 0;
 #if CHECK_ARRAY_CONSISTENCY
     m_storage->m_inCompactInitialization = false;
 #endif
@@ -227,17 +231,14 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
         vector[i].clear();
 
     checkConsistency();
-
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(initialStorage));
 }
 
 JSArray::~JSArray()
 {
     ASSERT(vptr() == JSGlobalData::jsArrayVPtr);
-    checkConsistency(DestructorConsistencyCheck);
-
-    delete m_storage->m_sparseValueMap;
-    fastFree(m_storage->m_allocBase);
+    // The storage is not checked, since an array that is swept lazily may be
+    // destroyed after the copying space has reused its storage.
+    delete m_sparseValueMap;
 }
 
 bool JSArray::getOwnPropertySlot(ExecState* exec, unsigned i, PropertySlot& slot)
@@ -256,7 +257,7 @@ bool JSArray::getOwnPropertySlot(ExecState* exec, unsigned i, PropertySlot& slot
             slot.setValue(value);
             return true;
         }
-    } else if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    } else if (SparseArrayValueMap* map = m_sparseValueMap) {
         if (i >= MIN_SPARSE_ARRAY_INDEX) {
             SparseArrayValueMap::iterator it = map->find(i);
             if (it != map->end()) {
@@ -304,7 +305,7 @@ bool JSArray::getOwnPropertyDescriptor(ExecState* exec, const Identifier& proper
                 descriptor.setDescriptor(value.get(), 0);
                 return true;
             }
-        } else if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+        } else if (SparseArrayValueMap* map = m_sparseValueMap) {
             if (i >= MIN_SPARSE_ARRAY_INDEX) {
                 SparseArrayValueMap::iterator it = map->find(i);
                 if (it != map->end()) {
@@ -372,7 +373,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
 {
     ArrayStorage* storage = m_storage;
     
-    SparseArrayValueMap* map = storage->m_sparseValueMap;
+    SparseArrayValueMap* map = m_sparseValueMap;
 
     if (i >= MIN_SPARSE_ARRAY_INDEX) {
         if (i > MAX_ARRAY_INDEX) {
@@ -386,7 +387,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         if ((i > MAX_STORAGE_VECTOR_INDEX) || !isDenseEnoughForVector(i + 1, storage->m_numValuesInVector + 1)) {
             if (!map) {
                 map = new SparseArrayValueMap;
-                storage->m_sparseValueMap = map;
+                m_sparseValueMap = map;
             }
 
             WriteBarrier<Unknown> temp;
@@ -396,9 +397,9 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
                 return;
 
             size_t capacity = map->capacity();
-            if (capacity != storage->reportedMapCapacity) {
-                Heap::heap(this)->reportExtraMemoryCost((capacity - storage->reportedMapCapacity) * (sizeof(unsigned) + sizeof(JSValue)));
-                storage->reportedMapCapacity = capacity;
+            if (capacity != m_reportedMapCapacity) {
+                Heap::heap(this)->reportExtraMemoryCost((capacity - m_reportedMapCapacity) * (sizeof(unsigned) + sizeof(JSValue)));
+                m_reportedMapCapacity = capacity;
             }
             return;
         }
@@ -439,13 +440,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         }
     }
 
-    void* baseStorage = storage->m_allocBase;
-    
-    if (!tryFastRealloc(baseStorage, storageSize(newVectorLength + m_indexBias)).getValue(baseStorage)) {
-        throwOutOfMemoryError(exec);
-        return;
-    }
-
+    void* baseStorage = Heap::heap(this)->reallocateStorage(storage->m_allocBase, storageSize(m_vectorLength + m_indexBias), storageSize(newVectorLength + m_indexBias));
     m_storage = reinterpret_cast_ptr<ArrayStorage*>(static_cast<char*>(baseStorage) + m_indexBias * sizeof(JSValue));
     m_storage->m_allocBase = baseStorage;
     storage = m_storage;
@@ -474,8 +469,6 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
     storage->m_vector[i].set(exec->globalData(), this, value);
 
     checkConsistency();
-
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
 }
 
 bool JSArray::deleteProperty(ExecState* exec, const Identifier& propertyName)
@@ -509,7 +502,7 @@ bool JSArray::deleteProperty(ExecState* exec, unsigned i)
         return true;
     }
 
-    if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    if (SparseArrayValueMap* map = m_sparseValueMap) {
         if (i >= MIN_SPARSE_ARRAY_INDEX) {
             SparseArrayValueMap::iterator it = map->find(i);
             if (it != map->end()) {
@@ -542,7 +535,7 @@ void JSArray::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNa
             propertyNames.add(Identifier::from(exec, i));
     }
 
-    if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    if (SparseArrayValueMap* map = m_sparseValueMap) {
         SparseArrayValueMap::iterator end = map->end();
         for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it)
             propertyNames.add(Identifier::from(exec, it->first));
@@ -592,10 +585,7 @@ bool JSArray::increaseVectorLength(unsigned newLength)
     ASSERT(newLength > vectorLength);
     ASSERT(newLength <= MAX_STORAGE_VECTOR_INDEX);
     unsigned newVectorLength = getNewVectorLength(newLength);
-    void* baseStorage = storage->m_allocBase;
-
-    if (!tryFastRealloc(baseStorage, storageSize(newVectorLength + m_indexBias)).getValue(baseStorage))
-        return false;
+    void* baseStorage = Heap::heap(this)->reallocateStorage(storage->m_allocBase, storageSize(vectorLength + m_indexBias), storageSize(newVectorLength + m_indexBias));
 
     storage = m_storage = reinterpret_cast_ptr<ArrayStorage*>(static_cast<char*>(baseStorage) + m_indexBias * sizeof(JSValue));
     m_storage->m_allocBase = baseStorage;
@@ -605,8 +595,6 @@ bool JSArray::increaseVectorLength(unsigned newLength)
         vector[i].clear();
 
     m_vectorLength = newVectorLength;
-    
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
 
     return true;
 }
@@ -623,9 +611,7 @@ bool JSArray::increaseVectorPrefixLength(unsigned newLength)
     ASSERT(newLength <= MAX_STORAGE_VECTOR_INDEX);
     unsigned newVectorLength = getNewVectorLength(newLength);
 
-    void* newBaseStorage = fastMalloc(storageSize(newVectorLength + m_indexBias));
-    if (!newBaseStorage)
-        return false;
+    void* newBaseStorage = Heap::heap(this)->allocateStorage(storageSize(newVectorLength + m_indexBias));
     
     m_indexBias += newVectorLength - newLength;
     
@@ -637,10 +623,6 @@ bool JSArray::increaseVectorPrefixLength(unsigned newLength)
     m_storage->m_allocBase = newBaseStorage;
     m_vectorLength = newLength;
     
-    fastFree(storage->m_allocBase);
-
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
-    
     return true;
 }
     
@@ -667,7 +649,7 @@ void JSArray::setLength(unsigned newLength)
             storage->m_numValuesInVector -= hadValue;
         }
 
-        if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+        if (SparseArrayValueMap* map = m_sparseValueMap) {
             SparseArrayValueMap copy = *map;
             SparseArrayValueMap::iterator end = copy.end();
             for (SparseArrayValueMap::iterator it = copy.begin(); it != end; ++it) {
@@ -676,7 +658,7 @@ void JSArray::setLength(unsigned newLength)
             }
             if (map->isEmpty()) {
                 delete map;
-                storage->m_sparseValueMap = 0;
+                m_sparseValueMap = 0;
             }
         }
     }
@@ -710,14 +692,14 @@ JSValue JSArray::pop()
             result = jsUndefined();
     } else {
         result = jsUndefined();
-        if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+        if (SparseArrayValueMap* map = m_sparseValueMap) {
             SparseArrayValueMap::iterator it = map->find(length);
             if (it != map->end()) {
                 result = it->second.get();
                 map->remove(it);
                 if (map->isEmpty()) {
                     delete map;
-                    storage->m_sparseValueMap = 0;
+                    m_sparseValueMap = 0;
                 }
             }
         }
@@ -745,7 +727,7 @@ void JSArray::push(ExecState* exec, JSValue value)
     }
 
     if (storage->m_length < MIN_SPARSE_ARRAY_INDEX) {
-        SparseArrayValueMap* map = storage->m_sparseValueMap;
+        SparseArrayValueMap* map = m_sparseValueMap;
         if (!map || map->isEmpty()) {
             if (increaseVectorLength(storage->m_length + 1)) {
                 storage = m_storage;
@@ -881,7 +863,7 @@ void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType cal
     ArrayStorage* storage = m_storage;
 
     unsigned lengthNotIncludingUndefined = compactForSorting();
-    if (storage->m_sparseValueMap) {
+    if (m_sparseValueMap) {
         throwOutOfMemoryError(exec);
         return;
     }
@@ -914,7 +896,7 @@ void JSArray::sort(ExecState* exec)
     ArrayStorage* storage = m_storage;
 
     unsigned lengthNotIncludingUndefined = compactForSorting();
-    if (storage->m_sparseValueMap) {
+    if (m_sparseValueMap) {
         throwOutOfMemoryError(exec);
         return;
     }
@@ -1072,7 +1054,7 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
         return;
 
     unsigned usedVectorLength = min(storage->m_length, m_vectorLength);
-    unsigned nodeCount = usedVectorLength + (storage->m_sparseValueMap ? storage->m_sparseValueMap->size() : 0);
+    unsigned nodeCount = usedVectorLength + (m_sparseValueMap ? m_sparseValueMap->size() : 0);
 
     if (!nodeCount)
         return;
@@ -1122,7 +1104,7 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
 
     unsigned newUsedVectorLength = numDefined + numUndefined;
 
-    if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    if (SparseArrayValueMap* map = m_sparseValueMap) {
         newUsedVectorLength += map->size();
         if (newUsedVectorLength > m_vectorLength) {
             // Check that it is possible to allocate an array large enough to hold all the entries.
@@ -1142,7 +1124,7 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
         }
 
         delete map;
-        storage->m_sparseValueMap = 0;
+        m_sparseValueMap = 0;
     }
 
     ASSERT(tree.abstractor().m_nodes.size() >= numDefined);
@@ -1237,7 +1219,7 @@ unsigned JSArray::compactForSorting()
 
     unsigned newUsedVectorLength = numDefined + numUndefined;
 
-    if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    if (SparseArrayValueMap* map = m_sparseValueMap) {
         newUsedVectorLength += map->size();
         if (newUsedVectorLength > m_vectorLength) {
             // Check that it is possible to allocate an array large enough to hold all the entries - if not,
@@ -1253,7 +1235,7 @@ unsigned JSArray::compactForSorting()
             storage->m_vector[numDefined++].setWithoutWriteBarrier(it->second.get());
 
         delete map;
-        storage->m_sparseValueMap = 0;
+        m_sparseValueMap = 0;
     }
 
     for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
@@ -1270,12 +1252,12 @@ unsigned JSArray::compactForSorting()
 
 void* JSArray::subclassData() const
 {
-    return m_storage->subclassData;
+    return m_subclassData;
 }
 
 void JSArray::setSubclassData(void* d)
 {
-    m_storage->subclassData = d;
+    m_subclassData = d;
 }
 
 #if CHECK_ARRAY_CONSISTENCY
@@ -1286,14 +1268,13 @@ void JSArray::checkConsistency(ConsistencyCheckType type)
 
     ASSERT(storage);
     if (type == SortConsistencyCheck)
-        ASSERT(!storage->m_sparseValueMap);
+        ASSERT(!m_sparseValueMap);
 
     unsigned numValuesInVector = 0;
     for (unsigned i = 0; i < m_vectorLength; ++i) {
         if (JSValue value = storage->m_vector[i]) {
             ASSERT(i < storage->m_length);
-            if (type != DestructorConsistencyCheck)
-                value.isUndefined(); // Likely to crash if the object was deallocated.
+            value.isUndefined(); // Likely to crash if the object was deallocated.
             ++numValuesInVector;
         } else {
             if (type == SortConsistencyCheck)
@@ -1303,16 +1284,15 @@ void JSArray::checkConsistency(ConsistencyCheckType type)
     ASSERT(numValuesInVector == storage->m_numValuesInVector);
     ASSERT(numValuesInVector <= storage->m_length);
 
-    if (storage->m_sparseValueMap) {
-        SparseArrayValueMap::iterator end = storage->m_sparseValueMap->end();
-        for (SparseArrayValueMap::iterator it = storage->m_sparseValueMap->begin(); it != end; ++it) {
+    if (m_sparseValueMap) {
+        SparseArrayValueMap::iterator end = m_sparseValueMap->end();
+        for (SparseArrayValueMap::iterator it = m_sparseValueMap->begin(); it != end; ++it) {
             unsigned index = it->first;
             ASSERT(index < storage->m_length);
             ASSERT(index >= storage->m_vectorLength);
             ASSERT(index <= MAX_ARRAY_INDEX);
             ASSERT(it->second);
-            if (type != DestructorConsistencyCheck)
-                it->second.isUndefined(); // Likely to crash if the object was deallocated.
+            it->second.isUndefined(); // Likely to crash if the object was deallocated.
         }
     }
 }
@@ -34,13 +34,12 @@ namespace JSC {
     // setStorage() methods.  It is important to note that there may be space before the ArrayStorage that 
     // is used to quick unshift / shift operation.  The actual allocated pointer is available by using:
     //     getStorage() - m_indexBias * sizeof(JSValue)
+    // The storage comes from Heap::allocateStorage() and may be moved by the collector, so anything that
+    // has to outlive the array's storage, like the sparse value map, is kept in the JSArray itself.
     struct ArrayStorage {
         unsigned m_length; // The "length" property on the array
         unsigned m_numValuesInVector;
-        SparseArrayValueMap* m_sparseValueMap;
-        void* subclassData; // A JSArray subclass can use this to fill the vector lazily.
-        void* m_allocBase; // Pointer to base address returned by malloc().  Keeping this pointer does eliminate false positives from the leak detector.
-        size_t reportedMapCapacity;
+        void* m_allocBase; // Pointer to base address returned by Heap::allocateStorage().
 #if CHECK_ARRAY_CONSISTENCY
         bool m_inCompactInitialization;
 #endif
@@ -161,12 +160,17 @@ namespace JSC {
         
         unsigned compactForSorting();
 
-        enum ConsistencyCheckType { NormalConsistencyCheck, DestructorConsistencyCheck, SortConsistencyCheck };
+        enum ConsistencyCheckType { NormalConsistencyCheck, SortConsistencyCheck };
         void checkConsistency(ConsistencyCheckType = NormalConsistencyCheck);
 
+        size_t storageBytes() const { return m_indexBias * sizeof(JSValue) + OBJECT_OFFSETOF(ArrayStorage, m_vector) + m_vectorLength * sizeof(JSValue); }
+
         unsigned m_vectorLength; // The valid length of m_vector
         int m_indexBias; // The number of JSValue sized blocks before ArrayStorage.
         ArrayStorage *m_storage;
+        SparseArrayValueMap* m_sparseValueMap;
+        void* m_subclassData; // A JSArray subclass can use this to fill the vector lazily.
+        size_t m_reportedMapCapacity;
     };
 
     JSArray* asArray(JSValue);
@@ -190,11 +194,16 @@ namespace JSC {
         JSObject::markChildrenDirect(markStack);
         
         ArrayStorage* storage = m_storage;
+        void* baseStorage = markStack.copyStorage(storage->m_allocBase, storageBytes());
+        if (baseStorage != storage->m_allocBase) {
+            storage = m_storage = reinterpret_cast_ptr<ArrayStorage*>(static_cast<char*>(baseStorage) + m_indexBias * sizeof(JSValue));
+            storage->m_allocBase = baseStorage;
+        }
 
         unsigned usedVectorLength = std::min(storage->m_length, m_vectorLength);
         markStack.appendValues(storage->m_vector, usedVectorLength, MayContainNullValues);
 
-        if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+        if (SparseArrayValueMap* map = m_sparseValueMap) {
             SparseArrayValueMap::iterator end = map->end();
             for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it)
                 markStack.append(&it->second);
@@ -120,7 +120,7 @@ void JSGlobalData::storeVPtrs()
 {
     // Enough storage to fit a JSArray, JSByteArray, JSString, or JSFunction.
     // COMPILE_ASSERTS below check that this is true.
-    char storage[64];
+    char storage[128];
 
     COMPILE_ASSERT(sizeof(JSArray) <= sizeof(storage), sizeof_JSArray_must_be_less_than_storage);
     JSCell* jsArray = new (storage) JSArray(JSArray::VPtrStealingHack);
@@ -419,9 +419,9 @@ void JSGlobalData::dumpRegExpTrace()
     
     if (iter != m_rtTraceList->end()) {
         printf("\nRegExp Tracing\n");
-        printf("                                                            match()    matches\n");
-        printf("Regular Expression                          JIT Address      calls      found\n");
-        printf("----------------------------------------+----------------+----------+----------\n");
+        printf("                                                            match()    matches   fallback\n");
+        printf("Regular Expression                          JIT Address      calls      found      calls\n");
+        printf("----------------------------------------+----------------+----------+----------+----------\n");
     
         unsigned reCount = 0;
     
@@ -133,6 +133,9 @@ namespace JSC {
         void makeUsableFromMultipleThreads() { heap.machineThreads().makeUsableFromMultipleThreads(); }
 #endif
 
+        // Replaces the policy that decides how far the heap grows between collections.
+        void setHeapSizingPolicy(PassOwnPtr<HeapSizingPolicy> policy) { heap.setSizingPolicy(policy); }
+
         GlobalDataType globalDataType;
         ClientData* clientData;
 
@@ -439,8 +439,10 @@ DynamicGlobalObjectScope::DynamicGlobalObjectScope(JSGlobalData& globalData, JSG
 {
     if (!m_dynamicGlobalObjectSlot) {
 #if ENABLE(ASSEMBLER)
-        if (ExecutableAllocator::underMemoryPressure())
+        if (ExecutableAllocator::underMemoryPressure()) {
             globalData.recompileAllJSFunctions();
+            ExecutableAllocator::trim();
+        }
 #endif
 
         m_dynamicGlobalObjectSlot = dynamicGlobalObject;
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "JSONObject.h"
 
+#include "ArrayPrototype.h"
 #include "BooleanObject.h"
 #include "Error.h"
 #include "ExceptionHelpers.h"
@@ -35,10 +36,12 @@
 #include "Local.h"
 #include "LocalScope.h"
 #include "Lookup.h"
+#include "ObjectPrototype.h"
 #include "PropertyNameArray.h"
 #include "UStringBuilder.h"
 #include "UStringConcatenate.h"
 #include <wtf/MathExtras.h>
+#include <wtf/SIMDHelpers.h>
 
 namespace JSC {
 
@@ -102,12 +105,18 @@ private:
     friend class Holder;
 
     static void appendQuotedString(UStringBuilder&, const UString&);
+    static void appendQuotedString(UStringBuilder&, const UChar*, unsigned length);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
 
     enum StringifyResult { StringifyFailed, StringifySucceeded, StringifyFailedDueToUndefinedValue };
     StringifyResult appendStringifiedValue(UStringBuilder&, JSValue, JSObject* holder, const PropertyNameForFunctionCall&);
 
+    bool appendFastPath(UStringBuilder&, JSObject*);
+    bool appendFastObject(UStringBuilder&, JSObject*, unsigned depth);
+    bool appendFastValue(UStringBuilder&, JSValue, unsigned depth);
+    bool isFastPathStructure(Structure*);
+
     bool willIndent() const;
     void indent();
     void unindent();
@@ -124,6 +133,10 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+    Structure* m_lastFastPathStructure;
+    // The size of the holder stack when the fast path last gave up on an object.
+    // Nothing inside that object is tried on the fast path again.
+    unsigned m_fastPathDisabledDepth;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -204,6 +217,8 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     , m_arrayReplacerPropertyNames(exec)
     , m_replacerCallType(CallTypeNone)
     , m_gap(gap(exec, space.get()))
+    , m_lastFastPathStructure(0)
+    , m_fastPathDisabledDepth(std::numeric_limits<unsigned>::max())
 {
     if (!m_replacer.isObject())
         return;
@@ -262,21 +277,51 @@ Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
     return Local<Unknown>(m_exec->globalData(), jsString(m_exec, result.toUString()));
 }
 
+static ALWAYS_INLINE bool needsEscaping(UChar character)
+{
+    return character < 0x20 || character == '"' || character == '\\';
+}
+
+// Returns the first character in [position, end) that has to be escaped, or end.
+// Most strings have long runs that need no escaping, which are checked eight
+// UChars at a time.
+static ALWAYS_INLINE const UChar* skipUnescapedCharacters(const UChar* position, const UChar* end)
+{
+#if USE(UCHAR_VECTORS)
+    const UCharVector quote = splatVector('"');
+    const UCharVector backslash = splatVector('\\');
+    const UCharVector space = splatVector(' ');
+    while (static_cast<size_t>(end - position) >= ucharVectorLength) {
+        UCharVector characters = loadVector(position);
+        UCharVector quoteOrBackslash = orVector(equalVector(characters, quote), equalVector(characters, backslash));
+        if (anyLaneSet(orVector(lessThanVector(characters, space), quoteOrBackslash)))
+            break;
+        position += ucharVectorLength;
+    }
+#endif
+    while (position < end && !needsEscaping(*position))
+        ++position;
+    return position;
+}
+
 void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& value)
 {
-    int length = value.length();
+    appendQuotedString(builder, value.characters(), value.length());
+}
 
+void Stringifier::appendQuotedString(UStringBuilder& builder, const UChar* data, unsigned length)
+{
     builder.append('"');
 
-    const UChar* data = value.characters();
-    for (int i = 0; i < length; ++i) {
-        int start = i;
-        while (i < length && (data[i] > 0x1F && data[i] != '"' && data[i] != '\\'))
-            ++i;
-        builder.append(data + start, i - start);
-        if (i >= length)
+    const UChar* end = data + length;
+    const UChar* position = data;
+    while (true) {
+        const UChar* runStart = position;
+        position = skipUnescapedCharacters(position, end);
+        builder.append(runStart, position - runStart);
+        if (position == end)
             break;
-        switch (data[i]) {
+        switch (*position) {
             case '\t':
                 builder.append('\\');
                 builder.append('t');
@@ -307,11 +352,12 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
                 break;
             default:
                 static const char hexDigits[] = "0123456789abcdef";
-                UChar ch = data[i];
+                UChar ch = *position;
                 UChar hex[] = { '\\', 'u', hexDigits[(ch >> 12) & 0xF], hexDigits[(ch >> 8) & 0xF], hexDigits[(ch >> 4) & 0xF], hexDigits[ch & 0xF] };
                 builder.append(hex, WTF_ARRAY_LENGTH(hex));
                 break;
         }
+        ++position;
     }
 
     builder.append('"');
@@ -404,6 +450,16 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         return StringifyFailedDueToUndefinedValue;
     }
 
+    if (m_replacerCallType == CallTypeNone && !m_usingArrayReplacer && m_holderStack.size() <= m_fastPathDisabledDepth) {
+        unsigned rollBackPoint = builder.length();
+        UString indent = m_indent;
+        if (appendFastPath(builder, object))
+            return StringifySucceeded;
+        builder.resize(rollBackPoint);
+        m_indent = indent;
+        m_fastPathDisabledDepth = m_holderStack.size();
+    }
+
     // Handle cycle detection, and put the holder on the stack.
     for (unsigned i = 0; i < m_holderStack.size(); i++) {
         if (m_holderStack[i].object() == object) {
@@ -433,6 +489,8 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
             }
         }
         m_holderStack.removeLast();
+        if (m_holderStack.size() == m_fastPathDisabledDepth)
+            m_fastPathDisabledDepth = std::numeric_limits<unsigned>::max();
     } while (!m_holderStack.isEmpty());
     return StringifySucceeded;
 }
@@ -466,6 +524,169 @@ inline void Stringifier::startNewLine(UStringBuilder& builder) const
     builder.append(m_indent);
 }
 
+// Plain objects and dense arrays are serialized without going through the holder
+// stack and the generic property lookups. Without a replacer, only toJSON functions
+// and getters could run JavaScript, and the fast path gives up on any object that
+// could have either, as well as on anything that is not a primitive, a plain object
+// or a dense array. Cycles are left to the generic path too, which the fast path
+// falls back to when it recurses too deeply. The caller then rolls back what the
+// fast path appended, and serializes the whole object with the generic path, so
+// that deep structures are not walked again from each level below it.
+static const unsigned maximumFastPathDepth = 32;
+
+static inline void appendInt32(UStringBuilder& builder, int32_t value)
+{
+    char buffer[12];
+    char* end = buffer + sizeof(buffer);
+    char* start = end;
+    unsigned magnitude = value < 0 ? -static_cast<unsigned>(value) : value;
+    do {
+        *--start = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0)
+        *--start = '-';
+    builder.append(start, end - start);
+}
+
+bool Stringifier::appendFastPath(UStringBuilder& builder, JSObject* object)
+{
+    // A toJSON function that ran since the last time could have put toJSON on a
+    // prototype. The array prototype inherits from the object prototype.
+    if (m_exec->lexicalGlobalObject()->arrayPrototype()->hasProperty(m_exec, m_exec->globalData().propertyNames->toJSON))
+        return false;
+    m_lastFastPathStructure = 0;
+    return appendFastObject(builder, object, 0);
+}
+
+// Objects with the same non-dictionary Structure have the same prototype and
+// properties, so homogeneous arrays of records only check the first record.
+bool Stringifier::isFastPathStructure(Structure* structure)
+{
+    if (structure == m_lastFastPathStructure)
+        return true;
+
+    JSGlobalObject* globalObject = m_exec->lexicalGlobalObject();
+    if (structure->typeInfo().isFinal()) {
+        if (structure->storedPrototype() != JSValue(globalObject->objectPrototype()))
+            return false;
+    } else if (structure->classInfo() == &JSArray::s_info) {
+        if (structure->storedPrototype() != JSValue(globalObject->arrayPrototype()))
+            return false;
+    } else
+        return false;
+
+    JSGlobalData& globalData = m_exec->globalData();
+    if (structure->hasGetterSetterProperties() || structure->get(globalData, globalData.propertyNames->toJSON) != WTF::notFound)
+        return false;
+
+    if (!structure->isDictionary())
+        m_lastFastPathStructure = structure;
+    return true;
+}
+
+bool Stringifier::appendFastObject(UStringBuilder& builder, JSObject* object, unsigned depth)
+{
+    if (depth >= maximumFastPathDepth)
+        return false;
+
+    Structure* structure = object->structure();
+    if (!isFastPathStructure(structure))
+        return false;
+
+    if (!structure->typeInfo().isFinal()) {
+        JSArray* array = asArray(object);
+        unsigned length = array->length();
+        builder.append('[');
+        indent();
+        for (unsigned i = 0; i < length; ++i) {
+            // Holes, sparse elements and the elements of arrays that fill themselves
+            // in lazily are left to the generic path.
+            if (!array->canGetIndex(i))
+                return false;
+            if (i)
+                builder.append(',');
+            startNewLine(builder);
+            JSValue value = array->getIndex(i);
+            if (value.isUndefined())
+                builder.append("null", 4);
+            else if (!appendFastValue(builder, value, depth + 1))
+                return false;
+        }
+        unindent();
+        if (length)
+            startNewLine(builder);
+        builder.append(']');
+        return true;
+    }
+
+    builder.append('{');
+    indent();
+    bool appendedProperty = false;
+    if (const PropertyTable* propertyTable = structure->propertyTable(m_exec->globalData())) {
+        PropertyTable::const_iterator end = propertyTable->end();
+        for (PropertyTable::const_iterator iter = propertyTable->begin(); iter != end; ++iter) {
+            if (iter->attributes & DontEnum)
+                continue;
+            JSValue value = object->getDirectOffset(iter->offset);
+            if (value.isUndefined())
+                continue;
+            if (appendedProperty)
+                builder.append(',');
+            startNewLine(builder);
+            appendQuotedString(builder, iter->key->characters(), iter->key->length());
+            builder.append(':');
+            if (willIndent())
+                builder.append(' ');
+            if (!appendFastValue(builder, value, depth + 1))
+                return false;
+            appendedProperty = true;
+        }
+    }
+    unindent();
+    if (appendedProperty)
+        startNewLine(builder);
+    builder.append('}');
+    return true;
+}
+
+bool Stringifier::appendFastValue(UStringBuilder& builder, JSValue value, unsigned depth)
+{
+    if (value.isInt32()) {
+        appendInt32(builder, value.asInt32());
+        return true;
+    }
+    if (value.isNumber()) {
+        double number = value.uncheckedGetNumber();
+        if (!isfinite(number))
+            builder.append("null", 4);
+        else
+            builder.append(UString::number(number));
+        return true;
+    }
+    if (value.isString()) {
+        const UString& string = asString(value)->value(m_exec);
+        if (m_exec->hadException())
+            return false;
+        appendQuotedString(builder, string);
+        return true;
+    }
+    if (value.isObject())
+        return appendFastObject(builder, asObject(value), depth);
+    if (value.isNull()) {
+        builder.append("null", 4);
+        return true;
+    }
+    if (value.isBoolean()) {
+        if (value.isTrue())
+            builder.append("true", 4);
+        else
+            builder.append("false", 5);
+        return true;
+    }
+    return false;
+}
+
 inline Stringifier::Holder::Holder(JSGlobalData& globalData, JSObject* object)
     : m_object(globalData, object)
     , m_isArray(object->inherits(&JSArray::s_info))
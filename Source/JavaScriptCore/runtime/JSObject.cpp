@@ -584,13 +584,13 @@ void JSObject::allocatePropertyStorage(size_t oldSize, size_t newSize)
     bool wasInline = (oldSize < JSObject::baseExternalStorageCapacity);
 
     PropertyStorage oldPropertyStorage = m_propertyStorage;
-    PropertyStorage newPropertyStorage = new WriteBarrierBase<Unknown>[newSize];
-
-    for (unsigned i = 0; i < oldSize; ++i)
-       newPropertyStorage[i] = oldPropertyStorage[i];
-
-    if (!wasInline)
-        delete [] oldPropertyStorage;
+    PropertyStorage newPropertyStorage;
+    if (wasInline) {
+        newPropertyStorage = static_cast<PropertyStorage>(Heap::heap(this)->allocateStorage(newSize * sizeof(WriteBarrierBase<Unknown>)));
+        for (unsigned i = 0; i < oldSize; ++i)
+            newPropertyStorage[i] = oldPropertyStorage[i];
+    } else
+        newPropertyStorage = static_cast<PropertyStorage>(Heap::heap(this)->reallocateStorage(oldPropertyStorage, oldSize * sizeof(WriteBarrierBase<Unknown>), newSize * sizeof(WriteBarrierBase<Unknown>)));
 
     m_propertyStorage = newPropertyStorage;
 }
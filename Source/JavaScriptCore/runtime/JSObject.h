@@ -416,8 +416,6 @@ inline JSObject::JSObject(JSGlobalData& globalData, Structure* structure, Proper
 
 inline JSObject::~JSObject()
 {
-    if (!isUsingInlineStorage())
-        delete [] m_propertyStorage;
 }
 
 inline JSValue JSObject::prototype() const
@@ -824,6 +822,9 @@ ALWAYS_INLINE void JSObject::markChildrenDirect(MarkStack& markStack)
 {
     JSCell::markChildren(markStack);
 
+    if (!isUsingInlineStorage())
+        m_propertyStorage = static_cast<PropertyStorage>(markStack.copyStorage(m_propertyStorage, m_structure->propertyStorageCapacity() * sizeof(WriteBarrierBase<Unknown>)));
+
     PropertyStorage storage = propertyStorage();
     size_t storageSize = m_structure->propertyStorageSize();
     markStack.appendValues(storage, storageSize);
@@ -33,6 +33,8 @@
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
+static const unsigned fiberFromRopeCutoff = 16;
+static const unsigned maxCopiedSubstringFromRopeLength = 32;
 
 // Overview: this methods converts a JSString from holding a string in rope form
 // down to a simple UString representation.  It does so by building up the string
@@ -108,6 +110,71 @@ void JSString::resolveRope(ExecState* exec) const
     }
 }
     
+// Finds the flat fiber that holds the characters [index, index + length) of
+// the rope by walking down through its fibers, which is much quicker than
+// flattening the rope when they are near one of its ends and it was built by
+// concatenation: appending leaves the last characters in the top level fibers,
+// and prepending leaves the first ones there. Each level is searched from the
+// end nearer to the index. Returns 0 if the characters span fibers or if
+// finding them takes more than a few steps, since then the caller is better
+// off flattening the rope once.
+StringImpl* JSString::fiberFromRope(unsigned index, unsigned length, unsigned& fiberStart) const
+{
+    ASSERT(isRope());
+    ASSERT(length);
+    ASSERT(index + length <= m_length);
+
+    RopeImpl::Fiber* fibers = m_other.m_fibers.data();
+    unsigned fiberCount = m_fiberCount;
+    unsigned start = 0;
+    unsigned end = m_length;
+    unsigned steps = 0;
+    while (true) {
+        RopeImpl::Fiber fiber;
+        if (index - start < (end - start) / 2) {
+            unsigned i = 0;
+            while (true) {
+                if (++steps > fiberFromRopeCutoff)
+                    return 0;
+                ASSERT(i < fiberCount);
+                unsigned fiberLength = fibers[i]->length();
+                if (index - start < fiberLength) {
+                    end = start + fiberLength;
+                    break;
+                }
+                start += fiberLength;
+                ++i;
+            }
+            fiber = fibers[i];
+        } else {
+            unsigned i = fiberCount - 1;
+            while (true) {
+                if (++steps > fiberFromRopeCutoff)
+                    return 0;
+                unsigned fiberLength = fibers[i]->length();
+                if (end - index <= fiberLength) {
+                    start = end - fiberLength;
+                    break;
+                }
+                end -= fiberLength;
+                ASSERT(i);
+                --i;
+            }
+            fiber = fibers[i];
+        }
+
+        if (index + length > end)
+            return 0;
+        if (!RopeImpl::isRope(fiber)) {
+            fiberStart = start;
+            return static_cast<StringImpl*>(fiber);
+        }
+        RopeImpl* rope = static_cast<RopeImpl*>(fiber);
+        fibers = rope->fibers();
+        fiberCount = rope->fiberCount();
+    }
+}
+
 // This function construsts a substring out of a rope without flattening by reusing the existing fibers.
 // This can reduce memory usage substantially. Since traversing ropes is slow the function will revert 
 // back to flattening if the rope turns out to be long.
@@ -118,6 +185,27 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
     
     JSGlobalData* globalData = &exec->globalData();
 
+    unsigned fiberStart;
+    if (StringImpl* fiberString = fiberFromRope(substringStart, substringLength, fiberStart))
+        return jsSubstring(globalData, UString(fiberString), substringStart - fiberStart, substringLength);
+
+    // A short substring that spans fibers is copied out of them one fiber at a time.
+    if (substringLength <= maxCopiedSubstringFromRopeLength) {
+        UChar characters[maxCopiedSubstringFromRopeLength];
+        unsigned substringEnd = substringStart + substringLength;
+        unsigned position = substringStart;
+        while (position < substringEnd) {
+            StringImpl* fiberString = fiberFromRope(position, 1, fiberStart);
+            if (!fiberString)
+                break;
+            unsigned count = std::min(substringEnd, fiberStart + fiberString->length()) - position;
+            StringImpl::copyChars(characters + position - substringStart, fiberString->characters() + position - fiberStart, count);
+            position += count;
+        }
+        if (position == substringEnd)
+            return jsString(globalData, UString(characters, substringLength));
+    }
+
     UString substringFibers[3];
     
     unsigned fiberCount = 0;
@@ -138,7 +226,7 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
         if (copyStart == fiberStart && copyEnd == fiberEnd)
             substringFibers[substringFiberCount++] = UString(fiberString);
         else
-            substringFibers[substringFiberCount++] = UString(StringImpl::create(fiberString, copyStart - fiberStart, copyEnd - copyStart));
+            substringFibers[substringFiberCount++] = UString(createSubstringImpl(fiberString, copyStart - fiberStart, copyEnd - copyStart));
         if (fiberEnd >= substringEnd)
             break;
         if (fiberCount > substringFromRopeCutoff || substringFiberCount >= 3) {
@@ -217,6 +305,9 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    unsigned fiberStart;
+    if (StringImpl* fiberString = fiberFromRope(i, 1, fiberStart))
+        return jsSingleCharacterSubstring(exec, UString(fiberString), i - fiberStart);
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
@@ -226,6 +317,19 @@ JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
     return jsSingleCharacterSubstring(exec, m_value, i);
 }
 
+UChar JSString::characterAtSlowCase(ExecState* exec, unsigned i)
+{
+    ASSERT(isRope());
+    unsigned fiberStart;
+    if (StringImpl* fiberString = fiberFromRope(i, 1, fiberStart))
+        return fiberString->characters()[i - fiberStart];
+    resolveRope(exec);
+    if (exec->exception())
+        return 0;
+    ASSERT(i < m_value.length());
+    return m_value.characters()[i];
+}
+
 JSValue JSString::toPrimitive(ExecState*, PreferredPrimitiveType) const
 {
     return const_cast<JSString*>(this);
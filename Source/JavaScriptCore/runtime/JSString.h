@@ -346,6 +346,8 @@ namespace JSC {
         bool canGetIndex(unsigned i) { return i < m_length; }
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
+        UChar characterAt(ExecState*, unsigned);
+        UChar characterAtSlowCase(ExecState*, unsigned);
 
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
@@ -359,6 +361,7 @@ namespace JSC {
         }
 
         void resolveRope(ExecState*) const;
+        StringImpl* fiberFromRope(unsigned index, unsigned length, unsigned& fiberStart) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
 
         void appendStringInConstruct(unsigned& index, const UString& string)
@@ -444,6 +447,22 @@ namespace JSC {
 
     JSString* asString(JSValue);
 
+    // Substrings share the buffer of the string that they are taken from, except
+    // when they are a small part of it. A short substring that outlives a long
+    // string, like a word taken from a document, would otherwise keep the whole
+    // buffer alive, so it gets a copy of its characters instead. The substring of a
+    // substring shares the buffer of the original string, so that is the length it
+    // is compared with.
+    static const unsigned maxSubstringSharingRatio = 8;
+
+    inline PassRefPtr<StringImpl> createSubstringImpl(StringImpl* string, unsigned offset, unsigned length)
+    {
+        ASSERT(offset + length <= string->length());
+        if (length < string->bufferOwnerLength() / maxSubstringSharingRatio)
+            return StringImpl::create(string->characters() + offset, length);
+        return StringImpl::create(string, offset, length);
+    }
+
     // When an object is created from a different DLL, MSVC changes vptr to a "local" one right after invoking a constructor,
     // see <http://groups.google.com/group/microsoft.public.vc.language/msg/55cdcefeaf770212>.
     // This breaks isJSString(), and we don't need that hack anyway, so we change vptr back to primary one.
@@ -479,7 +498,7 @@ namespace JSC {
         UChar c = s.characters()[offset];
         if (c <= maxSingleCharacterString)
             return globalData->smallStrings.singleCharacterString(globalData, c);
-        return fixupVPtr(globalData, new (globalData) JSString(globalData, UString(StringImpl::create(s.impl(), offset, 1))));
+        return fixupVPtr(globalData, new (globalData) JSString(globalData, UString(createSubstringImpl(s.impl(), offset, 1))));
     }
 
     inline JSString* jsNontrivialString(JSGlobalData* globalData, const char* s)
@@ -505,6 +524,14 @@ namespace JSC {
         return jsSingleCharacterSubstring(exec, m_value, i);
     }
 
+    inline UChar JSString::characterAt(ExecState* exec, unsigned i)
+    {
+        ASSERT(canGetIndex(i));
+        if (isRope())
+            return characterAtSlowCase(exec, i);
+        return m_value.characters()[i];
+    }
+
     inline JSString* jsString(JSGlobalData* globalData, const UString& s)
     {
         int size = s.length();
@@ -550,7 +577,7 @@ namespace JSC {
             if (c <= maxSingleCharacterString)
                 return globalData->smallStrings.singleCharacterString(globalData, c);
         }
-        return fixupVPtr(globalData, new (globalData) JSString(globalData, UString(StringImpl::create(s.impl(), offset, length)), JSString::HasOtherOwner));
+        return fixupVPtr(globalData, new (globalData) JSString(globalData, UString(createSubstringImpl(s.impl(), offset, length)), JSString::HasOtherOwner));
     }
 
     inline JSString* jsOwnedString(JSGlobalData* globalData, const UString& s)
@@ -141,8 +141,21 @@ template <LiteralParser::ParserMode mode> static inline bool isSafeStringCharact
 template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType LiteralParser::Lexer::lexString(LiteralParserToken& token)
 {
     ++m_ptr;
-    const UChar* runStart;
+    const UChar* runStart = m_ptr;
+    while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
+        ++m_ptr;
+    // Most strings have no escapes, and are used straight from the source.
+    if (m_ptr < m_end && *m_ptr == '"') {
+        token.stringBuffer = UString();
+        token.stringStart = runStart;
+        token.stringLength = m_ptr - runStart;
+        token.type = TokString;
+        token.end = ++m_ptr;
+        return TokString;
+    }
+
     UStringBuilder builder;
+    builder.append(runStart, m_ptr - runStart);
     do {
         runStart = m_ptr;
         while (m_ptr < m_end && isSafeStringCharacter<mode>(*m_ptr))
@@ -207,7 +220,9 @@ template <LiteralParser::ParserMode mode> inline LiteralParser::TokenType Litera
     if (m_ptr >= m_end || *m_ptr != '"')
         return TokError;
 
-    token.stringToken = builder.toUString();
+    token.stringBuffer = builder.toUString();
+    token.stringStart = token.stringBuffer.characters();
+    token.stringLength = token.stringBuffer.length();
     token.type = TokString;
     token.end = ++m_ptr;
     return TokString;
@@ -231,6 +246,7 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
 
     if (m_ptr < m_end && *m_ptr == '-') // -?
         ++m_ptr;
+    const UChar* integerStart = m_ptr;
     
     // (0 | [1-9][0-9]*)
     if (m_ptr < m_end && *m_ptr == '0') // 0
@@ -243,6 +259,18 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     } else
         return TokError;
 
+    // Most numbers are small integers, which are converted without strtod.
+    static const int maximumFastIntegerLength = 9;
+    if (m_ptr - integerStart <= maximumFastIntegerLength && (m_ptr >= m_end || (*m_ptr != '.' && *m_ptr != 'e' && *m_ptr != 'E'))) {
+        int integer = 0;
+        for (const UChar* digit = integerStart; digit < m_ptr; ++digit)
+            integer = integer * 10 + (*digit - '0');
+        token.type = TokNumber;
+        token.end = m_ptr;
+        token.numberToken = integerStart == token.start ? integer : -static_cast<double>(integer);
+        return TokNumber;
+    }
+
     // ('.' [0-9]+)?
     if (m_ptr < m_end && *m_ptr == '.') {
         ++m_ptr;
@@ -287,13 +315,58 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+JSObject* LiteralParser::constructObject(Vector<Identifier, 16>& propertyNames, MarkedArgumentBuffer& propertyValues, size_t propertyCount)
+{
+    JSGlobalData& globalData = m_exec->globalData();
+    size_t namesStart = propertyNames.size() - propertyCount;
+    size_t valuesStart = propertyValues.size() - propertyCount;
+
+    unsigned cacheIndex = (PtrHash<StringImpl*>::hash(propertyNames[namesStart].impl()) + propertyCount) % cachedObjectStructureCount;
+    CachedObjectStructure& cached = m_cachedObjectStructures[cacheIndex];
+    bool useCachedStructure = cached.structure && cached.propertyNames.size() == propertyCount;
+    for (size_t i = 0; useCachedStructure && i < propertyCount; ++i)
+        useCachedStructure = cached.propertyNames[i] == propertyNames[namesStart + i];
+
+    JSObject* object = constructEmptyObject(m_exec);
+    if (useCachedStructure) {
+        object->transitionTo(globalData, cached.structure);
+        for (size_t i = 0; i < propertyCount; ++i)
+            object->putDirectOffset(globalData, cached.offsets[i], propertyValues.at(valuesStart + i));
+    } else {
+        for (size_t i = 0; i < propertyCount; ++i)
+            object->putDirect(globalData, propertyNames[namesStart + i], propertyValues.at(valuesStart + i));
+
+        // Objects with repeated names, or too many properties for a Structure
+        // to be shared, are not cached.
+        Structure* structure = object->structure();
+        if (!structure->isDictionary() && structure->propertyStorageSize() == propertyCount) {
+            cached.structure = structure;
+            cached.propertyNames.clear();
+            cached.offsets.clear();
+            for (size_t i = 0; i < propertyCount; ++i) {
+                cached.propertyNames.append(propertyNames[namesStart + i]);
+                cached.offsets.append(structure->get(globalData, propertyNames[namesStart + i]));
+            }
+        }
+    }
+
+    propertyNames.shrink(namesStart);
+    for (size_t i = 0; i < propertyCount; ++i)
+        propertyValues.removeLast();
+    return object;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
     MarkedArgumentBuffer objectStack;
     JSValue lastValue;
     Vector<ParserState, 16> stateStack;
+    // The names and values of the properties of the objects being parsed,
+    // and the number of names before those of each object.
     Vector<Identifier, 16> identifierStack;
+    MarkedArgumentBuffer propertyValueStack;
+    Vector<size_t, 16> objectStartStack;
     while (1) {
         switch(state) {
             startParseArray:
@@ -333,9 +406,6 @@ JSValue LiteralParser::parse(ParserState initialState)
             }
             startParseObject:
             case StartParseObject: {
-                JSObject* object = constructEmptyObject(m_exec);
-                objectStack.append(object);
-
                 TokenType type = m_lexer.next();
                 if (type == TokString) {
                     Lexer::LiteralParserToken identifierToken = m_lexer.currentToken();
@@ -345,14 +415,14 @@ JSValue LiteralParser::parse(ParserState initialState)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                    objectStartStack.append(identifierStack.size());
+                    identifierStack.append(Identifier(m_exec, identifierToken.stringStart, identifierToken.stringLength));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
                     return JSValue();
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = constructEmptyObject(m_exec);
                 break;
             }
             doParseObjectStartExpression:
@@ -367,21 +437,20 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                identifierStack.append(Identifier(m_exec, identifierToken.stringStart, identifierToken.stringLength));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
             case DoParseObjectEndExpression:
             {
-                asObject(objectStack.last())->putDirect(m_exec->globalData(), identifierStack.last(), lastValue);
-                identifierStack.removeLast();
+                propertyValueStack.append(lastValue);
                 if (m_lexer.currentToken().type == TokComma)
                     goto doParseObjectStartExpression;
                 if (m_lexer.currentToken().type != TokRBrace)
                     return JSValue();
                 m_lexer.next();
-                lastValue = objectStack.last();
-                objectStack.removeLast();
+                lastValue = constructObject(identifierStack, propertyValueStack, identifierStack.size() - objectStartStack.last());
+                objectStartStack.removeLast();
                 break;
             }
             startParseExpression:
@@ -394,7 +463,10 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokString: {
                         Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
                         m_lexer.next();
-                        lastValue = jsString(m_exec, stringToken.stringToken);
+                        if (!stringToken.stringBuffer.isNull())
+                            lastValue = jsString(m_exec, stringToken.stringBuffer);
+                        else
+                            lastValue = jsString(m_exec, UString(stringToken.stringStart, stringToken.stringLength));
                         break;
                     }
                     case TokNumber: {
@@ -26,12 +26,16 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
 #include "UString.h"
 
 namespace JSC {
 
+    class MarkedArgumentBuffer;
+    class Structure;
+
     class LiteralParser {
     public:
         typedef enum { StrictJSON, NonStrictJSON } ParserMode;
@@ -66,7 +70,11 @@ namespace JSC {
                 TokenType type;
                 const UChar* start;
                 const UChar* end;
-                UString stringToken;
+                // The characters of a string token are in the source, unless
+                // it had escapes, in which case they are in stringBuffer.
+                UString stringBuffer;
+                const UChar* stringStart;
+                unsigned stringLength;
                 double numberToken;
             };
             Lexer(const UString& s, ParserMode mode)
@@ -98,12 +106,28 @@ namespace JSC {
             const UChar* m_end;
         };
         
+        // The Structure that the last object with a given list of property
+        // names ended up with. The next object with the same names is given
+        // it at once, and its property storage filled in directly, instead
+        // of looking up a transition for each property. Objects are only
+        // made once all their properties have been parsed.
+        struct CachedObjectStructure {
+            CachedObjectStructure() : structure(0) { }
+
+            Structure* structure;
+            Vector<Identifier, 8> propertyNames;
+            Vector<size_t, 8> offsets;
+        };
+        static const unsigned cachedObjectStructureCount = 16;
+
         class StackGuard;
         JSValue parse(ParserState);
+        JSObject* constructObject(Vector<Identifier, 16>& propertyNames, MarkedArgumentBuffer& propertyValues, size_t propertyCount);
 
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
         ParserMode m_mode;
+        CachedObjectStructure m_cachedObjectStructures[cachedObjectStructureCount];
     };
 }
 
@@ -29,6 +29,7 @@
 #include "ExecutableAllocator.h"
 #include "JSGlobalData.h"
 #include "RegisterFile.h"
+#include <stdio.h>
 
 namespace JSC {
 
@@ -37,7 +38,7 @@ GlobalMemoryStatistics globalMemoryStatistics()
     GlobalMemoryStatistics stats;
 
     stats.stackBytes = RegisterFile::committedByteCount();
-#if ENABLE(EXECUTABLE_ALLOCATOR_FIXED)
+#if ENABLE(JIT) && ENABLE(ASSEMBLER)
     stats.JITBytes = ExecutableAllocator::committedByteCount();
 #else
     stats.JITBytes = 0;
@@ -45,6 +46,46 @@ GlobalMemoryStatistics globalMemoryStatistics()
     return stats;
 }
 
+void dumpHeapStatistics(Heap& heap)
+{
+    Vector<SizeClassStatistics> sizeClasses;
+    heap.markedSpace().sizeClassStatistics(sizeClasses);
+
+    printf("%8s %8s %10s %10s %12s %10s\n", "Cell", "Blocks", "Live", "Free", "Allocated", "Survival");
+
+    SizeClassStatistics total = { };
+    for (size_t i = 0; i < sizeClasses.size(); ++i) {
+        const SizeClassStatistics& statistics = sizeClasses[i];
+        if (!statistics.blockCount && !statistics.cellsBeforeLastCollection)
+            continue;
+        printf("%8lu %8lu %10lu %10lu %12lu %9.1f%%\n",
+            static_cast<unsigned long>(statistics.cellSize), static_cast<unsigned long>(statistics.blockCount),
+            static_cast<unsigned long>(statistics.liveCells), static_cast<unsigned long>(statistics.freeCells),
+            static_cast<unsigned long>(statistics.bytesAllocatedSinceLastCollection), statistics.survivalRate() * 100);
+
+        total.blockCount += statistics.blockCount;
+        total.liveCells += statistics.liveCells;
+        total.freeCells += statistics.freeCells;
+        total.bytesAllocatedSinceLastCollection += statistics.bytesAllocatedSinceLastCollection;
+        total.cellsBeforeLastCollection += statistics.cellsBeforeLastCollection;
+        total.cellsAfterLastCollection += statistics.cellsAfterLastCollection;
+    }
+
+    printf("%8s %8lu %10lu %10lu %12lu %9.1f%%\n", "Total",
+        static_cast<unsigned long>(total.blockCount), static_cast<unsigned long>(total.liveCells),
+        static_cast<unsigned long>(total.freeCells), static_cast<unsigned long>(total.bytesAllocatedSinceLastCollection),
+        total.survivalRate() * 100);
+
+    CopiedSpace& copiedSpace = heap.copiedSpace();
+    printf("Copied storage: %lu bytes used, %lu bytes of blocks\n",
+        static_cast<unsigned long>(copiedSpace.size()), static_cast<unsigned long>(copiedSpace.capacity()));
+
+    LargeObjectSpace& largeObjectSpace = heap.largeObjectSpace();
+    printf("Large objects: %lu, %lu bytes marked, %lu bytes of pages\n",
+        static_cast<unsigned long>(largeObjectSpace.objectCount()), static_cast<unsigned long>(largeObjectSpace.size()),
+        static_cast<unsigned long>(largeObjectSpace.capacity()));
+}
+
 }
 
 
@@ -28,8 +28,6 @@
 
 #include "Heap.h"
 
-class JSGlobalData;
-
 namespace JSC {
 
 struct GlobalMemoryStatistics {
@@ -39,6 +37,10 @@ struct GlobalMemoryStatistics {
 
 GlobalMemoryStatistics globalMemoryStatistics();
 
+// Prints a table of live and free cells, blocks, recent allocation and
+// survival rate for each of the heap's size classes.
+void dumpHeapStatistics(Heap&);
+
 }
 
 #endif // MemoryStatistics_h
@@ -85,6 +85,10 @@ struct PropertyMapEntry {
     }
 };
 
+// Tables with room for up to MaximumCompactCapacity keys are compact: they have no
+// hash index, and find keys by scanning an array of them that is kept after the
+// values, which is smaller and touches less memory than hashing into an index.
+// Larger tables hash into an index of entries in the table of values.
 class PropertyTable {
     WTF_MAKE_FAST_ALLOCATED;
 
@@ -138,7 +142,8 @@ public:
 
     // The find_iterator is a pair of a pointer to a Value* an the entry in the index.
     // If 'find' does not find an entry then iter.first will be 0, and iter.second will
-    // give the point in m_index where an entry should be inserted.
+    // give the point in m_index where an entry should be inserted. In a compact table,
+    // iter.second is the position of the key in compactKeys().
     typedef std::pair<ValueType*, unsigned> find_iterator;
 
     // Constructor is passed an initial capacity, a PropertyTable to copy, or both.
@@ -192,7 +197,10 @@ private:
     // Rehash the table.  Used to grow, or to recover deleted slots.
     void rehash(unsigned newCapacity);
 
-    // The capacity of the table of values is half of the size of the index.
+    bool isCompact() const;
+
+    // The capacity of the table of values is half of the size of the index, or
+    // is held in m_indexMask in a compact table.
     unsigned tableCapacity() const;
 
     // We keep an extra deleted slot after the array to make iteration work,
@@ -212,6 +220,11 @@ private:
     ValueType* table();
     const ValueType* table() const;
 
+    // In a compact table, the keys of the values lie after the table of values,
+    // with deleted keys in the same places as in the table.
+    StringImpl** compactKeys();
+    find_iterator findInCompactTable(const KeyType&);
+
     // total number of  used entries in the values array - by either valid entries, or deleted ones.
     unsigned usedCount() const;
 
@@ -221,28 +234,35 @@ private:
     // Calculates the appropriate table size (rounds up to a power of two).
     static unsigned sizeForCapacity(unsigned capacity);
 
+    // The size of the index and the index mask for a table that can hold capacity keys.
+    // A compact table has no index, and its index mask holds the capacity of its table.
+    static unsigned indexSizeForCapacity(unsigned capacity);
+    static unsigned indexMaskForCapacity(unsigned capacity);
+
     // Check if capacity is available.
     bool canInsert();
 
-    unsigned m_indexSize;
-    unsigned m_indexMask;
-    unsigned* m_index;
+    unsigned m_indexSize; // Zero in a compact table.
+    unsigned m_indexMask; // The capacity of the table of values in a compact table.
+    unsigned* m_index; // In a compact table, there is no index, so this points at the table of values.
     unsigned m_keyCount;
     unsigned m_deletedCount;
     OwnPtr< Vector<unsigned> > m_deletedOffsets;
 
     static const unsigned MinimumTableSize = 16;
+    static const unsigned MinimumCompactCapacity = 2;
+    static const unsigned MaximumCompactCapacity = 4;
     static const unsigned EmptyEntryIndex = 0;
 };
 
 inline PropertyTable::PropertyTable(unsigned initialCapacity)
-    : m_indexSize(sizeForCapacity(initialCapacity))
-    , m_indexMask(m_indexSize - 1)
+    : m_indexSize(indexSizeForCapacity(initialCapacity))
+    , m_indexMask(indexMaskForCapacity(initialCapacity))
     , m_index(static_cast<unsigned*>(fastZeroedMalloc(dataSize())))
     , m_keyCount(0)
     , m_deletedCount(0)
 {
-    ASSERT(isPowerOf2(m_indexSize));
+    ASSERT(isCompact() || isPowerOf2(m_indexSize));
 }
 
 inline PropertyTable::PropertyTable(JSGlobalData& globalData, JSCell* owner, const PropertyTable& other)
@@ -252,7 +272,7 @@ inline PropertyTable::PropertyTable(JSGlobalData& globalData, JSCell* owner, con
     , m_keyCount(other.m_keyCount)
     , m_deletedCount(other.m_deletedCount)
 {
-    ASSERT(isPowerOf2(m_indexSize));
+    ASSERT(isCompact() || isPowerOf2(m_indexSize));
 
     memcpy(m_index, other.m_index, dataSize());
 
@@ -269,13 +289,13 @@ inline PropertyTable::PropertyTable(JSGlobalData& globalData, JSCell* owner, con
 }
 
 inline PropertyTable::PropertyTable(JSGlobalData& globalData, JSCell* owner, unsigned initialCapacity, const PropertyTable& other)
-    : m_indexSize(sizeForCapacity(initialCapacity))
-    , m_indexMask(m_indexSize - 1)
+    : m_indexSize(indexSizeForCapacity(initialCapacity))
+    , m_indexMask(indexMaskForCapacity(initialCapacity))
     , m_index(static_cast<unsigned*>(fastZeroedMalloc(dataSize())))
     , m_keyCount(0)
     , m_deletedCount(0)
 {
-    ASSERT(isPowerOf2(m_indexSize));
+    ASSERT(isCompact() || isPowerOf2(m_indexSize));
     ASSERT(initialCapacity >= other.m_keyCount);
 
     const_iterator end = other.end();
@@ -321,16 +341,37 @@ inline PropertyTable::const_iterator PropertyTable::end() const
     return const_iterator(table() + usedCount());
 }
 
+NEVER_INLINE inline PropertyTable::find_iterator PropertyTable::findInCompactTable(const KeyType& key)
+{
+    // Kept out of line so that find(), which is inlined into every property lookup,
+    // stays small. Scan all of the keys rather than stopping at a match, so that the
+    // number of iterations only depends on the table, and the loop is easy to predict.
+    StringImpl** keys = compactKeys();
+    unsigned usedCount = this->usedCount();
+    unsigned position = usedCount;
+    for (unsigned i = 0; i < usedCount; ++i) {
+        if (keys[i] == key)
+            position = i;
+    }
+    if (position == usedCount)
+        return std::make_pair((ValueType*)0, usedCount);
+    return std::make_pair(&table()[position], position);
+}
+
 inline PropertyTable::find_iterator PropertyTable::find(const KeyType& key)
 {
     ASSERT(key);
-    unsigned hash = key->existingHash();
-    unsigned step = 0;
 
 #if DUMP_PROPERTYMAP_STATS
     ++numProbes;
 #endif
 
+    if (isCompact())
+        return findInCompactTable(key);
+
+    unsigned hash = key->existingHash();
+    unsigned step = 0;
+
     while (true) {
         unsigned entryIndex = m_index[hash & m_indexMask];
         if (entryIndex == EmptyEntryIndex)
@@ -371,7 +412,10 @@ inline std::pair<PropertyTable::find_iterator, bool> PropertyTable::add(const Va
 
     // Allocate a slot in the hashtable, and set the index to reference this.
     unsigned entryIndex = usedCount() + 1;
-    m_index[iter.second] = entryIndex;
+    if (isCompact())
+        compactKeys()[iter.second] = entry.key;
+    else
+        m_index[iter.second] = entryIndex;
     iter.first = &table()[entryIndex - 1];
     *iter.first = entry;
 
@@ -391,7 +435,10 @@ inline void PropertyTable::remove(const find_iterator& iter)
 
     // Replace this one element with the deleted sentinel. Also clear out
     // the entry so we can iterate all the entries as needed.
-    m_index[iter.second] = deletedEntryIndex();
+    if (isCompact())
+        compactKeys()[iter.second] = PROPERTY_MAP_DELETED_ENTRY_KEY;
+    else
+        m_index[iter.second] = deletedEntryIndex();
     iter.first->key->deref();
     iter.first->key = PROPERTY_MAP_DELETED_ENTRY_KEY;
 
@@ -399,7 +446,7 @@ inline void PropertyTable::remove(const find_iterator& iter)
     --m_keyCount;
     ++m_deletedCount;
 
-    if (m_deletedCount * 4 >= m_indexSize)
+    if (m_deletedCount * 2 >= tableCapacity())
         rehash(m_keyCount);
 }
 
@@ -454,7 +501,7 @@ inline PassOwnPtr<PropertyTable> PropertyTable::copy(JSGlobalData& globalData, J
 
     // Fast case; if the new table will be the same m_indexSize as this one, we can memcpy it,
     // save rehashing all keys.
-    if (sizeForCapacity(newCapacity) == m_indexSize)
+    if (indexSizeForCapacity(newCapacity) == m_indexSize && indexMaskForCapacity(newCapacity) == m_indexMask)
         return new PropertyTable(globalData, owner, *this);
     return new PropertyTable(globalData, owner, newCapacity, *this);
 }
@@ -474,11 +521,14 @@ inline void PropertyTable::reinsert(const ValueType& entry)
     // Used to insert a value known not to be in the table, and where
     // we know capacity to be available.
     ASSERT(canInsert());
-    find_iterator iter = find(entry.key);
-    ASSERT(!iter.first);
-
     unsigned entryIndex = usedCount() + 1;
-    m_index[iter.second] = entryIndex;
+    if (isCompact())
+        compactKeys()[entryIndex - 1] = entry.key;
+    else {
+        find_iterator iter = find(entry.key);
+        ASSERT(!iter.first);
+        m_index[iter.second] = entryIndex;
+    }
     table()[entryIndex - 1] = entry;
 
     ++m_keyCount;
@@ -490,8 +540,8 @@ inline void PropertyTable::rehash(unsigned newCapacity)
     iterator iter = this->begin();
     iterator end = this->end();
 
-    m_indexSize = sizeForCapacity(newCapacity);
-    m_indexMask = m_indexSize - 1;
+    m_indexSize = indexSizeForCapacity(newCapacity);
+    m_indexMask = indexMaskForCapacity(newCapacity);
     m_keyCount = 0;
     m_deletedCount = 0;
     m_index = static_cast<unsigned*>(fastZeroedMalloc(dataSize()));
@@ -504,7 +554,9 @@ inline void PropertyTable::rehash(unsigned newCapacity)
     fastFree(oldEntryIndices);
 }
 
-inline unsigned PropertyTable::tableCapacity() const { return m_indexSize >> 1; }
+inline bool PropertyTable::isCompact() const { return !m_indexSize; }
+
+inline unsigned PropertyTable::tableCapacity() const { return isCompact() ? m_indexMask : m_indexSize >> 1; }
 
 inline unsigned PropertyTable::deletedEntryIndex() const { return tableCapacity() + 1; }
 
@@ -528,6 +580,13 @@ inline const PropertyTable::ValueType* PropertyTable::table() const
     return reinterpret_cast<const ValueType*>(m_index + m_indexSize);
 }
 
+inline StringImpl** PropertyTable::compactKeys()
+{
+    ASSERT(isCompact());
+    // The keys lie after the table of values, and the extra deleted slot after it.
+    return reinterpret_cast<StringImpl**>(reinterpret_cast<ValueType*>(m_index) + m_indexMask + 1);
+}
+
 inline unsigned PropertyTable::usedCount() const
 {
     // Total number of  used entries in the values array - by either valid entries, or deleted ones.
@@ -537,7 +596,8 @@ inline unsigned PropertyTable::usedCount() const
 inline size_t PropertyTable::dataSize()
 {
     // The size in bytes of data needed for by the table.
-    return m_indexSize * sizeof(unsigned) + ((tableCapacity()) + 1) * sizeof(ValueType);
+    size_t keysSize = isCompact() ? tableCapacity() * sizeof(StringImpl*) : 0;
+    return m_indexSize * sizeof(unsigned) + ((tableCapacity()) + 1) * sizeof(ValueType) + keysSize;
 }
 
 inline unsigned PropertyTable::sizeForCapacity(unsigned capacity)
@@ -547,6 +607,18 @@ inline unsigned PropertyTable::sizeForCapacity(unsigned capacity)
     return nextPowerOf2(capacity + 1) * 2;
 }
 
+inline unsigned PropertyTable::indexSizeForCapacity(unsigned capacity)
+{
+    return capacity > MaximumCompactCapacity ? sizeForCapacity(capacity) : 0;
+}
+
+inline unsigned PropertyTable::indexMaskForCapacity(unsigned capacity)
+{
+    if (capacity > MaximumCompactCapacity)
+        return sizeForCapacity(capacity) - 1;
+    return capacity > MinimumCompactCapacity ? nextPowerOf2(capacity) : MinimumCompactCapacity;
+}
+
 inline bool PropertyTable::canInsert()
 {
     return usedCount() < tableCapacity();
@@ -71,16 +71,55 @@ struct RegExpRepresentation {
     Yarr::YarrCodeBlock m_regExpJITCode;
 #endif
     OwnPtr<Yarr::BytecodePattern> m_regExpBytecode;
+
+    Vector<UChar> m_literalPrefix;
+    bool m_containsRequiredCharacter;
+    UChar m_requiredCharacter;
 };
 
+// Moves startOffset to the first place where a match could start: the next occurrence
+// of the pattern's literal prefix. Returns false if there is none, or if the character
+// that every match contains after the prefix does not occur after it. The characters
+// are found with StringImpl::find, which compares several at a time.
+static inline bool skipToMatchCandidate(const RegExpRepresentation& representation, StringImpl* string, int& startOffset)
+{
+    const UChar* characters = string->characters();
+    unsigned length = string->length();
+    size_t position = startOffset;
+
+    if (size_t prefixLength = representation.m_literalPrefix.size()) {
+        if (length - position < prefixLength)
+            return false;
+
+        const UChar* prefix = representation.m_literalPrefix.data();
+        size_t lastCandidate = length - prefixLength;
+        while (true) {
+            position = string->find(prefix[0], position);
+            if (position == notFound || position > lastCandidate)
+                return false;
+            if (!memcmp(characters + position + 1, prefix + 1, (prefixLength - 1) * sizeof(UChar)))
+                break;
+            ++position;
+        }
+        startOffset = position;
+        position += prefixLength;
+    }
+
+    if (representation.m_containsRequiredCharacter)
+        return string->find(representation.m_requiredCharacter, position) != notFound;
+    return true;
+}
+
 inline RegExp::RegExp(JSGlobalData* globalData, const UString& patternString, RegExpFlags flags)
     : m_patternString(patternString)
     , m_flags(flags)
     , m_constructionError(0)
     , m_numSubpatterns(0)
+    , m_recentlyUsed(false)
 #if ENABLE(REGEXP_TRACING)
     , m_rtMatchCallCount(0)
     , m_rtMatchFoundCount(0)
+    , m_rtFallBackMatchCallCount(0)
 #endif
     , m_representation(adoptPtr(new RegExpRepresentation))
 {
@@ -107,11 +146,17 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
         return ParseError;
 
     m_numSubpatterns = pattern.m_numSubpatterns;
+    if (pattern.m_isLiteral)
+        m_literal = UString(pattern.m_literalPrefix.data(), pattern.m_literalPrefix.size());
+
+    m_representation->m_literalPrefix = pattern.m_literalPrefix;
+    m_representation->m_containsRequiredCharacter = pattern.m_containsRequiredCharacter;
+    m_representation->m_requiredCharacter = pattern.m_requiredCharacter;
 
     RegExpState res = ByteCode;
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && globalData->canUseJIT()) {
+    if (globalData->canUseJIT()) {
         Yarr::jitCompile(pattern, globalData, m_representation->m_regExpJITCode);
 #if ENABLE(YARR_JIT_DEBUG)
         if (!m_representation->m_regExpJITCode.isFallBack())
@@ -130,11 +175,37 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
     return res;
 }
 
-int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
+size_t RegExp::compiledSize() const
+{
+    size_t size = 0;
+#if ENABLE(YARR_JIT)
+    size += m_representation->m_regExpJITCode.size();
+#endif
+    if (m_representation->m_regExpBytecode)
+        size += m_representation->m_regExpBytecode->sizeInBytes();
+    return size;
+}
+
+void RegExp::invalidateCode()
+{
+    if (m_state == ParseError)
+        return;
+
+#if ENABLE(YARR_JIT)
+    m_representation->m_regExpJITCode.clear();
+#endif
+    m_representation->m_regExpBytecode.clear();
+    m_state = NotCompiled;
+}
+
+int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, Vector<int, 32>* ovector)
 {
     if (startOffset < 0)
         startOffset = 0;
 
+    m_recentlyUsed = true;
+    compileIfNecessary(globalData);
+
 #if ENABLE(REGEXP_TRACING)
     m_rtMatchCallCount++;
 #endif
@@ -161,6 +232,9 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
         for (unsigned j = 0, i = 0; i < m_numSubpatterns + 1; j += 2, i++)            
             offsetVector[j] = -1;
 
+        if (!skipToMatchCandidate(*m_representation, s.impl(), startOffset))
+            return -1;
+
         int result;
 #if ENABLE(YARR_JIT)
         if (m_state == JITCode) {
@@ -169,8 +243,13 @@ int RegExp::match(const UString& s, int startOffset, Vector<int, 32>* ovector)
             matchCompareWithInterpreter(s, startOffset, offsetVector, result);
 #endif
         } else
+#endif
+        {
+#if ENABLE(REGEXP_TRACING)
+            m_rtFallBackMatchCallCount++;
 #endif
             result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s.characters(), startOffset, s.length(), offsetVector);
+        }
         ASSERT(result >= -1);
 
 #if ENABLE(REGEXP_TRACING)
@@ -254,7 +333,7 @@ void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int*
 
         const size_t jitAddrSize = 20;
         char jitAddr[jitAddrSize];
-        if (m_state == JITCode)
+        if (m_state != JITCode)
             snprintf(jitAddr, jitAddrSize, "fallback");
         else
             snprintf(jitAddr, jitAddrSize, "0x%014lx", reinterpret_cast<unsigned long int>(codeBlock.getAddr()));
@@ -262,7 +341,7 @@ void RegExp::matchCompareWithInterpreter(const UString& s, int startOffset, int*
         const char* jitAddr = "JIT Off";
 #endif
 
-        printf("%-40.40s %16.16s %10d %10d\n", formattedPattern, jitAddr, m_rtMatchCallCount, m_rtMatchFoundCount);
+        printf("%-40.40s %16.16s %10d %10d %10d\n", formattedPattern, jitAddr, m_rtMatchCallCount, m_rtMatchFoundCount, m_rtFallBackMatchCallCount);
     }
 #endif
     
@@ -46,11 +46,24 @@ namespace JSC {
 
         const UString& pattern() const { return m_patternString; }
 
+        // The only string that the pattern matches, or a null string if it can match more than one.
+        const UString& literal() const { return m_literal; }
+
         bool isValid() const { return !m_constructionError && m_flags != InvalidFlags; }
         const char* errorMessage() const { return m_constructionError; }
 
-        int match(const UString&, int startOffset, Vector<int, 32>* ovector = 0);
+        int match(JSGlobalData&, const UString&, int startOffset, Vector<int, 32>* ovector = 0);
         unsigned numSubpatterns() const { return m_numSubpatterns; }
+
+        // The memory held by the compiled code and bytecode of the pattern.
+        size_t compiledSize() const;
+
+        // Releases the compiled code and bytecode. The pattern is compiled again the next time it is matched.
+        void invalidateCode();
+
+        // Set by each match, and cleared by the RegExpCache when it looks for RegExps to evict.
+        bool recentlyUsed() const { return m_recentlyUsed; }
+        void setRecentlyUsed(bool recentlyUsed) { m_recentlyUsed = recentlyUsed; }
         
 #if ENABLE(REGEXP_TRACING)
         void printTraceData();
@@ -62,22 +75,31 @@ namespace JSC {
         enum RegExpState {
             ParseError,
             JITCode,
-            ByteCode
+            ByteCode,
+            NotCompiled
         } m_state;
 
         RegExpState compile(JSGlobalData*);
+        void compileIfNecessary(JSGlobalData& globalData)
+        {
+            if (m_state == NotCompiled)
+                m_state = compile(&globalData);
+        }
 
 #if ENABLE(YARR_JIT_DEBUG)
         void matchCompareWithInterpreter(const UString&, int startOffset, int* offsetVector, int jitResult);
 #endif
 
         UString m_patternString;
+        UString m_literal;
         RegExpFlags m_flags;
         const char* m_constructionError;
         unsigned m_numSubpatterns;
+        bool m_recentlyUsed;
 #if ENABLE(REGEXP_TRACING)
         unsigned m_rtMatchCallCount;
         unsigned m_rtMatchFoundCount;
+        unsigned m_rtFallBackMatchCallCount;
 #endif
 
         OwnPtr<RegExpRepresentation> m_representation;
@@ -31,47 +31,87 @@
 
 namespace JSC {
 
-PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags flags)
+RegExpCache::RegExpCache(JSGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_byteBudget(defaultByteBudget)
 {
-    if (patternString.length() < maxCacheablePatternLength) {
-        pair<RegExpCacheMap::iterator, bool> result = m_cacheMap.add(RegExpKey(flags, patternString), 0);
-        if (!result.second)
-            return result.first->second;
-        else
-            return create(patternString, flags, result.first);
-    }
-    return create(patternString, flags, m_cacheMap.end());
 }
 
-PassRefPtr<RegExp> RegExpCache::create(const UString& patternString, RegExpFlags flags, RegExpCacheMap::iterator iterator) 
+RegExpCache::~RegExpCache()
 {
+    deleteAllValues(m_cacheMap);
+}
+
+PassRefPtr<RegExp> RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags flags)
+{
+    if (patternString.length() >= maxCacheablePatternLength) {
+        ++m_statistics.missCount;
+        return RegExp::create(m_globalData, patternString, flags);
+    }
+
+    RegExpKey key(flags, patternString);
+    RegExpCacheMap::iterator iterator = m_cacheMap.find(key);
+    if (iterator != m_cacheMap.end()) {
+        ++m_statistics.hitCount;
+        RegExpCacheEntry* entry = iterator->second;
+        m_leastRecentlyUsed.remove(entry);
+        m_leastRecentlyUsed.append(entry);
+        return entry->regExp;
+    }
+
+    ++m_statistics.missCount;
     RefPtr<RegExp> regExp = RegExp::create(m_globalData, patternString, flags);
+    size_t cost = regExp->compiledSize();
+    if (cost > m_byteBudget)
+        return regExp.release();
 
-    if (patternString.length() >= maxCacheablePatternLength)
-        return regExp;
+    // The new entry is about to be used, so it is not the one to make room for itself.
+    regExp->setRecentlyUsed(true);
+    RegExpCacheEntry* entry = new RegExpCacheEntry(key, regExp, cost);
+    m_cacheMap.set(key, entry);
+    m_leastRecentlyUsed.append(entry);
+    ++m_statistics.entryCount;
+    m_statistics.cachedBytes += cost;
+    evictIfNecessary();
+    return regExp.release();
+}
 
-    RegExpKey key = RegExpKey(flags, patternString);
-    iterator->first = key;
-    iterator->second = regExp;
+void RegExpCache::setByteBudget(size_t byteBudget)
+{
+    m_byteBudget = byteBudget;
+    evictIfNecessary();
+}
 
-    ++m_nextKeyToEvict;
-    if (m_nextKeyToEvict == maxCacheableEntries) {
-        m_nextKeyToEvict = 0;
-        m_isFull = true;
+void RegExpCache::evictIfNecessary()
+{
+    // Each pass either evicts the entry or clears its flag, so this ends within two passes over the cache.
+    while (m_statistics.cachedBytes > m_byteBudget || m_statistics.entryCount > maxCacheableEntries) {
+        RegExpCacheEntry* entry = m_leastRecentlyUsed.head();
+        ASSERT(entry);
+        m_leastRecentlyUsed.remove(entry);
+        if (entry->regExp->recentlyUsed()) {
+            entry->regExp->setRecentlyUsed(false);
+            m_leastRecentlyUsed.append(entry);
+            continue;
+        }
+        evict(entry);
     }
-    if (m_isFull)
-        m_cacheMap.remove(RegExpKey(patternKeyArray[m_nextKeyToEvict].flagsValue, patternKeyArray[m_nextKeyToEvict].pattern));
-
-    patternKeyArray[m_nextKeyToEvict].flagsValue = key.flagsValue;
-    patternKeyArray[m_nextKeyToEvict].pattern = patternString.impl();
-    return regExp;
 }
 
-RegExpCache::RegExpCache(JSGlobalData* globalData)
-    : m_globalData(globalData)
-    , m_nextKeyToEvict(-1)
-    , m_isFull(false)
+void RegExpCache::evict(RegExpCacheEntry* entry)
 {
+    m_cacheMap.remove(entry->key);
+    --m_statistics.entryCount;
+    m_statistics.cachedBytes -= entry->cost;
+    ++m_statistics.evictionCount;
+    m_statistics.evictedBytes += entry->cost;
+
+    // A RegExp that is still referenced keeps its pattern, but not its code.
+    if (!entry->regExp->hasOneRef()) {
+        entry->regExp->invalidateCode();
+        ++m_statistics.invalidatedCount;
+    }
+    delete entry;
 }
 
 }
@@ -28,7 +28,7 @@
 #include "RegExp.h"
 #include "RegExpKey.h"
 #include "UString.h"
-#include <wtf/FixedArray.h>
+#include <wtf/DoublyLinkedList.h>
 #include <wtf/HashMap.h>
 
 #ifndef RegExpCache_h
@@ -36,31 +36,99 @@
 
 namespace JSC {
 
-class RegExpCache {
+struct RegExpCacheStatistics {
+    RegExpCacheStatistics()
+        : hitCount(0)
+        , missCount(0)
+        , evictionCount(0)
+        , evictedBytes(0)
+        , invalidatedCount(0)
+        , entryCount(0)
+        , cachedBytes(0)
+    {
+    }
+
+    unsigned hitCount;
+    unsigned missCount; // Including patterns too long to be cached.
 
-typedef HashMap<RegExpKey, RefPtr<RegExp> > RegExpCacheMap;
+    // RegExps that were evicted, the compiled code and bytecode they held, and
+    // how many of them were still in use and so only had their code dropped.
+    unsigned evictionCount;
+    size_t evictedBytes;
+    unsigned invalidatedCount;
+
+    unsigned entryCount;
+    size_t cachedBytes;
+};
+
+class RegExpCacheEntry {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    RegExpCacheEntry(const RegExpKey& key, PassRefPtr<RegExp> regExp, size_t cost)
+        : key(key)
+        , regExp(regExp)
+        , cost(cost)
+        , m_prev(0)
+        , m_next(0)
+    {
+    }
+
+    RegExpCacheEntry* prev() const { return m_prev; }
+    RegExpCacheEntry* next() const { return m_next; }
+    void setPrev(RegExpCacheEntry* prev) { m_prev = prev; }
+    void setNext(RegExpCacheEntry* next) { m_next = next; }
+
+    RegExpKey key;
+    RefPtr<RegExp> regExp;
+    size_t cost;
+
+private:
+    RegExpCacheEntry* m_prev;
+    RegExpCacheEntry* m_next;
+};
+
+// Keeps recently used RegExps, so that a pattern that is created again does not
+// have to be compiled again. The cache is bounded by the size of the compiled
+// code and bytecode that it holds, as well as by the number of entries, and
+// evicts the least recently used entries first. An entry that has been matched
+// since it was last looked at gets a second chance, so that RegExps from
+// literals, which only come to the cache when their code is compiled, are not
+// evicted while they are in use. An evicted RegExp that is still referenced
+// drops its code, and compiles it again if it is matched again.
+class RegExpCache {
+    typedef HashMap<RegExpKey, RegExpCacheEntry*> RegExpCacheMap;
 
 public:
-    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
-    PassRefPtr<RegExp> create(const UString& patternString, RegExpFlags, RegExpCacheMap::iterator);
     RegExpCache(JSGlobalData* globalData);
+    ~RegExpCache();
+
+    PassRefPtr<RegExp> lookupOrCreate(const UString& patternString, RegExpFlags);
+
+    size_t byteBudget() const { return m_byteBudget; }
+    void setByteBudget(size_t);
+
+    const RegExpCacheStatistics& statistics() const { return m_statistics; }
 
 private:
     static const unsigned maxCacheablePatternLength = 256;
 
 #if PLATFORM(IOS)
-    // The RegExpCache can currently hold onto multiple Mb of memory;
-    // as a short-term fix some embedded platforms may wish to reduce the cache size.
-    static const int maxCacheableEntries = 32;
+    // Embedded platforms keep less compiled code around.
+    static const unsigned maxCacheableEntries = 32;
+    static const size_t defaultByteBudget = 128 * 1024;
 #else
-    static const int maxCacheableEntries = 256;
+    static const unsigned maxCacheableEntries = 256;
+    static const size_t defaultByteBudget = 1024 * 1024;
 #endif
 
-    FixedArray<RegExpKey, maxCacheableEntries> patternKeyArray;
+    void evictIfNecessary();
+    void evict(RegExpCacheEntry*);
+
     RegExpCacheMap m_cacheMap;
+    DoublyLinkedList<RegExpCacheEntry> m_leastRecentlyUsed;
     JSGlobalData* m_globalData;
-    int m_nextKeyToEvict;
-    bool m_isFull;
+    size_t m_byteBudget;
+    RegExpCacheStatistics m_statistics;
 };
 
 } // namespace JSC
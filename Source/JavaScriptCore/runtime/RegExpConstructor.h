@@ -70,7 +70,8 @@ namespace JSC {
 
         static const ClassInfo s_info;
 
-        void performMatch(RegExp*, const UString&, int startOffset, int& position, int& length, int** ovector = 0);
+        void performMatch(JSGlobalData&, RegExp*, const UString&, int startOffset, int& position, int& length, int** ovector = 0);
+        void setLastMatch(const UString&, int position, int length);
         JSObject* arrayOfMatches(ExecState*) const;
 
         void setInput(const UString&);
@@ -109,9 +110,9 @@ namespace JSC {
       expression matching through the performMatch function. We use cached results to calculate, 
       e.g., RegExp.lastMatch and RegExp.leftParen.
     */
-    ALWAYS_INLINE void RegExpConstructor::performMatch(RegExp* r, const UString& s, int startOffset, int& position, int& length, int** ovector)
+    ALWAYS_INLINE void RegExpConstructor::performMatch(JSGlobalData& globalData, RegExp* r, const UString& s, int startOffset, int& position, int& length, int** ovector)
     {
-        position = r->match(s, startOffset, &d->tempOvector());
+        position = r->match(globalData, s, startOffset, &d->tempOvector());
 
         if (ovector)
             *ovector = d->tempOvector().data();
@@ -128,6 +129,20 @@ namespace JSC {
         }
     }
 
+    // Records a match of a RegExp without subpatterns that was found without running it.
+    inline void RegExpConstructor::setLastMatch(const UString& s, int position, int length)
+    {
+        Vector<int, 32>& ovector = d->tempOvector();
+        ovector.resize(2);
+        ovector[0] = position;
+        ovector[1] = position + length;
+
+        d->input = s;
+        d->lastInput = s;
+        d->changeLastOvector();
+        d->lastNumSubPatterns = 0;
+    }
+
 } // namespace JSC
 
 #endif // RegExpConstructor_h
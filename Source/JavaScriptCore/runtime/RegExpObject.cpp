@@ -145,7 +145,7 @@ bool RegExpObject::match(ExecState* exec)
     if (!regExp()->global()) {
         int position;
         int length;
-        regExpConstructor->performMatch(d->regExp.get(), input, 0, position, length);
+        regExpConstructor->performMatch(exec->globalData(), d->regExp.get(), input, 0, position, length);
         return position >= 0;
     }
 
@@ -168,7 +168,7 @@ bool RegExpObject::match(ExecState* exec)
 
     int position;
     int length = 0;
-    regExpConstructor->performMatch(d->regExp.get(), input, lastIndex, position, length);
+    regExpConstructor->performMatch(exec->globalData(), d->regExp.get(), input, lastIndex, position, length);
     if (position < 0) {
         setLastIndex(0);
         return false;
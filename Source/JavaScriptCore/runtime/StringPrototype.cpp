@@ -294,6 +294,49 @@ static ALWAYS_INLINE JSValue jsSpliceSubstringsWithSeparators(ExecState* exec, J
     return jsString(exec, impl);
 }
 
+// Replaces every occurrence of match, building the result in a buffer of the right size.
+static NEVER_INLINE JSValue jsReplaceAllOccurrences(ExecState* exec, JSString* sourceVal, const UString& source, const UString& match, const UString& replacement, RegExpConstructor* regExpConstructor)
+{
+    unsigned matchLength = match.length();
+    ASSERT(matchLength);
+
+    Vector<unsigned, 32> matchPositions;
+    for (size_t position = source.find(match); position != notFound; position = source.find(match, position + matchLength))
+        matchPositions.append(position);
+    if (matchPositions.isEmpty())
+        return sourceVal;
+
+    unsigned matchCount = matchPositions.size();
+    unsigned replacementLength = replacement.length();
+    unsigned keptLength = source.length() - matchCount * matchLength;
+    if (replacementLength && matchCount > (std::numeric_limits<int>::max() - keptLength) / replacementLength)
+        return throwOutOfMemoryError(exec);
+    unsigned totalLength = keptLength + matchCount * replacementLength;
+
+    regExpConstructor->setLastMatch(source, matchPositions.last(), matchLength);
+    if (!totalLength)
+        return jsEmptyString(exec);
+
+    UChar* buffer;
+    RefPtr<StringImpl> impl = StringImpl::tryCreateUninitialized(totalLength, buffer);
+    if (!impl)
+        return throwOutOfMemoryError(exec);
+
+    const UChar* sourceCharacters = source.characters();
+    unsigned sourcePosition = 0;
+    for (unsigned i = 0; i < matchCount; ++i) {
+        unsigned length = matchPositions[i] - sourcePosition;
+        StringImpl::copyChars(buffer, sourceCharacters + sourcePosition, length);
+        buffer += length;
+        StringImpl::copyChars(buffer, replacement.characters(), replacementLength);
+        buffer += replacementLength;
+        sourcePosition = matchPositions[i] + matchLength;
+    }
+    StringImpl::copyChars(buffer, sourceCharacters + sourcePosition, source.length() - sourcePosition);
+
+    return jsString(exec, impl.release());
+}
+
 EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
@@ -317,6 +360,11 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
 
         RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
 
+        // A global RegExp that only matches a literal is replaced by a constant replacement
+        // without running the RegExp, as a string search.
+        if (global && callType == CallTypeNone && !reg->literal().isNull() && replacementString.find('$', 0) == notFound)
+            return JSValue::encode(jsReplaceAllOccurrences(exec, sourceVal, source, reg->literal(), replacementString, regExpConstructor));
+
         int lastIndex = 0;
         unsigned startPosition = 0;
 
@@ -335,7 +383,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
                 int matchIndex;
                 int matchLen = 0;
                 int* ovector;
-                regExpConstructor->performMatch(reg, source, startPosition, matchIndex, matchLen, &ovector);
+                regExpConstructor->performMatch(exec->globalData(), reg, source, startPosition, matchIndex, matchLen, &ovector);
                 if (matchIndex < 0)
                     break;
 
@@ -380,7 +428,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
                 int matchIndex;
                 int matchLen = 0;
                 int* ovector;
-                regExpConstructor->performMatch(reg, source, startPosition, matchIndex, matchLen, &ovector);
+                regExpConstructor->performMatch(exec->globalData(), reg, source, startPosition, matchIndex, matchLen, &ovector);
                 if (matchIndex < 0)
                     break;
 
@@ -486,6 +534,15 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    if (thisValue.isString()) {
+        // Reading a character of a rope does not always need to flatten it.
+        JSString* string = asString(thisValue);
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < string->length())
+            return JSValue::encode(string->getIndex(exec, static_cast<unsigned>(dpos)));
+        return JSValue::encode(jsEmptyString(exec));
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -506,6 +563,14 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    if (thisValue.isString()) {
+        JSString* string = asString(thisValue);
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < string->length())
+            return JSValue::encode(jsNumber(string->characterAt(exec, static_cast<unsigned>(dpos))));
+        return JSValue::encode(jsNaN());
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -618,7 +683,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncMatch(ExecState* exec)
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
     int matchLength = 0;
-    regExpConstructor->performMatch(reg.get(), s, 0, pos, matchLength);
+    regExpConstructor->performMatch(exec->globalData(), reg.get(), s, 0, pos, matchLength);
     if (!(reg->global())) {
         // case without 'g' flag is handled like RegExp.prototype.exec
         if (pos < 0)
@@ -633,7 +698,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncMatch(ExecState* exec)
         list.append(jsSubstring(exec, s, pos, matchLength));
         lastIndex = pos;
         pos += matchLength == 0 ? 1 : matchLength;
-        regExpConstructor->performMatch(reg.get(), s, pos, pos, matchLength);
+        regExpConstructor->performMatch(exec->globalData(), reg.get(), s, pos, pos, matchLength);
     }
     if (list.isEmpty()) {
         // if there are no matches at all, it's important to return
@@ -668,7 +733,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSearch(ExecState* exec)
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
     int pos;
     int matchLength = 0;
-    regExpConstructor->performMatch(reg.get(), s, 0, pos, matchLength);
+    regExpConstructor->performMatch(exec->globalData(), reg.get(), s, 0, pos, matchLength);
     return JSValue::encode(jsNumber(pos));
 }
 
@@ -713,16 +778,17 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
     unsigned i = 0;
     unsigned p0 = 0;
     unsigned limit = a1.isUndefined() ? 0xFFFFFFFFU : a1.toUInt32(exec);
-    if (a0.inherits(&RegExpObject::s_info)) {
+    // A RegExp that only matches a literal splits the string as the literal would.
+    if (a0.inherits(&RegExpObject::s_info) && asRegExpObject(a0)->regExp()->literal().isNull()) {
         RegExp* reg = asRegExpObject(a0)->regExp();
-        if (s.isEmpty() && reg->match(s, 0) >= 0) {
+        if (s.isEmpty() && reg->match(exec->globalData(), s, 0) >= 0) {
             // empty string matched by regexp -> empty array
             return JSValue::encode(result);
         }
         unsigned pos = 0;
         while (i != limit && pos < s.length()) {
             Vector<int, 32> ovector;
-            int mpos = reg->match(s, pos, &ovector);
+            int mpos = reg->match(exec->globalData(), s, pos, &ovector);
             if (mpos < 0)
                 break;
             int mlen = ovector[1] - ovector[0];
@@ -740,7 +806,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
             }
         }
     } else {
-        UString u2 = a0.toString(exec);
+        UString u2 = a0.inherits(&RegExpObject::s_info) ? asRegExpObject(a0)->regExp()->literal() : a0.toString(exec);
         if (u2.isEmpty()) {
             if (s.isEmpty()) {
                 // empty separator matches empty string -> empty array
@@ -748,6 +814,13 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
             }
             while (i != limit && p0 < s.length() - 1)
                 result->put(exec, i++, jsSingleCharacterSubstring(exec, s, p0++));
+        } else if (u2.length() == 1) {
+            UChar separator = u2[0];
+            size_t pos;
+            while (i != limit && (pos = s.find(separator, p0)) != notFound) {
+                result->put(exec, i++, jsSubstring(exec, s, p0, pos - p0));
+                p0 = pos + 1;
+            }
         } else {
             size_t pos;
             while (i != limit && (pos = s.find(u2, p0)) != notFound) {
@@ -791,6 +791,24 @@ void Structure::markChildren(MarkStack& markStack)
 
 void PropertyTable::checkConsistency()
 {
+    if (isCompact()) {
+        ASSERT(!m_indexSize);
+        ASSERT(m_indexMask >= PropertyTable::MinimumCompactCapacity);
+        ASSERT(m_indexMask <= PropertyTable::MaximumCompactCapacity);
+        ASSERT(m_keyCount + m_deletedCount <= m_indexMask);
+        ASSERT(!table()[deletedEntryIndex() - 1].key);
+
+        unsigned nonEmptyEntryCount = 0;
+        for (unsigned c = 0; c < usedCount(); ++c) {
+            StringImpl* rep = table()[c].key;
+            ASSERT(compactKeys()[c] == rep);
+            if (rep != PROPERTY_MAP_DELETED_ENTRY_KEY)
+                ++nonEmptyEntryCount;
+        }
+        ASSERT(nonEmptyEntryCount == m_keyCount);
+        return;
+    }
+
     ASSERT(m_indexSize >= PropertyTable::MinimumTableSize);
     ASSERT(m_indexMask);
     ASSERT(m_indexSize == m_indexMask + 1);
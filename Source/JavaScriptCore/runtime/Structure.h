@@ -133,6 +133,13 @@ namespace JSC {
         JSPropertyNameIterator* enumerationCache(); // Defined in JSPropertyNameIterator.h.
         void getPropertyNames(JSGlobalData&, PropertyNameArray&, EnumerationMode mode);
 
+        // Iterating the table visits the properties in the order that getPropertyNames() returns them.
+        const PropertyTable* propertyTable(JSGlobalData& globalData)
+        {
+            materializePropertyMapIfNecessary(globalData);
+            return m_propertyTable.get();
+        }
+
         const ClassInfo* classInfo() const { return m_classInfo; }
 
         static ptrdiff_t prototypeOffset()
@@ -285,11 +292,20 @@ namespace JSC {
         return asCell()->structure()->typeInfo().needsThisConversion();
     }
 
+    ALWAYS_INLINE bool MarkStack::testAndSetMarked(JSCell* cell)
+    {
+#if ENABLE(PARALLEL_GC)
+        if (m_isInParallelMode)
+            return Heap::concurrentTestAndSetMarked(cell);
+#endif
+        return Heap::testAndSetMarked(cell);
+    }
+
     ALWAYS_INLINE void MarkStack::internalAppend(JSCell* cell)
     {
         ASSERT(!m_isCheckingForDefaultMarkViolation);
         ASSERT(cell);
-        if (Heap::testAndSetMarked(cell))
+        if (testAndSetMarked(cell))
             return;
         if (cell->structure()->typeInfo().type() >= CompoundType)
             m_values.append(cell);
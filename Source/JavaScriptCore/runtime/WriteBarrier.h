@@ -27,11 +27,28 @@
 #define WriteBarrier_h
 
 #include "JSValue.h"
+#include "MarkedBlock.h"
 
 namespace JSC {
 class JSCell;
 class JSGlobalData;
 
+// With ENABLE(GGC), storing a reference into a cell dirties the cell's block,
+// adding the block's old cells to the remembered set that the next young
+// collection rescans. JIT code does the same with JIT::emitWriteBarrier().
+#if ENABLE(GGC)
+inline void writeBarrier(JSGlobalData&, const JSCell* owner, JSValue value)
+{
+    if (owner && value.isCell())
+        MarkedBlock::blockFor(owner)->setDirty();
+}
+
+inline void writeBarrier(JSGlobalData&, const JSCell* owner, JSCell* value)
+{
+    if (owner && value)
+        MarkedBlock::blockFor(owner)->setDirty();
+}
+#else
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 {
 }
@@ -39,6 +56,7 @@ inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSCell*)
 {
 }
+#endif
 
 typedef enum { } Unknown;
 typedef JSValue* HandleSlot;
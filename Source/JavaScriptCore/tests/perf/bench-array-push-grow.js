@@ -0,0 +1,33 @@
+// Grows arrays one element at a time with push(), from a handful of elements
+// up to a few thousand, the way scripts build up lists of results. Most
+// backing stores are thrown away while still small, and the rest are
+// reallocated over and over as they grow. Reports the time taken and how
+// many collections ran.
+(function () {
+    var before = gcStatistics();
+    var start = new Date;
+
+    var checksum = 0;
+    var retained = [];
+    for (var round = 0; round < 2000; ++round) {
+        for (var n = 1; n < 4096; n *= 2) {
+            var array = [];
+            for (var i = 0; i < n; ++i)
+                array.push(i);
+            checksum += array[n - 1];
+            if (!(round & 31))
+                retained.push(array);
+        }
+        var small = [];
+        for (var i = 0; i < 2000; ++i)
+            small.push([i, i + 1, i + 2]);
+        checksum += small.length;
+    }
+
+    var elapsed = new Date - start;
+    var after = gcStatistics();
+
+    print("checksum: " + checksum + " (" + retained.length + " retained)");
+    print("time: " + elapsed + "ms");
+    print("collections: " + (after.collectionCount - before.collectionCount));
+})();
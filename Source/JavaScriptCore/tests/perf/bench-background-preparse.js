@@ -0,0 +1,90 @@
+// Measures how much of the parsing of a large script is hidden by pre-parsing
+// it on a background thread while it downloads. The download is simulated by
+// appending the script in chunks, with the main thread busy for a while
+// between chunks, as it would be with layout and other scripts. Then the whole
+// script is evaluated, and the time that the main thread spent parsing is
+// reported, with and without the background preparse. Only one module in ten
+// is run, so most of the functions only need to be syntax checked, which the
+// background thread has done by the time the script runs. The parsing time is
+// only reported in builds with ENABLE(PARSER_STATS). Needs a build with
+// ENABLE(JSC_MULTIPLE_THREADS); in other builds nothing is pre-parsed. With a
+// single core, the background thread slows down the simulated download instead
+// of running beside it.
+(function () {
+    var moduleCount = 4000;
+    var chunkCount = 100;
+
+    function module(i) {
+        var source = "modules[" + i + "] = function (exports) {\n";
+        source += "    var counter = " + i + ";\n";
+        source += "    function describe(value) {\n";
+        source += "        var parts = [];\n";
+        source += "        for (var j = 0; j < 4; ++j)\n";
+        source += "            parts.push(\"module " + i + " part \" + j + \": \" + (value * j));\n";
+        source += "        return parts.join(\", \");\n";
+        source += "    }\n";
+        source += "    exports.increment = function (amount) {\n";
+        source += "        counter = (counter + amount) | 0;\n";
+        source += "        return counter;\n";
+        source += "    };\n";
+        source += "    exports.describe = function (value) {\n";
+        source += "        if (typeof value != \"number\")\n";
+        source += "            throw new TypeError(\"module " + i + " describes numbers\");\n";
+        source += "        return describe(value);\n";
+        source += "    };\n";
+        source += "    return exports;\n";
+        source += "};\n";
+        return source;
+    }
+
+    var parts = ["var modules = [];\n"];
+    for (var i = 0; i < moduleCount; ++i)
+        parts.push(module(i));
+    parts.push("var checksum = 0;\n");
+    parts.push("for (var i = 0; i < modules.length; i += 10)\n");
+    parts.push("    checksum = (checksum + modules[i]({}).increment(i)) | 0;\n");
+    parts.push("checksum;\n");
+    var script = parts.join("");
+
+    var chunks = [];
+    var chunkLength = Math.ceil(script.length / chunkCount);
+    for (var i = 0; i < script.length; i += chunkLength)
+        chunks.push(script.substring(i, i + chunkLength));
+
+    function busy(milliseconds) {
+        var end = new Date().getTime() + milliseconds;
+        var x = 0;
+        while (new Date().getTime() < end)
+            x = (x + 1) | 0;
+        return x;
+    }
+
+    function run(name, preparse) {
+        if (preparse)
+            beginBackgroundPreparse();
+        var downloadStart = new Date;
+        for (var i = 0; i < chunks.length; ++i) {
+            if (preparse)
+                appendToBackgroundPreparse(chunks[i]);
+            busy(2);
+        }
+        var downloadTime = new Date - downloadStart;
+
+        var hasParserStatistics = typeof parserStatistics == "function";
+        var parseTime = hasParserStatistics && parserStatistics().parseTime;
+        var start = new Date;
+        var evaluation = evaluateWithBackgroundPreparse(script);
+        var time = new Date - start;
+        var parsing = "";
+        if (hasParserStatistics)
+            parsing = ", " + (parserStatistics().parseTime - parseTime).toFixed(1) + "ms of it parsing";
+        print(name + ": " + time + "ms to evaluate" + parsing + ", after " + downloadTime + "ms of download ("
+            + evaluation.transferredFunctions + " functions pre-parsed in the background, checksum " + evaluation.result + ")");
+    }
+
+    print(script.length + " characters in " + chunks.length + " chunks");
+    for (var round = 0; round < 3; ++round) {
+        run("main thread", false);
+        run("background", true);
+    }
+})();
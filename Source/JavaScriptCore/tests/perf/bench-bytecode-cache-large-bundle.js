@@ -0,0 +1,49 @@
+// Loads a large generated script bundle three times, each in a new global
+// object: first with an empty bytecode cache, which is filled as the bundle is
+// compiled; then again without a cache, once the rest of the engine is warm;
+// and last with the cache from the first load, so that the program and every
+// function that ran are loaded from it instead of being parsed and generated.
+// Reports each load time, the size of the cache and how many code blocks came
+// from it. The checksums must match.
+(function () {
+    var moduleCount = 4000;
+
+    function moduleSource(i) {
+        var source = "modules[" + i + "] = function (exports) {";
+        source += "var table = [" + i + ", " + (i * 7 % 13) + ", " + (i * 11 % 17) + "];";
+        source += "exports.name = 'module" + i + "';";
+        source += "exports.init = function (state) {";
+        for (var j = 0; j < 4 + i % 12; ++j)
+            source += "state.value = (state.value * 31 + table[" + (j % 3) + "] + " + j + ") | 0;";
+        source += "switch (state.value & 3) { case 0: state.tag = 'a'; break; case 1: state.tag = 'b'; break; default: state.tag = 'c'; }";
+        source += "return state.value; };";
+        // Most exported functions are never called, so they are never compiled or cached.
+        source += "exports.unused = function (a, b) { var s = 0; for (var k = 0; k < a; ++k) s += b[k]; return s; };";
+        source += "return exports; };";
+        return source;
+    }
+
+    var parts = ["var modules = new Array(" + moduleCount + ");"];
+    for (var i = 0; i < moduleCount; ++i)
+        parts.push(moduleSource(i));
+    parts.push("function boot() {"
+        + "var state = { value: 0, tag: '' };"
+        + "for (var i = 0; i < modules.length; ++i)"
+        + "    modules[i]({}).init(state);"
+        + "return state.value + state.tag; }");
+    parts.push("boot();");
+    var bundle = parts.join("\n");
+
+    function load(name, cache) {
+        var start = new Date;
+        var loaded = evaluateWithBytecodeCache(bundle, cache);
+        var time = new Date - start;
+        print(name + ": " + time + "ms, " + loaded.loadedCodeBlocks + " of " + loaded.codeBlocks + " code blocks from the cache (checksum " + loaded.result + ")");
+        return loaded;
+    }
+
+    var cold = load("cold", undefined);
+    print("bytecode cache: " + (cold.bytecodeCache.length >> 10) + "K for " + bundle.length + " characters");
+    load("uncached", undefined);
+    load("warm", cold.bytecodeCache);
+})();
@@ -0,0 +1,53 @@
+// Runs hot numeric loops that keep more values live than there are machine
+// registers, so the DFG JIT's register allocator has to choose which values to
+// spill to the RegisterFile and reload. "mix" keeps eight integer state words
+// (masked so that they stay int32s) and their temporaries live across each
+// iteration; "blend" reads several elements of an array of doubles per
+// iteration and combines them with constants and locals. Set DFG_SPILL_STATS
+// in DFGNode.h to see how many values were spilled and filled in each. The
+// checksums must match those printed by a build without the DFG JIT.
+(function () {
+    function mix(n) {
+        var a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8;
+        for (var i = 0; i < n; ++i) {
+            a = (a + (b ^ i)) & 0xfffffff;
+            b = (b + ((c << 3) & 0xffffff ^ (d >> 2))) & 0xfffffff;
+            c = (c ^ (e + f)) & 0xfffffff;
+            d = (d + (g ^ (h << 1))) & 0xfffffff;
+            e = (e ^ (a + d)) & 0xfffffff;
+            f = (f + (b ^ (c >> 1))) & 0xfffffff;
+            g = (g ^ (e - h)) & 0xfffffff;
+            h = (h + (a ^ f ^ g)) & 0xfffffff;
+        }
+        return a ^ b ^ c ^ d ^ e ^ f ^ g ^ h;
+    }
+
+    function blend(values, n) {
+        var total = 0;
+        var length = values.length - 3;
+        for (var round = 0; round < n; ++round) {
+            for (var i = 0; i < length; ++i) {
+                var x = values[i], y = values[i + 1], z = values[i + 2], w = values[i + 3];
+                total = total + (x * 0.5 + y * 0.25) * (z - w * 0.125) + (x - z) * (y + w) * 0.0625;
+            }
+            total = total % 1000003;
+        }
+        return total;
+    }
+
+    var doubles = [];
+    for (var i = 0; i < 1000; ++i)
+        doubles.push((i % 89) + 0.25);
+
+    var start = new Date;
+    var checksum = 0;
+    for (var round = 0; round < 200; ++round)
+        checksum = (checksum + mix(100000)) | 0;
+    print("integer state: " + (new Date - start) + "ms (checksum " + checksum + ")");
+
+    start = new Date;
+    checksum = 0;
+    for (var round = 0; round < 20; ++round)
+        checksum = (checksum + blend(doubles, 1000)) % 1000000007;
+    print("double kernel: " + (new Date - start) + "ms (checksum " + checksum + ")");
+})();
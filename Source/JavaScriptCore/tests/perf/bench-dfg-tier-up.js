@@ -0,0 +1,69 @@
+// Runs small compute-heavy leaf functions long enough for the DFG JIT to
+// optimize them from the value profiles gathered by the baseline JIT. The
+// first call to "mix" spends all its time in one loop, so it only speeds up
+// if the loop enters the optimized code while it is running. "accumulate"
+// sees integers, then doubles, so its integer speculations fail and it has to
+// exit to the baseline code and be optimized again for the types seen since.
+// "difference" calls a valueOf before one of its speculations fails, which
+// must not call it again. The checksums must match those printed by a build
+// without the DFG JIT.
+(function () {
+    function mix(n) {
+        var hash = 0;
+        for (var i = 0; i < n; ++i)
+            hash = ((hash << 5) - hash + (i ^ (i >> 3))) | 0;
+        return hash;
+    }
+
+    function sum(values) {
+        var total = 0;
+        for (var i = 0; i < values.length; ++i)
+            total = total + values[i];
+        return total;
+    }
+
+    function accumulate(values, scale) {
+        var total = 0;
+        for (var i = 0; i < values.length; ++i)
+            total = total + values[i] * scale;
+        return total;
+    }
+
+    function difference(x, y) {
+        return x - y;
+    }
+
+    var integers = [];
+    var doubles = [];
+    for (var i = 0; i < 1000; ++i) {
+        integers.push(i % 97);
+        doubles.push((i % 89) + 0.25);
+    }
+
+    var start = new Date;
+    var checksum = mix(20000000);
+    print("loop entry: " + (new Date - start) + "ms (checksum " + checksum + ")");
+
+    start = new Date;
+    checksum = 0;
+    for (var round = 0; round < 20000; ++round)
+        checksum = (checksum + sum(integers)) % 1000000007;
+    print("int32 array: " + (new Date - start) + "ms (checksum " + checksum + ")");
+
+    start = new Date;
+    checksum = 0;
+    for (var round = 0; round < 10000; ++round)
+        checksum = (checksum + accumulate(integers, 3)) % 1000000007;
+    for (var round = 0; round < 10000; ++round)
+        checksum = (checksum + accumulate(doubles, 0.5)) % 1000000007;
+    print("int32 then double: " + (new Date - start) + "ms (checksum " + checksum + ")");
+
+    var valueOfCalls = 0;
+    var counted = { valueOf: function () { ++valueOfCalls; return 10; } };
+    start = new Date;
+    checksum = 0;
+    for (var i = 0; i < 200000; ++i)
+        checksum = (checksum + difference(counted, i)) | 0;
+    checksum = (checksum + difference(counted, "3")) | 0;
+    print("exit after valueOf: " + (new Date - start) + "ms (checksum " + checksum + ", " + valueOfCalls + " valueOf calls)");
+})();
@@ -0,0 +1,68 @@
+// Allocates at the bottom of deep call stacks that go through native frames
+// (Array.prototype.forEach and sort callbacks), so every collection has to
+// scan a deep machine stack and a deep register file for conservative roots.
+// Reports the time spent gathering roots, how many candidate words were
+// scanned per collection, and how many of those the block filter let through
+// to a block lookup without them turning out to be cells.
+(function () {
+    var one = [0];
+    var pair = [1, 0];
+
+    // Every fourth frame is native; jsc allows at most 256 of those deep.
+    function descend(depth, work) {
+        if (!depth)
+            return work();
+        if (depth & 3)
+            return descend(depth - 1, work);
+        var result;
+        if (depth & 4)
+            one.forEach(function () { result = descend(depth - 1, work); });
+        else
+            pair.slice().sort(function (a, b) { result = descend(depth - 1, work); return a - b; });
+        return result;
+    }
+
+    function churn() {
+        var list = [];
+        for (var i = 0; i < 2000; ++i)
+            list.push({ index: i, name: "n" + i });
+        return list.length;
+    }
+
+    var before = gcStatistics();
+    var start = new Date;
+
+    var checksum = 0;
+    var candidates = 0;
+    var lookups = 0;
+    var roots = 0;
+    var samples = 0;
+    for (var round = 0; round < 200; ++round) {
+        checksum += descend(200 + (round % 5) * 150, function () {
+            var count = gcStatistics().collectionCount;
+            var result = churn() + churn();
+            var statistics = gcStatistics();
+            if (statistics.collectionCount != count) {
+                candidates += statistics.lastConservativeCandidateCount;
+                lookups += statistics.lastConservativeBlockLookupCount;
+                roots += statistics.lastConservativeRootCount;
+                ++samples;
+            }
+            return result;
+        });
+    }
+
+    var elapsed = new Date - start;
+    var after = gcStatistics();
+    var collections = after.collectionCount - before.collectionCount;
+    var gatheringTime = after.totalRootGatheringTime - before.totalRootGatheringTime;
+
+    print("checksum: " + checksum);
+    print("time: " + elapsed + "ms");
+    print("collections: " + collections);
+    print("root gathering: " + gatheringTime.toFixed(2) + "ms total, " + (collections ? gatheringTime / collections : 0).toFixed(3) + "ms per collection");
+    if (samples) {
+        print("candidates per collection: " + Math.round(candidates / samples) + ", block lookups: " + Math.round(lookups / samples) + ", roots: " + Math.round(roots / samples));
+        print("filter false positives: " + (lookups ? 100 * (lookups - roots) / lookups : 0).toFixed(1) + "% of lookups, " + (100 * (lookups - roots) / candidates).toFixed(2) + "% of candidates");
+    }
+})();
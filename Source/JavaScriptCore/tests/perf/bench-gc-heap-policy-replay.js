@@ -0,0 +1,62 @@
+// Replays a fixed allocation trace -- a mix of temporaries, medium-lived
+// caches and a slowly growing long-lived set, in phases with different
+// allocation rates -- and reports how many collections ran, the time spent
+// marking and the largest heap seen. The trace comes from a seeded generator,
+// so every run allocates the same objects in the same order.
+// Compare "jsc -p default" against "jsc -p adaptive" or "jsc -p adaptive=<MB>".
+(function () {
+    var seed = 49734321;
+    function random() {
+        seed = (seed * 1103515245 + 12345) % 2147483648;
+        return seed / 2147483648;
+    }
+
+    function makeObject(size) {
+        var object = { id: size, payload: [] };
+        for (var i = 0; i < size; ++i)
+            object.payload.push({ index: i, name: "n" + i });
+        return object;
+    }
+
+    var longLived = [];
+    var medium = new Array(256);
+    var phases = [
+        // [allocations, chance of medium lifetime, chance of long lifetime, object size]
+        [60000, 0.05, 0.002, 4],
+        [20000, 0.30, 0.010, 16],
+        [120000, 0.01, 0.000, 2],
+        [30000, 0.20, 0.020, 8],
+    ];
+
+    var before = gcStatistics();
+    var peakCapacity = before.capacity;
+    var start = new Date;
+
+    var checksum = 0;
+    for (var round = 0; round < 3; ++round) {
+        for (var p = 0; p < phases.length; ++p) {
+            var phase = phases[p];
+            for (var i = 0; i < phase[0]; ++i) {
+                var object = makeObject(1 + Math.floor(random() * phase[3]));
+                var lifetime = random();
+                if (lifetime < phase[2])
+                    longLived.push(object);
+                else if (lifetime < phase[2] + phase[1])
+                    medium[Math.floor(random() * medium.length)] = object;
+                checksum += object.payload.length;
+
+                if (!(i & 1023))
+                    peakCapacity = Math.max(peakCapacity, gcStatistics().capacity);
+            }
+        }
+    }
+
+    var elapsed = new Date - start;
+    var after = gcStatistics();
+
+    print("checksum: " + checksum + " (" + longLived.length + " long-lived)");
+    print("time: " + elapsed + "ms");
+    print("collections: " + (after.collectionCount - before.collectionCount));
+    print("mark time: " + (after.totalMarkTime - before.totalMarkTime).toFixed(2) + "ms, worst pause: " + after.maxPauseTime.toFixed(2) + "ms");
+    print("peak capacity: " + (peakCapacity / (1024 * 1024)).toFixed(2) + "MB");
+})();
@@ -0,0 +1,27 @@
+// Reports garbage collection pause times over a large, fully live object graph.
+// Compare marker thread counts with e.g. "jsc -m 1 ..." vs. "jsc -m 4 ...".
+(function () {
+    function makeTree(depth) {
+        if (!depth)
+            return { value: depth };
+        return { left: makeTree(depth - 1), right: makeTree(depth - 1), value: [depth, depth + 1] };
+    }
+
+    var roots = [];
+    for (var i = 0; i < 8; ++i)
+        roots.push(makeTree(16));
+
+    var iterations = 10;
+    var total = 0;
+    var worst = 0;
+    for (var i = 0; i < iterations; ++i) {
+        var start = new Date;
+        gc();
+        var pause = new Date - start;
+        total += pause;
+        if (pause > worst)
+            worst = pause;
+    }
+
+    print("average pause: " + (total / iterations) + "ms, worst pause: " + worst + "ms");
+})();
@@ -0,0 +1,48 @@
+// Allocates many short-lived objects next to a large, long-lived object graph,
+// the way page scripts churn through temporaries. Reports how many collections
+// ran, how many of them were young collections, and the pause times.
+// Compare a jsc built with ENABLE(GGC) against one without.
+(function () {
+    function makeTree(depth) {
+        if (!depth)
+            return { value: depth };
+        return { left: makeTree(depth - 1), right: makeTree(depth - 1), value: [depth, "" + depth] };
+    }
+
+    var retained = [];
+    for (var i = 0; i < 4; ++i)
+        retained.push(makeTree(15));
+
+    // Old objects that keep being pointed at young ones, through the
+    // remembered set.
+    var cache = [];
+    for (var i = 0; i < 64; ++i)
+        cache.push({ latest: null });
+
+    var before = gcStatistics();
+    var start = new Date;
+
+    var checksum = 0;
+    for (var i = 0; i < 400000; ++i) {
+        var node = { tag: "div", id: i, children: [], attributes: { className: "item" + (i & 15) } };
+        for (var j = 0; j < 4; ++j)
+            node.children.push({ tag: "span", text: "t" + j });
+        cache[i & 63].latest = node;
+        checksum += node.children.length;
+    }
+
+    for (var i = 0; i < cache.length; ++i)
+        checksum += cache[i].latest.children[3].text.length;
+
+    var elapsed = new Date - start;
+    var after = gcStatistics();
+
+    var collections = after.collectionCount - before.collectionCount;
+    var youngCollections = after.youngCollectionCount - before.youngCollectionCount;
+    var markTime = after.totalMarkTime - before.totalMarkTime;
+
+    print("checksum: " + checksum);
+    print("time: " + elapsed + "ms");
+    print("collections: " + collections + " (" + youngCollections + " young)");
+    print("average mark time: " + (collections ? markTime / collections : 0).toFixed(2) + "ms, worst pause: " + after.maxPauseTime.toFixed(2) + "ms");
+})();
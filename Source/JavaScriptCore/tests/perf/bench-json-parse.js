@@ -0,0 +1,52 @@
+// Measures JSON.parse on documents like large API responses: arrays of
+// records that all have the same keys, with nested objects and short string
+// values without escapes. "records" has records with few enough properties
+// to be stored inline, "wide records" has records with more properties than
+// that, and "escaped strings" has values that need to be unescaped. Reports
+// the fastest of several runs in MB of JSON per second, and the heap capacity
+// after the parsed documents have been kept alive.
+(function () {
+    var recordCount = 20000;
+
+    function record(i) {
+        return '{"id":' + i + ',"name":"user' + i + '","active":' + (i % 3 ? 'true' : 'false')
+            + ',"location":{"city":"City ' + (i % 100) + '","zip":"' + (10000 + i) + '"}}';
+    }
+
+    function wideRecord(i) {
+        return '{"id":' + i + ',"first":"First' + i + '","last":"Last' + i + '","email":"user' + i + '@example.com"'
+            + ',"score":' + (i * 7 % 1000) + ',"ratio":' + (i % 17) / 8 + ',"tags":["a","b","c' + (i % 5) + '"]'
+            + ',"created":"2011-04-' + (10 + i % 20) + 'T12:00:00Z","verified":' + (i % 2 ? 'true' : 'false') + ',"manager":null}';
+    }
+
+    function escapedRecord(i) {
+        return '{"id":' + i + ',"text":"line one\\nline \\"two\\" \\u00e9' + i + '","path":"C:\\\\dir\\\\file' + i + '"}';
+    }
+
+    function document(recordSource) {
+        var records = [];
+        for (var i = 0; i < recordCount; ++i)
+            records.push(recordSource(i));
+        return '{"count":' + recordCount + ',"results":[' + records.join(",") + ']}';
+    }
+
+    var kept = [];
+    function measure(name, json) {
+        var best = Infinity;
+        var result;
+        for (var i = 0; i < 10; ++i) {
+            var start = new Date;
+            result = JSON.parse(json);
+            best = Math.min(best, new Date - start);
+        }
+        kept.push(result);
+        var megabytes = json.length / (1024 * 1024);
+        print(name + ": " + (megabytes / (best / 1000)).toFixed(1) + " MB/s (" + json.length + " characters in " + best + "ms)");
+    }
+
+    measure("records", document(record));
+    measure("wide records", document(wideRecord));
+    measure("escaped strings", document(escapedRecord));
+    gc();
+    print("heap capacity: " + Math.round(gcStatistics().capacity / 1024) + "K for " + kept.length * recordCount + " records");
+})();
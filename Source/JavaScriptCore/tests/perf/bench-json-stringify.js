@@ -0,0 +1,47 @@
+// Measures JSON.stringify on large arrays of records that all have the same
+// keys, like the API responses measured by bench-json-parse.js. "records" has
+// short records with a nested object, "wide records" has more properties than
+// are stored inline, "long strings" has values with long runs of characters
+// that need no escaping and a few that do, and "indented" is the records again
+// with a gap. Reports the fastest of several runs in MB of JSON per second.
+(function () {
+    var recordCount = 20000;
+
+    function record(i) {
+        return { id: i, name: "user" + i, active: !!(i % 3), location: { city: "City " + (i % 100), zip: "" + (10000 + i) } };
+    }
+
+    function wideRecord(i) {
+        return { id: i, first: "First" + i, last: "Last" + i, email: "user" + i + "@example.com", score: i * 7 % 1000, ratio: (i % 17) / 8,
+            tags: ["a", "b", "c" + (i % 5)], created: "2011-04-" + (10 + i % 20) + "T12:00:00Z", verified: !!(i % 2), manager: null };
+    }
+
+    function longStringRecord(i) {
+        return { id: i, summary: "Record " + i + " has a summary that is long enough to be scanned a vector at a time before the end.",
+            text: "line one\nline \"two\" of record " + i + ", with a path C:\\dir\\file" + i };
+    }
+
+    function records(recordSource) {
+        var result = [];
+        for (var i = 0; i < recordCount; ++i)
+            result.push(recordSource(i));
+        return { count: recordCount, results: result };
+    }
+
+    function measure(name, value, space) {
+        var best = Infinity;
+        var json;
+        for (var i = 0; i < 10; ++i) {
+            var start = new Date;
+            json = JSON.stringify(value, null, space);
+            best = Math.min(best, new Date - start);
+        }
+        var megabytes = json.length / (1024 * 1024);
+        print(name + ": " + (megabytes / (best / 1000)).toFixed(1) + " MB/s (" + json.length + " characters in " + best + "ms)");
+    }
+
+    measure("records", records(record));
+    measure("wide records", records(wideRecord));
+    measure("long strings", records(longStringRecord));
+    measure("indented", records(record), 2);
+})();
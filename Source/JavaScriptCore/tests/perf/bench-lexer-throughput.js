@@ -0,0 +1,78 @@
+// Measures how fast the lexer gets through large generated bundles, in MB of
+// source per second. The "unminified" bundle is indented, commented and has
+// long string literals; the "minified" bundle is the same code with no
+// whitespace or comments and short names. The "documented" bundle is mostly
+// long doc comments and HTML templates in string literals, which are the runs
+// of characters that the lexer skips a vector at a time. The bundles are
+// wrapped in module functions, so that most of the source is only syntax
+// checked, and compiled with the Function constructor, which parses them
+// without running them.
+(function () {
+    var moduleCount = 2000;
+
+    function unminifiedModule(i) {
+        var source = "/*\n * Module " + i + ".\n *\n * Exports a counter and a formatter. This comment is long enough\n * to take a few lines, like the license and API comments in real code.\n */\n";
+        source += "modules[" + i + "] = function (exports, require) {\n";
+        source += "    // Local state of the module.\n";
+        source += "    var counter = " + i + ";\n";
+        source += "    var message = \"Module " + i + " reports the current value of its counter: \";\n";
+        source += "    var template = 'The quick brown fox jumps over the lazy dog, module " + i + "';\n\n";
+        source += "    exports.increment = function (amount) {\n";
+        source += "        // Increment the counter, wrapping at 2^31.\n";
+        source += "        counter = (counter + amount) | 0;\n";
+        source += "        return counter;\n";
+        source += "    };\n\n";
+        source += "    exports.format = function (value) {\n";
+        source += "        if (value < 0) {\n";
+        source += "            return \"negative: \" + message + value + \" (\" + template + \")\";\n";
+        source += "        }\n";
+        source += "        return message + value;\n";
+        source += "    };\n";
+        source += "    return exports;\n";
+        source += "};\n\n";
+        return source;
+    }
+
+    function minifiedModule(i) {
+        return "m[" + i + "]=function(e,r){var c=" + i + ",s=\"Module " + i + ": \",t='fox " + i + "';"
+            + "e.i=function(a){c=c+a|0;return c};"
+            + "e.f=function(v){if(v<0)return\"-\"+s+v+\"(\"+t+\")\";return s+v};return e};";
+    }
+
+    function documentedModule(i) {
+        var source = "/**\n";
+        for (var j = 0; j < 8; ++j)
+            source += " * Line " + j + " of the documentation of module " + i + ", which describes its arguments and results.\n";
+        source += " */\n";
+        source += "modules[" + i + "] = function (exports) {\n";
+        source += "    exports.template = \"<div class='module-" + i + "'><h1>Module " + i + "</h1><p>This paragraph is part of a template that is kept in a string literal.</p></div>\";\n";
+        source += "    exports.style = '.module-" + i + " { margin: 0; padding: 4px 8px; border: 1px solid #ccc; font: 12px sans-serif; }';\n";
+        source += "    return exports;\n";
+        source += "};\n\n";
+        return source;
+    }
+
+    function bundle(moduleSource) {
+        var parts = [];
+        for (var i = 0; i < moduleCount; ++i)
+            parts.push(moduleSource(i));
+        return parts.join("");
+    }
+
+    // Reports the fastest of several runs, which is the least disturbed by
+    // garbage collection.
+    function measure(name, source) {
+        var best = Infinity;
+        for (var i = 0; i < 10; ++i) {
+            var start = new Date;
+            new Function("modules", "m", source);
+            best = Math.min(best, new Date - start);
+        }
+        var megabytes = source.length / (1024 * 1024);
+        print(name + ": " + (megabytes / (best / 1000)).toFixed(1) + " MB/s (" + source.length + " characters in " + best + "ms)");
+    }
+
+    measure("unminified", bundle(unminifiedModule));
+    measure("minified", bundle(minifiedModule));
+    measure("documented", bundle(documentedModule));
+})();
@@ -0,0 +1,33 @@
+// Loads a large generated script bundle in which only a few functions are
+// hot, and reports how much executable memory was committed for machine code
+// once the bundle has initialized and run. With tiered compilation, functions
+// that run once stay in the interpreter and never take up executable memory;
+// run it with "jsc -t 0" to compare with compiling everything. Builds other
+// than 64-bit Mac need ENABLE_TIERED_COMPILATION defined to 1 for this.
+(function () {
+    var moduleCount = 4000;
+
+    var parts = ["var modules = new Array(" + moduleCount + ");"];
+    for (var i = 0; i < moduleCount; ++i) {
+        var source = "modules[" + i + "] = function (state) {";
+        for (var j = 0; j < 4 + i % 12; ++j)
+            source += "state.value = (state.value * 31 + " + (i * 7 % 13 + j) + ") | 0;";
+        source += "return { id: " + i + ", check: function (x) { return x === state.value; } }; };";
+        parts.push(source);
+    }
+    parts.push("function boot() {"
+        + "var state = { value: 0 }; var last;"
+        + "for (var i = 0; i < modules.length; ++i)"
+        + "    last = modules[i](state);"
+        + "return last.check(state.value) ? state.value : -1; }");
+    parts.push("function work(n) { var h = 0; for (var i = 0; i < n; ++i) h = (h * 33 + i) | 0; return h; }");
+
+    gc();
+    var before = executableMemoryStatistics().committed;
+    var checksum = eval(parts.join("\n") + "\nboot() + work(1000000);");
+    gc();
+    var after = executableMemoryStatistics();
+
+    print("executable memory: " + ((after.committed - before) >> 10) + "K committed for " + moduleCount + " modules (checksum " + checksum + ")");
+    print("allocations: " + after.allocations + ", free: " + (after.free >> 10) + "K");
+})();
@@ -0,0 +1,33 @@
+// Builds objects by adding properties one at a time, past the point where
+// they outgrow their inline storage and need out-of-line property storage
+// that has to be reallocated as it grows. Reports the time taken and how
+// many collections ran.
+(function () {
+    var names = [];
+    for (var i = 0; i < 64; ++i)
+        names.push("property" + i);
+
+    var before = gcStatistics();
+    var start = new Date;
+
+    var checksum = 0;
+    var retained = [];
+    for (var round = 0; round < 40000; ++round) {
+        var count = 4 + (round & 63) % 60;
+        for (var k = 0; k < 16; ++k) {
+            var object = {};
+            for (var i = 0; i < count; ++i)
+                object[names[i]] = i;
+            checksum += object[names[count - 1]];
+            if (!(round & 255))
+                retained.push(object);
+        }
+    }
+
+    var elapsed = new Date - start;
+    var after = gcStatistics();
+
+    print("checksum: " + checksum + " (" + retained.length + " retained)");
+    print("time: " + elapsed + "ms");
+    print("collections: " + (after.collectionCount - before.collectionCount));
+})();
@@ -0,0 +1,42 @@
+// Reads and overwrites the same properties on objects of several shapes from
+// the same get_by_id and put_by_id sites, the way code that walks a list of
+// heterogeneous records does. Each site sees every shape, so it only stays
+// out of the slow path if its inline cache can hold them all.
+// Build jsc with ENABLE(PROPERTY_ACCESS_SAMPLING) for per-site hit rates.
+(function () {
+    function Point(x, y) { this.x = x; this.y = y; this.weight = 1; }
+    function Point3D(x, y, z) { this.x = x; this.y = y; this.z = z; this.weight = 2; }
+    function Sprite(x, y) { this.name = "sprite"; this.x = x; this.y = y; this.weight = 3; }
+    function Particle(x, y) { this.vx = 0; this.vy = 0; this.x = x; this.y = y; this.weight = 4; }
+    function Label(x, y) { this.text = "label"; this.visible = true; this.x = x; this.y = y; this.weight = 5; }
+    function Box(x, y) { this.width = 10; this.height = 10; this.depth = 10; this.x = x; this.y = y; this.weight = 6; }
+
+    var constructors = [Point, Point3D, Sprite, Particle, Label, Box];
+
+    function makeObjects(shapeCount) {
+        var objects = [];
+        for (var i = 0; i < 600; ++i)
+            objects.push(new constructors[i % shapeCount](i, -i));
+        return objects;
+    }
+
+    function step(objects) {
+        var sum = 0;
+        for (var i = 0; i < objects.length; ++i) {
+            var object = objects[i];
+            object.x = object.x + object.weight;
+            object.y = object.y - 1;
+            sum += object.x - object.y;
+        }
+        return sum;
+    }
+
+    for (var shapeCount = 1; shapeCount <= constructors.length; ++shapeCount) {
+        var objects = makeObjects(shapeCount);
+        var start = new Date;
+        var checksum = 0;
+        for (var round = 0; round < 4000; ++round)
+            checksum = (checksum + step(objects)) % 1000000007;
+        print(shapeCount + " shape" + (shapeCount > 1 ? "s" : "") + ": " + (new Date - start) + "ms (checksum " + checksum + ")");
+    }
+})();
@@ -0,0 +1,81 @@
+// Measures the property tables of objects with a few properties, like the
+// option bags and small records that most objects in a page are. "memory"
+// builds objects with many different shapes and reports the malloc memory
+// used for each shape, which is mostly its property table. "lookup" looks
+// properties up by a name that changes each time, so that the lookups can not
+// be cached and go to the property table, including names that the object
+// does not have, and reports the fastest of several runs. Both are reported
+// for objects with several numbers of properties; the checksums must not
+// change.
+(function () {
+    var shapeCount = 4000;
+    var lookupCount = 2000000;
+    var propertyCounts = [3, 4, 6, 8, 12];
+
+    // The name of each property depends on its position and on a digit of the
+    // shape's number, so that each shape adds a different sequence of names.
+    var names = [];
+    for (var position = 0; position < 12; ++position) {
+        names.push([]);
+        for (var digit = 0; digit < 16; ++digit)
+            names[position].push("p" + position + "_" + digit);
+    }
+
+    // Use all of the names once, so that making them into identifiers is not
+    // counted in the memory used for the shapes.
+    var allNames = {};
+    for (var position = 0; position < names.length; ++position) {
+        for (var digit = 0; digit < 16; ++digit)
+            allNames[names[position][digit]] = digit;
+    }
+
+    function object(shape, propertyCount) {
+        var result = {};
+        for (var position = 0; position < propertyCount; ++position)
+            result[names[position][(shape >> (4 * (position % 3))) & 15]] = position;
+        return result;
+    }
+
+    function measureMemory(propertyCount) {
+        var objects = [];
+        gc();
+        var before = mallocStatistics().inUse;
+        for (var shape = 0; shape < shapeCount; ++shape)
+            objects.push(object(shape, propertyCount));
+        gc();
+        var after = mallocStatistics().inUse;
+        print("memory, " + propertyCount + " properties: " + Math.round((after - before) / shapeCount) + " bytes per shape");
+    }
+
+    function measureLookup(propertyCount) {
+        var objects = [];
+        for (var shape = 0; shape < 16; ++shape)
+            objects.push(object(shape * 0x111, propertyCount));
+        var keys = [];
+        for (var position = 0; position < propertyCount + 2; ++position)
+            keys.push(names[position % 12][position & 15]);
+
+        var best = Infinity;
+        var checksum;
+        for (var run = 0; run < 5; ++run) {
+            var start = new Date;
+            checksum = 0;
+            for (var i = 0; i < lookupCount; ++i) {
+                var o = objects[i & 15];
+                var key = keys[i % keys.length];
+                var value = o[key];
+                if (value !== undefined)
+                    checksum = (checksum + value) | 0;
+                if (key in o)
+                    ++checksum;
+            }
+            best = Math.min(best, new Date - start);
+        }
+        print("lookup, " + propertyCount + " properties: " + best + "ms (checksum " + checksum + ")");
+    }
+
+    for (var i = 0; i < propertyCounts.length; ++i)
+        measureMemory(propertyCounts[i]);
+    for (var i = 0; i < propertyCounts.length; ++i)
+        measureLookup(propertyCounts[i]);
+})();
@@ -0,0 +1,53 @@
+// Runs patterns that used to fall back from the regular expression JIT to the
+// interpreter, the kind that URL rewriting and HTML sanitizing code uses in
+// loops: back-references to quoted attributes and matching tags, groups
+// repeated a fixed number of times, and repeated capturing groups at the end
+// of a pattern. Reports the fastest of several runs in matches per second;
+// the checksums must not change. Build with ENABLE(REGEXP_TRACING) to see
+// which patterns still run in the interpreter, in the "fallback calls" column.
+(function () {
+    var count = 5000;
+
+    var htmlParts = [];
+    for (var i = 0; i < count; ++i) {
+        htmlParts.push("<p class='para" + i + "' title=\"Paragraph " + i + "\"><b>bold " + i + "</b> and <i>italic</i> text, "
+            + "<a href='/page/" + i + "?ref=home' data-id=\"" + i + "\">link " + i + "</a></p>\n");
+    }
+    var html = htmlParts.join("");
+
+    var urlParts = [];
+    for (var i = 0; i < count; ++i)
+        urlParts.push("http://" + (i % 256) + "." + (i * 3 % 256) + ".1." + (i % 7) + "/static/v" + (i % 5) + "/img" + i + ".png?size=" + (i % 3) + "x" + (i % 4) + "&lang=en");
+    var urls = urlParts.join("\n");
+
+    function checksum(regexp, text) {
+        regexp.lastIndex = 0;
+        var matches = 0;
+        var total = 0;
+        var match;
+        while ((match = regexp.exec(text))) {
+            ++matches;
+            total = (total + match.index + (match[1] ? match[1].length : 0)) | 0;
+        }
+        return { matches: matches, total: total };
+    }
+
+    function measure(name, regexp, text) {
+        var best = Infinity;
+        var result;
+        for (var i = 0; i < 5; ++i) {
+            var start = new Date;
+            for (var j = 0; j < 10; ++j)
+                result = checksum(regexp, text);
+            best = Math.max(1, Math.min(best, new Date - start));
+        }
+        print(name + " " + regexp + ": " + Math.round(result.matches * 10 / (best / 1000)) + " matches/s (" + result.matches + " matches, checksum " + result.total + ")");
+    }
+
+    measure("quoted attributes", /(['"])(.*?)\1/g, html);
+    measure("matching tags", /<(\w+)[^>]*>[^<]*<\/\1>/g, html);
+    measure("attribute pairs", /(\w+)=(['"])[^'"]*\2/g, html);
+    measure("dotted quads", /(?:\d{1,3}\.){3}\d{1,3}/g, urls);
+    measure("size parameters", /(\d)x(\d)(&\w+=\w+)*/g, urls);
+    measure("path segments", /\/(\w+)(\/\w+)*/g, urls);
+})();
@@ -0,0 +1,44 @@
+// Measures the regular expression cache on a workload like a library that
+// builds a RegExp for each class name it looks for, with a few names used much
+// more often than the rest, next to a few hot literals. Reports the time, the
+// cache's hit rate, and how much compiled code and bytecode it holds and has
+// evicted. Run with -r <KB> to see how the hit rate and time change with the
+// cache's budget; the checksum must not change.
+(function () {
+    var nameCount = 2000;
+    var lookupCount = 200000;
+    var classNames = "header nav item-12 item-345 selected active footer widget-7 widget-1234 hidden";
+    var literals = [/(\w+)-(\d+)/, /\bactive\b/, /^\s*header/, /(?:widget|item)-(\d{3,})/g];
+
+    // Picks names with a skewed distribution, so that some are used all the
+    // time and most are used once in a while.
+    var seed = 1;
+    function nextName() {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        var r = seed / 0x7fffffff;
+        var index = Math.floor(r * r * r * nameCount);
+        if (index % 17 == 0)
+            return "item-" + index;
+        return "name" + index;
+    }
+
+    var start = new Date;
+    var checksum = 0;
+    for (var i = 0; i < lookupCount; ++i) {
+        var pattern = new RegExp("(^|\\s)" + nextName() + "(\\s|$)");
+        if (pattern.test(classNames))
+            ++checksum;
+        var literal = literals[i & 3];
+        literal.lastIndex = 0;
+        var match = literal.exec(classNames);
+        if (match)
+            checksum = (checksum + match.index) | 0;
+    }
+    var time = new Date - start;
+
+    var statistics = regExpCacheStatistics();
+    var hitRate = statistics.hits / (statistics.hits + statistics.misses) * 100;
+    print("regexp cache: " + time + "ms (checksum " + checksum + ")");
+    print("    " + hitRate.toFixed(1) + "% hits, " + statistics.entries + " entries holding " + Math.round(statistics.bytes / 1024) + "K of a " + Math.round(statistics.budget / 1024) + "K budget");
+    print("    " + statistics.evictions + " evictions of " + Math.round(statistics.evictedBytes / 1024) + "K, " + statistics.invalidated + " of them still in use");
+})();
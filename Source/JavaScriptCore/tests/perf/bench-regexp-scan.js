@@ -0,0 +1,63 @@
+// Measures regular expressions that begin with a literal, or that contain a
+// literal character every match has to have, run over realistic text: server
+// log lines, an HTML page and a list of URLs. Before the matcher is entered,
+// the input is scanned for the literal prefix, and for the required character
+// after it, so most start offsets are never tried. Reports the fastest of
+// several runs in matches per second; the match counts must not change.
+(function () {
+    var lineCount = 20000;
+
+    var methods = ["GET", "POST", "GET", "GET", "PUT"];
+    var logLines = [];
+    for (var i = 0; i < lineCount; ++i) {
+        logLines.push("10.0." + (i % 256) + "." + (i * 7 % 256) + " - - [18/Apr/2011:12:" + (10 + i % 50) + ":" + (10 + i % 49)
+            + " +0000] \"" + methods[i % methods.length] + " /app/item/" + i + "?session=" + (i * 2654435761 % 1000000) + " HTTP/1.1\" "
+            + (i % 23 ? 200 : 404) + " " + (1000 + i * 13 % 5000) + (i % 97 ? "" : " error=timeout retries=" + (i % 5)));
+    }
+    var log = logLines.join("\n");
+
+    var htmlParts = ["<!DOCTYPE html><html><head><meta http-equiv=\"Content-Type\" content=\"text/html; charset=utf-8\"><title>Items</title></head><body>"];
+    for (var i = 0; i < lineCount / 4; ++i) {
+        htmlParts.push("<div class=\"item item-" + i + "\"><h2>Item " + i + "</h2><p>Some text describing item " + i
+            + ", which is long enough to look like a product listing.</p><a href=\"/items/" + i + "\" title=\"Item " + i + "\">details</a></div>\n");
+    }
+    htmlParts.push("</body></html>");
+    var html = htmlParts.join("");
+
+    var urlLines = [];
+    for (var i = 0; i < lineCount; ++i)
+        urlLines.push((i % 3 ? "https" : "http") + "://www.example" + (i % 40) + ".com/path/to/page" + i + ".html?id=" + i + (i % 5 ? "" : "&utm_source=feed") + "#section" + (i % 7));
+    var urls = urlLines.join("\n");
+
+    function countMatches(regexp, text) {
+        regexp.lastIndex = 0;
+        var count = 0;
+        while (regexp.exec(text))
+            ++count;
+        return count;
+    }
+
+    function measure(name, regexp, text) {
+        var best = Infinity;
+        var count;
+        for (var i = 0; i < 5; ++i) {
+            var start = new Date;
+            count = 0;
+            for (var j = 0; j < 20; ++j)
+                count += countMatches(regexp, text);
+            best = Math.max(1, Math.min(best, new Date - start));
+        }
+        print(name + " " + regexp + ": " + Math.round(count / (best / 1000)) + " matches/s (" + count + " matches in " + best + "ms)");
+    }
+
+    measure("log", /error=\w+/g, log);
+    measure("log", /HTTP\/1\.1" 404/g, log);
+    measure("log", /session=\d+/g, log);
+    measure("log", /\[\d+\/Apr/g, log);
+    measure("html", /\bcharset=[\w-]+/g, html);
+    measure("html", /<a href="([^"]*)"/g, html);
+    measure("html", /<h2>(.*?)<\/h2>/g, html);
+    measure("urls", /utm_source=(\w+)/g, urls);
+    measure("urls", /http:\/\/([^\/]+)/g, urls);
+    measure("urls", /\w+\.html/g, urls);
+})();
@@ -0,0 +1,60 @@
+// Loads a large generated script bundle the way a page loads its libraries:
+// thousands of small module functions are defined, most of them run once or
+// not at all during initialization, and only a few helpers run often enough
+// to matter. Reports the time to evaluate the bundle and run its
+// initialization, then the time for a short burst of steady-state work. Run
+// it with "jsc -t 0", which compiles all code before it runs, to compare with
+// tiered compilation. Tiered compilation is only on by default in 64-bit Mac
+// builds; elsewhere, build with ENABLE_TIERED_COMPILATION defined to 1, or jsc
+// does not take -t. The checksum must not depend on the threshold. In
+// builds with ENABLE(PARSER_STATS), also reports how much of the bundle was
+// parsed into ASTs, how much was only pre-parsed, and how many of its
+// functions were never called.
+(function () {
+    var moduleCount = 4000;
+
+    function moduleSource(i) {
+        var source = "modules[" + i + "] = function (exports) {";
+        source += "var table = [" + i + ", " + (i * 7 % 13) + ", " + (i * 11 % 17) + "];";
+        source += "exports.name = 'module" + i + "';";
+        source += "exports.init = function (state) {";
+        for (var j = 0; j < 4 + i % 12; ++j)
+            source += "state.value = (state.value * 31 + table[" + (j % 3) + "] + " + j + ") | 0;";
+        source += "return state.value; };";
+        // Most exported functions are never called.
+        source += "exports.unused = function (a, b) { var s = 0; for (var k = 0; k < a; ++k) s += b[k]; return s; };";
+        source += "return exports; };";
+        return source;
+    }
+
+    var parts = ["var modules = new Array(" + moduleCount + ");"];
+    for (var i = 0; i < moduleCount; ++i)
+        parts.push(moduleSource(i));
+    parts.push("function hash(state, x) { return ((state << 5) - state + x) | 0; }");
+    parts.push("function boot() {"
+        + "var state = { value: 0 };"
+        + "for (var i = 0; i < modules.length; ++i)"
+        + "    modules[i]({}).init(state);"
+        + "return state.value; }");
+    parts.push("function work(n) { var h = 0; for (var i = 0; i < n; ++i) h = hash(h, i); return h; }");
+    var bundle = parts.join("\n");
+
+    var hasParserStatistics = typeof parserStatistics == "function";
+    var before = hasParserStatistics && parserStatistics();
+    var start = new Date;
+    var checksum = eval(bundle + "\nboot();");
+    print("startup: " + (new Date - start) + "ms for " + bundle.length + " characters (checksum " + checksum + ")");
+
+    if (hasParserStatistics) {
+        var after = parserStatistics();
+        var delta = function (name) { return after[name] - before[name]; };
+        print("parsing: " + delta("parseTime").toFixed(1) + "ms, " + delta("fullyParsedBytes") + " characters parsed, "
+            + delta("preparsedBytes") + " pre-parsed in " + delta("preparseTime").toFixed(1) + "ms, "
+            + delta("skippedBytes") + " skipped");
+        print("functions: " + delta("functions") + " created, " + delta("uncalledFunctions") + " never called");
+    }
+
+    start = new Date;
+    checksum = eval("work(3000000);");
+    print("steady state: " + (new Date - start) + "ms (checksum " + checksum + ")");
+})();
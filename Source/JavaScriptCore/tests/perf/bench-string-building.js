@@ -0,0 +1,87 @@
+// Measures string building workloads that mix concatenation with reading
+// characters, and the memory kept alive by substrings of large strings.
+// "last character" appends pieces of a template and looks at the end of the
+// result after each append, "first character" looks at its start, which is
+// deeper in a rope built by appending, and "substring of rope" takes short
+// substrings of the end. Reports the fastest of several runs.
+// "retained substrings" takes a few short tokens out of each of a series of
+// large documents and keeps only the tokens; it reports how much more malloc
+// memory is in use after the documents are collected (always zero when built
+// with the system malloc).
+(function () {
+    var pieceCount = 5000;
+    var pieces = [];
+    for (var i = 0; i < pieceCount; ++i)
+        pieces.push(i % 2 ? "Item " + i + "</li>\n" : "<li class='item-" + i + "'>");
+
+    function lastCharacter() {
+        var html = "";
+        var closed = 0;
+        for (var i = 0; i < pieceCount; ++i) {
+            html += pieces[i];
+            if (html.charAt(html.length - 1) == "\n")
+                ++closed;
+        }
+        return closed;
+    }
+
+    function firstCharacter() {
+        var html = "";
+        var tags = 0;
+        for (var i = 0; i < pieceCount; ++i) {
+            html += pieces[i];
+            if (html.charCodeAt(0) == 60)
+                ++tags;
+        }
+        return tags;
+    }
+
+    function substringOfRope() {
+        var html = "";
+        var indented = 0;
+        for (var i = 0; i < pieceCount; ++i) {
+            html += pieces[i];
+            if (html.substring(html.length - 6) == "</li>\n")
+                ++indented;
+        }
+        return indented;
+    }
+
+    function measure(name, test) {
+        var best = Infinity;
+        var result;
+        for (var i = 0; i < 5; ++i) {
+            var start = new Date;
+            result = test();
+            best = Math.min(best, new Date - start);
+        }
+        print(name + ": " + best + "ms (result " + result + ")");
+    }
+
+    measure("last character", lastCharacter);
+    measure("first character", firstCharacter);
+    measure("substring of rope", substringOfRope);
+
+    function retainedSubstrings() {
+        var line = "";
+        for (var i = 0; i < 1000; ++i)
+            line += String.fromCharCode(97 + i % 26);
+        var lines = [];
+        for (var i = 0; i < 100; ++i)
+            lines.push(line);
+        gc();
+        var before = mallocStatistics().inUse;
+        var tokens = [];
+        for (var document = 0; document < 100; ++document) {
+            var text = lines.join(document);
+            for (var i = 0; i < 10; ++i)
+                tokens.push(text.substring(i * 9000 + document, i * 9000 + document + 12));
+        }
+        text = null;
+        gc();
+        var retained = mallocStatistics().inUse - before;
+        print("retained substrings: " + Math.round(retained / 1024) + "K for " + tokens.length + " tokens of " + tokens[0].length + " characters");
+    }
+
+    retainedSubstrings();
+})();
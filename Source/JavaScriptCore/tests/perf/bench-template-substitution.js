@@ -0,0 +1,43 @@
+// Measures filling in HTML templates by substituting placeholders, the way
+// small client-side template libraries do: each placeholder is replaced with
+// a global RegExp that only matches a literal, or by splitting on it and
+// joining with the value. "index of" looks for the placeholders with indexOf.
+// Reports the time for each way of substituting; the checksums must not
+// change.
+(function () {
+    var template = "<li class='item'><a href='/items/{{id}}' title='{{name}}'>{{name}}</a>"
+        + "<span class='price'>{{price}}</span><p>Description of {{name}}, which is one of the"
+        + " items in the list, with enough text around the placeholders to be searched.</p></li>";
+    var itemCount = 50000;
+
+    function item(i) {
+        return { id: String(i), name: "Item " + i, price: "$" + (i % 100) + ".99" };
+    }
+
+    function fillWithRegExps(values) {
+        return template.replace(/\{\{id\}\}/g, values.id).replace(/\{\{name\}\}/g, values.name).replace(/\{\{price\}\}/g, values.price);
+    }
+
+    function fillWithSplit(values) {
+        return template.split("{{id}}").join(values.id).split("{{name}}").join(values.name).split("{{price}}").join(values.price);
+    }
+
+    function countPlaceholders() {
+        var count = 0;
+        for (var position = template.indexOf("{{"); position != -1; position = template.indexOf("{{", position + 2))
+            ++count;
+        return count;
+    }
+
+    function measure(name, fill) {
+        var start = new Date;
+        var checksum = 0;
+        for (var i = 0; i < itemCount; ++i)
+            checksum = (checksum + fill(item(i)).length) | 0;
+        print(name + ": " + (new Date - start) + "ms (checksum " + checksum + ")");
+    }
+
+    measure("global regexp", fillWithRegExps);
+    measure("split and join", fillWithSplit);
+    measure("index of", function () { return { length: countPlaceholders() }; });
+})();
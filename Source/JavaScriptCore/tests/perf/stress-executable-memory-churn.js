@@ -0,0 +1,44 @@
+// Compiles and throws away thousands of functions, keeping a small rotating
+// set of them alive so that freed code is interleaved with live code, and
+// checks that the memory committed for JIT code stops growing once the first
+// rounds have warmed up. Prints PASS or FAIL, then the allocator statistics.
+(function () {
+    function makeFunction(i) {
+        // Vary the size so that pools of several sizes are freed and reused.
+        var body = "var sum = a;";
+        for (var j = 0; j < i % 24; ++j)
+            body += "sum = (sum * 31 + " + j + " + b) | 0;";
+        return new Function("a", "b", body + "return sum + " + i + ";");
+    }
+
+    var retained = new Array(64);
+    var committedAfterRound = [];
+    var checksum = 0;
+    var start = new Date;
+
+    for (var round = 0; round < 20; ++round) {
+        for (var i = 0; i < 500; ++i) {
+            var n = round * 500 + i;
+            var f = makeFunction(n);
+            checksum = (checksum + f(n, 3) + f(n + 1, 4)) | 0;
+            if (!(n % 7))
+                retained[n % retained.length] = f;
+        }
+        gc();
+        committedAfterRound.push(executableMemoryStatistics().committed);
+    }
+
+    var elapsed = new Date - start;
+    var warm = committedAfterRound[3];
+    var peak = Math.max.apply(Math, committedAfterRound.slice(3));
+    var statistics = executableMemoryStatistics();
+
+    var kb = function (bytes) { return (bytes / 1024).toFixed(0) + "KB"; };
+    print(peak <= warm * 1.5 + 256 * 1024 ? "PASS" : "FAIL: committed JIT memory grew from " + kb(warm) + " to " + kb(peak));
+    print("checksum: " + checksum);
+    print("time: " + elapsed + "ms");
+    print("committed after each round: " + committedAfterRound.map(kb).join(" "));
+    print("free: " + kb(statistics.free) + " in " + statistics.freeBlocks + " blocks, largest " + kb(statistics.largestFreeBlock) + ", free list fragmentation " + statistics.freeListFragmentation.toFixed(2));
+    print("allocations: " + statistics.allocations + ", " + statistics.reuses + " from the free lists");
+    print("trimmed: " + kb(trimExecutableMemory()) + ", committed after trim: " + kb(executableMemoryStatistics().committed));
+})();
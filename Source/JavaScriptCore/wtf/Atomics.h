@@ -107,6 +107,21 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+#if OS(WINDOWS)
+    return InterlockedCompareExchange(reinterpret_cast<long volatile*>(location), static_cast<long>(newValue), static_cast<long>(expected)) == static_cast<long>(expected);
+#elif OS(DARWIN)
+    return OSAtomicCompareAndSwap32Barrier(static_cast<int32_t>(expected), static_cast<int32_t>(newValue), reinterpret_cast<int32_t volatile*>(location));
+#else
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+#endif
+}
+
+#endif
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -114,4 +129,8 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+using WTF::weakCompareAndSwap;
+#endif
+
 #endif // Atomics_h
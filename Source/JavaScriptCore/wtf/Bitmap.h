@@ -19,6 +19,7 @@
 #ifndef Bitmap_h
 #define Bitmap_h
 
+#include "Atomics.h"
 #include "FixedArray.h"
 #include "StdLibExtras.h"
 #include <stdint.h>
@@ -37,6 +38,9 @@ public:
     bool get(size_t) const;
     void set(size_t);
     bool testAndSet(size_t);
+#if ENABLE(COMPARE_AND_SWAP)
+    bool concurrentTestAndSet(size_t);
+#endif
     size_t nextPossiblyUnset(size_t) const;
     void clear(size_t);
     void clearAll();
@@ -87,6 +91,22 @@ inline bool Bitmap<size>::testAndSet(size_t n)
     return result;
 }
 
+#if ENABLE(COMPARE_AND_SWAP)
+template<size_t size>
+inline bool Bitmap<size>::concurrentTestAndSet(size_t n)
+{
+    WordType mask = one << (n % wordSize);
+    WordType* wordPtr = bits.data() + n / wordSize;
+    WordType oldValue;
+    do {
+        oldValue = *wordPtr;
+        if (oldValue & mask)
+            return true;
+    } while (!weakCompareAndSwap(wordPtr, oldValue, oldValue | mask));
+    return false;
+}
+#endif
+
 template<size_t size>
 inline void Bitmap<size>::clear(size_t n)
 {
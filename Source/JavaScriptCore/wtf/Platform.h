@@ -1039,6 +1039,11 @@
 #define ENABLE_OPCODE_STATS 0
 #endif
 
+/* Counts how much code is parsed and pre-parsed, and how many functions are never called. */
+#if !defined(ENABLE_PARSER_STATS)
+#define ENABLE_PARSER_STATS 0
+#endif
+
 #if !defined(ENABLE_GLOBAL_FASTMALLOC_NEW)
 #define ENABLE_GLOBAL_FASTMALLOC_NEW 1
 #endif
@@ -1118,11 +1123,23 @@
 #define ENABLE_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
+/* The DFG JIT is only implemented for JSVALUE64, and is only enabled on PLATFORM(MAC), where it has been tested. */
 #if ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
 #define ENABLE_DFG_JIT 1
-/* Enabled with restrictions to circumvent known performance regressions. */
-#define ENABLE_DFG_JIT_RESTRICTIONS 1
+#endif
+
+/* The baseline JIT records the types it sees so the DFG JIT can speculate on them. */
+#if !defined(ENABLE_VALUE_PROFILER) && ENABLE(DFG_JIT)
+#define ENABLE_VALUE_PROFILER 1
+#endif
+
+/* Tiered compilation runs cold code in the interpreter, and compiles it with the JIT once it is warm.
+   Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
+#if !defined(ENABLE_TIERED_COMPILATION) && ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
+#define ENABLE_TIERED_COMPILATION 1
+#endif
+#if ENABLE(TIERED_COMPILATION) && !defined(ENABLE_INTERPRETER)
+#define ENABLE_INTERPRETER 1
 #endif
 
 /* Ensure that either the JIT or the interpreter has been enabled. */
@@ -1163,6 +1180,14 @@
     #endif
 #endif
 
+/* Per-site inline cache hit and slow case counts for get_by_id and put_by_id, dumped by jsc. */
+#if !defined(ENABLE_PROPERTY_ACCESS_SAMPLING)
+#define ENABLE_PROPERTY_ACCESS_SAMPLING 0
+#endif
+#if ENABLE(PROPERTY_ACCESS_SAMPLING) && !ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
+#error "PROPERTY_ACCESS_SAMPLING requires JIT_OPTIMIZE_PROPERTY_ACCESS"
+#endif
+
 #if CPU(X86) && COMPILER(MSVC)
 #define JSC_HOST_CALL __fastcall
 #elif CPU(X86) && COMPILER(GCC)
@@ -1270,6 +1295,24 @@
 
 #define ENABLE_JSC_ZOMBIES 0
 
+/* Lock-free compare-and-swap, see weakCompareAndSwap() in Atomics.h. */
+#if !defined(ENABLE_COMPARE_AND_SWAP) && (OS(DARWIN) || (OS(WINDOWS) && !COMPILER(MINGW) && !OS(WINCE)) || (COMPILER(GCC) && GCC_VERSION_AT_LEAST(4, 1, 0) && !OS(SYMBIAN)))
+#define ENABLE_COMPARE_AND_SWAP 1
+#endif
+
+/* Parallel marking in the garbage collector. The number of marker threads is
+   still chosen at runtime; a single marker keeps the serial behavior. */
+#if !defined(ENABLE_PARALLEL_GC) && ENABLE(JSC_MULTIPLE_THREADS) && ENABLE(COMPARE_AND_SWAP)
+#define ENABLE_PARALLEL_GC 1
+#endif
+
+/* Generational (young/old) collection. It depends on every store of a
+   reference into a cell going through a write barrier, including the stores
+   made by JIT code, so it is off until ports have audited their bindings. */
+#if !defined(ENABLE_GGC)
+#define ENABLE_GGC 0
+#endif
+
 /* FIXME: Eventually we should enable this for all platforms and get rid of the define. */
 #if PLATFORM(MAC) || PLATFORM(WIN) || PLATFORM(QT)
 #define WTF_USE_PLATFORM_STRATEGIES 1
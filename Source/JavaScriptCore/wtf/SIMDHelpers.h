@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef SIMDHelpers_h
+#define SIMDHelpers_h
+
+#include <wtf/AlwaysInline.h>
+#include <wtf/Platform.h>
+#include <wtf/unicode/Unicode.h>
+
+#if CPU(X86_64) || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define WTF_USE_UCHAR_VECTORS 1
+#define WTF_USE_SSE2_UCHAR_VECTORS 1
+#include <emmintrin.h>
+#elif CPU(ARM_NEON)
+#define WTF_USE_UCHAR_VECTORS 1
+#define WTF_USE_NEON_UCHAR_VECTORS 1
+#include <arm_neon.h>
+#endif
+
+// Helpers for code that compares eight UChars at a time. A mask has each lane all
+// ones where the comparison is true, and all zeros where it is false. Code using
+// them is compiled only if USE(UCHAR_VECTORS), and still has to handle the
+// characters at the end that do not fill a whole vector.
+
+#if USE(UCHAR_VECTORS)
+
+namespace WTF {
+
+#if USE(SSE2_UCHAR_VECTORS)
+typedef __m128i UCharVector;
+
+ALWAYS_INLINE UCharVector loadVector(const UChar* characters) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters)); }
+ALWAYS_INLINE UCharVector splatVector(UChar character) { return _mm_set1_epi16(static_cast<short>(character)); }
+ALWAYS_INLINE UCharVector equalVector(UCharVector a, UCharVector b) { return _mm_cmpeq_epi16(a, b); }
+ALWAYS_INLINE UCharVector orVector(UCharVector a, UCharVector b) { return _mm_or_si128(a, b); }
+ALWAYS_INLINE UCharVector andVector(UCharVector a, UCharVector b) { return _mm_and_si128(a, b); }
+
+// SSE2 only compares signed 16-bit lanes, so both sides are moved into the signed range first.
+ALWAYS_INLINE UCharVector lessThanVector(UCharVector a, UCharVector b)
+{
+    const __m128i signBit = _mm_set1_epi16(static_cast<short>(0x8000));
+    return _mm_cmplt_epi16(_mm_xor_si128(a, signBit), _mm_xor_si128(b, signBit));
+}
+
+ALWAYS_INLINE bool anyLaneSet(UCharVector mask) { return _mm_movemask_epi8(mask); }
+ALWAYS_INLINE bool allLanesSet(UCharVector mask) { return _mm_movemask_epi8(mask) == 0xFFFF; }
+ALWAYS_INLINE bool laneIsSet(UCharVector mask, unsigned lane) { return _mm_movemask_epi8(mask) & (1 << (2 * lane)); }
+#elif USE(NEON_UCHAR_VECTORS)
+typedef uint16x8_t UCharVector;
+
+ALWAYS_INLINE UCharVector loadVector(const UChar* characters) { return vld1q_u16(reinterpret_cast<const uint16_t*>(characters)); }
+ALWAYS_INLINE UCharVector splatVector(UChar character) { return vdupq_n_u16(character); }
+ALWAYS_INLINE UCharVector equalVector(UCharVector a, UCharVector b) { return vceqq_u16(a, b); }
+ALWAYS_INLINE UCharVector orVector(UCharVector a, UCharVector b) { return vorrq_u16(a, b); }
+ALWAYS_INLINE UCharVector andVector(UCharVector a, UCharVector b) { return vandq_u16(a, b); }
+ALWAYS_INLINE UCharVector lessThanVector(UCharVector a, UCharVector b) { return vcltq_u16(a, b); }
+ALWAYS_INLINE bool anyLaneSet(UCharVector mask) { return vget_lane_u64(vreinterpret_u64_u16(vorr_u16(vget_low_u16(mask), vget_high_u16(mask))), 0); }
+ALWAYS_INLINE bool allLanesSet(UCharVector mask) { return !~vget_lane_u64(vreinterpret_u64_u16(vand_u16(vget_low_u16(mask), vget_high_u16(mask))), 0); }
+
+ALWAYS_INLINE bool laneIsSet(UCharVector mask, unsigned lane)
+{
+    uint16_t lanes[8];
+    vst1q_u16(lanes, mask);
+    return lanes[lane];
+}
+#endif
+
+static const unsigned ucharVectorLength = sizeof(UCharVector) / sizeof(UChar);
+
+} // namespace WTF
+
+using WTF::UCharVector;
+using WTF::allLanesSet;
+using WTF::andVector;
+using WTF::anyLaneSet;
+using WTF::equalVector;
+using WTF::laneIsSet;
+using WTF::lessThanVector;
+using WTF::loadVector;
+using WTF::orVector;
+using WTF::splatVector;
+using WTF::ucharVectorLength;
+
+#endif // USE(UCHAR_VECTORS)
+
+#endif // SIMDHelpers_h
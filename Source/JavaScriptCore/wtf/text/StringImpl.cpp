@@ -28,6 +28,7 @@
 #include "AtomicString.h"
 #include "StringBuffer.h"
 #include "StringHash.h"
+#include <wtf/SIMDHelpers.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/WTFThreadData.h>
 
@@ -518,9 +519,57 @@ int codePointCompare(const StringImpl* s1, const StringImpl* s2)
     return (l1 > l2) ? 1 : -1;
 }
 
+#if USE(UCHAR_VECTORS)
+// Skips the vectors that do not contain matchCharacter, and finds it in the rest one at a time.
+static inline size_t findCharacterUsingVectors(const UChar* characters, unsigned length, UChar matchCharacter, unsigned index)
+{
+    if (index < length) {
+        UCharVector match = splatVector(matchCharacter);
+        for (; length - index >= ucharVectorLength; index += ucharVectorLength) {
+            if (anyLaneSet(equalVector(loadVector(characters + index), match)))
+                break;
+        }
+    }
+    return WTF::find(characters, length, matchCharacter, index);
+}
+
+// Compares the first and the last character of matchCharacters with eight places at a time,
+// and compares the rest only where both of them matched. delta is the last place to try.
+static inline size_t findStringUsingVectors(const UChar* searchCharacters, unsigned delta, const UChar* matchCharacters, unsigned matchLength)
+{
+    ASSERT(matchLength > 1);
+    unsigned lastIndex = matchLength - 1;
+    UChar first = matchCharacters[0];
+    UChar last = matchCharacters[lastIndex];
+    size_t compareSize = (matchLength - 2) * sizeof(UChar);
+
+    unsigned i = 0;
+    UCharVector firstVector = splatVector(first);
+    UCharVector lastVector = splatVector(last);
+    for (; i <= delta && delta - i >= ucharVectorLength - 1; i += ucharVectorLength) {
+        UCharVector mask = andVector(equalVector(loadVector(searchCharacters + i), firstVector), equalVector(loadVector(searchCharacters + i + lastIndex), lastVector));
+        if (!anyLaneSet(mask))
+            continue;
+        for (unsigned lane = 0; lane < ucharVectorLength; ++lane) {
+            if (laneIsSet(mask, lane) && !memcmp(searchCharacters + i + lane + 1, matchCharacters + 1, compareSize))
+                return i + lane;
+        }
+    }
+    for (; i <= delta; ++i) {
+        if (searchCharacters[i] == first && searchCharacters[i + lastIndex] == last && !memcmp(searchCharacters + i + 1, matchCharacters + 1, compareSize))
+            return i;
+    }
+    return notFound;
+}
+#endif
+
 size_t StringImpl::find(UChar c, unsigned start)
 {
+#if USE(UCHAR_VECTORS)
+    return findCharacterUsingVectors(m_data, m_length, c, start);
+#else
     return WTF::find(m_data, m_length, c, start);
+#endif
 }
 
 size_t StringImpl::find(CharacterMatchFunctionPtr matchFunction, unsigned start)
@@ -621,7 +670,7 @@ size_t StringImpl::find(StringImpl* matchString, unsigned index)
 
     // Optimization 1: fast case for strings of length 1.
     if (matchLength == 1)
-        return WTF::find(characters(), length(), matchString->characters()[0], index);
+        return find(matchString->characters()[0], index);
 
     // Check index & matchLength are in range.
     if (index > length())
@@ -635,6 +684,10 @@ size_t StringImpl::find(StringImpl* matchString, unsigned index)
     const UChar* searchCharacters = characters() + index;
     const UChar* matchCharacters = matchString->characters();
 
+#if USE(UCHAR_VECTORS)
+    size_t matchIndex = findStringUsingVectors(searchCharacters, delta, matchCharacters, matchLength);
+    return matchIndex == notFound ? notFound : index + matchIndex;
+#else
     // Optimization 2: keep a running hash of the strings,
     // only call memcmp if the hashes match.
     unsigned searchHash = 0;
@@ -654,6 +707,7 @@ size_t StringImpl::find(StringImpl* matchString, unsigned index)
         ++i;
     }
     return index + i;
+#endif
 }
 
 size_t StringImpl::findIgnoringCase(StringImpl* matchString, unsigned index)
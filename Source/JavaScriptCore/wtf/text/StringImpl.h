@@ -199,6 +199,9 @@ public:
 
     SharedUChar* sharedBuffer();
     const UChar* characters() const { return m_data; }
+    // The length of the string that owns this string's buffer. For a substring, that
+    // is the string it shares the buffer of, which the substring keeps alive.
+    unsigned bufferOwnerLength() const { return bufferOwnership() == BufferSubstring ? m_substringBuffer->length() : length(); }
 
     size_t cost()
     {
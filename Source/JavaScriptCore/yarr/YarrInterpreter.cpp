@@ -735,7 +735,6 @@ public:
         ASSERT(term.type == ByteTerm::TypeParenthesesSubpatternTerminalBegin);
         ASSERT(term.atom.quantityType == QuantifierGreedy);
         ASSERT(term.atom.quantityCount == quantifyInfinite);
-        ASSERT(!term.capture());
 
         BackTrackInfoParenthesesTerminal* backTrack = reinterpret_cast<BackTrackInfoParenthesesTerminal*>(context->frame + term.frameLocation);
         backTrack->begin = input.getPos();
@@ -751,6 +750,13 @@ public:
         if (backTrack->begin == input.getPos())
             return false;
 
+        // The parentheses don't contain captures, so an iteration that matched only has its own to record.
+        if (term.capture()) {
+            unsigned subpatternId = term.atom.subpatternId;
+            output[(subpatternId << 1)] = backTrack->begin + term.inputPosition;
+            output[(subpatternId << 1) + 1] = input.getPos() + term.inputPosition;
+        }
+
         // Successful match! Okay, what's next? - loop around and try to match moar!
         context->term -= (term.atom.parenthesesWidth + 1);
         return true;
@@ -761,7 +767,6 @@ public:
         ASSERT(term.type == ByteTerm::TypeParenthesesSubpatternTerminalBegin);
         ASSERT(term.atom.quantityType == QuantifierGreedy);
         ASSERT(term.atom.quantityCount == quantifyInfinite);
-        ASSERT(!term.capture());
 
         // If we backtrack to this point, we have failed to match this iteration of the parens.
         // Since this is greedy / zero minimum a failed is also accepted as a match!
@@ -1897,6 +1902,25 @@ PassOwnPtr<BytecodePattern> byteCompile(YarrPattern& pattern, BumpPointerAllocat
     return ByteCompiler(pattern).compile(allocator);
 }
 
+static size_t sizeInBytes(const ByteDisjunction* disjunction)
+{
+    return sizeof(ByteDisjunction) + disjunction->terms.capacity() * sizeof(ByteTerm);
+}
+
+size_t BytecodePattern::sizeInBytes() const
+{
+    size_t size = sizeof(BytecodePattern) + Yarr::sizeInBytes(m_body.get()) + m_beginChars.capacity() * sizeof(BeginChar);
+    for (size_t i = 0; i < m_allParenthesesInfo.size(); ++i)
+        size += Yarr::sizeInBytes(m_allParenthesesInfo[i]);
+    for (size_t i = 0; i < m_userCharacterClasses.size(); ++i) {
+        CharacterClass* characterClass = m_userCharacterClasses[i];
+        size += sizeof(CharacterClass)
+            + (characterClass->m_matches.capacity() + characterClass->m_matchesUnicode.capacity()) * sizeof(UChar)
+            + (characterClass->m_ranges.capacity() + characterClass->m_rangesUnicode.capacity()) * sizeof(CharacterRange);
+    }
+    return size;
+}
+
 int interpret(BytecodePattern* bytecode, const UChar* input, unsigned start, unsigned length, int* output)
 {
     return Interpreter(bytecode, output, input, start, length).interpret();
@@ -350,6 +350,9 @@ public:
         deleteAllValues(m_userCharacterClasses);
     }
 
+    // The memory held by the bytecode, including its character classes.
+    size_t sizeInBytes() const;
+
     OwnPtr<ByteDisjunction> m_body;
     bool m_ignoreCase;
     bool m_multiline;
@@ -1543,6 +1543,54 @@ class YarrGenerator : private MacroAssembler {
         state.setBacktrackLabel(backtrackBegin);
     }
 
+    // Matches the text of a capture that has already been closed; an unset capture matches
+    // the empty string. The index before the match is kept in the frame, so that backtracking
+    // into the back-reference can restore it.
+    void generateBackReference(TermGenerationState& state)
+    {
+        const RegisterID character = regT0;
+        const RegisterID matchIndex = regT1;
+        PatternTerm& term = state.term();
+        unsigned subpatternId = term.backReferenceSubpatternId;
+        int inputOffset = state.inputOffset();
+
+        ASSERT(term.quantityType == QuantifierFixedCount && term.quantityCount == 1);
+        ASSERT(!m_pattern.m_ignoreCase);
+
+        storeToFrame(index, term.frameLocation);
+
+        JumpList matched;
+        JumpList failures;
+        load32(Address(output, (subpatternId << 1) * sizeof(int)), matchIndex);
+        matched.append(branch32(Equal, matchIndex, TrustedImm32(-1)));
+        load32(Address(output, ((subpatternId << 1) + 1) * sizeof(int)), character);
+        sub32(matchIndex, character);
+        matched.append(branchTest32(Zero, character));
+
+        // Keep the index at which the copy will end in the frame, and check that there is
+        // enough input for it. The index is already past the input that the terms after
+        // this one were checked for, as with atEndOfInput(), so the offset is not added.
+        add32(index, character);
+        storeToFrame(character, term.frameLocation + 1);
+        failures.append(branch32(Above, character, length));
+
+        Label loop(this);
+        load16(BaseIndex(input, matchIndex, TimesTwo, 0), character);
+        failures.append(branch16(NotEqual, BaseIndex(input, index, TimesTwo, inputOffset * sizeof(UChar)), character));
+        add32(TrustedImm32(1), matchIndex);
+        add32(TrustedImm32(1), index);
+        branch32(NotEqual, index, Address(stackPointerRegister, (term.frameLocation + 1) * sizeof(void*))).linkTo(loop, this);
+        matched.append(jump());
+
+        Label backtrackBegin(this);
+        failures.link(this);
+        loadFromFrame(term.frameLocation, index);
+        state.jumpToBacktrack(this);
+
+        matched.link(this);
+        state.setBacktrackLabel(backtrackBegin);
+    }
+
     void generateParenthesesDisjunction(PatternTerm& parenthesesTerm, TermGenerationState& state, unsigned alternativeFrameLocation)
     {
         ASSERT((parenthesesTerm.type == PatternTerm::TypeParenthesesSubpattern) || (parenthesesTerm.type == PatternTerm::TypeParentheticalAssertion));
@@ -1721,6 +1769,7 @@ class YarrGenerator : private MacroAssembler {
                     store32(indexTemporary, Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
                 } else
                     store32(index, Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+                m_closedSubpatterns[term.parentheses.subpatternId] = true;
             }
 
             m_expressionState.decrementParenNestingLevel();
@@ -1764,7 +1813,15 @@ class YarrGenerator : private MacroAssembler {
                 generateTerm(parenthesesState);
 
             // If we get here, we matched! If the index advanced then try to match more since limit isn't supported yet.
-            branch32(NotEqual, index, Address(stackPointerRegister, (parenthesesTerm.frameLocation * sizeof(void*))), matchAgain);
+            if (parenthesesTerm.capture()) {
+                // The parentheses contain no captures of their own, so only an iteration that
+                // matched needs to record the capture.
+                Jump matchedNothing = branch32(Equal, index, Address(stackPointerRegister, (parenthesesTerm.frameLocation * sizeof(void*))));
+                storeCapture(parenthesesTerm.parentheses.subpatternId, state.inputOffset(), parenthesesTerm.frameLocation);
+                jump(matchAgain);
+                matchedNothing.link(this);
+            } else
+                branch32(NotEqual, index, Address(stackPointerRegister, (parenthesesTerm.frameLocation * sizeof(void*))), matchAgain);
 
             // If we get here we matched, but we matched "" - cannot accept this alternative as is, so either backtrack,
             // or fall through to try the next alternative if no backtrack is available.
@@ -1782,6 +1839,24 @@ class YarrGenerator : private MacroAssembler {
 
         // If the last alternative falls through to here, we have a failed match...
         // Which means that we match whatever we have matched up to this point (even if nothing).
+
+        if (parenthesesTerm.capture())
+            m_closedSubpatterns[parenthesesTerm.parentheses.subpatternId] = true;
+    }
+
+    // Stores the start, kept in the frame, and the end, the current index, of a capture.
+    void storeCapture(unsigned subpatternId, int inputOffset, unsigned startFrameLocation)
+    {
+        const RegisterID indexTemporary = regT0;
+
+        loadFromFrame(startFrameLocation, indexTemporary);
+        if (inputOffset)
+            add32(Imm32(inputOffset), indexTemporary);
+        store32(indexTemporary, Address(output, (subpatternId << 1) * sizeof(int)));
+        move(index, indexTemporary);
+        if (inputOffset)
+            add32(Imm32(inputOffset), indexTemporary);
+        store32(indexTemporary, Address(output, ((subpatternId << 1) + 1) * sizeof(int)));
     }
 
     void generateParentheticalAssertion(TermGenerationState& state)
@@ -1897,7 +1972,14 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+            // Only a reference to a capture that closes before it can be read from the output
+            // vector; a reference from inside its own capture, or to a later one, is left to
+            // the interpreter, as are case-insensitive and quantified back-references.
+            if (term.quantityType == QuantifierFixedCount && term.quantityCount == 1 && !m_pattern.m_ignoreCase
+                && term.backReferenceSubpatternId < m_closedSubpatterns.size() && m_closedSubpatterns[term.backReferenceSubpatternId])
+                generateBackReference(state);
+            else
+                m_shouldFallBack = true;
             break;
 
         case PatternTerm::TypeForwardReference:
@@ -2228,6 +2310,7 @@ public:
         : m_pattern(pattern)
         , m_shouldFallBack(false)
     {
+        m_closedSubpatterns.fill(false, pattern.m_numSubpatterns + 1);
     }
 
     void generate()
@@ -2260,6 +2343,9 @@ private:
     YarrPattern& m_pattern;
     bool m_shouldFallBack;
     GenerationState m_expressionState;
+
+    // The captures whose code has been generated in full, in pattern order.
+    Vector<bool> m_closedSubpatterns;
 };
 
 void jitCompile(YarrPattern& pattern, JSGlobalData* globalData, YarrCodeBlock& jitObject)
@@ -62,6 +62,14 @@ public:
     void setFallBack(bool fallback) { m_needFallBack = fallback; }
     bool isFallBack() { return m_needFallBack; }
     void set(MacroAssembler::CodeRef ref) { m_ref = ref; }
+    size_t size() const { return m_ref.m_size; }
+
+    // Releases the generated code, so that the pattern has to be compiled again before it is next run.
+    void clear()
+    {
+        m_ref = MacroAssembler::CodeRef();
+        m_needFallBack = false;
+    }
 
     int execute(const UChar* input, unsigned start, unsigned length, int* output)
     {
@@ -630,18 +630,47 @@ public:
 
         if (min == 0)
             term.quantify(max, greedy   ? QuantifierGreedy : QuantifierNonGreedy);
-        else if (min == max)
+        else if (min == max) {
             term.quantify(min, QuantifierFixedCount);
-        else {
+            unrollFixedCountParentheses(m_alternative->m_terms.size() - 1);
+        } else {
             term.quantify(min, QuantifierFixedCount);
             m_alternative->m_terms.append(copyTerm(term));
             // NOTE: this term is interesting from an analysis perspective, in that it can be ignored.....
             m_alternative->lastTerm().quantify((max == quantifyInfinite) ? max : max - min, greedy ? QuantifierGreedy : QuantifierNonGreedy);
             if (m_alternative->lastTerm().type == PatternTerm::TypeParenthesesSubpattern)
                 m_alternative->lastTerm().parentheses.isCopy = true;
+            unrollFixedCountParentheses(m_alternative->m_terms.size() - 2);
         }
     }
 
+    static bool containsNestedCaptures(const PatternTerm& term)
+    {
+        // A non-capturing group's subpatternId is that of the first capture it would contain.
+        if (term.m_capture)
+            return term.parentheses.lastSubpatternId > term.parentheses.subpatternId;
+        return term.parentheses.lastSubpatternId >= term.parentheses.subpatternId;
+    }
+
+    // Replaces a group matched a fixed number of times, like (ab){3}, with that many copies of
+    // the group, each matched once, which both matchers handle better. Only groups that don't
+    // contain captures are unrolled: a capture inside the group has to be reset at the start
+    // of each iteration, and the copies wouldn't do that.
+    void unrollFixedCountParentheses(unsigned termIndex)
+    {
+        static const unsigned maximumUnrolledCount = 8;
+
+        PatternTerm term = m_alternative->m_terms[termIndex];
+        ASSERT(term.quantityType == QuantifierFixedCount);
+        if (term.type != PatternTerm::TypeParenthesesSubpattern || term.quantityCount == 1 || term.quantityCount > maximumUnrolledCount || containsNestedCaptures(term))
+            return;
+
+        unsigned count = term.quantityCount;
+        m_alternative->m_terms[termIndex].quantify(1, QuantifierFixedCount);
+        for (unsigned i = 1; i < count; ++i)
+            m_alternative->m_terms.insert(termIndex + i, copyTerm(m_alternative->m_terms[termIndex]));
+    }
+
     void disjunction()
     {
         m_alternative = m_alternative->m_parent->addNewAlternative();
@@ -764,15 +793,11 @@ public:
     // We can presently avoid backtracking for:
     //   * where the parens are at the end of the regular expression (last term in any of the
     //     alternatives of the main body disjunction).
-    //   * where the parens are non-capturing, and quantified unbounded greedy (*).
-    //   * where the parens do not contain any capturing subpatterns.
+    //   * where the parens are quantified unbounded greedy (*).
+    //   * where the parens do not contain any capturing subpatterns; the parens themselves
+    //     may capture, in which case each iteration that matches records the capture.
     void checkForTerminalParentheses()
     {
-        // This check is much too crude; should be just checking whether the candidate
-        // node contains nested capturing subpatterns, not the whole expression!
-        if (m_pattern.m_numSubpatterns)
-            return;
-
         Vector<PatternAlternative*>& alternatives = m_pattern.m_body->m_alternatives;
         for (size_t i = 0; i < alternatives.size(); ++i) {
             Vector<PatternTerm>& terms = alternatives[i]->m_terms;
@@ -781,7 +806,7 @@ public:
                 if (term.type == PatternTerm::TypeParenthesesSubpattern
                     && term.quantityType == QuantifierGreedy
                     && term.quantityCount == quantifyInfinite
-                    && !term.capture())
+                    && !containsNestedCaptures(term))
                     term.parentheses.isTerminal = true;
             }
         }
@@ -947,7 +972,111 @@ public:
         }
     }
 
+    // Finds the characters that every match must start with, and a character that every
+    // match must contain after them, so that the input can be scanned for them before the
+    // matcher is run. Only patterns with a single alternative have them.
+    void setupLiteralPrefix()
+    {
+        if (m_pattern.m_body->m_alternatives.size() != 1)
+            return;
+
+        PatternAlternative* alternative = m_pattern.m_body->m_alternatives[0];
+        if (appendLiteralPrefix(alternative))
+            m_pattern.m_isLiteral = !m_pattern.m_literalPrefix.isEmpty() && !m_pattern.m_numSubpatterns && !containsAssertions(alternative);
+
+        unsigned characterCount = 0;
+        findRequiredCharacter(alternative, characterCount);
+    }
+
 private:
+    // Matches only itself; with ignoreCase, that is a character that has no other case.
+    bool isLiteralCharacter(UChar character)
+    {
+        if (!m_pattern.m_ignoreCase)
+            return true;
+        if (character <= 0x7f)
+            return !isASCIIAlpha(character);
+        return Unicode::toUpper(character) == character && Unicode::toLower(character) == character;
+    }
+
+    // Returns true if all of the alternative was added to the prefix, so that the terms
+    // after it can be added too.
+    bool appendLiteralPrefix(PatternAlternative* alternative)
+    {
+        static const unsigned maximumLiteralPrefixLength = 32;
+
+        Vector<PatternTerm>& terms = alternative->m_terms;
+        for (unsigned i = 0; i < terms.size(); ++i) {
+            PatternTerm& term = terms[i];
+            switch (term.type) {
+            case PatternTerm::TypeAssertionEOL:
+            case PatternTerm::TypeAssertionWordBoundary:
+            case PatternTerm::TypeParentheticalAssertion:
+                // These don't consume input, so the characters after them start the match.
+                break;
+
+            case PatternTerm::TypePatternCharacter:
+                if (term.quantityType != QuantifierFixedCount || !isLiteralCharacter(term.patternCharacter))
+                    return false;
+                for (unsigned count = 0; count < term.quantityCount; ++count) {
+                    if (m_pattern.m_literalPrefix.size() == maximumLiteralPrefixLength)
+                        return false;
+                    m_pattern.m_literalPrefix.append(term.patternCharacter);
+                }
+                break;
+
+            case PatternTerm::TypeParenthesesSubpattern:
+                if (term.quantityType != QuantifierFixedCount || term.quantityCount != 1 || term.parentheses.disjunction->m_alternatives.size() != 1)
+                    return false;
+                if (!appendLiteralPrefix(term.parentheses.disjunction->m_alternatives[0]))
+                    return false;
+                break;
+
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Only called for alternatives that appendLiteralPrefix has added all of.
+    bool containsAssertions(PatternAlternative* alternative)
+    {
+        Vector<PatternTerm>& terms = alternative->m_terms;
+        for (unsigned i = 0; i < terms.size(); ++i) {
+            PatternTerm& term = terms[i];
+            if (term.type == PatternTerm::TypeParenthesesSubpattern) {
+                if (containsAssertions(term.parentheses.disjunction->m_alternatives[0]))
+                    return true;
+            } else if (term.type != PatternTerm::TypePatternCharacter)
+                return true;
+        }
+        return false;
+    }
+
+    // Visits the literal characters that every match contains, in order, and keeps the
+    // last of them that is not part of the prefix. characterCount counts the characters
+    // visited, the first of which are the prefix.
+    void findRequiredCharacter(PatternAlternative* alternative, unsigned& characterCount)
+    {
+        Vector<PatternTerm>& terms = alternative->m_terms;
+        for (unsigned i = 0; i < terms.size(); ++i) {
+            PatternTerm& term = terms[i];
+            if (term.type == PatternTerm::TypePatternCharacter) {
+                if (term.quantityType != QuantifierFixedCount || !term.quantityCount || !isLiteralCharacter(term.patternCharacter))
+                    continue;
+                characterCount += term.quantityCount;
+                if (characterCount > m_pattern.m_literalPrefix.size()) {
+                    m_pattern.m_containsRequiredCharacter = true;
+                    m_pattern.m_requiredCharacter = term.patternCharacter;
+                }
+            } else if (term.type == PatternTerm::TypeParenthesesSubpattern) {
+                if (term.quantityType == QuantifierFixedCount && term.quantityCount == 1 && term.parentheses.disjunction->m_alternatives.size() == 1)
+                    findRequiredCharacter(term.parentheses.disjunction->m_alternatives[0], characterCount);
+            }
+        }
+    }
+
     YarrPattern& m_pattern;
     PatternAlternative* m_alternative;
     CharacterClassConstructor m_characterClassConstructor;
@@ -985,6 +1114,7 @@ const char* YarrPattern::compile(const UString& patternString)
         
     constructor.setupOffsets();
     constructor.setupBeginChars();
+    constructor.setupLiteralPrefix();
 
     return 0;
 }
@@ -995,6 +1125,9 @@ YarrPattern::YarrPattern(const UString& pattern, bool ignoreCase, bool multiline
     , m_containsBackreferences(false)
     , m_containsBeginChars(false)
     , m_containsBOL(false)
+    , m_containsRequiredCharacter(false)
+    , m_isLiteral(false)
+    , m_requiredCharacter(0)
     , m_numSubpatterns(0)
     , m_maxBackReference(0)
     , newlineCached(0)
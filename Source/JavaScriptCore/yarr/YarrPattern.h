@@ -329,6 +329,9 @@ struct YarrPattern {
         m_containsBackreferences = false;
         m_containsBeginChars = false;
         m_containsBOL = false;
+        m_containsRequiredCharacter = false;
+        m_isLiteral = false;
+        m_requiredCharacter = 0;
 
         newlineCached = 0;
         digitsCached = 0;
@@ -343,6 +346,7 @@ struct YarrPattern {
         deleteAllValues(m_userCharacterClasses);
         m_userCharacterClasses.clear();
         m_beginChars.clear();
+        m_literalPrefix.clear();
     }
 
     bool containsIllegalBackReference()
@@ -398,6 +402,9 @@ struct YarrPattern {
     bool m_containsBackreferences : 1;
     bool m_containsBeginChars : 1;
     bool m_containsBOL : 1;
+    bool m_containsRequiredCharacter : 1;
+    bool m_isLiteral : 1;
+    UChar m_requiredCharacter;
     unsigned m_numSubpatterns;
     unsigned m_maxBackReference;
     PatternDisjunction* m_body;
@@ -405,6 +412,11 @@ struct YarrPattern {
     Vector<CharacterClass*> m_userCharacterClasses;
     Vector<BeginChar> m_beginChars;
 
+    // Every match starts with m_literalPrefix, and, if m_containsRequiredCharacter
+    // is set, contains m_requiredCharacter somewhere after the prefix. If m_isLiteral
+    // is set, the pattern matches m_literalPrefix and nothing else.
+    Vector<UChar> m_literalPrefix;
+
 private:
     const char* compile(const UString& patternString);
 
@@ -61,6 +61,10 @@ namespace WebCore {
             , m_cachedScript(cachedScript)
         {
             m_cachedScript->addClient(this);
+            setBytecodeCache(m_cachedScript->bytecodeCache());
+#if ENABLE(JSC_MULTIPLE_THREADS)
+            setBackgroundPreparser(m_cachedScript->takeBackgroundPreparser());
+#endif
         }
 
         CachedResourceHandle<CachedScript> m_cachedScript;
@@ -52,6 +52,7 @@ public:
     ScriptSourceCode(CachedScript* cs)
         : m_provider(CachedScriptSourceProvider::create(cs))
         , m_code(m_provider)
+        , m_cachedScript(cs)
     {
     }
 
@@ -64,6 +65,8 @@ public:
     int startLine() const { return m_code.firstLine(); }
 
     const KURL& url() const { return m_url; }
+
+    CachedScript* cachedScript() const { return m_cachedScript.get(); }
     
 private:
     RefPtr<ScriptSourceProvider> m_provider;
@@ -72,6 +75,7 @@ private:
     
     KURL m_url;
 
+    CachedResourceHandle<CachedScript> m_cachedScript;
 };
 
 } // namespace WebCore
@@ -27,6 +27,7 @@
 #include "config.h"
 #include "CachedScript.h"
 
+#include "CachedMetadata.h"
 #include "MemoryCache.h"
 #include "CachedResourceClient.h"
 #include "CachedResourceClientWalker.h"
@@ -44,6 +45,12 @@ CachedScript::CachedScript(const String& url, const String& charset)
     : CachedResource(url, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+#if USE(JSC)
+    , m_hasBeenEvaluated(false)
+#endif
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+    , m_streamedSize(0)
+#endif
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -53,8 +60,19 @@ CachedScript::CachedScript(const String& url, const String& charset)
 
 CachedScript::~CachedScript()
 {
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+    finishBackgroundPreparse();
+#endif
 }
 
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+void CachedScript::load(CachedResourceLoader* cachedResourceLoader)
+{
+    // Load incrementally, so that the script can be pre-parsed as it arrives.
+    CachedResource::load(cachedResourceLoader, true, DoSecurityCheck, true);
+}
+#endif
+
 void CachedScript::didAddClient(CachedResourceClient* c)
 {
     if (m_decodedDataDeletionTimer.isActive())
@@ -95,6 +113,9 @@ const String& CachedScript::script()
 
 void CachedScript::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
 {
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+    streamToBackgroundPreparser(data.get(), allDataReceived);
+#endif
     if (!allDataReceived)
         return;
 
@@ -108,6 +129,9 @@ void CachedScript::error(CachedResource::Status status)
 {
     setStatus(status);
     ASSERT(errorOccurred());
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+    finishBackgroundPreparse();
+#endif
     setLoading(false);
     checkNotify();
 }
@@ -119,6 +143,14 @@ void CachedScript::destroyDecodedData()
 #if USE(JSC)
     if (m_sourceProviderCache && m_clients.isEmpty())
         m_sourceProviderCache->clear();
+    // The bytecode cache can be read back from the cached metadata.
+    if (m_clients.isEmpty())
+        m_bytecodeCache = 0;
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    // Nothing is left to use the functions of a script that has not run.
+    if (m_clients.isEmpty())
+        finishBackgroundPreparse();
+#endif
 
     extraSize = m_sourceProviderCache ? m_sourceProviderCache->byteSize() : 0;
 #endif
@@ -144,6 +176,81 @@ void CachedScript::sourceProviderCacheSizeChanged(int delta)
 {
     setDecodedSize(decodedSize() + delta);
 }
+
+// A pseudo-randomly chosen ID used to store and retrieve the JSC bytecode cache
+// from the cached metadata of the script.
+static const unsigned bytecodeCacheDataTypeID = 0x4A534243;
+
+JSC::BytecodeCache* CachedScript::bytecodeCache() const
+{
+    // Global code that may be cached can not keep global variables in
+    // registers, so a script only gets a cache to store its code in once it
+    // runs again.
+    if (!m_bytecodeCache) {
+        if (CachedMetadata* cachedMetadata = this->cachedMetadata(bytecodeCacheDataTypeID))
+            m_bytecodeCache = JSC::BytecodeCache::create(cachedMetadata->data(), cachedMetadata->size());
+        else if (m_hasBeenEvaluated)
+            m_bytecodeCache = JSC::BytecodeCache::create();
+    }
+    return m_bytecodeCache.get();
+}
+
+void CachedScript::storeBytecodeCache()
+{
+    // The cached metadata of a resource can only be set once, so the bytecode
+    // cache is stored after the first run that had a cache, with the code it
+    // needed to initialize.
+    m_hasBeenEvaluated = true;
+    if (!m_bytecodeCache || !m_bytecodeCache->hasNewCodeBlocks() || cachedMetadata(bytecodeCacheDataTypeID))
+        return;
+
+    Vector<char> data;
+    m_bytecodeCache->serialize(data);
+    setCachedMetadata(bytecodeCacheDataTypeID, data.data(), data.size());
+}
+#endif
+
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+void CachedScript::streamToBackgroundPreparser(SharedBuffer* data, bool allDataReceived)
+{
+    if (!m_backgroundPreparser) {
+        // Only a script that arrives in several parts is pre-parsed, since
+        // one that arrives at once would be parsed on the main thread first.
+        if (allDataReceived || m_streamedSize || !data)
+            return;
+        m_backgroundPreparser = JSC::BackgroundPreparser::create();
+        m_streamingDecoder = TextResourceDecoder::create("application/javascript", encoding());
+    }
+
+    // The script is decoded again when it runs; if that gives a different
+    // source, the pre-parsed functions are not used.
+    if (data && data->size() > m_streamedSize) {
+        String source = m_streamingDecoder->decode(data->data() + m_streamedSize, data->size() - m_streamedSize);
+        m_streamedSize = data->size();
+        m_backgroundPreparser->appendSource(source.characters(), source.length());
+    }
+    if (allDataReceived) {
+        String source = m_streamingDecoder->flush();
+        m_backgroundPreparser->appendSource(source.characters(), source.length());
+        m_backgroundPreparser->finish();
+        m_streamingDecoder = 0;
+    }
+}
+
+void CachedScript::finishBackgroundPreparse()
+{
+    if (!m_backgroundPreparser)
+        return;
+    m_backgroundPreparser->finish();
+    m_backgroundPreparser = 0;
+    m_streamingDecoder = 0;
+}
+
+PassRefPtr<JSC::BackgroundPreparser> CachedScript::takeBackgroundPreparser()
+{
+    m_streamingDecoder = 0;
+    return m_backgroundPreparser.release();
+}
 #endif
 
 } // namespace WebCore
@@ -31,6 +31,8 @@
 
 #if USE(JSC)
 namespace JSC {
+    class BackgroundPreparser;
+    class BytecodeCache;
     class SourceProviderCache;
 }
 #endif
@@ -38,6 +40,7 @@ namespace JSC {
 namespace WebCore {
 
     class CachedResourceLoader;
+    class SharedBuffer;
     class TextResourceDecoder;
 
     class CachedScript : public CachedResource {
@@ -50,6 +53,10 @@ namespace WebCore {
         virtual void didAddClient(CachedResourceClient*);
         virtual void allClientsRemoved();
 
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+        virtual void load(CachedResourceLoader*);
+#endif
+
         virtual void setEncoding(const String&);
         virtual String encoding() const;
         virtual void data(PassRefPtr<SharedBuffer> data, bool allDataReceived);
@@ -60,9 +67,26 @@ namespace WebCore {
         // Allows JSC to cache additional information about the source.
         JSC::SourceProviderCache* sourceProviderCache() const;
         void sourceProviderCacheSizeChanged(int delta);
+
+        // Allows JSC to load the code of the script instead of compiling it
+        // again. The cache is kept as the cached metadata of the resource.
+        // Returns 0 until the script has been evaluated once.
+        JSC::BytecodeCache* bytecodeCache() const;
+        // Called after each evaluation of the script.
+        void storeBytecodeCache();
+#endif
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+        // The script is pre-parsed on a background thread while it loads.
+        // The preparser is handed to the first source provider of the script,
+        // which adds the pre-parsed functions to the source provider cache.
+        PassRefPtr<JSC::BackgroundPreparser> takeBackgroundPreparser();
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+        void streamToBackgroundPreparser(SharedBuffer*, bool allDataReceived);
+        void finishBackgroundPreparse();
+#endif
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
         String m_script;
@@ -70,6 +94,13 @@ namespace WebCore {
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
         mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        mutable RefPtr<JSC::BytecodeCache> m_bytecodeCache;
+        bool m_hasBeenEvaluated;
+#endif
+#if USE(JSC) && ENABLE(JSC_MULTIPLE_THREADS)
+        RefPtr<JSC::BackgroundPreparser> m_backgroundPreparser;
+        RefPtr<TextResourceDecoder> m_streamingDecoder;
+        unsigned m_streamedSize;
 #endif
     };
 }